@@ -14,10 +14,17 @@ Sim, eu sei que esse arquivo 
 
 #include "a_estrela.h"
 #include "obtendo_possibilidades.h"
+#include "lista_aberta.h"
+#include "trabalhadores.h"
+#include "carimbo.h"
+#include "campo.h"
 
 #include <cmath>
 #include <algorithm>
 #include <chrono>
+#include <limits>
+#include <vector>
+#include <cstring>
 
 using std::min;
 using std::max;
@@ -38,6 +45,23 @@ Explica
 	
 	Mais precisamente,  parecido com o #define s que para funo.
 */
+inline float
+limitar(
+	float valor,
+	float minimo,
+	float maximo
+){
+	/*
+	Mesmo que fmaxf( minimo, fminf( valor, maximo ) ), inclusive para NaN,
+	que vira maximo. Sem -ffast-math o compilador no expande fminf e fmaxf,
+	e cada converso de obstculo pagava quatro chamadas de biblioteca.
+	*/
+	valor = valor < maximo ? valor : maximo;
+
+	return valor > minimo ? valor : minimo;
+}
+
+
 inline int 
 x_para_linha(
 	float x
@@ -48,18 +72,13 @@ x_para_linha(
 	*/
 	return int(
 		// Linhas e Colunas so inteiras.
-		fmaxf(
+		limitar(
 			/*
-			Garantimos que a sada ser 0 ou algo maior.
+			Garantimos que estar entre 0 e as 320 linhas totais.
 			*/
+			10 * x + 160,
 			0.f,
-			fminf(
-				/*
-				Garantimos que estar sob as 320 linhas totais.
-				*/
-				10 * x + 160,
-				320.f
-			)
+			320.f
 		) + 0.5f
 	);
 }
@@ -71,18 +90,13 @@ y_para_col(
 ){
 	return int(
 		// Linhas e Colunas so inteiras.
-		fmaxf(
+		limitar(
 			/*
-			Garantimos que a sada ser 0 ou algo maior.
+			Garantimos que estar entre 0 e as 220 colunas totais.
 			*/
+			10 * y + 110,
 			0.f,
-			fminf(
-				/*
-				Garantimos que estar sob as 220 colunas totais.
-				*/
-				10 * y + 110,
-				220.f
-			)
+			220.f
 		) + 0.5f
 	);
 }
@@ -112,13 +126,13 @@ distancia_diagonal(
 		ir_ao_gol
 	){
 		delta_linha = abs(
-			LINHA_DO_GOL - linha
+			Campo::linha_do_gol - linha
 		);
 		
 		// OK, me rendi  forma que foi escrito no original.
-		if(coluna > 119)       { delta_coluna = coluna - 119; }
-		else if(coluna < 101)  { delta_coluna = 101 - coluna; }
-		else                   { delta_coluna = 0;			  }
+		if(coluna > Campo::ultima_coluna_do_gol)        { delta_coluna = coluna - Campo::ultima_coluna_do_gol;   }
+		else if(coluna < Campo::primeira_coluna_do_gol) { delta_coluna = Campo::primeira_coluna_do_gol - coluna; }
+		else                                            { delta_coluna = 0;			                             }
 	}
 	else{
 		delta_linha  = abs( linha  - linha_final  );
@@ -135,9 +149,71 @@ distancia_diagonal(
 }
 
 
+#define ESTADOS_POR_GERACAO 4  // Aberto, fechado, conhecido e fechado inconsistente
+
+inline int
+estado_na_geracao(
+	unsigned short marca,
+	unsigned short geracao
+){
+	/*
+	Descrio:
+		Traduz a marca guardada em estado_dos_nodes para o estado do n na
+		busca atual, cuja gerao  'geracao':
+
+			geracao     -> 1, aberto
+			geracao + 1 -> 2, fechado
+			geracao + 2 -> 3, conhecido, com custo e pai vlidos, mas fora da lista
+			geracao + 3 -> 4, fechado e inconsistente
+			menor       -> 0, desconhecido, pois sobrou de uma busca anterior
+
+		Os estados 3 e 4 s aparecem na busca em qualquer tempo.
+
+		Assim ningum precisa zerar o quadro inteiro antes de cada busca,
+		veja proxima_geracao(). Custo e pai s so lidos de ns abertos ou
+		fechados, logo o que sobrou neles tambm no atrapalha.
+	*/
+	return marca < geracao ? 0 : marca - geracao + 1;
+}
+
+
+inline unsigned short
+proxima_geracao(
+	ContextoDePlanejamento& contexto
+){
+	/*
+	Descrio:
+		Avana a gerao do contexto em ESTADOS_POR_GERACAO, uma marca para
+		cada estado. As marcas s crescem, ento as de buscas anteriores
+		ficam todas abaixo da nova gerao.
+
+		Quando o contador est para estourar, a sim zeramos o quadro e
+		recomeamos do 1. Isso acontece uma vez a cada ~16 mil buscas, e
+		tambm na primeira, j que a arena no vem zerada.
+	*/
+	if(
+		contexto.geracao_dos_nodes > 0xFFFF - 2 * ESTADOS_POR_GERACAO
+	){
+		std::fill(
+			contexto.estado_dos_nodes,
+			contexto.estado_dos_nodes + QUANT_LINHAS * QUANT_COLUNAS,
+			0
+		);
+
+		contexto.geracao_dos_nodes = 1;
+	}
+	else{
+		contexto.geracao_dos_nodes += ESTADOS_POR_GERACAO;
+	}
+
+	return contexto.geracao_dos_nodes;
+}
+
+
 // Assim como definimos um Terra em circuitos, definiremos um n no expandido
 // que representar o menor custo total previsto.
-Node* min_node = nullptr;  
+// S a BST usa. thread_local para que buscas em threads diferentes no se atropelem.
+thread_local Node* min_node = nullptr;  
 
 
 namespace noding{
@@ -827,20 +903,93 @@ namespace noding{
 		*/
 		return raiz;
 	}
-	
-	inline Node*
+}
+
+
+#if defined(LISTA_ABERTA_BST)
+
+class ListaAberta {
+	/*
+	Descrio:
+		Adaptador que coloca a BST de noding atrs da mesma interface dos
+		motores de lista_aberta.h. Serve apenas para compararmos desempenho,
+		pois ela degenera em lista ligada quando os custos chegam ordenados.
+	*/
+public:
+
+	ListaAberta() : raiz( nullptr ), quantidade( 0 ) {
+		nos = new Node[QUANT_POSICOES];
+	}
+
+	~ListaAberta(){
+		delete[] nos;
+	}
+
+	inline void limpar()         { raiz = nullptr; min_node = nullptr; quantidade = 0; }
+	inline bool vazia()   const  { return raiz == nullptr; }
+	inline int  tamanho() const  { return quantidade;      }
+
+	inline int
+	extrair_min(){
+
+		const int posicao = min_node - nos;
+
+		raiz = noding::remover_min( raiz, false );
+		quantidade--;
+
+		return posicao;
+	}
+
+	inline void
+	inserir(
+		int   posicao,
+		float valor,
+		float /* custo */
+	){
+		nos[posicao].valor = valor;
+		raiz = noding::inserir( &nos[posicao], raiz );
+		quantidade++;
+	}
+
+	inline void
+	atualizar(
+		int   posicao,
+		float valor,
+		float /* custo */
+	){
+		raiz = noding::remover_node( &nos[posicao], raiz, false );
+
+		nos[posicao].valor = valor;
+		raiz = noding::inserir( &nos[posicao], raiz );
+	}
+
+private:
+
+	Node* raiz;
+	Node* nos;  // S usamos left, right, up e valor.
+	int   quantidade;
+};
+
+#endif // LISTA_ABERTA_BST
+
+
+namespace noding{
+
+	inline void
 	expandir_filho(
-		Node* raiz_da_estrutura,  
+		ListaAberta& lista_aberta,
 		float custo_para_chegar_ao_no_desejado,
 		float limite_para_qual_custo_eh_impossivel,
-		Node* node_atual_a_ser_expandido,
-		Node* quadro_de_possibilidades,
+		int   posicao_do_node_atual,
 		int   posicao_do_node_no_quadro,
 		int   estado_atual_do_node, 
 		bool  ir_ao_gol,
 		int   linha, int coluna,
 		int   linha_final, int coluna_final,
-		unsigned int* estado_dos_nodes,
+		float*          custo_dos_nodes,
+		int*            parente_dos_nodes,
+		unsigned short* estado_dos_nodes,
+		unsigned short  geracao,
 		float extra
 	){
 		/*
@@ -858,8 +1007,8 @@ namespace noding{
 		    grid e manter a estrutura de busca otimizada.
 
 		Parmetros:
-		    - Node* raiz_da_estrutura:
-		        Ponteiro para a raiz da estrutura usada no algoritmo.
+		    - ListaAberta& lista_aberta:
+		        Lista aberta do A*, veja lista_aberta.h.
 		    
 		    - float custo_para_chegar_ao_no_desejado:
 		        Custo heurstico estimado para alcanar o n filho a partir do n atual.
@@ -867,14 +1016,11 @@ namespace noding{
 		    - float limite_para_qual_custo_eh_impossivel:
 		        Limite acima do qual um caminho  considerado invivel e penalizado.
 		    
-		    - Node* node_atual_a_ser_expandido:
-		        Ponteiro para o n atualmente em expanso.
-		    
-		    - Node* quadro_de_possibilidades:
-		        Vetor de todos os ns do campo, representando a malha de possibilidades.
+		    - int posicao_do_node_atual:
+		        Posio no quadro do n atualmente em expanso.
 		    
 		    - int posicao_do_node_no_quadro:
-		        ndice do n filho dentro do vetor `quadro_de_possibilidades`.
+		        Posio no quadro do n filho.
 		    
 		    - int estado_atual_do_node:
 	            0 = j explorado
@@ -889,19 +1035,18 @@ namespace noding{
 		    - int linha_final, coluna_final:
 		        Coordenadas do n de destino final (meta).
 		    
-		    - unsigned int* estado_dos_nodes:
-		        Vetor que armazena o estado de todos os ns (explorado, na estrutura, etc.).
+		    - float* custo_dos_nodes, int* parente_dos_nodes:
+		        Custo acumulado e pai de cada n, veja ContextoDePlanejamento.
+		    
+		    - unsigned short* estado_dos_nodes, unsigned short geracao:
+		        Marcas de estado de todos os ns e a gerao da busca atual, veja estado_na_geracao().
 		    
 		    - float extra:
 		        Custo adicional associado ao movimento at o n filho.
 
 		Retorno:
-		    - Node*:
-		        Retorna o ponteiro para a nova raiz da estrutura, 
-		        podendo ser o mesmo ou modificado conforme inseres/remoes realizadas.
-
-		        Caso o caminho at o filho no seja mais eficiente, o node no  reinserido,
-		        e a estrutura permanece inalterada.
+		    No h. Caso o caminho at o filho no seja mais eficiente, o node
+		    no  atualizado e a lista aberta permanece inalterada.
 		*/
 
 		if(
@@ -915,12 +1060,10 @@ namespace noding{
 			custo_para_chegar_ao_no_desejado = 100.f;
 		}
 		
-		float min_custo = (*node_atual_a_ser_expandido).custo_pontual + extra + std::fmaxf(
+		float min_custo = custo_dos_nodes[posicao_do_node_atual] + extra + std::fmaxf(
 																							0.f,
 																							custo_para_chegar_ao_no_desejado
 																						   );  // Max para garantimos que seja positivo.
-
-		Node* filho = &quadro_de_possibilidades[posicao_do_node_no_quadro];
 		
 		if(
 			// Caso o n atual j esteja na lista aberta.
@@ -928,33 +1071,15 @@ namespace noding{
 		){
 			if(
 				/*
-				E o novo custo calculo no for melhor que o do n atual,
-				o descartamos.
+				E o novo custo calculado no for melhor que o custo j
+				registrado no filho, o descartamos.
 				*/
-				min_custo >= (*node_atual_a_ser_expandido).custo_pontual
+				min_custo >= custo_dos_nodes[posicao_do_node_no_quadro]
 			){
 				
-				return raiz_da_estrutura;
-			}
-			else{
-				/*
-				Houve uma melhora, devemos remover a referncia do n filho,
-				atualiz-lo e adicion-lo na estrutura posteriormente.
-				*/
-
-				raiz_da_estrutura = noding::remover_node(
-					filho,
-					raiz_da_estrutura,
-					false
-				);
+				return;
 			}
 		}
-		else{
-			// Colocamos ele na lista.
-			estado_dos_nodes[
-				posicao_do_node_no_quadro
-			] = 1;
-		}
 		
 		/*
 		Preenchemos caractersticas do n filho que est sendo analisado.
@@ -967,1557 +1092,5638 @@ namespace noding{
 																						coluna_final
 																					  );
 		
-		(*filho).custo_pontual = min_custo;
-		(*filho).valor = predicao_de_custo_para_atravessar_filho;
-		(*filho).parente = node_atual_a_ser_expandido;
+		/*
+		O valor previsto fica s na lista aberta, o quadro guarda o custo e o pai.
+		*/
+		custo_dos_nodes  [posicao_do_node_no_quadro] = min_custo;
+		parente_dos_nodes[posicao_do_node_no_quadro] = posicao_do_node_atual;
 		
-		// Finalmente, o inserimos.
-		return noding::inserir(
-			filho,
-			raiz_da_estrutura
-		);
+		if(
+			estado_atual_do_node
+		){
+			// Houve uma melhora, vulgo decrease-key.
+			lista_aberta.atualizar(
+				posicao_do_node_no_quadro,
+				predicao_de_custo_para_atravessar_filho,
+				min_custo
+			);
+		}
+		else{
+			// Colocamos ele na lista.
+			estado_dos_nodes[
+				posicao_do_node_no_quadro
+			] = geracao;  // aberto
+			
+			lista_aberta.inserir(
+				posicao_do_node_no_quadro,
+				predicao_de_custo_para_atravessar_filho,
+				min_custo
+			);
+		}
 	}
 }
 
-float caminho_final[2050] = {0};
-int tamanho_do_caminho_final = 0;
+////////////////////////////////////////////////////////////////////////////
+/// Jump Point Search
+////////////////////////////////////////////////////////////////////////////
 
-inline void
-construir_caminho_final(
-	/*
-	Observe essa diferena sutil, simplesmente genial Miguel Abreu.
-	
-	Node* const
-		Ponteiro para Node constante.
-		Objeto Node no pode ser modificado atravs do ponteiro.
-		Mas o ponteiro pode apontar para outro Node.
-	
-	Node* const
-		Ponteiro constante para Node
-		Ponteiro em si  constante, no pode apontar para outro Node.
-		Mas o objeto Node pode ser modificado.
-	*/
-	Node* const melhor_node,
-	const Node* quadro_de_possibilidades,
-	
-	float status,
-	/*
-	Ativa ou desativa a substituio das coordenadas finais discretas
-	por valores exatos.
-	
-	False - Coordenadas Discretas do Grid
-	True  - Substitui o ltimo ponto do caminho por valores exatos em end_x e em end_y.
-	*/
-	const bool override_end=false,
-	/*
-	Especificam as coordenadas exatas do ponto final quando override est ativo.
-	*/
-	const float end_x=0, const float end_y=0
-){
+class BuscaPorSaltos {
 	/*
 	Descrio:
-		Funo responsvel por atribuir o caminho especificado pela varivel 
-		melhor_node  varivel que representar o caminho obtido pelo algoritmo
-		globalmente.
+		Expanso alternativa do A*, escolhida por OpcoesDeBusca::pontos_de_salto.
 
-		Reitero que esta funo NO  responsvel por qualquer calculo ou condio,
-		apenas atribui valores do array de caminho.
+		Quase todo o campo (LIN12_308) tem custo zero, e o A* comum abre cada
+		uma dessas clulas. Aqui, a partir de um n, andamos em linha reta ou
+		na diagonal sem abrir nada enquanto a vizinhana for uniforme, e s
+		paramos em clulas que realmente podem mudar o caminho:
+
+			- clulas de custo diferente de zero (obstculos, amortecimento,
+			  paredes e o prprio objetivo, que vale -1);
+			- clulas livres com vizinho forado, ou seja, ao lado de uma
+			  clula de custo diferente de zero, pela qual o desvio de mesmo
+			  custo deixaria de existir.
+
+		Clulas de custo zero se comportam como o campo vazio do JPS original,
+		e as demais fazem o papel das paredes na hora de decidir os vizinhos
+		forados. A diferena  que aqui elas no so intransponveis: viram
+		ns e so expandidas nas 8 direes, com o mesmo custo de aresta e a
+		mesma regra de proibio de expandir_filho().
+
+		Os saltos retos so a maior parte do trabalho, pois cada passo de um
+		salto diagonal dispara dois deles. Por isso cada linha e cada coluna
+		da janela de busca vira um mapa de bits de clulas no livres, montado
+		s quando algum passa por ali, e o salto reto acha o prximo ponto de
+		interesse 64 clulas por vez.
+
+		Os ns ficam ligados apenas aos pontos de salto. desdobrar() preenche
+		as clulas intermedirias antes de montarmos o caminho final.
 	*/
-	
-	Node* ptr = melhor_node;
-	
-	// Vamos percorrer at o fim da estrutura.
-	int quantidade_de_parentes = 0;
-	while(
-		ptr != nullptr
+public:
+
+	void
+	preparar(
+		ListaAberta&    lista_aberta,
+		float*          custo_dos_nodes,
+		int*            parente_dos_nodes,
+		unsigned short* estado_dos_nodes,
+		unsigned short  geracao,
+		const float*    quadro_de_custo,
+		int           limite_para_qual_custo_eh_impossivel,
+		bool          ir_ao_gol,
+		int           end_linha,  int end_coluna,
+		int           linha_min,  int linha_max,
+		int           coluna_min, int coluna_max
 	){
-		
-		ptr = (*ptr).parente;
-		quantidade_de_parentes++;
+		// Chamado uma vez por busca, depois que o quadro e a janela esto prontos.
+		this->lista_aberta                         = &lista_aberta;
+		this->custo_dos_nodes                      = custo_dos_nodes;
+		this->parente_dos_nodes                    = parente_dos_nodes;
+		this->estado_dos_nodes                     = estado_dos_nodes;
+		this->geracao                              = geracao;
+		this->quadro_de_custo                      = quadro_de_custo;
+		this->limite_para_qual_custo_eh_impossivel = limite_para_qual_custo_eh_impossivel;
+		this->ir_ao_gol                            = ir_ao_gol;
+		this->end_linha                            = end_linha;
+		this->end_coluna                           = end_coluna;
+		this->linha_min                            = linha_min;
+		this->linha_max                            = linha_max;
+		this->coluna_min                           = coluna_min;
+		this->coluna_max                           = coluna_max;
+
+		std::fill( linha_pronta,  linha_pronta  + QUANT_LINHAS,  false );
+		std::fill( coluna_pronta, coluna_pronta + QUANT_COLUNAS, false );
 	}
-	
-	tamanho_do_caminho_final = min(
+
+	inline void
+	expandir(
+		int pos_atual
+	){
 		/*
-		Limitamos o caminho final  quantidade de slots disponveis.
+		Descrio:
+			Substitui os 8 blocos de expanso do lao principal de a_estrela().
+
+			Ns livres que vieram de um salto seguem apenas as direes
+			naturais, mais as foradas. O incio e os ns de custo diferente
+			de zero olham as 8 direes.
 		*/
-		2 * quantidade_de_parentes,
-		2048
-	);
-	
-	/*
-	Voltamos ao melhor n. 
-	Note que foi por isso que escrevemos o const, para preservar essa
-	propriedade. 
-	Completamente insano.
-	*/
-	ptr = melhor_node; 
-	int indice = tamanho_do_caminho_final - 1;
-	
-	if(
-		// Se ativado, atualiza o ponto final para coordenadas corretas
-		// ao invs de verso discreta.
-		override_end
+		const int linha  = pos_atual / QUANT_COLUNAS;
+		const int coluna = pos_atual % QUANT_COLUNAS;
+
+		const int pos_pai = parente_dos_nodes[pos_atual];
+
+		if(
+			pos_pai == -1 || quadro_de_custo[pos_atual] != 0
+		){
+			for(
+				int d = 0;
+				d < 8;
+				d++
+			){
+				saltar_e_relaxar( pos_atual, linha, coluna, DIRECOES[d][0], DIRECOES[d][1] );
+			}
+
+			return;
+		}
+
+		const int dl = sinal( linha  - pos_pai / QUANT_COLUNAS );
+		const int dc = sinal( coluna - pos_pai % QUANT_COLUNAS );
+
+		if(
+			dl != 0 && dc != 0
+		){
+			// Naturais da diagonal
+			saltar_e_relaxar( pos_atual, linha, coluna, dl, dc );
+			saltar_e_relaxar( pos_atual, linha, coluna, dl, 0  );
+			saltar_e_relaxar( pos_atual, linha, coluna, 0,  dc );
+
+			// Forados
+			if(
+				!livre( linha, coluna - dc ) && dentro( linha + dl, coluna - dc )
+			){
+				saltar_e_relaxar( pos_atual, linha, coluna, dl, -dc );
+			}
+
+			if(
+				!livre( linha - dl, coluna ) && dentro( linha - dl, coluna + dc )
+			){
+				saltar_e_relaxar( pos_atual, linha, coluna, -dl, dc );
+			}
+
+			return;
+		}
+
+		saltar_e_relaxar( pos_atual, linha, coluna, dl, dc );
+
+		// Forados de um movimento reto: as duas laterais,  frente.
+		const int lateral_l = dc;
+		const int lateral_c = dl;
+
+		if(
+			!livre( linha + lateral_l, coluna + lateral_c ) && dentro( linha + dl + lateral_l, coluna + dc + lateral_c )
+		){
+			saltar_e_relaxar( pos_atual, linha, coluna, dl + lateral_l, dc + lateral_c );
+		}
+
+		if(
+			!livre( linha - lateral_l, coluna - lateral_c ) && dentro( linha + dl - lateral_l, coluna + dc - lateral_c )
+		){
+			saltar_e_relaxar( pos_atual, linha, coluna, dl - lateral_l, dc - lateral_c );
+		}
+	}
+
+	inline void
+	desdobrar(
+		const int melhor_posicao
 	){
 		/*
-		indice   - acessamos no indice.
-		indice-- - acessamos no indice e o decrementamos
+		Descrio:
+			Troca cada ligao ponto de salto -> ponto de salto pela sequncia
+			de clulas vizinhas entre eles, para que construir_caminho_final()
+			receba o mesmo tipo de cadeia que o A* comum produz.
+
+			Cada salto  reto ou diagonal, logo basta andar um passo de cada
+			vez na direo do pai. S o campo parente das clulas do meio 
+			reescrito, e a busca j acabou quando isso acontece.
 		*/
-		caminho_final[indice--] = end_y;
-		caminho_final[indice--] = end_x;
-		
-		ptr = (*ptr).parente;
+		int pos_filho = melhor_posicao;
+
+		while(
+			parente_dos_nodes[pos_filho] != -1
+		){
+			const int pos_pai = parente_dos_nodes[pos_filho];
+
+			const int linha_pai  = pos_pai / QUANT_COLUNAS;
+			const int coluna_pai = pos_pai % QUANT_COLUNAS;
+
+			int linha  = pos_filho / QUANT_COLUNAS;
+			int coluna = pos_filho % QUANT_COLUNAS;
+
+			const int dl = sinal( linha  - linha_pai  );
+			const int dc = sinal( coluna - coluna_pai );
+
+			int atual = pos_filho;
+
+			while(
+				true
+			){
+				linha  -= ( linha  != linha_pai  ) ? dl : 0;
+				coluna -= ( coluna != coluna_pai ) ? dc : 0;
+
+				if(
+					linha == linha_pai && coluna == coluna_pai
+				){
+					break;
+				}
+
+				const int meio = linha * QUANT_COLUNAS + coluna;
+
+				parente_dos_nodes[atual] = meio;
+				atual = meio;
+			}
+
+			parente_dos_nodes[atual] = pos_pai;
+			pos_filho = pos_pai;
+		}
 	}
-	
-	// Preenchemos os endereos no caminho!
-	while(
-		indice > 0
+
+private:
+
+	static const int PALAVRAS_POR_LINHA  = ( QUANT_COLUNAS + 63 ) / 64;
+	static const int PALAVRAS_POR_COLUNA = ( QUANT_LINHAS  + 63 ) / 64;
+
+	static constexpr int DIRECOES[8][2] = {
+		{ -1, -1 }, { -1, 0 }, { -1, 1 },
+		{  0, -1 },            {  0, 1 },
+		{  1, -1 }, {  1, 0 }, {  1, 1 }
+	};
+
+	inline static int
+	sinal(
+		int valor
 	){
-		// No  um delta embaixo parece.
-		caminho_final[indice--] = (
-			(ptr - quadro_de_possibilidades) % QUANT_COLUNAS
-		) / 10.f - 11.f;  // y
-		
-		caminho_final[indice--] = (
-			(ptr - quadro_de_possibilidades) / QUANT_COLUNAS
-		) / 10.f - 16.f;  // x
-		
-		ptr = (*ptr).parente;
+		return ( valor > 0 ) - ( valor < 0 );
+	}
 
-		// Observe que no fazemos alterao do ndice aqui.
-		// Fazemos dentro do acesso do vetor, indice--.
+	inline bool
+	dentro(
+		int linha,
+		int coluna
+	) const {
+		return linha >= linha_min && linha <= linha_max && coluna >= coluna_min && coluna <= coluna_max;
 	}
-	
-	/*
-	Atualizamos o status do caminho e acrescentamos a unidade do tamanho
-	
-	0 - sucesso
-	1 - tempo excedido
-	2 - impossvel
-	*/
-	caminho_final[
-		tamanho_do_caminho_final++
-	] = status;  
-		
-	/*
-	Informaes sobre o custo completo do caminho.
-	*/
-	caminho_final[
-		tamanho_do_caminho_final++
-	] = (*melhor_node).custo_pontual / 10.f; 
-}	
 
+	inline bool
+	livre(
+		int linha,
+		int coluna
+	) const {
+		// Fora da janela de busca conta como no livre, assim como uma parede.
+		return dentro( linha, coluna ) && quadro_de_custo[ linha * QUANT_COLUNAS + coluna ] == 0;
+	}
 
-inline bool 
-se_a_linha_ab_intercepta_qualquer_gol(
-	float a_x,
-	float a_y,
-	float b_x,
-	float b_y
-){
-	/*
-	Descrio:
-		Objetivo da funo  autoexplicativo.
-		
-		Assume que a e b so dois pontos fora da rea inalcanvel do gol.
-		Logo, linha ab, se for o caso, deve entrar e sair da rea inalcanvel.
-		
-		Para detectar isso, consideramos apenas a interseo da linha ab com as bordas
-		externas do gol.
-		
-		As bordas internas tero outras verificaes.
-		
-		Os nmeros usados aqui so especficos para as dimenses do gol.
-		No razo para eles alm de propores geomtricas.
-	*/
-	
-	
-	float delta_x = b_x - a_x;
-	float delta_y = b_y - a_y;
-	float coef_ang = 0;  // coeficiente angular
-	
-	if(
-		// Verificar se linha ab e 'goal back' so no colineares.
-		delta_x != 0
+	inline const uint64_t*
+	bits_da_linha(
+		int linha
 	){
 		/*
-		a_x + delta_x * coef_ang = 15.75.
+		Bit 1 para cada coluna no livre da linha, contando as que esto fora
+		da janela. Linhas fora da janela s aparecem como laterais de um
+		salto e no foram nada, por isso valem zero.
 		*/
-		coef_ang = (
-			15.75 - a_x
-		) / delta_x;
-		
+		static const uint64_t NADA[ PALAVRAS_POR_COLUNA ] = {};
+
 		if(
-			(
-				coef_ang >= 0
-			) && (
-				coef_ang <= 1 
-			) && (
-				fabsf(  // Apenas pega o valor absoluto de floats.
-					a_y + delta_y * coef_ang 
-				) <= 1.25
-			)
+			linha < linha_min || linha > linha_max
 		){
-			/*
-			Ento h coliso.
-			*/
-			return true;
+			return NADA;
 		}
-		
-		coef_ang = (
-			- 15.75 - a_x
-		) / delta_x;
-		
+
+		uint64_t* bits = mapa_das_linhas[linha];
+
 		if(
-			(
-				coef_ang >= 0
-			) && (
-				coef_ang <= 1 
-			) && (
-				fabsf(  // Apenas pega o valor absoluto de floats.
-					a_y + delta_y * coef_ang 
-				) <= 1.25
-			)
+			!linha_pronta[linha]
 		){
-			/*
-			Ento h coliso.
-			*/
-			return true;
+			for(
+				int palavra = 0;
+				palavra < PALAVRAS_POR_LINHA;
+				palavra++
+			){
+				uint64_t valor = 0;
+
+				for(
+					int b = 0;
+					b < 64;
+					b++
+				){
+					const int coluna = palavra * 64 + b;
+
+					valor |= uint64_t( coluna >= QUANT_COLUNAS || !livre( linha, coluna ) ) << b;
+				}
+
+				bits[palavra] = valor;
+			}
+
+			linha_pronta[linha] = true;
 		}
-		
+
+		return bits;
 	}
-	
-	if(
-		// Verificar se linha ab e 'goal sides' so no colineares.
-		delta_y != 0
+
+	inline const uint64_t*
+	bits_da_coluna(
+		int coluna
+	){
+		// Mesma coisa, transposto: bit 1 para cada linha no livre da coluna.
+		static const uint64_t NADA[ PALAVRAS_POR_COLUNA ] = {};
+
+		if(
+			coluna < coluna_min || coluna > coluna_max
+		){
+			return NADA;
+		}
+
+		uint64_t* bits = mapa_das_colunas[coluna];
+
+		if(
+			!coluna_pronta[coluna]
+		){
+			for(
+				int palavra = 0;
+				palavra < PALAVRAS_POR_COLUNA;
+				palavra++
+			){
+				uint64_t valor = 0;
+
+				for(
+					int b = 0;
+					b < 64;
+					b++
+				){
+					const int linha = palavra * 64 + b;
+
+					valor |= uint64_t( linha >= QUANT_LINHAS || !livre( linha, coluna ) ) << b;
+				}
+
+				bits[palavra] = valor;
+			}
+
+			coluna_pronta[coluna] = true;
+		}
+
+		return bits;
+	}
+
+	inline static int
+	proximo_bit(
+		const uint64_t* a,
+		const uint64_t* b,
+		const uint64_t* c,
+		int palavras,
+		int inicio,
+		int sentido
 	){
 		/*
-		a_y + delta_y * coef_ang = 1.25
+		Descrio:
+			Primeiro ndice a partir de 'inicio', no 'sentido' (+1 ou -1), com
+			bit 1 em qualquer um dos trs mapas.
+
+		Retorno:
+			O ndice, ou -1 se no houver nenhum.
 		*/
-		
-		coef_ang = (
-			1.25 - a_y
-		) / delta_y;
 		if(
-			coef_ang >= 0 && coef_ang <= 1
+			inicio < 0 || inicio >= palavras * 64
 		){
-			
-			float intersecao_x = fabsf(
-				a_x + delta_x * coef_ang
-			);
-			
-			if(
-				intersecao_x >= 15 && intersecao_x <= 15.75
+			return -1;
+		}
+
+		int palavra = inicio >> 6;
+
+		if(
+			sentido > 0
+		){
+			uint64_t valor = ( a[palavra] | b[palavra] | c[palavra] ) & ( ~uint64_t( 0 ) << ( inicio & 63 ) );
+
+			while(
+				valor == 0
 			){
-				/*
-				H coliso
-				*/
-				return true;
+				if(
+					++palavra >= palavras
+				){
+					return -1;
+				}
+
+				valor = a[palavra] | b[palavra] | c[palavra];
 			}
+
+			return palavra * 64 + __builtin_ctzll( valor );
 		}
-		
-		coef_ang = (
-			- 1.25 - a_y
-		) / delta_y;
-		if(
-			coef_ang >= 0 && coef_ang <= 1
+
+		uint64_t valor = ( a[palavra] | b[palavra] | c[palavra] ) & ( ~uint64_t( 0 ) >> ( 63 - ( inicio & 63 ) ) );
+
+		while(
+			valor == 0
 		){
-			
-			float intersecao_x = fabsf(
-				a_x + delta_x * coef_ang
-			);
-			
 			if(
-				intersecao_x >= 15 && intersecao_x <= 15.75
+				--palavra < 0
 			){
-				/*
-				H coliso
-				*/
-				return true;
+				return -1;
 			}
-			
+
+			valor = a[palavra] | b[palavra] | c[palavra];
 		}
-	
 
+		return palavra * 64 + 63 - __builtin_clzll( valor );
 	}
 
-	return false;
-}
+	inline int
+	saltar_reto(
+		int  linha,
+		int  coluna,
+		int  dl,
+		int  dc,
+		int& passos
+	){
+		/*
+		Descrio:
+			Salto em linha reta. Uma clula livre s  ponto de salto se uma
+			das laterais no for livre, e uma clula no livre sempre . Logo
+			o ponto de salto  o primeiro bit 1 na unio da linha (ou coluna)
+			com as duas vizinhas.
+		*/
+		int indice = -1;
 
+		if(
+			dl == 0
+		){
+			indice = proximo_bit(
+				bits_da_linha( linha ),
+				bits_da_linha( linha - 1 ),
+				bits_da_linha( linha + 1 ),
+				PALAVRAS_POR_LINHA,
+				coluna + dc,
+				dc
+			);
+			passos = abs( indice - coluna );
+			coluna = indice;
+		}
+		else{
+			indice = proximo_bit(
+				bits_da_coluna( coluna ),
+				bits_da_coluna( coluna - 1 ),
+				bits_da_coluna( coluna + 1 ),
+				PALAVRAS_POR_COLUNA,
+				linha + dl,
+				dl
+			);
+			passos = abs( indice - linha );
+			linha  = indice;
+		}
 
-inline void 
-adicionar_espaco_de_amortecimento(
-	// A sutileza  que no estamos fornecendo um ponteiro para array,
-	// mas o vetor. Note que apesar de serem trabalhados iguais no cdigo,
-	// possuem valores semnticos diferentes.
-	float quadro_de_custo[]
-){
-	/*
-	Descrio:
-		Adiciona espao de amortecimento perto das linhas centrais e finais
-		a fim de evitar colises com as bordas do campo. 
-		
-		 como se estivessemos criando um campo de potencial a fim de permitir
-		comportamentos mais suaves.
-		
-		Objetivo: criar reas de custo gradual ao redor das reas citadas.
-		
-		TAMANHO_DO_AMORTECIMENTO trata-se da diminuio gradativa de 6 para 1,
-		onde 6  o mais perto e 1  o mais distante.
-	*/
-	
-	// linha do gol inimigo
-	for(
-		int i = 0;
-		i < TAMANHO_DO_AMORTECIMENTO;
-		i++
-	){
-		int ii = (i + 12) * QUANT_COLUNAS;
-		
-		for(
-			int j = 12 + i;
-			j < (209 - i);
-			j++
+		if(
+			indice == -1 || !dentro( linha, coluna )
 		){
-			quadro_de_custo[
-				j + ii
-			] = TAMANHO_DO_AMORTECIMENTO - i;
+			return -1;
 		}
-	}
-	
-	// Nosso gol
-	for(
-		int i = 0;
-		i < TAMANHO_DO_AMORTECIMENTO;
-		i++
-	){
-		int ii = (308 - i) * QUANT_COLUNAS;
-		
-		for(
-			int j = 12 + i;
-			j < 99;
-			j++
+
+		const int   posicao = linha * QUANT_COLUNAS + coluna;
+		const float custo   = quadro_de_custo[posicao];
+
+		if(
+			// Mesma regra de proibio do A* comum. S o primeiro passo parte de uma clula que pode no ser livre.
+			custo <= limite_para_qual_custo_eh_impossivel and custo < ( passos == 1 ? quadro_de_custo[ posicao - dl * QUANT_COLUNAS - dc ] : 0.f )
 		){
-			
-			quadro_de_custo[
-				j + ii
-			] = TAMANHO_DO_AMORTECIMENTO - i;
-			
-			quadro_de_custo[
-				220 + ii - j
-			] = TAMANHO_DO_AMORTECIMENTO - i;
+			return -1;
 		}
+
+		return posicao;
 	}
-	
-	// Linhas laterais
-	for(
-		int i = 0;
-		i < TAMANHO_DO_AMORTECIMENTO;
-		i++
+
+	inline int
+	saltar(
+		int  linha,
+		int  coluna,
+		int  dl,
+		int  dc,
+		int& passos
 	){
-		for(
-			int j = (13 + i) * QUANT_COLUNAS;
-			j < (308 - i) * QUANT_COLUNAS;
-			j += QUANT_COLUNAS
+		/*
+		Descrio:
+			Anda a partir de (linha, coluna) na direo (dl, dc) at achar um
+			ponto de salto.
+
+		Retorno:
+			Posio do ponto de salto, com 'passos' clulas de distncia, ou
+			-1 se a direo no leva a lugar nenhum: saiu da janela ou o
+			passo seguinte  proibido.
+		*/
+		if(
+			dl == 0 || dc == 0
 		){
-			
-			quadro_de_custo[
-				j + i + 12	
-			] = TAMANHO_DO_AMORTECIMENTO - i;
-			
-			quadro_de_custo[
-				j - i + 208
-			] = TAMANHO_DO_AMORTECIMENTO - i;
+			return saltar_reto( linha, coluna, dl, dc, passos );
+		}
+
+		float custo_anterior = quadro_de_custo[ linha * QUANT_COLUNAS + coluna ];
+
+		passos = 0;
+
+		while(
+			true
+		){
+			linha  += dl;
+			coluna += dc;
+			passos++;
+
+			if(
+				!dentro( linha, coluna )
+			){
+				return -1;
+			}
+
+			const int   posicao = linha * QUANT_COLUNAS + coluna;
+			const float custo   = quadro_de_custo[posicao];
+
+			if(
+				custo != 0
+			){
+				if(
+					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_anterior
+				){
+					return -1;
+				}
+
+				return posicao;
+			}
+
+			if(
+				(
+					!livre( linha, coluna - dc ) && dentro( linha + dl, coluna - dc )
+				) || (
+					!livre( linha - dl, coluna ) && dentro( linha - dl, coluna + dc )
+				)
+			){
+				return posicao;
+			}
+
+			int passos_retos = 0;
+
+			if(
+				// Se algum salto reto que parte daqui acha algo, paramos aqui.
+				saltar_reto( linha, coluna, dl, 0, passos_retos ) != -1 ||
+				saltar_reto( linha, coluna, 0, dc, passos_retos ) != -1
+			){
+				return posicao;
+			}
+
+			custo_anterior = 0;
 		}
 	}
-}
 
+	inline void
+	saltar_e_relaxar(
+		int   pos_atual,
+		int   linha,
+		int   coluna,
+		int   dl,
+		int   dc
+	){
+		int passos = 0;
 
-bool 
-se_caminho_esta_obstruido(
-	// Pontos
-	float start_x, float start_y,
-	float end_x, float end_y,
-	float obstaculos_dados[],
-	int   quantidade_de_obstaculos_dados,
-	bool  ir_ao_gol,
-	int   limite_para_qual_custo_eh_impossivel,
-	float quadro_de_custos[]
+		const int posicao = saltar( linha, coluna, dl, dc, passos );
+
+		if(
+			posicao == -1
+		){
+			return;
+		}
+
+		const int estado_do_node = estado_na_geracao( estado_dos_nodes[posicao], geracao );
+
+		if(
+			estado_do_node == 2
+		){
+			return;
+		}
+
+		/*
+		As clulas do meio tm custo zero, ento o salto custa apenas o
+		comprimento do trajeto, mais o custo da clula de chegada, que
+		expandir_filho() j trata.
+		*/
+		noding::expandir_filho(
+			*lista_aberta,
+			quadro_de_custo[posicao],
+			limite_para_qual_custo_eh_impossivel,
+			pos_atual,
+			posicao,
+			estado_do_node,
+			ir_ao_gol,
+			posicao / QUANT_COLUNAS,
+			posicao % QUANT_COLUNAS,
+			end_linha,
+			end_coluna,
+			custo_dos_nodes,
+			parente_dos_nodes,
+			estado_dos_nodes,
+			geracao,
+			passos * ( ( dl != 0 && dc != 0 ) ? SQRT_2 : 1.f )
+		);
+	}
+
+	ListaAberta*   lista_aberta;
+	float*         custo_dos_nodes;
+	int*           parente_dos_nodes;
+	unsigned short* estado_dos_nodes;
+	unsigned short geracao;
+	const float*   quadro_de_custo;
+	int            limite_para_qual_custo_eh_impossivel;
+	bool           ir_ao_gol;
+	int            end_linha,  end_coluna;
+	int            linha_min,  linha_max;
+	int            coluna_min, coluna_max;
+
+	uint64_t mapa_das_linhas [QUANT_LINHAS ][PALAVRAS_POR_LINHA ];
+	uint64_t mapa_das_colunas[QUANT_COLUNAS][PALAVRAS_POR_COLUNA];
+	bool     linha_pronta    [QUANT_LINHAS ];
+	bool     coluna_pronta   [QUANT_COLUNAS];
+};
+
+constexpr int BuscaPorSaltos::DIRECOES[8][2];
+
+
+inline unsigned char*
+fatia_da_arena(
+	unsigned char*& livre,
+	size_t          bytes
 ){
 	/*
 	Descrio:
-		Verifica se um determinado caminho est obstculo.
-		
-		O caminho est obstrudo se intercepta qualquer circunferncia 
-		HARD ou SOFT ou se comea dentro de circuferncia HARD.
-		
-		Os nmeros escolhidos no so aleatrios, tem haver com as propores
-		geomtricas,  bem complexo.
-	
-	Retorno:
-		False - Se no for necessrio que A* resolva esse problema.
-		True  - se estiver obstrudo, logo A* buscar outro caminho.
+		Entrega os prximos 'bytes' da arena e avana 'livre' at a prxima
+		linha de cache, para que dois vetores nunca dividam uma.
 	*/
+	unsigned char* fatia = livre;
+
+	livre += ( bytes + 63 ) & ~size_t( 63 );
+
+	return fatia;
+}
+
+
+ContextoDePlanejamento::ContextoDePlanejamento() :
+	tamanho_do_caminho_final( 0 )
+{
+	/*
+	Os vetores por clula saem de um nico bloco, alinhado em 64 bytes.
+	Como o contexto padro  thread_local (veja contexto_da_thread()), cada
+	thread aloca esse bloco uma vez e o reaproveita em todas as buscas.
+	Nada disso fica na pilha, ento a busca roda em threads de pilha pequena.
+	*/
+	const size_t tamanho_da_arena =
+		64 +                                                             // folga para o alinhamento
+		( ( QUANT_POSICOES * sizeof(float)          + 63 ) & ~size_t( 63 ) ) +  // custo_dos_nodes
+		( ( QUANT_POSICOES * sizeof(int)            + 63 ) & ~size_t( 63 ) ) +  // parente_dos_nodes
+		( ( QUANT_POSICOES * sizeof(unsigned short) + 63 ) & ~size_t( 63 ) ) +  // estado_dos_nodes
+		( ( QUANT_POSICOES * sizeof(float)          + 63 ) & ~size_t( 63 ) );   // quadro_de_custo
+
+	arena = new unsigned char[ tamanho_da_arena ];
+
+	unsigned char* livre = arena + ( ( 64 - ( reinterpret_cast<uintptr_t>( arena ) & 63 ) ) & 63 );
+
+	custo_dos_nodes          = reinterpret_cast<float*>         ( fatia_da_arena( livre, QUANT_POSICOES * sizeof(float)          ) );
+	parente_dos_nodes        = reinterpret_cast<int*>           ( fatia_da_arena( livre, QUANT_POSICOES * sizeof(int)            ) );
+	estado_dos_nodes         = reinterpret_cast<unsigned short*>( fatia_da_arena( livre, QUANT_POSICOES * sizeof(unsigned short) ) );
+	quadro_de_custo          = reinterpret_cast<float*>         ( fatia_da_arena( livre, QUANT_POSICOES * sizeof(float)          ) );
+
+	lista_aberta             = new ListaAberta;
+	busca_por_saltos         = new BuscaPorSaltos;
+	linhas_sujas             = new bool        [ QUANT_LINHAS ];
+	quadro_preparado_para    = -1;
+	geracao_dos_nodes        = 0xFFFF;  // A primeira busca zera as marcas, veja proxima_geracao().
+	expansoes_na_ultima_busca = 0;
+	fator_de_suboptimalidade  = 1.f;
+
+	std::fill( linhas_sujas, linhas_sujas + QUANT_LINHAS, false );
+}
+
+
+ContextoDePlanejamento::~ContextoDePlanejamento(){
+
+	delete[] arena;
+	delete   lista_aberta;
+	delete   busca_por_saltos;
+	delete[] linhas_sujas;
+}
+
+
+ContextoDePlanejamento&
+contexto_da_thread(){
+	/*
+	Descrio:
+		Contexto usado quando ningum fornece um. Cada thread tem o seu,
+		criado na primeira chamada e destrudo junto com a thread.
+	*/
+	thread_local ContextoDePlanejamento contexto;
+
+	return contexto;
+}
+
+
+inline long long
+medir_etapa(
+	high_resolution_clock::time_point& desde
+){
+	/*
+	Nanossegundos desde 'desde', que passa a ser agora. Assim etapas
+	seguidas so medidas com uma nica leitura de relgio cada.
+	*/
+	const high_resolution_clock::time_point agora = high_resolution_clock::now();
+	const long long passados = std::chrono::duration_cast<std::chrono::nanoseconds>( agora - desde ).count();
+
+	desde = agora;
+
+	return passados;
+}
+
+
+inline void
+construir_caminho_final(
+	ContextoDePlanejamento& contexto,
+	/*
+	Posio no quadro do ltimo n do caminho. Antes era um Node* const,
+	agora os pais so posies, veja ContextoDePlanejamento.
+	*/
+	const int melhor_posicao,
 	
-	/////////////////////////////////////////////////////////////////////////
-	/// Definies Importantes
-	/////////////////////////////////////////////////////////////////////////
-	
-	start_x = max(
-		-16.f,
-		min(
-			start_x,
-			16.f
-		) // limita para que seja menor que 16.f
-	); // Limita para que seja maior que -16.f
-	
-	start_y = max(
-		-11.f,
-		min(
-			start_y,
-			11.f
-		)
-	);
-	
-	int start_x_linha  = x_para_linha( start_x );
-	int end_x_linha    = x_para_linha( end_x   );
-	int start_y_coluna = y_para_col  ( start_y );
-	int end_y_coluna   = y_para_col  ( end_y   );
-	
-	float start_custo = quadro_de_custos[
-		start_x_linha * QUANT_COLUNAS + start_y_coluna
-	];
-	
-	float end_custo   = quadro_de_custos[
-		end_x_linha   * QUANT_COLUNAS + end_y_coluna
-	];
-	
-	/////////////////////////////////////////////////////////////////////////
-	/// Aplicao de Algoritmo
-	/////////////////////////////////////////////////////////////////////////
+	float status,
+	/*
+	Ativa ou desativa a substituio das coordenadas finais discretas
+	por valores exatos.
 	
+	False - Coordenadas Discretas do Grid
+	True  - Substitui o ltimo ponto do caminho por valores exatos em end_x e em end_y.
+	*/
+	const bool override_end=false,
 	/*
-	Caso o caminho tenha start e end iguais ou adjacentes, ser trivial.
+	Especificam as coordenadas exatas do ponto final quando override est ativo.
 	*/
-	bool se_esta_perto = abs(
-		start_x_linha  - end_x_linha
-	) <= 1 and           abs(
-		start_y_coluna - end_y_coluna
-	) <= 1;
-	
+	const float end_x=0, const float end_y=0
+){
 	/*
-	Permite que A* segure o abacaxi se a posio start  inacessvel ou
-	fora dos limites de borda no  permitido ou est bem perto do limite 
-	de borda ou no
+	Descrio:
+		Funo responsvel por atribuir o caminho especificado pela varivel 
+		melhor_posicao ao caminho final do contexto.
+
+		Reitero que esta funo NO  responsvel por qualquer calculo ou condio,
+		apenas atribui valores do array de caminho.
 	*/
-	if(
-		(
-			start_custo <= limite_para_qual_custo_eh_impossivel
-		) || (
-			!se_esta_perto and start_custo > 0
-		)
+	high_resolution_clock::time_point inicio_da_reconstrucao = high_resolution_clock::now();
+	
+	float*      caminho_final            = contexto.caminho_final;
+	int&        tamanho_do_caminho_final = contexto.tamanho_do_caminho_final;
+	const int*  parente_dos_nodes        = contexto.parente_dos_nodes;
+	
+	int posicao = melhor_posicao;
+	
+	// Vamos percorrer at o fim da estrutura.
+	int quantidade_de_parentes = 0;
+	while(
+		posicao != -1
 	){
-		return true;
+		
+		posicao = parente_dos_nodes[posicao];
+		quantidade_de_parentes++;
 	}
 	
+	tamanho_do_caminho_final = min(
+		/*
+		Limitamos o caminho final  quantidade de slots disponveis.
+		*/
+		2 * quantidade_de_parentes,
+		2048
+	);
+	
 	/*
-	Se desejarmos ir ao gol, devemos verificar se h coliso com gol, usamos A*.
+	Voltamos ao melhor n. 
+	Note que foi por isso que escrevemos o const, para preservar essa
+	propriedade. 
+	Completamente insano.
 	*/
+	posicao = melhor_posicao; 
+	int indice = tamanho_do_caminho_final - 1;
+	
 	if(
-		ir_ao_gol
+		// Se ativado, atualiza o ponto final para coordenadas corretas
+		// ao invs de verso discreta.
+		override_end
 	){
-		
-		end_x = 15.2;
-		end_y = max(
-			-0.8f,
-			min(
-				start_y, 0.8f
-			)
-		);
-	}
-	else{
-		
 		/*
-		Restringimos para que o final esteja no mapa.
+		indice   - acessamos no indice.
+		indice-- - acessamos no indice e o decrementamos
 		*/
-		end_x = max(
-			-16.f,
-			min(
-				end_x,
-				16.f
-			)
-		);
+		caminho_final[indice--] = end_y;
+		caminho_final[indice--] = end_x;
 		
-		end_y = max(
-			-11.f,
-			min(
-				end_y,
-				11.f
-			)
-		);	
+		posicao = parente_dos_nodes[posicao];
 	}
 	
-	/**
-     * Check if path intersects either goal (considering the unreachable area)
-     * - at this point we know that 'start' and 'end' are reachable
-     * - Therefore, the path must enter and exit the goal unreachable area for an intersection to exist
-     * - To detect this, we consider only the intersection of the path and the goal outer borders (back+sides)
-     * - The front is covered next by goal posts checks
-     */
-	if(
-		se_a_linha_ab_intercepta_qualquer_gol(
-			start_x,
-			start_y,
-			end_x,
-			end_y
-		)
+	// Preenchemos os endereos no caminho!
+	while(
+		indice > 0
 	){
-		return true;
-	}
-		
-	float obstaculos[
-		quantidade_de_obstaculos_dados * 4 / 5 + 16
-	] = {
-		/*
-		Lista de todos os obstculos
-			Traves do Gol + Obstculos Dados
-			
-		Note que incluindo as traves do gol provemos nenhum espao de 
-		amortecimento, o qual poderia ser necessrio.
-		
-		Parmetros como as numeraes de obstculos sero apresentados:
-			
-			Localizao da Trava do Gol (x, y)
-			'''
-			Miguel Abreu:
-				Goal post location (tested in simulator, collision with robot,
-				robot is sideways to the goal post and arms are close to body)
-			'''
-			
-			raio_HARD:
-			'''
-			Miguel Abreu:
-				Hard radius (tested in the same way, robot collides when 
-				closer than 0.15m from goal post border)
-				post radius 0.02 + agent radius 0.15 = 0.17
-			'''
-			
-			maior_raio:
-			'''
-				largest radius (equivalent to hard radius, since there is no
-				soft radius).
-			'''
-		*/
-		 15.02,  1.07, 0.17, 0.17,
-		
-		 15.02, -1.07, 0.17, 0.17,
-		
-		-15.02,  1.07, 0.17, 0.17,
-		
-		-15.02, -1.07, 0.17, 0.17,
-	};  // x, y, raio_HARD, maior_raio
-	
-	int quantidade_de_obstaculos_totais = 16;
-	
-	for(
-		int index = 0;
-		index < quantidade_de_obstaculos_dados;
-		index += 5
-	){
-		obstaculos[
-			quantidade_de_obstaculos_totais++
-		] = obstaculos_dados[
-			index
-		]; // x
-		
-		obstaculos[
-			quantidade_de_obstaculos_totais++
-		] = obstaculos_dados[
-			index + 1
-		]; // y
-		
-		obstaculos[
-			quantidade_de_obstaculos_totais++
-		] = fmaxf(
-			0,
-			fminf(
-				obstaculos_dados[
-					index + 2
-				],
-				DIST_MAX
-			)
-		); // Raio Hard
-		
-		obstaculos[
-			quantidade_de_obstaculos_totais++
-		] = fmaxf(
-			0, 
-			fminf(
-				max(
-					obstaculos_dados[
-						index + 2
-					],
-					obstaculos_dados[
-						index + 3
-					]
-				),
-				DIST_MAX
-			)
-		);  // Maior Raio
+		// No  um delta embaixo parece.
+		caminho_final[indice--] = (
+			posicao % QUANT_COLUNAS
+		) / 10.f - 11.f;  // y
 		
+		caminho_final[indice--] = (
+			posicao / QUANT_COLUNAS
+		) / 10.f - 16.f;  // x
 		
+		posicao = parente_dos_nodes[posicao];
+
+		// Observe que no fazemos alterao do ndice aqui.
+		// Fazemos dentro do acesso do vetor, indice--.
 	}
 	
-	/////////////////////////////////////////////////////////////////////
-	/// Verificaes de Obstruo
-	/////////////////////////////////////////////////////////////////////
+	/*
+	Atualizamos o status do caminho e acrescentamos a unidade do tamanho
 	
-	if(
-		// Caso Especial: Caminho  obstrudo se comea ou termina em rea HARD.
-		se_esta_perto
+	0 - sucesso
+	1 - tempo excedido
+	2 - impossvel
+	*/
+	caminho_final[
+		tamanho_do_caminho_final++
+	] = status;  
+		
+	/*
+	Informaes sobre o custo completo do caminho.
+	*/
+	caminho_final[
+		tamanho_do_caminho_final++
+	] = contexto.custo_dos_nodes[melhor_posicao] / 10.f; 
+
+	contexto.estatisticas_da_ultima_busca.tempo_de_reconstrucao += medir_etapa( inicio_da_reconstrucao );
+}	
+
+
+/*
+Custo de entrar numa clula, o mesmo que expandir_filho() soma ao passo.
+*/
+inline float
+custo_de_entrar(
+	float custo,
+	int   limite_para_qual_custo_eh_impossivel
+){
+	return custo <= limite_para_qual_custo_eh_impossivel ? 100.f : fmaxf( 0.f, custo );
+}
+
+
+inline float
+custo_da_linha_de_visada(
+	int   linha_a,
+	int   coluna_a,
+	int   linha_b,
+	int   coluna_b,
+	const float quadro_de_custo[],
+	int   limite_para_qual_custo_eh_impossivel
+){
+	/*
+	Descrio:
+		Custo de ir de a at b em linha reta, na mesma moeda do A*: o
+		comprimento mais o custo de cada clula que a reta toca, sem contar
+		a primeira.
+
+		As clulas tocadas so as da supercobertura da reta, ou seja, quando
+		ela passa exatamente por um canto, as duas clulas do canto entram
+		na conta. Assim a reta nunca raspa a quina de um obstculo.
+
+	Retorno:
+		O custo, ou -1 se a reta toca alguma clula impossvel.
+	*/
+
+	const int delta_linha  = linha_b  - linha_a;
+	const int delta_coluna = coluna_b - coluna_a;
+
+	const int passos_na_linha  = abs( delta_linha  );
+	const int passos_na_coluna = abs( delta_coluna );
+
+	const int sentido_linha  = delta_linha  > 0 ? 1 : -1;
+	const int sentido_coluna = delta_coluna > 0 ? 1 : -1;
+
+	float custo = sqrtf( float( delta_linha * delta_linha + delta_coluna * delta_coluna ) );
+
+	int linha  = linha_a;
+	int coluna = coluna_a;
+
+	int feitos_na_linha  = 0;
+	int feitos_na_coluna = 0;
+
+	while(
+		feitos_na_linha < passos_na_linha || feitos_na_coluna < passos_na_coluna
 	){
-		for(
-			int ob = 0;
-			ob < quantidade_de_obstaculos_totais;
-			ob += 4
+		/*
+		Comparamos onde a reta cruza a prxima fronteira de linha e a prxima
+		de coluna, (0.5 + feitos) / passos, multiplicando em cruz para
+		ficar nos inteiros.
+		*/
+		const int decisao = ( 1 + 2 * feitos_na_linha  ) * passos_na_coluna
+		                  - ( 1 + 2 * feitos_na_coluna ) * passos_na_linha;
+
+		if(
+			decisao == 0
 		){
-			float center_x = obstaculos[ ob     ];  // Centro_x
-			float center_y = obstaculos[ ob + 1 ];  // Centro_y
-			
-			float raio_hard = obstaculos[ ob +2 ]; 
-			
-			/*
-			Comeo para Centro
-			*/
-			float sc_x = center_x - start_x;
-			float sc_y = center_y - start_y;
-			
-			/*
-			Final para Centro
-			*/
-			float ec_x = center_x -  end_x;
-			float ec_y = center_y -  end_y;
-			
+			// Passamos pelo canto, as duas vizinhas do canto contam.
+			const float lado_linha  = quadro_de_custo[ ( linha + sentido_linha ) * QUANT_COLUNAS + coluna                  ];
+			const float lado_coluna = quadro_de_custo[   linha                   * QUANT_COLUNAS + coluna + sentido_coluna ];
+
 			if(
-				/*
-				Calculos se o inicio ou se o final est dentro da rea.
-				Observe que no utilizamos sqrt.
-				*/
-				(
-					(sc_x * sc_x + sc_y * sc_y) <= (raio_hard * raio_hard)
-				) || (
-					(ec_x * ec_x + ec_y * ec_y) <= (raio_hard * raio_hard)
-				)
+				lado_linha <= limite_para_qual_custo_eh_impossivel || lado_coluna <= limite_para_qual_custo_eh_impossivel
 			){
-				return true;
+				return -1;
 			}
-			
+
+			custo += fmaxf( 0.f, lado_linha ) + fmaxf( 0.f, lado_coluna );
+
+			linha  += sentido_linha;
+			coluna += sentido_coluna;
+			feitos_na_linha++;
+			feitos_na_coluna++;
 		}
-	}
-	else{
-		// Caso Normal: Caminho  obstrudo se intercepta obstculo
-		
-		for(
-			int ob = 0;
-			ob < quantidade_de_obstaculos_totais;
-			ob += 4
+		else if(
+			decisao < 0
 		){
-			float center_x   = obstaculos[ ob    ];
-			float center_y   = obstaculos[ ob + 1];
-			float maior_raio = obstaculos[ ob + 3];
-			
-			/*
-			Comeo para Centro
-			*/
-			float sc_x = center_x - start_x;
-			float sc_y = center_y - start_y;
-			
-			/*
-			Comeo para Final
-			*/
-			float se_x = end_x    - start_x;
-			float se_y = end_y    - start_y;
-			
-			/*
-			escala = comprimento da projeo / comprimento do vetor alvo
-			*/
-			float proj_sc_escala = (
-				// produto escalar, v?
-				sc_x * se_x + sc_y * se_y
-			) / (
-				// Mdulo do vetor de comeo -> final.
-				se_x * se_x + se_y * se_y
-			);
-			
-			/*
-			Projeo do vetor comeo -> centro sob o vetor comeo -> final.
-			*/
-			float proj_sc_x = se_x * proj_sc_escala;
-			float proj_sc_y = se_y * proj_sc_escala;
-			
-			// Fazemos isso para impedir divises por 0.
-			float parametro = (abs( se_x ) > abs( se_y )) ? proj_sc_x / se_x : proj_sc_y / se_y;
-			
-			if(
-				parametro <= 0
-			){
-				if(
-					// Verifica distncia do centro do obstaculo e comeo.
-					sc_x * sc_x + sc_y * sc_y <= maior_raio * maior_raio 
-				){
-					return true;
-				}
-			}
-			else{
-				if(
-					parametro >= 1
-				){
-					float ec_x = center_x - end_x;
-					float ec_y = center_y - end_y;
-					
-					if(
-						// Verifica distncia do centro do obstculo e final.
-						ec_x * ec_x + ec_y * ec_y <= maior_raio * maior_raio
-					){
-						return true;
-					}
-				}
-				else{
-					// Verificamos distncia do centro e da projeo.
-					
-					float proj_c_x = center_x - ( proj_sc_x + start_x );
-					float proj_c_y = center_y - ( proj_sc_y + start_y );
-					
-					if(
-						proj_c_x * proj_c_x + proj_c_y * proj_c_y <= maior_raio * maior_raio
-					){
-						return true;
-					}
-				}
-			}
+			linha += sentido_linha;
+			feitos_na_linha++;
+		}
+		else{
+			coluna += sentido_coluna;
+			feitos_na_coluna++;
 		}
+
+		const float custo_da_celula = quadro_de_custo[ linha * QUANT_COLUNAS + coluna ];
+
+		if(
+			custo_da_celula <= limite_para_qual_custo_eh_impossivel
+		){
+			return -1;
+		}
+
+		custo += fmaxf( 0.f, custo_da_celula );
 	}
-	
-	float delta_x = end_x - start_x;
-	float delta_y = end_y - start_y;
-	
-	tamanho_do_caminho_final = 6;
-	caminho_final[ 0 ] = start_x;
-	caminho_final[ 1 ] = start_y;
-	caminho_final[ 2 ] =   end_x;
-	caminho_final[ 3 ] =   end_y;
-	caminho_final[ 4 ] =       3;  // Sem obstculos.
-	/*
-	min. A* cost from start to end (e_cost is added even if start==end
-	to help debug cell costs)
-	*/
-	caminho_final[ 5 ] = sqrtf( delta_x * delta_x + delta_y * delta_y ) + max( 0.f, end_custo / 10.f );
-	
-	return false;  // Sem obstrues.
+
+	return custo;
 }
 
 
 void
-a_estrela(
-	float parametros[],
-	int quantidade_de_parametros
+suavizar_caminho(
+	float caminho[],
+	int& tamanho_do_caminho,
+	const float quadro_de_custo[],
+	int limite_para_qual_custo_eh_impossivel
 ){
 	/*
 	Descrio:
-		Responsvel por computar o melhor caminho possvel usando
-		a mtrica de distncia exclusiva e algoritmo A*.
+		Transforma a escada de clulas devolvida pela busca num caminho de
+		qualquer ngulo, puxando o barbante: a partir de uma ncora, avanamos
+		pelo caminho enquanto a reta da ncora at o ponto seguinte for
+		possvel e no custar mais que o trecho da escada que ela substitui.
+		O ltimo ponto aceito vira a nova ncora.
 
-		O caminho  expandido a partir da funo expandir_filho()
-		presente em noding.
-		
-	Parmetros:
-		[start x][start y]						-> posio inicial
-		[allow out of bounds?]					-> se est permitido sair dos limites
-		[go to goal?]							-> se h um objetivo  
-		[optional target x][optional target y]	-> posio do objetivo opcional
-		[timeout]								-> tempo limite de busca
-		[x][y][hard radius][soft radius][force] -> descrio dos obstculos
+		Como cada atalho custa no mximo o trecho original, o caminho
+		suavizado nunca  mais caro que o da busca, e o custo no fim do
+		vetor  atualizado com a economia. Em campo aberto, onde todas as
+		clulas custam zero, qualquer reta possvel  aceita. Dentro da
+		influncia dos obstculos a reta s  aceita se no pagar mais, logo
+		o caminho continua contornando as regies caras como antes.
 
-	Retorno:
-		No h retorno prvio, dado que esta funo calcula os nodes
-		que representam o melhor caminho, em seguida passa para construir_caminho_final()
-		a fim de popular o array de caminho.
+		Clulas impossveis nunca so atravessadas por um atalho. Se o
+		caminho original passa por elas, como quando comeamos dentro de um
+		obstculo, esse trecho fica como est.
+
+		Cada teste percorre a reta clula a clula, s testamos as quinas da
+		escada e paramos no primeiro atalho recusado, logo o custo fica bem
+		abaixo do custo da busca.
+
+	Parmetros:
+		caminho            -> [x, y, ..., status, custo], como em construir_caminho_final()
+		tamanho_do_caminho -> quantidade de floats, contando status e custo
 	*/
-	
-	//////////////////////////////////////////////////////////////////////
-	/// Extrao de Informaes dos Argumentos
-	//////////////////////////////////////////////////////////////////////
-	
-	// Auto permite que ns no nos importemos com o tipo fornecido.
-	// Pq apesar de saber que  uma unidade de tempo, o ngc  louco.
-	auto inicio = high_resolution_clock::now();
-	
-	const float start_x = parametros[ 0 ];
-	const float start_y = parametros[ 1 ];
-	
-	const bool permissao_para_ir_para_alem_dos_limites = parametros[2];
-	const int limite_para_qual_custo_eh_impossivel = permissao_para_ir_para_alem_dos_limites ? - 3 : - 2;
-		
-	const bool ir_ao_gol = parametros[ 3 ];
-	
-	const float alvo_opcional_x = parametros[ 4 ];
-	const float alvo_opcional_y = parametros[ 5 ];
-	
-	const int tempo_limite = parametros[ 6 ];  // para limitarmos o tempo de busca.
-	
-	float *obstaculos = parametros + 7;  // Aritmtica de Ponteiros
-	int quantidade_de_obstaculos = quantidade_de_parametros - 7;
 
-	float quadro_de_custo[
-		QUANT_LINHAS * QUANT_COLUNAS
-	] = {
-		/*
-		Definindo o campo de jogo.
-		No ousei tentar compreender isso ainda, entretanto,  importante
-		pra caramba dado que explicita 
-		*/
-		L0_1,
-		L2_5,
-		L6_10,
-		L11,
-		LIN12_308,
-		L309,
-		L310_314,
-		L2_5,
-		L0_1
-	};
+	const int quantidade_de_pontos = ( tamanho_do_caminho - 2 ) / 2;
 
 	if(
-		!permissao_para_ir_para_alem_dos_limites
-	){
-		adicionar_espaco_de_amortecimento(
-			quadro_de_custo
-		);
-	}
-	
-	if(
-		!se_caminho_esta_obstruido(
-			start_x,
-			start_y,
-			alvo_opcional_x,
-			alvo_opcional_y,
-			obstaculos,
-			quantidade_de_obstaculos,
-			ir_ao_gol,
-			limite_para_qual_custo_eh_impossivel,
-			quadro_de_custo
-		)
+		// Com dois pontos, j  uma reta.
+		quantidade_de_pontos < 3
 	){
-		// Retorna o caminho caso no esteja obstrudo
 		return;
 	}
 
-	const int start_linha = x_para_linha(
-		start_x
-	);
-	const int start_coluna = y_para_col(
-		start_y
-	);
-	const int start_pos = start_linha * QUANT_COLUNAS + start_coluna;
-	
-	////////////////////////////////////////////////////////////////////
-	/// Definimos objetivo.
-	////////////////////////////////////////////////////////////////////
-	
-	int end_linha  = 0;
-	int end_coluna = 0;
-	if(
-		!ir_ao_gol
+	const float status = caminho[ tamanho_do_caminho - 2 ];
+	float       custo  = caminho[ tamanho_do_caminho - 1 ];
+
+	/*
+	Custo acumulado da escada at cada ponto. O caminho tem no mximo 1024
+	pontos, veja construir_caminho_final().
+	*/
+	float acumulado[1024];
+	int   linhas   [1024];
+	int   colunas  [1024];
+
+	for(
+		int i = 0;
+		i < quantidade_de_pontos;
+		i++
 	){
-		end_linha  = x_para_linha( alvo_opcional_x );
-		end_coluna = y_para_col  ( alvo_opcional_y );
-	}
-	else{
-		end_linha = LINHA_DO_GOL;
+		linhas [i] = x_para_linha( caminho[ 2 * i     ] );
+		colunas[i] = y_para_col  ( caminho[ 2 * i + 1 ] );
+
+		if(
+			i == 0
+		){
+			acumulado[i] = 0;
+			continue;
+		}
+
+		const int dl = linhas [i] - linhas [i - 1];
+		const int dc = colunas[i] - colunas[i - 1];
+
+		acumulado[i] = acumulado[i - 1] + sqrtf( float( dl * dl + dc * dc ) ) + custo_de_entrar(
+			quadro_de_custo[ linhas[i] * QUANT_COLUNAS + colunas[i] ],
+			limite_para_qual_custo_eh_impossivel
+		);
 	}
-	
-	////////////////////////////////////////////////////////////////////
-	/// Limites de Borda
-	////////////////////////////////////////////////////////////////////
-	
-	int linha_min = min( start_linha, end_linha );
-	int linha_max = min( start_linha, end_linha );
-	
-	int coluna_min = 0;
-	int coluna_max = 0;
-	
-	if(
-		ir_ao_gol
-	){
-		coluna_min = min( start_coluna,        119 );
-		coluna_max = max( start_coluna, 	   101 );
-	}
-	else{
-		coluna_min = min( start_coluna, end_coluna );
-		coluna_max = max( start_coluna, end_coluna );
-	}
-	
-	if(
-		/*
-		Devemos limitar mais caso no seja permitir sair, para desincentivar
-		ainda mais a sada.
-		*/
-		!permissao_para_ir_para_alem_dos_limites
+
+	float economia = 0;
+	int   escritos = 1;  // O primeiro ponto fica onde est.
+	int   ancora   = 0;
+
+	while(
+		ancora < quantidade_de_pontos - 1
 	){
-		linha_min  = min( linha_min,  306         );
-		linha_max  = max( 14,         linha_max   );
-		coluna_min = min( coluna_min, 206         );
-		coluna_max = max( 14,  		  coluna_max  );
+		int   melhor          = ancora + 1;
+		float melhor_economia = 0;
+
+		// Enquanto os passos seguirem na mesma direo, a reta  a prpria escada.
+		const int dl_inicial = linhas [ancora + 1] - linhas [ancora];
+		const int dc_inicial = colunas[ancora + 1] - colunas[ancora];
+		bool      ainda_reto = true;
+
+		for(
+			int k = ancora + 2;
+			k < quantidade_de_pontos;
+			k++
+		){
+			ainda_reto = ainda_reto && linhas [k] - linhas [k - 1] == dl_inicial
+			                        && colunas[k] - colunas[k - 1] == dc_inicial;
+
+			if(
+				ainda_reto
+			){
+				melhor = k;
+				continue;
+			}
+
+			if(
+				/*
+				Meio de um trecho reto da escada. Testamos s as quinas, onde a
+				escada muda de direo, o que corta a maioria dos testes.
+				*/
+				k < quantidade_de_pontos - 1 && linhas [k + 1] - linhas [k] == linhas [k] - linhas [k - 1]
+				                             && colunas[k + 1] - colunas[k] == colunas[k] - colunas[k - 1]
+			){
+				continue;
+			}
+
+			const float custo_da_reta = custo_da_linha_de_visada(
+				linhas [ancora], colunas[ancora],
+				linhas [k],      colunas[k],
+				quadro_de_custo,
+				limite_para_qual_custo_eh_impossivel
+			);
+
+			const float custo_da_escada = acumulado[k] - acumulado[ancora];
+
+			if(
+				custo_da_reta < 0 || custo_da_reta > custo_da_escada + 1e-3f
+			){
+				break;
+			}
+
+			melhor          = k;
+			melhor_economia = custo_da_escada - custo_da_reta;
+		}
+
+		// Cada atalho aceito substitui o anterior, logo s a economia do ltimo vale.
+		economia += melhor_economia;
+
+		caminho[ 2 * escritos     ] = caminho[ 2 * melhor     ];
+		caminho[ 2 * escritos + 1 ] = caminho[ 2 * melhor + 1 ];
+		escritos++;
+
+		ancora = melhor;
 	}
 
-	////////////////////////////////////////////////////////////////////
-	/// Algoritmo A*
-	////////////////////////////////////////////////////////////////////
-	
-	Node* raiz_da_estrutura = nullptr;
-	Node quadro_de_possibilidades[
-		QUANT_COLUNAS * QUANT_LINHAS
-	];
+	tamanho_do_caminho = 2 * escritos;
+
+	caminho[ tamanho_do_caminho++ ] = status;
+	caminho[ tamanho_do_caminho++ ] = custo - economia / 10.f;
+}
+
+
+inline bool 
+se_a_linha_ab_intercepta_qualquer_gol(
+	float a_x,
+	float a_y,
+	float b_x,
+	float b_y
+){
+	/*
+	Descrio:
+		Objetivo da funo  autoexplicativo.
+		
+		Assume que a e b so dois pontos fora da rea inalcanvel do gol.
+		Logo, linha ab, se for o caso, deve entrar e sair da rea inalcanvel.
+		
+		Para detectar isso, consideramos apenas a interseo da linha ab com as bordas
+		externas do gol.
+		
+		As bordas internas tero outras verificaes.
+		
+		Os nmeros usados aqui so especficos para as dimenses do gol.
+		No razo para eles alm de propores geomtricas. Vm de
+		CampoNoQuadro, em campo.h: no campo oficial, 15.75 e 1.25.
+	*/
+	const double fundo = Campo::fundo_de_fora_do_gol;
+	const double lado  = Campo::meia_largura_de_fora;
+	const double linha = Campo::linha_de_fundo / 10.0;
 	
-	unsigned int estado_dos_nodes[
-		QUANT_LINHAS * QUANT_COLUNAS
-	] = {
-		/*
-		0 -> Desconhecido
-		1 -> Aberto
-		2 -> Fechado
-		*/
-		0	
-	};  
 	
-	///////////////////////////////////////////////////////////////////
-	/// Populamos com obstculos
-	///////////////////////////////////////////////////////////////////
+	float delta_x = b_x - a_x;
+	float delta_y = b_y - a_y;
+	float coef_ang = 0;  // coeficiente angular
 	
-	for(
-		int ob = 0;
-		ob < quantidade_de_obstaculos;
-		ob += 5
+	if(
+		// Verificar se linha ab e 'goal back' so no colineares.
+		delta_x != 0
 	){
-		int linha = x_para_linha( obstaculos[ ob    ] );
-		int coluna = y_para_col ( obstaculos[ ob + 1] );
+		/*
+		a_x + delta_x * coef_ang = fundo.
+		*/
+		coef_ang = (
+			fundo - a_x
+		) / delta_x;
 		
-		float raio_hard = fmaxf(
-			0,
-			fminf(
-				obstaculos[ ob + 2 ],
-				DIST_MAX
-			)
-		);
-		float raio_soft = fmaxf(
-			0,
-			fminf(
-				obstaculos[ ob + 3 ],
-				DIST_MAX
+		if(
+			(
+				coef_ang >= 0
+			) && (
+				coef_ang <= 1 
+			) && (
+				fabsf(  // Apenas pega o valor absoluto de floats.
+					a_y + delta_y * coef_ang 
+				) <= lado
 			)
-		);
-		
-		float forca = obstaculos[ ob + 4 ];
-		float forca_por_metro = forca / raio_soft;  // Rapaz, apenas para facilitar posteriores contas
-		
-		int raio_max = int(
-			fmaxf(
-				raio_hard,
-				raio_soft
-			) * 10.f + 1e-4
+		){
 			/*
-			A fim de aprimorar velocidade, no usaremos a funo pow(10, -4).
-			
-			Oq esse valor significa?
-				 um delta para evitar possveis erros em contas posteriores.	
+			Ento h coliso.
 			*/
-		);
-		linha_min  = min( linha_min,  linha  - raio_max - 1 );
-		linha_max  = max( linha_max,  linha  + raio_max + 1 );
-		coluna_min = min( coluna_min, coluna - raio_max - 1 );
-		coluna_max = max( coluna_max, coluna + raio_max + 1 );
-		
-		
-		////////////////////////////////////////////////////////////////////
-		/// Custo a partir dos raios de contato.
-		////////////////////////////////////////////////////////////////////
-		
-		/*
-		Fazemos atualizaes do custo a partir dos valores que esto em
-		obtendo_possibilidades.h
-		
-		Como acredito que voc pode no ter visto o cdigo referente 
-		obtendo_possibilidades.py, lhe darei outra explicao.
-		
-		quantidade_de_pontos_disponiveis
-			
-			quantidade de pontos que foram contabilizados ao redor do agente.
+			return true;
+		}
 		
-		aneis_e_pontos_disponiveis
-			
-			raio dos aneis de cada ponto disponvel. Por exemplo, um ponto
-			(linha, coluna) possui o valor de sua distncia registrada nesse 
-			array.
-			
-		linhas_de_cada_ponto
-		colunas_de_cada_ponto
+		coef_ang = (
+			- fundo - a_x
+		) / delta_x;
 		
-			Respectivamente, as linhas e colunas de cada ponto em arrays 
-			unidimensionais.
-		*/
-		int index = 0;
-		while(
+		if(
 			(
-				index < quantidade_de_pontos_disponiveis
+				coef_ang >= 0
+			) && (
+				coef_ang <= 1 
 			) && (
-				aneis_e_pontos_disponiveis[index] <= raio_hard
+				fabsf(  // Apenas pega o valor absoluto de floats.
+					a_y + delta_y * coef_ang 
+				) <= lado
 			)
 		){
-			// Lembre-se que este valor est definido em obtendo_possibilidades.h
-			int coef_linha  = linha  + linhas_de_cada_ponto [ index ];
-			int coef_coluna = coluna + colunas_de_cada_ponto[ index ];
+			/*
+			Ento h coliso.
+			*/
+			return true;
+		}
+		
+	}
+	
+	if(
+		// Verificar se linha ab e 'goal sides' so no colineares.
+		delta_y != 0
+	){
+		/*
+		a_y + delta_y * coef_ang = lado
+		*/
+		
+		coef_ang = (
+			lado - a_y
+		) / delta_y;
+		if(
+			coef_ang >= 0 && coef_ang <= 1
+		){
+			
+			float intersecao_x = fabsf(
+				a_x + delta_x * coef_ang
+			);
 			
 			if(
-				(
-					coef_linha  >= 0
-				) && (
-					coef_coluna >= 0
-				) && (
-					coef_linha  <  QUANT_LINHAS
-				) && (
-					coef_coluna <  QUANT_COLUNAS
-				)
+				intersecao_x >= linha && intersecao_x <= fundo
 			){
-				quadro_de_custo[
-					coef_linha * QUANT_COLUNAS + coef_coluna
-				] = - 3;
+				/*
+				H coliso
+				*/
+				return true;
 			}
-			
-			index++;
 		}
 		
-		while(
-			(
-				index < quantidade_de_pontos_disponiveis
-			) && (
-				aneis_e_pontos_disponiveis[index] <= raio_soft
-			)
+		coef_ang = (
+			- lado - a_y
+		) / delta_y;
+		if(
+			coef_ang >= 0 && coef_ang <= 1
 		){
-			int coef_linha  = linha  + linhas_de_cada_ponto [ index ];
-			int coef_coluna = coluna + colunas_de_cada_ponto[ index ];
-			
-			float custo_anteriormente_calculado = quadro_de_custo[
-				coef_linha * QUANT_COLUNAS + coef_coluna
-			];
 			
-			// Apenas um fator para ver se vale a pena tocar pelo raio_soft
-			float fr = forca - (forca_por_metro * aneis_e_pontos_disponiveis[index]);
+			float intersecao_x = fabsf(
+				a_x + delta_x * coef_ang
+			);
 			
 			if(
-				(
-					coef_linha  >= 0
-				) && (
-					coef_coluna >= 0
-				) && (
-					coef_linha  <  QUANT_LINHAS
-				) && (
-					coef_coluna <  QUANT_COLUNAS
-				) && (
-					custo_anteriormente_calculado > limite_para_qual_custo_eh_impossivel
-				) && (
-					custo_anteriormente_calculado < fr
-				)
+				intersecao_x >= linha && intersecao_x <= fundo
 			){
-				quadro_de_custo[
-					coef_linha * QUANT_COLUNAS + coef_coluna
-				] = fr;
+				/*
+				H coliso
+				*/
+				return true;
 			}
 			
-			index++;
 		}
-		
-	}
-	
-	///////////////////////////////////////////////////////////////////
-	/// Ajustes finos
-	///////////////////////////////////////////////////////////////////
 	
+
+	}
+
+	return false;
+}
+
+
+/*
+Os dois campos vazios, com e sem o amortecimento das bordas. Antes eram
+montados na carga do mdulo, a partir das macros L0_1 ... L310_314, e
+agora o compilador os gera a partir da geometria. Veja campo.h.
+*/
+static constexpr QuadrosDoCampo<GeometriaDoCampo> quadros_base{};
+
+
+inline const float*
+quadro_base_do_campo(
+	bool permissao_para_ir_para_alem_dos_limites
+){
+	return permissao_para_ir_para_alem_dos_limites ? quadros_base.fora_do_campo : quadros_base.dentro_do_campo;
+}
+
+
+inline void
+marcar_linhas_sujas(
+	ContextoDePlanejamento& contexto,
+	int linha_min,
+	int linha_max
+){
+	// Linhas do quadro de custo que precisaro ser restauradas na prxima chamada.
+	std::fill(
+		contexto.linhas_sujas + max( 0,                linha_min ),
+		contexto.linhas_sujas + min( QUANT_LINHAS - 1, linha_max ) + 1,
+		true
+	);
+}
+
+
+inline float*
+preparar_quadro_de_custo(
+	ContextoDePlanejamento& contexto,
+	bool permissao_para_ir_para_alem_dos_limites
+){
 	/*
-	Ajustamos limites de borda caso a rea disponvel esteja sobrepondo
-	rea dos gols.
-	
-	Os valores a seguir so especficos da geometria do campo.
+	Descrio:
+		Devolve o quadro de custo do contexto idntico ao quadro base pedido.
+
+		Se a chamada anterior usou o mesmo quadro base, copiamos de volta
+		apenas as linhas que ela sujou. Numa jogada tpica so algumas
+		dezenas de linhas, contra as 321 do quadro inteiro.
 	*/
+	const float* base   = quadro_base_do_campo( permissao_para_ir_para_alem_dos_limites );
+	float*       quadro = contexto.quadro_de_custo;
+
 	if(
-		coluna_max > 96 and coluna_min < 124
+		contexto.quadro_preparado_para != (int) permissao_para_ir_para_alem_dos_limites
+	){
+		std::copy( base, base + QUANT_LINHAS * QUANT_COLUNAS, quadro );
+		std::fill( contexto.linhas_sujas, contexto.linhas_sujas + QUANT_LINHAS, false );
+
+		contexto.quadro_preparado_para = permissao_para_ir_para_alem_dos_limites;
+		contexto.estatisticas_da_ultima_busca.linhas_restauradas += QUANT_LINHAS;
+
+		return quadro;
+	}
+
+	for(
+		int linha = 0;
+		linha < QUANT_LINHAS;
+		linha++
 	){
-		
-		if(
-			// Caso nosso gol esteja sendo sobreposto
-			linha_max > 1 and linha_min < 12
-		){
-			// Extend working area to include our goal
-			linha_max  = max( 12,  linha_max  );
-			linha_min  = min( 1,   linha_min  );
-			coluna_max = max( 124, coluna_max );
-			coluna_min = min( 96,  coluna_min );
-		}
-		
 		if(
-			// Caso seja o gol deles.
-			linha_max > 308 and linha_min < 319
+			contexto.linhas_sujas[linha]
 		){
-			// Extend working area to include their goal
-			linha_max  = max( 319, linha_max  );
-			linha_min  = min( 308, linha_min  );
-			coluna_max = max( 124, coluna_max );
-			coluna_min = min( 96,  coluna_min );
+			std::copy(
+				base   + linha * QUANT_COLUNAS,
+				base   + ( linha + 1 ) * QUANT_COLUNAS,
+				quadro + linha * QUANT_COLUNAS
+			);
+
+			contexto.linhas_sujas[linha] = false;
+			contexto.estatisticas_da_ultima_busca.linhas_restauradas++;
 		}
 	}
-	
-	///////////////////////////////////////////////////////////////////
-	/// Adicionamos o objetivo
-	///////////////////////////////////////////////////////////////////
-	
-	/*
-	Caso o objetivo no esteja acessvel, no adicionamos ao mapa.
-	Embora sua referncia ainda exista.
-	
-	Portanto, ns saberemos o quo longe estamos da referncia, apesar dela
-	ser inacessvel. Mesmo se estivermos bem prximos ao objetivo, a ideia 
-	 se afastar para atingir o ponto vlido mais prximo que permitir a 
-	acessibilidade.
+
+	return quadro;
+}
+
+
+inline void
+carimbar_obstaculo_pela_tabela(
+	float quadro_de_custo[],
+	int   linha,
+	int   coluna,
+	float raio_hard,
+	float raio_soft,
+	float forca,
+	int   limite_para_qual_custo_eh_impossivel,
+	/*
+	Opcional: s tocamos nas clulas cuja marca seja igual a 'marca'.
+	O replanejador incremental usa isso para recarimbar apenas a regio
+	que mudou desde o ltimo ciclo.
 	*/
-	
-	if(
-		!ir_ao_gol
-	){
-		float *custo_do_fim = &quadro_de_custo[
-			end_linha * QUANT_COLUNAS + end_coluna
-		];
-		
-		if(
-			*custo_do_fim > limite_para_qual_custo_eh_impossivel
-		){
-			
-			*custo_do_fim = -1;
-		}
-	}
-	else{
-		for(
-			int index = LINHA_DO_GOL * QUANT_COLUNAS + 101;
-			    index <= LINHA_DO_GOL * QUANT_COLUNAS + 119;
-			    index++
-		){
-			if(
-				quadro_de_custo[index] > limite_para_qual_custo_eh_impossivel
-			){
-				quadro_de_custo[index] = -1;
-			}
-		}
-	}
-	
-	// Adicionamos novos limites de borda para restringir ainda mais espao
-	linha_max  = min( 320, linha_max);
-	linha_min  = max( 0,   linha_min);
-	coluna_max = min( 220, coluna_max);
-	coluna_min = max( 0,   coluna_min);
-	
-	// Iniciamos o primeiro n.
-	// Fazemos um mnimo para nos basear a partir dele
-	quadro_de_possibilidades[start_pos].custo_pontual = 0;
-	quadro_de_possibilidades[start_pos].parente = nullptr;  
-	raiz_da_estrutura = noding::inserir( &quadro_de_possibilidades[ start_pos ], raiz_da_estrutura );
-	Node* melhor_node = &quadro_de_possibilidades[start_pos];
+	const unsigned int* marcas = nullptr,
+	unsigned int        marca  = 0
+){
+	/*
+	Descrio:
+		Carimbo original, clula a clula pela tabela de obtendo_possibilidades.h.
+		Mantido apenas para comparao, veja carimbo.h e o debug.cc.
 
-	// infinite distance if start is itself unreachable
-	float distancia_ao_melhor_node = std::numeric_limits<float>::max();  // Apenas dizemos que  a maior possvel primeiro.
+		Escreve no quadro o custo de um obstculo j convertido para linha
+		e coluna, com raios limitados a DIST_MAX.
+
+		Dentro do raio hard a clula vira -3. Entre o raio hard e o soft, a
+		clula recebe a fora repulsiva decrescente com a distncia, a menos
+		que j seja impossvel ou j tenha um custo maior. Por isso a ordem
+		em que os obstculos so carimbados no altera o resultado.
+	*/
 	
+	float forca_por_metro = forca / raio_soft;  // Rapaz, apenas para facilitar posteriores contas
+
 	/*
-	Caso ultrapasse essa medida, deve parar imediatamente e ficar com oq 
-	j tem.
-	*/
-	int medida_de_tempo_limite = 0;
+	Fazemos atualizaes do custo a partir dos valores que esto em
+	obtendo_possibilidades.h
 	
-	if(
-		quadro_de_custo[start_pos] > limite_para_qual_custo_eh_impossivel
-	){
+	Como acredito que voc pode no ter visto o cdigo referente 
+	obtendo_possibilidades.py, lhe darei outra explicao.
+	
+	quantidade_de_pontos_disponiveis
 		
-		distancia_ao_melhor_node = distancia_diagonal(
-			ir_ao_gol,
-			start_linha,
-			start_coluna,
-			end_linha,
-			end_coluna
-		);
-	}
+		quantidade de pontos que foram contabilizados ao redor do agente.
 	
-	////////////////////////////////////////////////////////////////////
-	/// Aplicao do Algoritmo A*
-	////////////////////////////////////////////////////////////////////
+	aneis_e_pontos_disponiveis
+		
+		raio dos aneis de cada ponto disponvel. Por exemplo, um ponto
+		(linha, coluna) possui o valor de sua distncia registrada nesse 
+		array.
+		
+	linhas_de_cada_ponto
+	colunas_de_cada_ponto
 	
+		Respectivamente, as linhas e colunas de cada ponto em arrays 
+		unidimensionais.
+	*/
+	int index = 0;
 	while(
-		raiz_da_estrutura != nullptr
+		(
+			index < quantidade_de_pontos_disponiveis
+		) && (
+			aneis_e_pontos_disponiveis[index] <= raio_hard
+		)
 	){
+		// Lembre-se que este valor est definido em obtendo_possibilidades.h
+		int coef_linha  = linha  + linhas_de_cada_ponto [ index ];
+		int coef_coluna = coluna + colunas_de_cada_ponto[ index ];
 		
-		// Procuramos o prximo melhor n.
-		Node* node_atual = min_node;
-		
-		const int pos_atual     = node_atual - quadro_de_possibilidades;
-		const int linha_atual   = pos_atual / QUANT_COLUNAS; 
-		const int coluna_atual  = pos_atual % QUANT_COLUNAS;
-		const float custo_atual = quadro_de_custo[pos_atual];
-		
-		medida_de_tempo_limite = (medida_de_tempo_limite + 1) % 31; // Checar o tempo a cada 32 iteraes
 		if(
-			custo_atual > limite_para_qual_custo_eh_impossivel
+			(
+				coef_linha  >= 0
+			) && (
+				coef_coluna >= 0
+			) && (
+				coef_linha  <  QUANT_LINHAS
+			) && (
+				coef_coluna <  QUANT_COLUNAS
+			) && (
+				marcas == nullptr || marcas[ coef_linha * QUANT_COLUNAS + coef_coluna ] == marca
+			)
 		){
-			float dist_diagonal = distancia_diagonal(
-				ir_ao_gol,
-				linha_atual,
-				coluna_atual,
-				end_linha,
-				end_coluna
-			);
-			
-			if(
-				// Achamos um novo melhor node
-				distancia_ao_melhor_node > dist_diagonal
-			){
-				
-				melhor_node = node_atual;
-				distancia_ao_melhor_node = dist_diagonal;
-			}
+			quadro_de_custo[
+				coef_linha * QUANT_COLUNAS + coef_coluna
+			] = - 3;
 		}
 		
-		raiz_da_estrutura = noding::remover_min( raiz_da_estrutura, false );
-		estado_dos_nodes[pos_atual] = 2;
+		index++;
+	}
+	
+	while(
+		(
+			index < quantidade_de_pontos_disponiveis
+		) && (
+			aneis_e_pontos_disponiveis[index] <= raio_soft
+		)
+	){
+		int coef_linha  = linha  + linhas_de_cada_ponto [ index ];
+		int coef_coluna = coluna + colunas_de_cada_ponto[ index ];
 		
-		// Checamos se o objetivo foi atingido.
-		if(
-			custo_atual == -1
-		){
-			
-			construir_caminho_final(
-				melhor_node,
-				quadro_de_possibilidades,
-				0, // Significa sucesso
-				!ir_ao_gol,
-				alvo_opcional_x,
-				alvo_opcional_y
-			);
-			
-			return;
-		}
+		// Apenas um fator para ver se vale a pena tocar pelo raio_soft
+		float fr = forca - (forca_por_metro * aneis_e_pontos_disponiveis[index]);
 		
 		if(
 			(
-				medida_de_tempo_limite == 0
+				coef_linha  >= 0
 			) && (
-				duration_cast<microseconds>( high_resolution_clock::now() - inicio).count() > tempo_limite
+				coef_coluna >= 0
+			) && (
+				coef_linha  <  QUANT_LINHAS
+			) && (
+				coef_coluna <  QUANT_COLUNAS
+			) && (
+				marcas == nullptr || marcas[ coef_linha * QUANT_COLUNAS + coef_coluna ] == marca
 			)
 		){
-			
-			construir_caminho_final(
-				melhor_node,
-				quadro_de_possibilidades,
-				1 // Significa tempo excedido.
-			);
-			
-			return;
-		}
-		
-		/////////////////////////////////////////////////////////////////
-		/// Expandimos nodes filhos
-		/////////////////////////////////////////////////////////////////
-		bool rcol_ok = coluna_atual < coluna_max;
-		bool lcol_ok = coluna_atual > coluna_min;
-		
-		if(
-			linha_atual > linha_min
-		){
-			int linha  = linha_atual  - 1;
-			int coluna = coluna_atual - 1;
-			
-			int   posicao        = pos_atual - QUANT_COLUNAS - 1;
-			float custo          = quadro_de_custo [  posicao  ];
-			int   estado_do_node = estado_dos_nodes[  posicao  ];
-			
-			if(
-				/*
-				Checa se no  um obstculo e se o node no est fechado.
-				*/
-				(
-					estado_do_node != 2
-				) && !(
-					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
-				) && (
-					lcol_ok
-				)
-				
-			){
-				raiz_da_estrutura = noding::expandir_filho(
-					raiz_da_estrutura,
-					custo,
-					limite_para_qual_custo_eh_impossivel,
-					node_atual,
-					quadro_de_possibilidades,
-					posicao,
-					estado_do_node,
-					ir_ao_gol,
-					linha,
-					coluna,
-					end_linha,
-					end_coluna,
-					estado_dos_nodes, 
-					SQRT_2 // Extra
-				);
-			}
-			
-			coluna++;
-			posicao++;
-			custo          = quadro_de_custo [ posicao ];
-			estado_do_node = estado_dos_nodes[ posicao ];
-			
-			if(
-				(
-					estado_do_node != 2
-				) && !(
-					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
-				)
-			){
-				raiz_da_estrutura = noding::expandir_filho(
-					raiz_da_estrutura,
-					custo,
-					limite_para_qual_custo_eh_impossivel,
-					node_atual,
-					quadro_de_possibilidades,
-					posicao,
-					estado_do_node,
-					ir_ao_gol,
-					linha,
-					coluna,
-					end_linha,
-					end_coluna,
-					estado_dos_nodes, 
-					1 // Extra
-				);
-			}
-			
-			coluna++;
-			posicao++;
-			custo          = quadro_de_custo [ posicao ];
-			estado_do_node = estado_dos_nodes[ posicao ];
+			// S lemos depois de saber que a clula existe.
+			float* custo_anteriormente_calculado = &quadro_de_custo[
+				coef_linha * QUANT_COLUNAS + coef_coluna
+			];
 			
 			if(
 				(
-					estado_do_node != 2
-				) && !(
-					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
+					*custo_anteriormente_calculado > limite_para_qual_custo_eh_impossivel
 				) && (
-					rcol_ok
+					*custo_anteriormente_calculado < fr
 				)
 			){
-				raiz_da_estrutura = noding::expandir_filho(
-					raiz_da_estrutura,
-					custo,
-					limite_para_qual_custo_eh_impossivel,
-					node_atual,
-					quadro_de_possibilidades,
-					posicao,
-					estado_do_node,
-					ir_ao_gol,
-					linha,
-					coluna,
-					end_linha,
-					end_coluna,
-					estado_dos_nodes, 
-					SQRT_2 // Extra
-				);
+				*custo_anteriormente_calculado = fr;
 			}
 		}
 		
-		if(
-			linha_atual < linha_max
-		){
-			int linha   = linha_atual  + 1;
-			int coluna  = coluna_atual - 1;
-			
-			int   posicao        = pos_atual + QUANT_COLUNAS - 1;
-			float custo          = quadro_de_custo [  posicao  ];
-			int   estado_do_node = estado_dos_nodes[  posicao  ];
-			
-			if(
-				/*
-				Checa se no  um obstculo e se o node no est fechado.
-				*/
-				(
-					estado_do_node != 2
-				) && !(
-					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
-				) && (
-					lcol_ok
-				)
-				
-			){
-				raiz_da_estrutura = noding::expandir_filho(
-					raiz_da_estrutura,
-					custo,
-					limite_para_qual_custo_eh_impossivel,
-					node_atual,
-					quadro_de_possibilidades,
-					posicao,
-					estado_do_node,
-					ir_ao_gol,
-					linha,
-					coluna,
-					end_linha,
-					end_coluna,
-					estado_dos_nodes, 
-					SQRT_2 // Extra
-				);
-			}
-			
-			coluna++;
-			posicao++;
-			custo          = quadro_de_custo [ posicao ];
-			estado_do_node = estado_dos_nodes[ posicao ];
-			
-			if(
-				(
-					estado_do_node != 2
-				) && !(
-					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
-				)
+		index++;
+	}
+}
+
+
+inline void
+carimbar_obstaculo(
+	float quadro_de_custo[],
+	int   linha,
+	int   coluna,
+	float raio_hard,
+	float raio_soft,
+	float forca,
+	int   limite_para_qual_custo_eh_impossivel,
+	/*
+	Opcional: s tocamos nas clulas cuja marca seja igual a 'marca'.
+	O replanejador incremental usa isso para recarimbar apenas a regio
+	que mudou desde o ltimo ciclo.
+	*/
+	const unsigned int* marcas = nullptr,
+	unsigned int        marca  = 0
+){
+	/*
+	Descrio:
+		Escreve no quadro o custo de um obstculo j convertido para linha
+		e coluna, com raios limitados a DIST_MAX.
+
+		Dentro do raio hard a clula vira -3. Entre o raio hard e o soft, a
+		clula recebe a fora repulsiva decrescente com a distncia, a menos
+		que j seja impossvel ou j tenha um custo maior. Por isso a ordem
+		em que os obstculos so carimbados no altera o resultado.
+
+		O trabalho  feito por faixas de linha, no motor vetorizado que o
+		processador suportar. Veja carimbo.h.
+	*/
+	carimbar_por_faixas(
+		nucleo_de_carimbo_ativo(),
+		quadro_de_custo,
+		linha,
+		coluna,
+		raio_hard,
+		raio_soft,
+		forca,
+		limite_para_qual_custo_eh_impossivel,
+		marcas,
+		marca
+	);
+}
+
+
+inline ObstaculoNoQuadro
+converter_obstaculo(
+	const float obstaculo[]  // [x][y][hard radius][soft radius][force]
+){
+	/*
+	Converte um obstculo para o quadro, do mesmo jeito que a_estrela() faz
+	antes de carimbar. Dois obstculos iguais aqui carimbam exatamente as
+	mesmas clulas, mesmo que x e y tenham mudado alguns milmetros.
+	*/
+	ObstaculoNoQuadro convertido;
+
+	convertido.linha     = x_para_linha( obstaculo[0] );
+	convertido.coluna    = y_para_col  ( obstaculo[1] );
+	convertido.raio_hard = limitar( obstaculo[2], 0.f, DIST_MAX );
+	convertido.raio_soft = limitar( obstaculo[3], 0.f, DIST_MAX );
+	convertido.forca     = obstaculo[4];
+	convertido.raio_max  = int( max( convertido.raio_hard, convertido.raio_soft ) * 10.f + 1e-4 );
+
+	return convertido;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// Fase Larga dos Obstculos
+////////////////////////////////////////////////////////////////////////////
+
+/*
+Grade de baldes sobre x em [-17, 17) e y em [-12, 12). Quem est fora cai
+no balde da borda, o que s gera candidatos a mais, nunca a menos.
+
+Cada obstculo entra em todos os baldes que a sua caixa, aumentada de
+FOLGA_DO_BALDE, toca. Assim um ponto exatamente na divisa entre dois
+baldes encontra o obstculo em qualquer um deles.
+*/
+#define LADO_DO_BALDE   2.f   // metros
+#define BALDES_EM_X     17
+#define BALDES_EM_Y     12
+#define QUANT_BALDES    ( BALDES_EM_X * BALDES_EM_Y )
+#define FOLGA_DO_BALDE  1e-2f
+
+inline int
+balde_em_x(
+	float x
+){
+	const float u = ( x + 17.f ) * ( 1.f / LADO_DO_BALDE );
+
+	return u <= 0.f ? 0 : ( u >= BALDES_EM_X ? BALDES_EM_X - 1 : int( u ) );
+}
+
+inline int
+balde_em_y(
+	float y
+){
+	const float u = ( y + 12.f ) * ( 1.f / LADO_DO_BALDE );
+
+	return u <= 0.f ? 0 : ( u >= BALDES_EM_Y ? BALDES_EM_Y - 1 : int( u ) );
+}
+
+
+inline void
+misturar_no_resumo(
+	unsigned long long& resumo,
+	unsigned int        palavra
+){
+	// FNV-1a, byte a byte.
+	for(
+		int byte = 0;
+		byte < 4;
+		byte++
+	){
+		resumo ^= ( palavra >> ( 8 * byte ) ) & 0xFF;
+		resumo *= 1099511628211ull;
+	}
+}
+
+
+inline unsigned int
+bits_do_float(
+	float valor
+){
+	unsigned int bits;
+	std::memcpy( &bits, &valor, sizeof( bits ) );
+
+	return bits;
+}
+
+
+inline void
+montar_fase_larga(
+	FaseLarga&  fase,
+	const float obstaculos[],
+	int         quantidade_de_obstaculos  // em floats, 5 por obstculo
+){
+	/*
+	Descrio:
+		Converte os obstculos da chamada e distribui cada um nos baldes
+		que ele pode tocar. Os baldes ficam num nico vetor, por contagem:
+		primeiro contamos quantos caem em cada balde, depois cada obstculo
+		 escrito no fim do seu trecho, andando para trs.
+
+		Custa O(obstculos) e no aloca nada depois da primeira chamada.
+		Se os obstculos so exatamente os da montagem anterior, como nas
+		consultas em lote e em vrias consultas do mesmo agente no mesmo
+		ciclo, nada  refeito.
+
+		Tambm refaz FaseLarga::resumo, a parte da ChaveDoCache que descreve
+		os obstculos. Ele sai dos convertidos e no dos floats originais,
+		logo um obstculo que andou alguns milmetros sem mudar de clula
+		no muda o resumo.
+	*/
+	if(
+		(int) fase.obstaculos.size() == quantidade_de_obstaculos &&
+		std::equal( obstaculos, obstaculos + quantidade_de_obstaculos, fase.obstaculos.begin() )
+	){
+		return;
+	}
+
+	fase.obstaculos.assign( obstaculos, obstaculos + quantidade_de_obstaculos );
+
+	const int quantidade = quantidade_de_obstaculos / 5;
+
+	fase.convertidos.resize( quantidade );
+	fase.x          .resize( quantidade );
+	fase.y          .resize( quantidade );
+	fase.maior_raio .resize( quantidade );
+	fase.caixas     .resize( 4 * quantidade );
+	fase.visto_na_consulta.resize( quantidade, 0u );
+	fase.inicio_do_balde.assign( QUANT_BALDES + 1, 0 );
+
+	int* inicio = fase.inicio_do_balde.data();
+	int* caixas = fase.caixas.data();
+
+	fase.resumo = 1469598103934665603ull;
+
+	for(
+		int i = 0;
+		i < quantidade;
+		i++
+	){
+		const ObstaculoNoQuadro convertido = converter_obstaculo( obstaculos + 5 * i );
+
+		const float x          = obstaculos[ 5 * i     ];
+		const float y          = obstaculos[ 5 * i + 1 ];
+		const float maior_raio = max( convertido.raio_hard, convertido.raio_soft );
+		const float alcance    = maior_raio + FOLGA_DO_BALDE;
+
+		misturar_no_resumo( fase.resumo, (unsigned int) convertido.linha  );
+		misturar_no_resumo( fase.resumo, (unsigned int) convertido.coluna );
+		misturar_no_resumo( fase.resumo, bits_do_float( convertido.raio_hard ) );
+		misturar_no_resumo( fase.resumo, bits_do_float( convertido.raio_soft ) );
+		misturar_no_resumo( fase.resumo, bits_do_float( convertido.forca     ) );
+
+		fase.convertidos[i] = convertido;
+		fase.x[i]           = x;
+		fase.y[i]           = y;
+		fase.maior_raio[i]  = maior_raio;
+
+		// Baldes que a caixa do obstculo toca: [bx_min, bx_max] x [by_min, by_max].
+		int* caixa = caixas + 4 * i;
+		caixa[0] = balde_em_x( x - alcance );
+		caixa[1] = balde_em_x( x + alcance );
+		caixa[2] = balde_em_y( y - alcance );
+		caixa[3] = balde_em_y( y + alcance );
+
+		for(
+			int bx = caixa[0];
+			bx <= caixa[1];
+			bx++
+		){
+			for(
+				int by = caixa[2];
+				by <= caixa[3];
+				by++
 			){
-				raiz_da_estrutura = noding::expandir_filho(
-					raiz_da_estrutura,
-					custo,
-					limite_para_qual_custo_eh_impossivel,
-					node_atual,
-					quadro_de_possibilidades,
-					posicao,
-					estado_do_node,
-					ir_ao_gol,
-					linha,
-					coluna,
-					end_linha,
-					end_coluna,
-					estado_dos_nodes, 
-					1 // Extra
-				);
+				inicio[ bx * BALDES_EM_Y + by ]++;
 			}
-			
-			coluna++;
-			posicao++;
-			custo          = quadro_de_custo [ posicao ];
-			estado_do_node = estado_dos_nodes[ posicao ];
-			
-			if(
-				(
-					estado_do_node != 2
-				) && !(
-					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
-				) && (
-					rcol_ok
-				)
+		}
+	}
+
+	// Agora inicio_do_balde[b] vira o fim do trecho do balde b.
+	for(
+		int b = 1;
+		b <= QUANT_BALDES;
+		b++
+	){
+		inicio[b] += inicio[b - 1];
+	}
+
+	fase.indices.resize( inicio[ QUANT_BALDES ] );
+
+	int* indices = fase.indices.data();
+
+	for(
+		// De trs para frente, para que cada balde fique em ordem crescente.
+		int i = quantidade - 1;
+		i >= 0;
+		i--
+	){
+		const int* caixa = caixas + 4 * i;
+
+		for(
+			int bx = caixa[0];
+			bx <= caixa[1];
+			bx++
+		){
+			for(
+				int by = caixa[2];
+				by <= caixa[3];
+				by++
 			){
-				raiz_da_estrutura = noding::expandir_filho(
-					raiz_da_estrutura,
-					custo,
-					limite_para_qual_custo_eh_impossivel,
-					node_atual,
-					quadro_de_possibilidades,
-					posicao,
-					estado_do_node,
-					ir_ao_gol,
-					linha,
-					coluna,
-					end_linha,
-					end_coluna,
-					estado_dos_nodes, 
-					SQRT_2 // Extra
-				);
+				indices[ --inicio[ bx * BALDES_EM_Y + by ] ] = i;
 			}
 		}
-		
-		int coluna  = coluna_atual - 1;
-		int posicao = pos_atual    - 1;
-		float custo          = quadro_de_custo [ posicao ];
-		int   estado_do_node = estado_dos_nodes[ posicao ];
-		
+	}
+	// E cada fim, decrementado uma vez por ocupante, terminou no incio do trecho.
+}
+
+
+template <typename Teste>
+inline bool
+algum_obstaculo_ao_longo_do_segmento(
+	FaseLarga& fase,
+	float a_x,
+	float a_y,
+	float b_x,
+	float b_y,
+	Teste teste
+){
+	/*
+	Descrio:
+		Chama teste(i) uma nica vez para cada obstculo de algum balde
+		atravessado pelo segmento ab, e para no primeiro que responder true.
+
+		Andamos pelas colunas de baldes em x. Dentro de cada coluna, o trecho
+		do segmento cobre um intervalo de y, e basta olhar os baldes dele.
+
+	Retorno:
+		true se teste(i) foi true para algum obstculo.
+	*/
+	if(
+		fase.convertidos.empty()
+	){
+		return false;
+	}
+
+	if(
+		// Deu a volta, as marcas antigas poderiam coincidir.
+		++fase.consulta == 0
+	){
+		std::fill( fase.visto_na_consulta.begin(), fase.visto_na_consulta.end(), 0u );
+		fase.consulta = 1;
+	}
+
+	const float x_min   = min( a_x, b_x );
+	const float x_max   = max( a_x, b_x );
+	const float delta_x = b_x - a_x;
+	const float delta_y = b_y - a_y;
+
+	const int bx_min = balde_em_x( x_min );
+	const int bx_max = balde_em_x( x_max );
+
+	for(
+		int bx = bx_min;
+		bx <= bx_max;
+		bx++
+	){
+		float y_0 = a_y;
+		float y_1 = b_y;
+
 		if(
-			/*
-			Checa se no  um obstculo e se o node no est fechado.
-			*/
-			(
-				estado_do_node != 2
-			) && !(
-				custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
-			) && (
-				lcol_ok
-			)
-			
+			delta_x != 0
 		){
-			raiz_da_estrutura = noding::expandir_filho(
-				raiz_da_estrutura,
-				custo,
-				limite_para_qual_custo_eh_impossivel,
-				node_atual,
-				quadro_de_possibilidades,
-				posicao,
-				estado_do_node,
-				ir_ao_gol,
-				linha_atual,
-				coluna,
-				end_linha,
-				end_coluna,
-				estado_dos_nodes, 
-				1 // Extra
-			);
+			// Trecho do segmento dentro desta coluna de baldes.
+			const float x_0 = bx == bx_min ? x_min : -17.f +   bx       * LADO_DO_BALDE;
+			const float x_1 = bx == bx_max ? x_max : -17.f + ( bx + 1 ) * LADO_DO_BALDE;
+
+			y_0 = a_y + delta_y * ( x_0 - a_x ) / delta_x;
+			y_1 = a_y + delta_y * ( x_1 - a_x ) / delta_x;
 		}
-			
-		coluna  += 2;
-		posicao += 2;
-		custo          = quadro_de_custo [ posicao ];
-		estado_do_node = estado_dos_nodes[ posicao ];
-		
-		if(
-			/*
-			Checa se no  um obstculo e se o node no est fechado.
-			*/
-			(
-				estado_do_node != 2
-			) && !(
-				custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
-			) && (
-				rcol_ok
-			)
-			
+
+		const int by_min = balde_em_y( min( y_0, y_1 ) - FOLGA_DO_BALDE );
+		const int by_max = balde_em_y( max( y_0, y_1 ) + FOLGA_DO_BALDE );
+
+		for(
+			int by = by_min;
+			by <= by_max;
+			by++
 		){
-			raiz_da_estrutura = noding::expandir_filho(
-				raiz_da_estrutura,
-				custo,
-				limite_para_qual_custo_eh_impossivel,
-				node_atual,
-				quadro_de_possibilidades,
-				posicao,
-				estado_do_node,
-				ir_ao_gol,
-				linha_atual,
-				coluna,
-				end_linha,
-				end_coluna,
-				estado_dos_nodes, 
-				1 // Extra
-			);
+			const int balde = bx * BALDES_EM_Y + by;
+
+			for(
+				int k = fase.inicio_do_balde[balde];
+				k < fase.inicio_do_balde[balde + 1];
+				k++
+			){
+				const int i = fase.indices[k];
+
+				if(
+					fase.visto_na_consulta[i] == fase.consulta
+				){
+					continue;
+				}
+				fase.visto_na_consulta[i] = fase.consulta;
+
+				if(
+					teste( i )
+				){
+					return true;
+				}
+			}
 		}
 	}
-	
-	construir_caminho_final(
-		melhor_node,
-		quadro_de_possibilidades,
-		2
-	);
-	
-	return;
+
+	return false;
+}
+
+
+inline bool
+ponto_no_circulo(
+	float ponto_x,
+	float ponto_y,
+	float centro_x,
+	float centro_y,
+	float raio
+){
+	// Observe que no utilizamos sqrt.
+	float dx = centro_x - ponto_x;
+	float dy = centro_y - ponto_y;
+
+	return ( dx * dx + dy * dy ) <= ( raio * raio );
+}
+
+
+inline bool
+segmento_toca_circulo(
+	float start_x,
+	float start_y,
+	float end_x,
+	float end_y,
+	float center_x,
+	float center_y,
+	float maior_raio
+){
+	/*
+	Descrio:
+		Se o segmento start -> end passa a at maior_raio do centro.
+		Projetamos o centro no segmento e medimos at o ponto mais prximo.
+	*/
+
+	/*
+	Comeo para Centro
+	*/
+	float sc_x = center_x - start_x;
+	float sc_y = center_y - start_y;
+	
+	/*
+	Comeo para Final
+	*/
+	float se_x = end_x    - start_x;
+	float se_y = end_y    - start_y;
+	
+	/*
+	escala = comprimento da projeo / comprimento do vetor alvo
+	*/
+	float proj_sc_escala = (
+		// produto escalar, v?
+		sc_x * se_x + sc_y * se_y
+	) / (
+		// Mdulo do vetor de comeo -> final.
+		se_x * se_x + se_y * se_y
+	);
+	
+	/*
+	Projeo do vetor comeo -> centro sob o vetor comeo -> final.
+	*/
+	float proj_sc_x = se_x * proj_sc_escala;
+	float proj_sc_y = se_y * proj_sc_escala;
+	
+	// Fazemos isso para impedir divises por 0.
+	float parametro = (abs( se_x ) > abs( se_y )) ? proj_sc_x / se_x : proj_sc_y / se_y;
+	
+	if(
+		parametro <= 0
+	){
+		// Verifica distncia do centro do obstaculo e comeo.
+		return sc_x * sc_x + sc_y * sc_y <= maior_raio * maior_raio;
+	}
+
+	if(
+		parametro >= 1
+	){
+		float ec_x = center_x - end_x;
+		float ec_y = center_y - end_y;
+		
+		// Verifica distncia do centro do obstculo e final.
+		return ec_x * ec_x + ec_y * ec_y <= maior_raio * maior_raio;
+	}
+
+	// Verificamos distncia do centro e da projeo.
+	float proj_c_x = center_x - ( proj_sc_x + start_x );
+	float proj_c_y = center_y - ( proj_sc_y + start_y );
+	
+	return proj_c_x * proj_c_x + proj_c_y * proj_c_y <= maior_raio * maior_raio;
+}
+
+
+bool 
+se_caminho_esta_obstruido(
+	ContextoDePlanejamento& contexto,
+	// Pontos
+	float start_x, float start_y,
+	float end_x, float end_y,
+	FaseLarga& fase_larga,  // obstculos da chamada, veja montar_fase_larga()
+	bool  ir_ao_gol,
+	int   limite_para_qual_custo_eh_impossivel,
+	const float quadro_de_custos[]
+){
+	/*
+	Descrio:
+		Verifica se um determinado caminho est obstculo.
+		
+		O caminho est obstrudo se intercepta qualquer circunferncia 
+		HARD ou SOFT ou se comea dentro de circuferncia HARD.
+		
+		Os nmeros escolhidos no so aleatrios, tem haver com as propores
+		geomtricas,  bem complexo.
+	
+	Retorno:
+		False - Se no for necessrio que A* resolva esse problema.
+		True  - se estiver obstrudo, logo A* buscar outro caminho.
+	*/
+	
+	/////////////////////////////////////////////////////////////////////////
+	/// Definies Importantes
+	/////////////////////////////////////////////////////////////////////////
+	
+	start_x = max(
+		-16.f,
+		min(
+			start_x,
+			16.f
+		) // limita para que seja menor que 16.f
+	); // Limita para que seja maior que -16.f
+	
+	start_y = max(
+		-11.f,
+		min(
+			start_y,
+			11.f
+		)
+	);
+	
+	int start_x_linha  = x_para_linha( start_x );
+	int end_x_linha    = x_para_linha( end_x   );
+	int start_y_coluna = y_para_col  ( start_y );
+	int end_y_coluna   = y_para_col  ( end_y   );
+	
+	float start_custo = quadro_de_custos[
+		start_x_linha * QUANT_COLUNAS + start_y_coluna
+	];
+	
+	float end_custo   = quadro_de_custos[
+		end_x_linha   * QUANT_COLUNAS + end_y_coluna
+	];
+	
+	/////////////////////////////////////////////////////////////////////////
+	/// Aplicao de Algoritmo
+	/////////////////////////////////////////////////////////////////////////
+	
+	/*
+	Caso o caminho tenha start e end iguais ou adjacentes, ser trivial.
+	*/
+	bool se_esta_perto = abs(
+		start_x_linha  - end_x_linha
+	) <= 1 and           abs(
+		start_y_coluna - end_y_coluna
+	) <= 1;
+	
+	/*
+	Permite que A* segure o abacaxi se a posio start  inacessvel ou
+	fora dos limites de borda no  permitido ou est bem perto do limite 
+	de borda ou no
+	*/
+	if(
+		(
+			start_custo <= limite_para_qual_custo_eh_impossivel
+		) || (
+			!se_esta_perto and start_custo > 0
+		)
+	){
+		return true;
+	}
+	
+	/*
+	Se desejarmos ir ao gol, devemos verificar se h coliso com gol, usamos A*.
+	*/
+	if(
+		ir_ao_gol
+	){
+		
+		// Meio do interior do gol deles, uma clula antes das traves.
+		const float y_max_no_gol = ( Campo::meia_boca_do_gol - 1 ) / 10.f;
+
+		end_x = ( Campo::linha_do_gol - Campo::linha_do_meio ) / 10.f;
+		end_y = max(
+			-y_max_no_gol,
+			min(
+				start_y, y_max_no_gol
+			)
+		);
+	}
+	else{
+		
+		/*
+		Restringimos para que o final esteja no mapa.
+		*/
+		end_x = max(
+			-16.f,
+			min(
+				end_x,
+				16.f
+			)
+		);
+		
+		end_y = max(
+			-11.f,
+			min(
+				end_y,
+				11.f
+			)
+		);	
+	}
+	
+	/**
+     * Check if path intersects either goal (considering the unreachable area)
+     * - at this point we know that 'start' and 'end' are reachable
+     * - Therefore, the path must enter and exit the goal unreachable area for an intersection to exist
+     * - To detect this, we consider only the intersection of the path and the goal outer borders (back+sides)
+     * - The front is covered next by goal posts checks
+     */
+	if(
+		se_a_linha_ab_intercepta_qualquer_gol(
+			start_x,
+			start_y,
+			end_x,
+			end_y
+		)
+	){
+		return true;
+	}
+		
+	static const float traves[16] = {
+		/*
+		Lista de todos os obstculos
+			Traves do Gol, os obstculos dados vm da fase larga
+			
+		Note que incluindo as traves do gol provemos nenhum espao de 
+		amortecimento, o qual poderia ser necessrio.
+		
+		Parmetros como as numeraes de obstculos sero apresentados:
+			
+			Localizao da Trava do Gol (x, y)
+			'''
+			Miguel Abreu:
+				Goal post location (tested in simulator, collision with robot,
+				robot is sideways to the goal post and arms are close to body)
+			'''
+			
+			raio_HARD:
+			'''
+			Miguel Abreu:
+				Hard radius (tested in the same way, robot collides when 
+				closer than 0.15m from goal post border)
+				post radius 0.02 + agent radius 0.15 = 0.17
+			'''
+			
+			maior_raio:
+			'''
+				largest radius (equivalent to hard radius, since there is no
+				soft radius).
+			'''
+		*/
+		 Campo::x_da_trave,  Campo::y_da_trave, 0.17, 0.17,
+		
+		 Campo::x_da_trave, -Campo::y_da_trave, 0.17, 0.17,
+		
+		-Campo::x_da_trave,  Campo::y_da_trave, 0.17, 0.17,
+		
+		-Campo::x_da_trave, -Campo::y_da_trave, 0.17, 0.17,
+	};  // x, y, raio_HARD, maior_raio
+	
+	/////////////////////////////////////////////////////////////////////
+	/// Verificaes de Obstruo
+	/////////////////////////////////////////////////////////////////////
+	
+	/*
+	Antes cada obstculo dado era copiado e testado contra o segmento. Agora
+	s testamos os que esto nos baldes que o segmento atravessa, e um caminho
+	livre com muitos obstculos longe dele sai em poucas contas.
+	*/
+	if(
+		// Caso Especial: Caminho  obstrudo se comea ou termina em rea HARD.
+		se_esta_perto
+	){
+		for(
+			int ob = 0;
+			ob < 16;
+			ob += 4
+		){
+			if(
+				ponto_no_circulo( start_x, start_y, traves[ ob ], traves[ ob + 1 ], traves[ ob + 2 ] ) ||
+				ponto_no_circulo( end_x,   end_y,   traves[ ob ], traves[ ob + 1 ], traves[ ob + 2 ] )
+			){
+				return true;
+			}
+		}
+
+		if(
+			algum_obstaculo_ao_longo_do_segmento(
+				fase_larga,
+				start_x,
+				start_y,
+				end_x,
+				end_y,
+				[&]( int i ){
+					const float raio_hard = fase_larga.convertidos[i].raio_hard;
+
+					return ponto_no_circulo( start_x, start_y, fase_larga.x[i], fase_larga.y[i], raio_hard ) ||
+					       ponto_no_circulo( end_x,   end_y,   fase_larga.x[i], fase_larga.y[i], raio_hard );
+				}
+			)
+		){
+			return true;
+		}
+	}
+	else{
+		// Caso Normal: Caminho  obstrudo se intercepta obstculo
+		
+		for(
+			int ob = 0;
+			ob < 16;
+			ob += 4
+		){
+			if(
+				segmento_toca_circulo( start_x, start_y, end_x, end_y, traves[ ob ], traves[ ob + 1 ], traves[ ob + 3 ] )
+			){
+				return true;
+			}
+		}
+
+		if(
+			algum_obstaculo_ao_longo_do_segmento(
+				fase_larga,
+				start_x,
+				start_y,
+				end_x,
+				end_y,
+				[&]( int i ){
+					return segmento_toca_circulo( start_x, start_y, end_x, end_y, fase_larga.x[i], fase_larga.y[i], fase_larga.maior_raio[i] );
+				}
+			)
+		){
+			return true;
+		}
+	}
+	
+	float delta_x = end_x - start_x;
+	float delta_y = end_y - start_y;
+	
+	float* caminho_final          = contexto.caminho_final;
+	int&   tamanho_do_caminho_final = contexto.tamanho_do_caminho_final;
+	
+	tamanho_do_caminho_final = 6;
+	caminho_final[ 0 ] = start_x;
+	caminho_final[ 1 ] = start_y;
+	caminho_final[ 2 ] =   end_x;
+	caminho_final[ 3 ] =   end_y;
+	caminho_final[ 4 ] =       3;  // Sem obstculos.
+	/*
+	min. A* cost from start to end (e_cost is added even if start==end
+	to help debug cell costs)
+	*/
+	caminho_final[ 5 ] = sqrtf( delta_x * delta_x + delta_y * delta_y ) + max( 0.f, end_custo / 10.f );
+	
+	return false;  // Sem obstrues.
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// Busca em Qualquer Tempo (ARA*)
+////////////////////////////////////////////////////////////////////////////
+
+static const float INFINITO = std::numeric_limits<float>::infinity();
+
+/*
+Os 8 vizinhos de uma clula e o passo at cada um, na mesma conveno de
+expandir_filho(): 1 nas retas e SQRT_2 nas diagonais.
+*/
+static const int   vizinhos_linha [8] = { -1,     -1,  -1,     0,  0,  1,      1,  1      };
+static const int   vizinhos_coluna[8] = { -1,      0,   1,    -1,  1, -1,      0,  1      };
+static const float vizinhos_passo [8] = { SQRT_2,  1,   SQRT_2, 1,  1,  SQRT_2, 1,  SQRT_2 };
+
+
+inline void
+busca_em_qualquer_tempo(
+	ContextoDePlanejamento& contexto,
+	const OpcoesDeBusca&    opcoes,
+	unsigned short          geracao,
+	const float*            quadro_de_custo,
+	int   limite_para_qual_custo_eh_impossivel,
+	bool  ir_ao_gol,
+	int   start_pos,
+	int   end_linha,  int end_coluna,
+	int   linha_min,  int linha_max,
+	int   coluna_min, int coluna_max,
+	float alvo_x,     float alvo_y,
+	const high_resolution_clock::time_point& inicio,
+	int   tempo_limite
+){
+	/*
+	Descrio:
+		ARA* (Likhachev, Gordon e Thrun), escolhido por
+		OpcoesDeBusca::em_qualquer_tempo. Chamado por a_estrela() depois que
+		o quadro de custo, o objetivo e a janela de busca esto prontos.
+
+		A lista aberta  ordenada por g + peso * h. Com peso > 1 a busca vai
+		quase reto ao objetivo e acha logo um caminho completo, que custa no
+		mximo peso vezes o timo. Em vez de recomear do zero com um peso
+		menor, seguimos da busca anterior:
+
+			- um n fechado que fica mais barato no  reaberto na mesma
+			  iterao, vira fechado inconsistente;
+			- na iterao seguinte, abertos e inconsistentes formam a nova
+			  lista aberta, com o peso novo, e os fechados viram apenas
+			  conhecidos, mantendo custo e pai.
+
+		Cada caminho completo vai direto para o caminho final do contexto.
+		Se o tempo acabar, o ltimo continua l, com status 0. S devolvemos
+		um pedao de caminho, com status 1, se o tempo acabar antes do
+		primeiro caminho completo, como no A* comum.
+
+		A garantia de cada caminho  min( peso, g(objetivo) / menor g + h
+		entre abertos e inconsistentes ), e fica em fator_de_suboptimalidade.
+		Paramos antes do timeout quando ela chega a 1.
+
+		A aresta e a regra de proibio so as mesmas de expandir_filho().
+	*/
+	ListaAberta&      lista_aberta      = *contexto.lista_aberta;
+	float*            custo_dos_nodes   = contexto.custo_dos_nodes;
+	int*              parente_dos_nodes = contexto.parente_dos_nodes;
+	unsigned short*   estado_dos_nodes  = contexto.estado_dos_nodes;
+	std::vector<int>& tocadas           = contexto.posicoes_tocadas;
+
+	const unsigned short aberto        = geracao;
+	const unsigned short fechado       = geracao + 1;
+	const unsigned short conhecido     = geracao + 2;
+	const unsigned short inconsistente = geracao + 3;
+
+	float peso = std::max( 1.f, opcoes.peso_inicial );
+
+	tocadas.clear();
+	lista_aberta.limpar();
+
+	custo_dos_nodes  [start_pos] = 0;
+	parente_dos_nodes[start_pos] = -1;
+	estado_dos_nodes [start_pos] = aberto;
+	tocadas.push_back( start_pos );
+
+	lista_aberta.inserir(
+		start_pos,
+		peso * distancia_diagonal( ir_ao_gol, start_pos / QUANT_COLUNAS, start_pos % QUANT_COLUNAS, end_linha, end_coluna ),
+		0
+	);
+
+	// Para o caso de o tempo acabar antes do primeiro caminho completo, veja a_estrela().
+	int   melhor_posicao           = start_pos;
+	float distancia_ao_melhor_node = std::numeric_limits<float>::max();
+	bool  tem_caminho_completo     = false;
+
+	int medida_de_tempo_limite = 0;
+
+	while(
+		true
+	){
+		/////////////////////////////////////////////////////////////////
+		/// Uma iterao: A* com a heurstica inflada por 'peso'
+		/////////////////////////////////////////////////////////////////
+
+		int objetivo = -1;
+
+		while(
+			!lista_aberta.vazia()
+		){
+			contexto.estatisticas_da_ultima_busca.maior_lista_aberta = max( contexto.estatisticas_da_ultima_busca.maior_lista_aberta, lista_aberta.tamanho() );
+
+			const int   pos_atual    = lista_aberta.extrair_min();
+			const int   linha_atual  = pos_atual / QUANT_COLUNAS;
+			const int   coluna_atual = pos_atual % QUANT_COLUNAS;
+			const float custo_atual  = quadro_de_custo[pos_atual];
+
+			if(
+				/*
+				h do objetivo  0, ento ele sair da lista significa que o seu
+				g  o menor valor em aberto. No o expandimos, e ele continua
+				aberto para a prxima iterao.
+				*/
+				custo_atual == -1
+			){
+				objetivo = pos_atual;
+				break;
+			}
+
+			contexto.expansoes_na_ultima_busca++;
+
+			if(
+				!tem_caminho_completo && custo_atual > limite_para_qual_custo_eh_impossivel
+			){
+				const float dist_diagonal = distancia_diagonal( ir_ao_gol, linha_atual, coluna_atual, end_linha, end_coluna );
+
+				if(
+					distancia_ao_melhor_node > dist_diagonal
+				){
+					melhor_posicao           = pos_atual;
+					distancia_ao_melhor_node = dist_diagonal;
+				}
+			}
+
+			estado_dos_nodes[pos_atual] = fechado;
+
+			medida_de_tempo_limite = (medida_de_tempo_limite + 1) % 31;
+			if(
+				(
+					medida_de_tempo_limite == 0
+				) && (
+					duration_cast<microseconds>( high_resolution_clock::now() - inicio ).count() > tempo_limite
+				)
+			){
+				if(
+					!tem_caminho_completo
+				){
+					construir_caminho_final(
+						contexto,
+						melhor_posicao,
+						1 // Significa tempo excedido.
+					);
+				}
+
+				// Seno, o ltimo caminho completo j est no contexto.
+				return;
+			}
+
+			for(
+				int v = 0;
+				v < 8;
+				v++
+			){
+				const int linha  = linha_atual  + vizinhos_linha [v];
+				const int coluna = coluna_atual + vizinhos_coluna[v];
+
+				if(
+					linha < linha_min || linha > linha_max || coluna < coluna_min || coluna > coluna_max
+				){
+					continue;
+				}
+
+				const int   posicao = linha * QUANT_COLUNAS + coluna;
+				const float custo   = quadro_de_custo[posicao];
+
+				if(
+					// Mesma proibio do lao de a_estrela().
+					custo <= limite_para_qual_custo_eh_impossivel && custo < custo_atual
+				){
+					continue;
+				}
+
+				const float novo_custo = custo_dos_nodes[pos_atual] + vizinhos_passo[v] + (
+					custo <= limite_para_qual_custo_eh_impossivel ? 100.f : std::fmaxf( 0.f, custo )
+				);
+
+				const int estado_do_node = estado_na_geracao( estado_dos_nodes[posicao], geracao );
+
+				if(
+					estado_do_node != 0 && novo_custo >= custo_dos_nodes[posicao]
+				){
+					continue;
+				}
+
+				custo_dos_nodes  [posicao] = novo_custo;
+				parente_dos_nodes[posicao] = pos_atual;
+
+				const float valor = novo_custo + peso * distancia_diagonal( ir_ao_gol, linha, coluna, end_linha, end_coluna );
+
+				if(
+					estado_do_node == 0 || estado_do_node == 3
+				){
+					if(
+						estado_do_node == 0
+					){
+						tocadas.push_back( posicao );
+					}
+
+					estado_dos_nodes[posicao] = aberto;
+					lista_aberta.inserir( posicao, valor, novo_custo );
+				}
+				else if(
+					estado_do_node == 1
+				){
+					lista_aberta.atualizar( posicao, valor, novo_custo );
+				}
+				else if(
+					estado_do_node == 2
+				){
+					// J expandido nesta iterao, fica para a prxima.
+					estado_dos_nodes[posicao] = inconsistente;
+				}
+			}
+		}
+
+		if(
+			objetivo == -1
+		){
+			/*
+			A lista esvaziou sem chegar ao objetivo, o que s pode acontecer na
+			primeira iterao, j que depois dela o objetivo segue aberto.
+			*/
+			construir_caminho_final(
+				contexto,
+				melhor_posicao,
+				2 // Significa impossvel.
+			);
+
+			return;
+		}
+
+		tem_caminho_completo = true;
+
+		construir_caminho_final(
+			contexto,
+			objetivo,
+			0, // Significa sucesso
+			!ir_ao_gol,
+			alvo_x,
+			alvo_y
+		);
+
+		/////////////////////////////////////////////////////////////////
+		/// Garantia do caminho encontrado
+		/////////////////////////////////////////////////////////////////
+
+		float menor_valor = custo_dos_nodes[objetivo];
+
+		for(
+			int i = 0;
+			i < (int) tocadas.size();
+			i++
+		){
+			const int posicao        = tocadas[i];
+			const int estado_do_node = estado_na_geracao( estado_dos_nodes[posicao], geracao );
+
+			if(
+				estado_do_node == 1 || estado_do_node == 4
+			){
+				menor_valor = std::min(
+					menor_valor,
+					custo_dos_nodes[posicao] + distancia_diagonal( ir_ao_gol, posicao / QUANT_COLUNAS, posicao % QUANT_COLUNAS, end_linha, end_coluna )
+				);
+			}
+		}
+
+		contexto.fator_de_suboptimalidade = menor_valor > 0 ? std::min( peso, custo_dos_nodes[objetivo] / menor_valor ) : 1.f;
+
+		if(
+			contexto.fator_de_suboptimalidade <= 1.f
+		){
+			// timo, no h o que melhorar.
+			return;
+		}
+
+		/////////////////////////////////////////////////////////////////
+		/// Prxima iterao, com peso menor
+		/////////////////////////////////////////////////////////////////
+
+		if(
+			/*
+			Conferimos aqui tambm, pois uma iterao que s reencontra o
+			objetivo no topo da lista no expande nada.
+			*/
+			duration_cast<microseconds>( high_resolution_clock::now() - inicio ).count() > tempo_limite
+		){
+			return;
+		}
+
+		peso = std::max( 1.f, std::min( peso, contexto.fator_de_suboptimalidade ) - opcoes.reducao_do_peso );
+
+		lista_aberta.limpar();
+
+		for(
+			int i = 0;
+			i < (int) tocadas.size();
+			i++
+		){
+			const int posicao        = tocadas[i];
+			const int estado_do_node = estado_na_geracao( estado_dos_nodes[posicao], geracao );
+
+			if(
+				estado_do_node == 1 || estado_do_node == 4
+			){
+				estado_dos_nodes[posicao] = aberto;
+
+				lista_aberta.inserir(
+					posicao,
+					custo_dos_nodes[posicao] + peso * distancia_diagonal( ir_ao_gol, posicao / QUANT_COLUNAS, posicao % QUANT_COLUNAS, end_linha, end_coluna ),
+					custo_dos_nodes[posicao]
+				);
+			}
+			else if(
+				estado_do_node == 2
+			){
+				estado_dos_nodes[posicao] = conhecido;
+			}
+		}
+	}
+}
+
+
+#define TAMANHO_DO_BLOCO 5  // 0.5m por bloco do quadro grosso
+#define LINHAS_GROSSAS   ( ( QUANT_LINHAS  + TAMANHO_DO_BLOCO - 1 ) / TAMANHO_DO_BLOCO )
+#define COLUNAS_GROSSAS  ( ( QUANT_COLUNAS + TAMANHO_DO_BLOCO - 1 ) / TAMANHO_DO_BLOCO )
+#define BLOCO_NAO_AVALIADO -2.f
+
+inline float
+avaliar_bloco(
+	PlanoGrosso& plano,
+	int          bloco,
+	const float* quadro_de_custo,
+	int limite_para_qual_custo_eh_impossivel,
+	int linha_min,  int linha_max,
+	int coluna_min, int coluna_max
+){
+	/*
+	Descrio:
+		Max-pooling de um bloco do quadro grosso: o pior custo de entrar numa
+		das suas clulas dentro da janela. Tambm guarda uma clula objetivo
+		do bloco, se houver.
+
+		S  feito quando a busca grossa toca o bloco pela primeira vez. Ela
+		costuma tocar poucas centenas dos ~3 mil blocos, e passar pelo campo
+		inteiro custaria mais que a prpria busca fina.
+
+	Retorno:
+		O custo do bloco, -1 se todas as clulas so impossveis.
+	*/
+	float& custo_do_bloco = plano.custo_do_bloco[bloco];
+
+	if(
+		custo_do_bloco != BLOCO_NAO_AVALIADO
+	){
+		return custo_do_bloco;
+	}
+
+	const int bl = bloco / COLUNAS_GROSSAS;
+	const int bc = bloco % COLUNAS_GROSSAS;
+
+	const int primeira_linha  = max( linha_min,  bl * TAMANHO_DO_BLOCO );
+	const int ultima_linha    = min( linha_max,  bl * TAMANHO_DO_BLOCO + TAMANHO_DO_BLOCO - 1 );
+	const int primeira_coluna = max( coluna_min, bc * TAMANHO_DO_BLOCO );
+	const int ultima_coluna   = min( coluna_max, bc * TAMANHO_DO_BLOCO + TAMANHO_DO_BLOCO - 1 );
+
+	float pior      = 0;
+	bool  possivel  = false;
+	int   objetivo  = -1;
+
+	for(
+		int linha = primeira_linha;
+		linha <= ultima_linha;
+		linha++
+	){
+		for(
+			int coluna = primeira_coluna;
+			coluna <= ultima_coluna;
+			coluna++
+		){
+			const float custo = quadro_de_custo[ linha * QUANT_COLUNAS + coluna ];
+
+			// Mesma conta de custo_de_entrar(), sem fmaxf, que aqui vira chamada de funo.
+			const float entrar = custo <= limite_para_qual_custo_eh_impossivel ? 100.f : ( custo > 0 ? custo : 0.f );
+
+			pior     = entrar > pior ? entrar : pior;
+			possivel = possivel || custo > limite_para_qual_custo_eh_impossivel;
+
+			if(
+				custo == -1 && objetivo == -1
+			){
+				objetivo = linha * QUANT_COLUNAS + coluna;
+			}
+		}
+	}
+
+	plano.objetivo_no_bloco[bloco] = objetivo;
+	custo_do_bloco = possivel ? pior : -1.f;
+
+	return custo_do_bloco;
+}
+
+
+inline bool
+busca_em_dois_niveis(
+	ContextoDePlanejamento& contexto,
+	const OpcoesDeBusca&    opcoes,
+	unsigned short          geracao,
+	float*                  quadro_de_custo,
+	int   limite_para_qual_custo_eh_impossivel,
+	bool  ir_ao_gol,
+	int   start_pos,
+	int   end_linha,  int end_coluna,
+	int   linha_min,  int linha_max,
+	int   coluna_min, int coluna_max,
+	float alvo_x,     float alvo_y,
+	const high_resolution_clock::time_point& inicio,
+	int   tempo_limite
+){
+	/*
+	Descrio:
+		Planejamento em dois nveis, escolhido por OpcoesDeBusca::em_dois_niveis.
+		Chamado por buscar_caminho() com o quadro de custo, o objetivo e a
+		janela de busca prontos, como busca_em_qualquer_tempo().
+
+		1. Cada bloco de TAMANHO_DO_BLOCO x TAMANHO_DO_BLOCO clulas da janela
+		   vira uma clula grossa com o pior custo de entrar nas suas clulas
+		   (max-pooling), veja avaliar_bloco(). Blocos inteiramente
+		   impossveis so proibidos, os parcialmente impossveis s ficam
+		   caros, para que uma brecha estreita ainda possa ser tentada pela
+		   busca fina.
+		2. Um A* no quadro grosso, de ~3 mil blocos, acha o corredor at o
+		   objetivo.
+		3. O horizonte  o primeiro bloco do corredor a mais de horizonte_fino
+		   metros do incio. O A* fino vai at a melhor clula desse bloco,
+		   s na janela dos blocos do corredor at ali, com um bloco de folga.
+		4. O caminho final  o fino mais os centros dos blocos restantes do
+		   corredor. O custo soma o fino e o grosso dali em diante.
+
+		As clulas alm do horizonte nunca so expandidas. Como o caminho 
+		refeito a cada ciclo, s o trecho perto do rob precisa ser preciso.
+
+	Retorno:
+		False se a consulta deve seguir a busca normal: objetivo mais perto
+		que o horizonte, alvo impossvel, quadro grosso sem caminho ou
+		horizonte inalcanvel pela busca fina. Nesse ltimo caso a busca
+		fina j usou 'geracao', e quem chamou precisa de uma nova.
+	*/
+	PlanoGrosso& plano = contexto.plano_grosso;
+
+	const int quantidade_de_blocos = LINHAS_GROSSAS * COLUNAS_GROSSAS;
+
+	if(
+		(int) plano.g.size() != quantidade_de_blocos
+	){
+		plano.custo_do_bloco   .resize( quantidade_de_blocos );
+		plano.objetivo_no_bloco.resize( quantidade_de_blocos );
+		plano.g                .resize( quantidade_de_blocos );
+		plano.pai              .resize( quantidade_de_blocos );
+	}
+
+	if(
+		// O A* comum devolve o melhor pedao de caminho at um alvo impossvel, deixamos com ele.
+		!ir_ao_gol && quadro_de_custo[ end_linha * QUANT_COLUNAS + end_coluna ] != -1
+	){
+		return false;
+	}
+
+	if(
+		// Objetivo a menos de um horizonte em linha reta, nem vale montar o quadro grosso.
+		distancia_diagonal( ir_ao_gol, start_pos / QUANT_COLUNAS, start_pos % QUANT_COLUNAS, end_linha, end_coluna ) <= opcoes.horizonte_fino * 10.f
+	){
+		return false;
+	}
+
+	/////////////////////////////////////////////////////////////////
+	/// Quadro grosso, s nos blocos que tocam a janela
+	/////////////////////////////////////////////////////////////////
+
+	const int bloco_linha_min  = linha_min  / TAMANHO_DO_BLOCO;
+	const int bloco_linha_max  = linha_max  / TAMANHO_DO_BLOCO;
+	const int bloco_coluna_min = coluna_min / TAMANHO_DO_BLOCO;
+	const int bloco_coluna_max = coluna_max / TAMANHO_DO_BLOCO;
+
+	const int start_bloco = ( start_pos / QUANT_COLUNAS / TAMANHO_DO_BLOCO ) * COLUNAS_GROSSAS + ( start_pos % QUANT_COLUNAS ) / TAMANHO_DO_BLOCO;
+
+	for(
+		int bl = bloco_linha_min;
+		bl <= bloco_linha_max;
+		bl++
+	){
+		for(
+			int bc = bloco_coluna_min;
+			bc <= bloco_coluna_max;
+			bc++
+		){
+			plano.custo_do_bloco[ bl * COLUNAS_GROSSAS + bc ] = BLOCO_NAO_AVALIADO;
+			plano.g             [ bl * COLUNAS_GROSSAS + bc ] = INFINITO;
+		}
+	}
+
+	// Avaliamos j o bloco do incio, que nunca  proibido, mesmo se comeamos dentro de um obstculo.
+	avaliar_bloco( plano, start_bloco, quadro_de_custo, limite_para_qual_custo_eh_impossivel, linha_min, linha_max, coluna_min, coluna_max );
+	plano.custo_do_bloco[start_bloco] = fmaxf( 0.f, plano.custo_do_bloco[start_bloco] );
+
+	/////////////////////////////////////////////////////////////////
+	/// A* grosso
+	/////////////////////////////////////////////////////////////////
+
+	/*
+	Atravessar um bloco custa TAMANHO_DO_BLOCO passos finos, cada um pagando
+	o pior custo do bloco. A heurstica  a do A* fino, a partir do centro.
+	*/
+	std::vector<std::pair<float, int>>& fila = plano.fila;
+	fila.clear();
+
+	plano.g  [start_bloco] = 0;
+	plano.pai[start_bloco] = -1;
+	fila.push_back( std::make_pair( 0.f, start_bloco ) );
+
+	int objetivo_grosso = -1;
+
+	while(
+		!fila.empty()
+	){
+		std::pop_heap( fila.begin(), fila.end(), std::greater<std::pair<float, int>>() );
+		const std::pair<float, int> topo = fila.back();
+		fila.pop_back();
+
+		const int bloco = topo.second;
+		const int bl    = bloco / COLUNAS_GROSSAS;
+		const int bc    = bloco % COLUNAS_GROSSAS;
+
+		if(
+			// Cpia velha, o bloco j saiu com um valor menor.
+			topo.first > plano.g[bloco] + distancia_diagonal(
+				ir_ao_gol,
+				bl * TAMANHO_DO_BLOCO + TAMANHO_DO_BLOCO / 2, bc * TAMANHO_DO_BLOCO + TAMANHO_DO_BLOCO / 2,
+				end_linha, end_coluna
+			) + 1e-3f
+		){
+			continue;
+		}
+
+		contexto.expansoes_na_ultima_busca++;
+
+		if(
+			ir_ao_gol ? plano.objetivo_no_bloco[bloco] != -1 : bloco == ( end_linha / TAMANHO_DO_BLOCO ) * COLUNAS_GROSSAS + end_coluna / TAMANHO_DO_BLOCO
+		){
+			objetivo_grosso = bloco;
+			break;
+		}
+
+		for(
+			int v = 0;
+			v < 8;
+			v++
+		){
+			const int vl = bl + vizinhos_linha [v];
+			const int vc = bc + vizinhos_coluna[v];
+
+			if(
+				vl < bloco_linha_min || vl > bloco_linha_max || vc < bloco_coluna_min || vc > bloco_coluna_max
+			){
+				continue;
+			}
+
+			const int   vizinho = vl * COLUNAS_GROSSAS + vc;
+			const float custo   = avaliar_bloco(
+				plano,
+				vizinho,
+				quadro_de_custo,
+				limite_para_qual_custo_eh_impossivel,
+				linha_min,  linha_max,
+				coluna_min, coluna_max
+			);
+
+			if(
+				custo < 0
+			){
+				continue;
+			}
+
+			const float novo_g = plano.g[bloco] + TAMANHO_DO_BLOCO * ( vizinhos_passo[v] + custo );
+
+			if(
+				novo_g >= plano.g[vizinho]
+			){
+				continue;
+			}
+
+			plano.g  [vizinho] = novo_g;
+			plano.pai[vizinho] = bloco;
+
+			fila.push_back( std::make_pair(
+				novo_g + distancia_diagonal(
+					ir_ao_gol,
+					vl * TAMANHO_DO_BLOCO + TAMANHO_DO_BLOCO / 2, vc * TAMANHO_DO_BLOCO + TAMANHO_DO_BLOCO / 2,
+					end_linha, end_coluna
+				),
+				vizinho
+			) );
+			std::push_heap( fila.begin(), fila.end(), std::greater<std::pair<float, int>>() );
+		}
+	}
+
+	if(
+		objetivo_grosso == -1
+	){
+		return false;
+	}
+
+	std::vector<int>& corredor = plano.caminho;
+	corredor.clear();
+
+	for(
+		int bloco = objetivo_grosso;
+		bloco != -1;
+		bloco = plano.pai[bloco]
+	){
+		corredor.push_back( bloco );
+	}
+
+	std::reverse( corredor.begin(), corredor.end() );
+
+	/////////////////////////////////////////////////////////////////
+	/// Horizonte e janela da busca fina
+	/////////////////////////////////////////////////////////////////
+
+	const int   start_linha  = start_pos / QUANT_COLUNAS;
+	const int   start_coluna = start_pos % QUANT_COLUNAS;
+	const float horizonte    = opcoes.horizonte_fino * 10.f;
+
+	int horizonte_no_corredor = -1;
+
+	int janela_linha_min  = start_linha,  janela_linha_max  = start_linha;
+	int janela_coluna_min = start_coluna, janela_coluna_max = start_coluna;
+
+	for(
+		int i = 0;
+		i < (int) corredor.size() - 1;  // O bloco do objetivo no serve de horizonte.
+		i++
+	){
+		const int bl = corredor[i] / COLUNAS_GROSSAS;
+		const int bc = corredor[i] % COLUNAS_GROSSAS;
+
+		janela_linha_min  = min( janela_linha_min,  ( bl - 1 ) * TAMANHO_DO_BLOCO                        );
+		janela_linha_max  = max( janela_linha_max,  ( bl + 2 ) * TAMANHO_DO_BLOCO - 1                    );
+		janela_coluna_min = min( janela_coluna_min, ( bc - 1 ) * TAMANHO_DO_BLOCO                        );
+		janela_coluna_max = max( janela_coluna_max, ( bc + 2 ) * TAMANHO_DO_BLOCO - 1                    );
+
+		const float dl = bl * TAMANHO_DO_BLOCO + TAMANHO_DO_BLOCO / 2 - start_linha;
+		const float dc = bc * TAMANHO_DO_BLOCO + TAMANHO_DO_BLOCO / 2 - start_coluna;
+
+		if(
+			dl * dl + dc * dc > horizonte * horizonte
+		){
+			horizonte_no_corredor = i;
+			break;
+		}
+	}
+
+	if(
+		// O objetivo est dentro do horizonte, a busca normal j  curta.
+		horizonte_no_corredor == -1
+	){
+		return false;
+	}
+
+	janela_linha_min  = max( janela_linha_min,  linha_min  );
+	janela_linha_max  = min( janela_linha_max,  linha_max  );
+	janela_coluna_min = max( janela_coluna_min, coluna_min );
+	janela_coluna_max = min( janela_coluna_max, coluna_max );
+
+	/*
+	Alvo da busca fina: a clula mais barata do bloco do horizonte, e entre
+	as mais baratas a mais perto do centro.
+	*/
+	const int horizonte_linha  = ( corredor[horizonte_no_corredor] / COLUNAS_GROSSAS ) * TAMANHO_DO_BLOCO;
+	const int horizonte_coluna = ( corredor[horizonte_no_corredor] % COLUNAS_GROSSAS ) * TAMANHO_DO_BLOCO;
+
+	int   alvo_fino        = -1;
+	float melhor_custo     = INFINITO;
+	int   melhor_distancia = 0;
+
+	for(
+		int linha = max( linha_min, horizonte_linha );
+		linha <= min( linha_max, horizonte_linha + TAMANHO_DO_BLOCO - 1 );
+		linha++
+	){
+		for(
+			int coluna = max( coluna_min, horizonte_coluna );
+			coluna <= min( coluna_max, horizonte_coluna + TAMANHO_DO_BLOCO - 1 );
+			coluna++
+		){
+			const float custo = quadro_de_custo[ linha * QUANT_COLUNAS + coluna ];
+
+			if(
+				custo <= limite_para_qual_custo_eh_impossivel
+			){
+				continue;
+			}
+
+			const int distancia = abs( linha - horizonte_linha - TAMANHO_DO_BLOCO / 2 ) + abs( coluna - horizonte_coluna - TAMANHO_DO_BLOCO / 2 );
+
+			if(
+				fmaxf( 0.f, custo ) < melhor_custo || ( fmaxf( 0.f, custo ) == melhor_custo && distancia < melhor_distancia )
+			){
+				alvo_fino        = linha * QUANT_COLUNAS + coluna;
+				melhor_custo     = fmaxf( 0.f, custo );
+				melhor_distancia = distancia;
+			}
+		}
+	}
+
+	if(
+		alvo_fino == -1
+	){
+		return false;
+	}
+
+	/////////////////////////////////////////////////////////////////
+	/// Busca fina at o horizonte
+	/////////////////////////////////////////////////////////////////
+
+	/*
+	Durante a busca fina, o nico objetivo  o alvo fino. Objetivos de
+	verdade que caiam na janela voltam a valer 0 e so restaurados depois.
+	*/
+	plano.desmarcados.clear();
+
+	for(
+		int linha = janela_linha_min;
+		linha <= janela_linha_max;
+		linha++
+	){
+		for(
+			int coluna = janela_coluna_min;
+			coluna <= janela_coluna_max;
+			coluna++
+		){
+			if(
+				quadro_de_custo[ linha * QUANT_COLUNAS + coluna ] == -1
+			){
+				quadro_de_custo[ linha * QUANT_COLUNAS + coluna ] = 0;
+				plano.desmarcados.push_back( linha * QUANT_COLUNAS + coluna );
+			}
+		}
+	}
+
+	const float custo_original_do_alvo_fino = quadro_de_custo[alvo_fino];
+	quadro_de_custo[alvo_fino] = -1;
+
+	// Peso 1 faz da busca em qualquer tempo um A* comum, que para no primeiro caminho.
+	OpcoesDeBusca busca_fina;
+	busca_fina.peso_inicial = 1.f;
+
+	busca_em_qualquer_tempo(
+		contexto,
+		busca_fina,
+		geracao,
+		quadro_de_custo,
+		limite_para_qual_custo_eh_impossivel,
+		false,
+		start_pos,
+		alvo_fino / QUANT_COLUNAS, alvo_fino % QUANT_COLUNAS,
+		janela_linha_min,  janela_linha_max,
+		janela_coluna_min, janela_coluna_max,
+		( alvo_fino / QUANT_COLUNAS ) / 10.f - 16.f,
+		( alvo_fino % QUANT_COLUNAS ) / 10.f - 11.f,
+		inicio,
+		tempo_limite
+	);
+
+	quadro_de_custo[alvo_fino] = custo_original_do_alvo_fino;
+
+	for(
+		int i = 0;
+		i < (int) plano.desmarcados.size();
+		i++
+	){
+		quadro_de_custo[ plano.desmarcados[i] ] = -1;
+	}
+
+	float*     caminho_final = contexto.caminho_final;
+	int&       tamanho       = contexto.tamanho_do_caminho_final;
+	const int  status        = (int) caminho_final[ tamanho - 2 ];
+
+	if(
+		status == 2
+	){
+		// O corredor grosso enganou, por exemplo numa brecha estreita demais.
+		return false;
+	}
+
+	if(
+		// Tempo esgotado, fica o pedao de caminho rumo ao horizonte.
+		status != 0
+	){
+		return true;
+	}
+
+	/////////////////////////////////////////////////////////////////
+	/// Caminho grosso do horizonte em diante
+	/////////////////////////////////////////////////////////////////
+
+	const float custo_fino = caminho_final[ tamanho - 1 ];
+	tamanho -= 2;
+
+	for(
+		int i = horizonte_no_corredor + 1;
+		i < (int) corredor.size() - 1 && tamanho + 2 <= 2048 - 2;
+		i++
+	){
+		caminho_final[ tamanho++ ] = ( ( corredor[i] / COLUNAS_GROSSAS ) * TAMANHO_DO_BLOCO + TAMANHO_DO_BLOCO / 2 ) / 10.f - 16.f;
+		caminho_final[ tamanho++ ] = ( ( corredor[i] % COLUNAS_GROSSAS ) * TAMANHO_DO_BLOCO + TAMANHO_DO_BLOCO / 2 ) / 10.f - 11.f;
+	}
+
+	// O ltimo ponto  o mesmo que a busca normal devolveria.
+	const int objetivo = plano.objetivo_no_bloco[objetivo_grosso];
+
+	caminho_final[ tamanho++ ] = ir_ao_gol ? ( objetivo / QUANT_COLUNAS ) / 10.f - 16.f : alvo_x;
+	caminho_final[ tamanho++ ] = ir_ao_gol ? ( objetivo % QUANT_COLUNAS ) / 10.f - 11.f : alvo_y;
+
+	caminho_final[ tamanho++ ] = 0;  // Sucesso
+	caminho_final[ tamanho++ ] = custo_fino + ( plano.g[objetivo_grosso] - plano.g[ corredor[horizonte_no_corredor] ] ) / 10.f;
+
+	// O trecho grosso no tem garantia de custo.
+	contexto.fator_de_suboptimalidade = INFINITO;
+
+	return true;
+}
+
+
+inline bool
+procurar_no_cache(
+	ContextoDePlanejamento& contexto,
+	const ChaveDoCache&     chave,
+	bool                    ir_ao_gol,
+	float                   alvo_x,
+	float                   alvo_y
+){
+	/*
+	Descrio:
+		Procura a chave no CacheDeCaminhos do contexto e, se achar, copia o
+		caminho guardado para o caminho final, como se a busca tivesse
+		acabado de rodar.
+
+		O caminho guardado  clula a clula, como o da busca, exceto pelo
+		ltimo ponto de um sucesso com alvo opcional, que  o alvo exato
+		da consulta que o guardou. Trocamos esse ponto pelo alvo desta
+		consulta, que cai na mesma clula, e o resultado fica idntico ao
+		de uma busca nova.
+
+	Retorno:
+		Se o caminho veio do cache.
+	*/
+	CacheDeCaminhos& cache = contexto.cache_de_caminhos;
+
+	for(
+		int i = 0;
+		i < (int) cache.entradas.size();
+		i++
+	){
+		CacheDeCaminhos::Entrada& entrada = cache.entradas[i];
+
+		if(
+			entrada.ultimo_uso == 0 || !( entrada.chave == chave )
+		){
+			continue;
+		}
+
+		entrada.ultimo_uso = ++cache.relogio;
+
+		const int tamanho = (int) entrada.caminho.size();
+
+		std::copy( entrada.caminho.begin(), entrada.caminho.end(), contexto.caminho_final );
+		contexto.tamanho_do_caminho_final = tamanho;
+		contexto.fator_de_suboptimalidade = entrada.fator_de_suboptimalidade;
+
+		if(
+			!ir_ao_gol && contexto.caminho_final[ tamanho - 2 ] == 0
+		){
+			contexto.caminho_final[ tamanho - 4 ] = alvo_x;
+			contexto.caminho_final[ tamanho - 3 ] = alvo_y;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+
+inline void
+guardar_no_cache(
+	ContextoDePlanejamento& contexto
+){
+	/*
+	Descrio:
+		Guarda o caminho final sob a chave montada por buscar_caminho(),
+		no lugar da entrada usada h mais tempo. Chamado por a_estrela()
+		depois da suavizao, logo um acerto no precisa suavizar de novo.
+	*/
+	CacheDeCaminhos& cache = contexto.cache_de_caminhos;
+
+	int menos_usada = 0;
+
+	for(
+		int i = 1;
+		i < (int) cache.entradas.size();
+		i++
+	){
+		if(
+			cache.entradas[i].ultimo_uso < cache.entradas[ menos_usada ].ultimo_uso
+		){
+			menos_usada = i;
+		}
+	}
+
+	CacheDeCaminhos::Entrada& entrada = cache.entradas[ menos_usada ];
+
+	entrada.chave                    = cache.chave_da_chamada;
+	entrada.ultimo_uso               = ++cache.relogio;
+	entrada.fator_de_suboptimalidade = contexto.fator_de_suboptimalidade;
+	entrada.caminho.assign(
+		contexto.caminho_final,
+		contexto.caminho_final + contexto.tamanho_do_caminho_final
+	);
+}
+
+
+static void
+buscar_caminho(
+	ContextoDePlanejamento& contexto,
+	float parametros[],
+	int quantidade_de_parametros,
+	const OpcoesDeBusca& opcoes
+){
+	/*
+	Descrio:
+		Responsvel por computar o melhor caminho possvel usando
+		a mtrica de distncia exclusiva e algoritmo A*.
+		
+		Tudo que a busca escreve pertence ao contexto, logo a funo 
+		reentrante: chamadas simultneas com contextos distintos so seguras.
+
+		O caminho  expandido a partir da funo expandir_filho()
+		presente em noding.
+		
+	Parmetros:
+		[start x][start y]						-> posio inicial
+		[allow out of bounds?]					-> se est permitido sair dos limites
+		[go to goal?]							-> se h um objetivo  
+		[optional target x][optional target y]	-> posio do objetivo opcional
+		[timeout]								-> tempo limite de busca
+		[x][y][hard radius][soft radius][force] -> descrio dos obstculos
+
+		opcoes -> escolhas da consulta que no esto no vetor, veja OpcoesDeBusca.
+
+	Retorno:
+		No h retorno prvio, dado que esta funo calcula os nodes
+		que representam o melhor caminho, em seguida passa para construir_caminho_final()
+		a fim de popular o array de caminho do contexto.
+	*/
+	
+	//////////////////////////////////////////////////////////////////////
+	/// Extrao de Informaes dos Argumentos
+	//////////////////////////////////////////////////////////////////////
+	
+	// Auto permite que ns no nos importemos com o tipo fornecido.
+	// Pq apesar de saber que  uma unidade de tempo, o ngc  louco.
+	auto inicio = high_resolution_clock::now();
+	
+	const float start_x = parametros[ 0 ];
+	const float start_y = parametros[ 1 ];
+	
+	const bool permissao_para_ir_para_alem_dos_limites = parametros[2];
+	const int limite_para_qual_custo_eh_impossivel = permissao_para_ir_para_alem_dos_limites ? - 3 : - 2;
+		
+	const bool ir_ao_gol = parametros[ 3 ];
+	
+	const float alvo_opcional_x = parametros[ 4 ];
+	const float alvo_opcional_y = parametros[ 5 ];
+	
+	const int tempo_limite = parametros[ 6 ];  // para limitarmos o tempo de busca.
+	
+	float *obstaculos = parametros + 7;  // Aritmtica de Ponteiros
+	int quantidade_de_obstaculos = quantidade_de_parametros - 7;
+
+	contexto.expansoes_na_ultima_busca = 0;
+	contexto.fator_de_suboptimalidade  = 1.f;
+
+	// Cada etapa  medida do fim da anterior at o seu fim.
+	EstatisticasDaBusca&              estatisticas = contexto.estatisticas_da_ultima_busca;
+	high_resolution_clock::time_point etapa        = inicio;
+
+	/*
+	Antes, o campo era montado na pilha a partir das macros L0_1 ... L310_314
+	e o amortecimento reaplicado a cada chamada, ou seja, 70 mil clulas
+	escritas s para comear. Agora partimos do quadro base pronto e s
+	restauramos o que a chamada anterior sujou.
+	*/
+	/*
+	Os obstculos so convertidos uma nica vez, aqui, e servem tanto ao
+	teste do caminho direto quanto ao carimbo mais abaixo.
+	*/
+	FaseLarga& fase_larga = contexto.fase_larga;
+
+	montar_fase_larga(
+		fase_larga,
+		obstaculos,
+		quantidade_de_obstaculos
+	);
+
+	/*
+	O teste do caminho direto s l as clulas do incio e do fim, que ainda
+	no tm obstculos, logo o quadro base basta. Antes ele vinha depois de
+	preparar_quadro_de_custo(), e um caminho livre pagava para restaurar
+	todas as linhas que a chamada anterior sujou.
+	*/
+	if(
+		!se_caminho_esta_obstruido(
+			contexto,
+			start_x,
+			start_y,
+			alvo_opcional_x,
+			alvo_opcional_y,
+			fase_larga,
+			ir_ao_gol,
+			limite_para_qual_custo_eh_impossivel,
+			quadro_base_do_campo( permissao_para_ir_para_alem_dos_limites )
+		)
+	){
+		estatisticas.tempo_do_atalho  = medir_etapa( etapa );
+		estatisticas.caminhos_diretos = 1;
+
+		// Retorna o caminho caso no esteja obstrudo
+		return;
+	}
+
+	estatisticas.tempo_do_atalho = medir_etapa( etapa );
+
+	if(
+		opcoes.usar_cache
+	){
+		/*
+		S agora, pois o caminho direto depende dos floats exatos de incio
+		e alvo, e a chave s enxerga clulas.
+		*/
+		CacheDeCaminhos& cache = contexto.cache_de_caminhos;
+		ChaveDoCache&    chave = cache.chave_da_chamada;
+
+		chave.inicio = x_para_linha( start_x ) * QUANT_COLUNAS + y_para_col( start_y );
+		chave.fim    = ir_ao_gol ? -1 : x_para_linha( alvo_opcional_x ) * QUANT_COLUNAS + y_para_col( alvo_opcional_y );
+		chave.modos  = ( permissao_para_ir_para_alem_dos_limites ? 1u : 0u ) |
+		               ( opcoes.pontos_de_salto                  ? 2u : 0u ) |
+		               ( opcoes.qualquer_angulo                  ? 4u : 0u ) |
+		               ( opcoes.em_dois_niveis                   ? 8u : 0u );
+		chave.horizonte_fino           = opcoes.em_dois_niveis ? opcoes.horizonte_fino : 0.f;
+		chave.quantidade_de_obstaculos = (int) fase_larga.convertidos.size();
+		chave.obstaculos               = fase_larga.resumo;
+
+		if(
+			procurar_no_cache(
+				contexto,
+				chave,
+				ir_ao_gol,
+				alvo_opcional_x,
+				alvo_opcional_y
+			)
+		){
+			cache.veio_do_cache           = true;
+			estatisticas.acertos_no_cache = 1;
+			estatisticas.tempo_de_reconstrucao = medir_etapa( etapa );
+
+			return;
+		}
+
+		// Quem depende do relgio no vai para o cache, veja OpcoesDeBusca::usar_cache.
+		cache.guardar_ao_fim = !opcoes.em_qualquer_tempo;
+	}
+
+	float* quadro_de_custo = preparar_quadro_de_custo(
+		contexto,
+		permissao_para_ir_para_alem_dos_limites
+	);
+
+	estatisticas.tempo_de_preparo = medir_etapa( etapa );
+
+	const int start_linha = x_para_linha(
+		start_x
+	);
+	const int start_coluna = y_para_col(
+		start_y
+	);
+	const int start_pos = start_linha * QUANT_COLUNAS + start_coluna;
+	
+	////////////////////////////////////////////////////////////////////
+	/// Definimos objetivo.
+	////////////////////////////////////////////////////////////////////
+	
+	int end_linha  = 0;
+	int end_coluna = 0;
+	if(
+		!ir_ao_gol
+	){
+		end_linha  = x_para_linha( alvo_opcional_x );
+		end_coluna = y_para_col  ( alvo_opcional_y );
+	}
+	else{
+		end_linha = Campo::linha_do_gol;
+	}
+	
+	////////////////////////////////////////////////////////////////////
+	/// Limites de Borda
+	////////////////////////////////////////////////////////////////////
+	
+	int linha_min = min( start_linha, end_linha );
+	int linha_max = max( start_linha, end_linha );
+	
+	int coluna_min = 0;
+	int coluna_max = 0;
+	
+	if(
+		ir_ao_gol
+	){
+		coluna_min = min( start_coluna, Campo::ultima_coluna_do_gol   );
+		coluna_max = max( start_coluna, Campo::primeira_coluna_do_gol );
+	}
+	else{
+		coluna_min = min( start_coluna, end_coluna );
+		coluna_max = max( start_coluna, end_coluna );
+	}
+	
+	if(
+		/*
+		Devemos limitar mais caso no seja permitir sair, para desincentivar
+		ainda mais a sada.
+		*/
+		!permissao_para_ir_para_alem_dos_limites
+	){
+		// Duas clulas para dentro do ltimo ponto livre do campo.
+		linha_min  = min( linha_min,  Campo::linha_do_meio  + Campo::fim_do_campo_em_x - 2 );
+		linha_max  = max( Campo::linha_do_meio  - Campo::fim_do_campo_em_x + 2, linha_max  );
+		coluna_min = min( coluna_min, Campo::coluna_do_meio + Campo::fim_do_campo_em_y - 2 );
+		coluna_max = max( Campo::coluna_do_meio - Campo::fim_do_campo_em_y + 2, coluna_max );
+	}
+
+	////////////////////////////////////////////////////////////////////
+	/// Algoritmo A*
+	////////////////////////////////////////////////////////////////////
+	
+	/*
+	Tudo vem do contexto. Antes os ns e seus estados viviam na pilha,
+	ocupando mais de 3MB a cada chamada.
+	*/
+	ListaAberta&   lista_aberta      = *contexto.lista_aberta;
+	float*         custo_dos_nodes   = contexto.custo_dos_nodes;
+	int*           parente_dos_nodes = contexto.parente_dos_nodes;
+	unsigned short* estado_dos_nodes = contexto.estado_dos_nodes;
+	
+	lista_aberta.limpar();
+	
+	/*
+	0 -> Desconhecido
+	1 -> Aberto
+	2 -> Fechado
+
+	Antes zervamos as 70 mil posies aqui, mesmo que a busca s visitasse
+	algumas dezenas. Agora cada busca tem a sua gerao, e as marcas das
+	anteriores valem como desconhecido. Veja estado_na_geracao().
+	*/
+	unsigned short geracao = proxima_geracao( contexto );
+	
+	///////////////////////////////////////////////////////////////////
+	/// Populamos com obstculos
+	///////////////////////////////////////////////////////////////////
+	
+	for(
+		int ob = 0;
+		ob < (int) fase_larga.convertidos.size();
+		ob++
+	){
+		const ObstaculoNoQuadro& obstaculo = fase_larga.convertidos[ ob ];
+
+		const int linha    = obstaculo.linha;
+		const int coluna   = obstaculo.coluna;
+		const int raio_max = obstaculo.raio_max;
+
+		linha_min  = min( linha_min,  linha  - raio_max - 1 );
+		linha_max  = max( linha_max,  linha  + raio_max + 1 );
+		coluna_min = min( coluna_min, coluna - raio_max - 1 );
+		coluna_max = max( coluna_max, coluna + raio_max + 1 );
+		
+		
+		marcar_linhas_sujas(
+			contexto,
+			linha - raio_max - 1,
+			linha + raio_max + 1
+		);
+		
+		carimbar_obstaculo(
+			quadro_de_custo,
+			linha,
+			coluna,
+			obstaculo.raio_hard,
+			obstaculo.raio_soft,
+			obstaculo.forca,
+			limite_para_qual_custo_eh_impossivel
+		);
+	}
+	
+	///////////////////////////////////////////////////////////////////
+	/// Ajustes finos
+	///////////////////////////////////////////////////////////////////
+	
+	/*
+	Ajustamos limites de borda caso a rea disponvel esteja sobrepondo
+	rea dos gols.
+	
+	As caixas dos gols vm da geometria do campo, veja CampoNoQuadro em campo.h.
+	*/
+	const int coluna_min_do_gol = Campo::coluna_do_meio - Campo::meia_largura_da_caixa;
+	const int coluna_max_do_gol = Campo::coluna_do_meio + Campo::meia_largura_da_caixa;
+
+	if(
+		coluna_max > coluna_min_do_gol and coluna_min < coluna_max_do_gol
+	){
+		const int nosso_gol_min = Campo::linha_do_meio - Campo::fim_da_caixa_do_gol;
+		const int nosso_gol_max = Campo::linha_do_meio - Campo::inicio_da_caixa_do_gol;
+		
+		if(
+			// Caso nosso gol esteja sendo sobreposto
+			linha_max > nosso_gol_min and linha_min < nosso_gol_max
+		){
+			// Extend working area to include our goal
+			linha_max  = max( nosso_gol_max,     linha_max  );
+			linha_min  = min( nosso_gol_min,     linha_min  );
+			coluna_max = max( coluna_max_do_gol, coluna_max );
+			coluna_min = min( coluna_min_do_gol, coluna_min );
+		}
+		
+		const int gol_deles_min = Campo::linha_do_meio + Campo::inicio_da_caixa_do_gol;
+		const int gol_deles_max = Campo::linha_do_meio + Campo::fim_da_caixa_do_gol;
+
+		if(
+			// Caso seja o gol deles.
+			linha_max > gol_deles_min and linha_min < gol_deles_max
+		){
+			// Extend working area to include their goal
+			linha_max  = max( gol_deles_max,     linha_max  );
+			linha_min  = min( gol_deles_min,     linha_min  );
+			coluna_max = max( coluna_max_do_gol, coluna_max );
+			coluna_min = min( coluna_min_do_gol, coluna_min );
+		}
+	}
+	
+	///////////////////////////////////////////////////////////////////
+	/// Adicionamos o objetivo
+	///////////////////////////////////////////////////////////////////
+	
+	/*
+	Caso o objetivo no esteja acessvel, no adicionamos ao mapa.
+	Embora sua referncia ainda exista.
+	
+	Portanto, ns saberemos o quo longe estamos da referncia, apesar dela
+	ser inacessvel. Mesmo se estivermos bem prximos ao objetivo, a ideia 
+	 se afastar para atingir o ponto vlido mais prximo que permitir a 
+	acessibilidade.
+	*/
+	
+	marcar_linhas_sujas(
+		contexto,
+		ir_ao_gol ? Campo::linha_do_gol : end_linha,
+		ir_ao_gol ? Campo::linha_do_gol : end_linha
+	);
+	
+	if(
+		!ir_ao_gol
+	){
+		float *custo_do_fim = &quadro_de_custo[
+			end_linha * QUANT_COLUNAS + end_coluna
+		];
+		
+		if(
+			*custo_do_fim > limite_para_qual_custo_eh_impossivel
+		){
+			
+			*custo_do_fim = -1;
+		}
+	}
+	else{
+		for(
+			int index = Campo::linha_do_gol * QUANT_COLUNAS + Campo::primeira_coluna_do_gol;
+			    index <= Campo::linha_do_gol * QUANT_COLUNAS + Campo::ultima_coluna_do_gol;
+			    index++
+		){
+			if(
+				quadro_de_custo[index] > limite_para_qual_custo_eh_impossivel
+			){
+				quadro_de_custo[index] = -1;
+			}
+		}
+	}
+
+	estatisticas.tempo_de_carimbo      = medir_etapa( etapa );
+	estatisticas.obstaculos_carimbados = fase_larga.convertidos.size();
+	
+	// Adicionamos novos limites de borda para restringir ainda mais espao
+	linha_max  = min( 320, linha_max);
+	linha_min  = max( 0,   linha_min);
+	coluna_max = min( 220, coluna_max);
+	coluna_min = max( 0,   coluna_min);
+	
+	if(
+		opcoes.em_dois_niveis
+	){
+		if(
+			busca_em_dois_niveis(
+				contexto,
+				opcoes,
+				geracao,
+				quadro_de_custo,
+				limite_para_qual_custo_eh_impossivel,
+				ir_ao_gol,
+				start_pos,
+				end_linha,  end_coluna,
+				linha_min,  linha_max,
+				coluna_min, coluna_max,
+				alvo_opcional_x,
+				alvo_opcional_y,
+				inicio,
+				tempo_limite
+			)
+		){
+			return;
+		}
+
+		// A busca fina pode ter usado a gerao, seguimos com uma nova.
+		geracao = proxima_geracao( contexto );
+	}
+
+	if(
+		opcoes.em_qualquer_tempo
+	){
+		busca_em_qualquer_tempo(
+			contexto,
+			opcoes,
+			geracao,
+			quadro_de_custo,
+			limite_para_qual_custo_eh_impossivel,
+			ir_ao_gol,
+			start_pos,
+			end_linha,  end_coluna,
+			linha_min,  linha_max,
+			coluna_min, coluna_max,
+			alvo_opcional_x,
+			alvo_opcional_y,
+			inicio,
+			tempo_limite
+		);
+
+		return;
+	}
+	
+	// Iniciamos o primeiro n.
+	// Fazemos um mnimo para nos basear a partir dele
+	custo_dos_nodes  [start_pos] = 0;
+	parente_dos_nodes[start_pos] = -1;  
+	lista_aberta.inserir( start_pos, 0, 0 );
+	int melhor_posicao = start_pos;
+
+	BuscaPorSaltos& saltos = *contexto.busca_por_saltos;
+	
+	if(
+		opcoes.pontos_de_salto
+	){
+		saltos.preparar(
+			lista_aberta,
+			custo_dos_nodes,
+			parente_dos_nodes,
+			estado_dos_nodes,
+			geracao,
+			quadro_de_custo,
+			limite_para_qual_custo_eh_impossivel,
+			ir_ao_gol,
+			end_linha,  end_coluna,
+			linha_min,  linha_max,
+			coluna_min, coluna_max
+		);
+	}
+
+	// infinite distance if start is itself unreachable
+	float distancia_ao_melhor_node = std::numeric_limits<float>::max();  // Apenas dizemos que  a maior possvel primeiro.
+	
+	/*
+	Caso ultrapasse essa medida, deve parar imediatamente e ficar com oq 
+	j tem.
+	*/
+	int medida_de_tempo_limite = 0;
+	
+	if(
+		quadro_de_custo[start_pos] > limite_para_qual_custo_eh_impossivel
+	){
+		
+		distancia_ao_melhor_node = distancia_diagonal(
+			ir_ao_gol,
+			start_linha,
+			start_coluna,
+			end_linha,
+			end_coluna
+		);
+	}
+	
+	////////////////////////////////////////////////////////////////////
+	/// Aplicao do Algoritmo A*
+	////////////////////////////////////////////////////////////////////
+	
+	while(
+		!lista_aberta.vazia()
+	){
+		
+		estatisticas.maior_lista_aberta = max( estatisticas.maior_lista_aberta, lista_aberta.tamanho() );
+
+		// Procuramos e retiramos o prximo melhor n.
+		const int pos_atual     = lista_aberta.extrair_min();
+		
+		const int linha_atual   = pos_atual / QUANT_COLUNAS; 
+		const int coluna_atual  = pos_atual % QUANT_COLUNAS;
+		const float custo_atual = quadro_de_custo[pos_atual];
+		
+		contexto.expansoes_na_ultima_busca++;
+		
+		medida_de_tempo_limite = (medida_de_tempo_limite + 1) % 31; // Checar o tempo a cada 32 iteraes
+		if(
+			custo_atual > limite_para_qual_custo_eh_impossivel
+		){
+			float dist_diagonal = distancia_diagonal(
+				ir_ao_gol,
+				linha_atual,
+				coluna_atual,
+				end_linha,
+				end_coluna
+			);
+			
+			if(
+				// Achamos um novo melhor node
+				distancia_ao_melhor_node > dist_diagonal
+			){
+				
+				melhor_posicao = pos_atual;
+				distancia_ao_melhor_node = dist_diagonal;
+			}
+		}
+		
+		estado_dos_nodes[pos_atual] = geracao + 1;  // fechado
+		
+		// Checamos se o objetivo foi atingido.
+		if(
+			custo_atual == -1
+		){
+			
+			if(
+				opcoes.pontos_de_salto
+			){
+				saltos.desdobrar( melhor_posicao );
+			}
+			
+			construir_caminho_final(
+				contexto,
+				melhor_posicao,
+				0, // Significa sucesso
+				!ir_ao_gol,
+				alvo_opcional_x,
+				alvo_opcional_y
+			);
+			
+			return;
+		}
+		
+		if(
+			(
+				medida_de_tempo_limite == 0
+			) && (
+				duration_cast<microseconds>( high_resolution_clock::now() - inicio).count() > tempo_limite
+			)
+		){
+			
+			if(
+				opcoes.pontos_de_salto
+			){
+				saltos.desdobrar( melhor_posicao );
+			}
+			
+			construir_caminho_final(
+				contexto,
+				melhor_posicao,
+				1 // Significa tempo excedido.
+			);
+			
+			return;
+		}
+		
+		/////////////////////////////////////////////////////////////////
+		/// Expandimos nodes filhos
+		/////////////////////////////////////////////////////////////////
+		
+		if(
+			opcoes.pontos_de_salto
+		){
+			saltos.expandir( pos_atual );
+			continue;
+		}
+		
+		bool rcol_ok = coluna_atual < coluna_max;
+		bool lcol_ok = coluna_atual > coluna_min;
+		
+		if(
+			linha_atual > linha_min
+		){
+			int linha  = linha_atual  - 1;
+			int coluna = coluna_atual - 1;
+			
+			int   posicao        = pos_atual - QUANT_COLUNAS - 1;
+			float custo          = quadro_de_custo [  posicao  ];
+			int   estado_do_node = estado_na_geracao( estado_dos_nodes[ posicao ], geracao );
+			
+			if(
+				/*
+				Checa se no  um obstculo e se o node no est fechado.
+				*/
+				(
+					estado_do_node != 2
+				) && !(
+					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
+				) && (
+					lcol_ok
+				)
+				
+			){
+				noding::expandir_filho(
+					lista_aberta,
+					custo,
+					limite_para_qual_custo_eh_impossivel,
+					pos_atual,
+					posicao,
+					estado_do_node,
+					ir_ao_gol,
+					linha,
+					coluna,
+					end_linha,
+					end_coluna,
+					custo_dos_nodes,
+					parente_dos_nodes,
+					estado_dos_nodes,
+					geracao,
+					SQRT_2 // Extra
+				);
+			}
+			
+			coluna++;
+			posicao++;
+			custo          = quadro_de_custo [ posicao ];
+			estado_do_node = estado_na_geracao( estado_dos_nodes[ posicao ], geracao );
+			
+			if(
+				(
+					estado_do_node != 2
+				) && !(
+					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
+				)
+			){
+				noding::expandir_filho(
+					lista_aberta,
+					custo,
+					limite_para_qual_custo_eh_impossivel,
+					pos_atual,
+					posicao,
+					estado_do_node,
+					ir_ao_gol,
+					linha,
+					coluna,
+					end_linha,
+					end_coluna,
+					custo_dos_nodes,
+					parente_dos_nodes,
+					estado_dos_nodes,
+					geracao,
+					1 // Extra
+				);
+			}
+			
+			coluna++;
+			posicao++;
+			custo          = quadro_de_custo [ posicao ];
+			estado_do_node = estado_na_geracao( estado_dos_nodes[ posicao ], geracao );
+			
+			if(
+				(
+					estado_do_node != 2
+				) && !(
+					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
+				) && (
+					rcol_ok
+				)
+			){
+				noding::expandir_filho(
+					lista_aberta,
+					custo,
+					limite_para_qual_custo_eh_impossivel,
+					pos_atual,
+					posicao,
+					estado_do_node,
+					ir_ao_gol,
+					linha,
+					coluna,
+					end_linha,
+					end_coluna,
+					custo_dos_nodes,
+					parente_dos_nodes,
+					estado_dos_nodes,
+					geracao,
+					SQRT_2 // Extra
+				);
+			}
+		}
+		
+		if(
+			linha_atual < linha_max
+		){
+			int linha   = linha_atual  + 1;
+			int coluna  = coluna_atual - 1;
+			
+			int   posicao        = pos_atual + QUANT_COLUNAS - 1;
+			float custo          = quadro_de_custo [  posicao  ];
+			int   estado_do_node = estado_na_geracao( estado_dos_nodes[ posicao ], geracao );
+			
+			if(
+				/*
+				Checa se no  um obstculo e se o node no est fechado.
+				*/
+				(
+					estado_do_node != 2
+				) && !(
+					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
+				) && (
+					lcol_ok
+				)
+				
+			){
+				noding::expandir_filho(
+					lista_aberta,
+					custo,
+					limite_para_qual_custo_eh_impossivel,
+					pos_atual,
+					posicao,
+					estado_do_node,
+					ir_ao_gol,
+					linha,
+					coluna,
+					end_linha,
+					end_coluna,
+					custo_dos_nodes,
+					parente_dos_nodes,
+					estado_dos_nodes,
+					geracao,
+					SQRT_2 // Extra
+				);
+			}
+			
+			coluna++;
+			posicao++;
+			custo          = quadro_de_custo [ posicao ];
+			estado_do_node = estado_na_geracao( estado_dos_nodes[ posicao ], geracao );
+			
+			if(
+				(
+					estado_do_node != 2
+				) && !(
+					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
+				)
+			){
+				noding::expandir_filho(
+					lista_aberta,
+					custo,
+					limite_para_qual_custo_eh_impossivel,
+					pos_atual,
+					posicao,
+					estado_do_node,
+					ir_ao_gol,
+					linha,
+					coluna,
+					end_linha,
+					end_coluna,
+					custo_dos_nodes,
+					parente_dos_nodes,
+					estado_dos_nodes,
+					geracao,
+					1 // Extra
+				);
+			}
+			
+			coluna++;
+			posicao++;
+			custo          = quadro_de_custo [ posicao ];
+			estado_do_node = estado_na_geracao( estado_dos_nodes[ posicao ], geracao );
+			
+			if(
+				(
+					estado_do_node != 2
+				) && !(
+					custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
+				) && (
+					rcol_ok
+				)
+			){
+				noding::expandir_filho(
+					lista_aberta,
+					custo,
+					limite_para_qual_custo_eh_impossivel,
+					pos_atual,
+					posicao,
+					estado_do_node,
+					ir_ao_gol,
+					linha,
+					coluna,
+					end_linha,
+					end_coluna,
+					custo_dos_nodes,
+					parente_dos_nodes,
+					estado_dos_nodes,
+					geracao,
+					SQRT_2 // Extra
+				);
+			}
+		}
+		
+		int coluna  = coluna_atual - 1;
+		int posicao = pos_atual    - 1;
+		float custo          = quadro_de_custo [ posicao ];
+		int   estado_do_node = estado_na_geracao( estado_dos_nodes[ posicao ], geracao );
+		
+		if(
+			/*
+			Checa se no  um obstculo e se o node no est fechado.
+			*/
+			(
+				estado_do_node != 2
+			) && !(
+				custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
+			) && (
+				lcol_ok
+			)
+			
+		){
+			noding::expandir_filho(
+				lista_aberta,
+				custo,
+				limite_para_qual_custo_eh_impossivel,
+				pos_atual,
+				posicao,
+				estado_do_node,
+				ir_ao_gol,
+				linha_atual,
+				coluna,
+				end_linha,
+				end_coluna,
+				custo_dos_nodes,
+				parente_dos_nodes,
+				estado_dos_nodes,
+				geracao,
+				1 // Extra
+			);
+		}
+			
+		coluna  += 2;
+		posicao += 2;
+		custo          = quadro_de_custo [ posicao ];
+		estado_do_node = estado_na_geracao( estado_dos_nodes[ posicao ], geracao );
+		
+		if(
+			/*
+			Checa se no  um obstculo e se o node no est fechado.
+			*/
+			(
+				estado_do_node != 2
+			) && !(
+				custo <= limite_para_qual_custo_eh_impossivel and custo < custo_atual
+			) && (
+				rcol_ok
+			)
+			
+		){
+			noding::expandir_filho(
+				lista_aberta,
+				custo,
+				limite_para_qual_custo_eh_impossivel,
+				pos_atual,
+				posicao,
+				estado_do_node,
+				ir_ao_gol,
+				linha_atual,
+				coluna,
+				end_linha,
+				end_coluna,
+				custo_dos_nodes,
+				parente_dos_nodes,
+				estado_dos_nodes,
+				geracao,
+				1 // Extra
+			);
+		}
+	}
+	
+	if(
+		opcoes.pontos_de_salto
+	){
+		saltos.desdobrar( melhor_posicao );
+	}
+	
+	construir_caminho_final(
+		contexto,
+		melhor_posicao,
+		2
+	);
+	
+	return;
+}
+
+
+inline float
+tempo_de_encontro(
+	float dx, float dy,  // obstculo menos incio, em metros
+	float vx, float vy,  // velocidade do obstculo
+	float velocidade_do_agente,
+	float horizonte
+){
+	/*
+	Descrio:
+		Primeiro instante t em que um agente saindo do incio, em linha
+		reta a velocidade_do_agente, pode estar onde o obstculo estar:
+
+			|d + v t| = velocidade_do_agente * t
+
+		Elevando ao quadrado, ( v.v - a ) t + 2 ( d.v ) t + d.d = 0.
+		Sem raiz positiva, o agente nunca o alcana, e ficamos com o horizonte.
+	*/
+	const float a = vx * vx + vy * vy - velocidade_do_agente * velocidade_do_agente;
+	const float b = 2.f * ( dx * vx + dy * vy );
+	const float c = dx * dx + dy * dy;
+
+	float t = horizonte;
+
+	if(
+		fabsf( a ) < 1e-6f
+	){
+		// Mesma velocidade, a equao vira de primeiro grau.
+		if(
+			b < 0
+		){
+			t = - c / b;
+		}
+	}
+	else{
+		const float delta = b * b - 4.f * a * c;
+
+		if(
+			delta >= 0
+		){
+			const float raiz = sqrtf( delta );
+			const float t1   = ( - b - raiz ) / ( 2.f * a );
+			const float t2   = ( - b + raiz ) / ( 2.f * a );
+
+			// A menor raiz no negativa.
+			if     ( t1 >= 0 && ( t2 < 0 || t1 <= t2 ) ) { t = t1; }
+			else if( t2 >= 0                          ) { t = t2; }
+		}
+	}
+
+	return t < horizonte ? t : horizonte;
+}
+
+
+inline int
+prever_obstaculos(
+	std::vector<float>&  previstos,
+	const float          parametros[],
+	int                  quantidade_de_parametros,
+	const OpcoesDeBusca& opcoes
+){
+	/*
+	Descrio:
+		Converte os obstculos de 7 valores de OpcoesDeBusca::obstaculos_em_movimento
+		nos 5 valores de sempre, j na posio prevista. Assim a busca, o carimbo e
+		todos os modos seguem sem saber de velocidades.
+
+		Cada obstculo  deslocado at onde estar no tempo de encontro com o
+		agente, e o raio soft cresce com o deslocamento. O raio hard no muda,
+		pois ele no deve ser atravessado nem na previso mais otimista.
+
+		Um obstculo que cruza a reta do agente passa a bloquear a brecha que
+		vai se fechar, e um que se afasta libera o lugar onde estava. Como a
+		previso muda pouco de um ciclo para o outro, o caminho tambm muda
+		pouco, em vez de fugir a cada ciclo de onde o adversrio estava.
+
+	Retorno:
+		Quantidade de valores escritos em 'previstos'.
+	*/
+	const int quantidade_de_obstaculos = ( quantidade_de_parametros - 7 ) / 7;
+
+	previstos.resize( 7 + 5 * quantidade_de_obstaculos );
+	std::copy( parametros, parametros + 7, previstos.begin() );
+
+	const float start_x = parametros[0];
+	const float start_y = parametros[1];
+
+	for(
+		int i = 0;
+		i < quantidade_de_obstaculos;
+		i++
+	){
+		const float* obstaculo = parametros + 7 + 7 * i;
+		float*       previsto  = previstos.data() + 7 + 5 * i;
+
+		const float vx = obstaculo[5];
+		const float vy = obstaculo[6];
+
+		const float t = tempo_de_encontro(
+			obstaculo[0] - start_x,
+			obstaculo[1] - start_y,
+			vx, vy,
+			opcoes.velocidade_do_agente,
+			opcoes.horizonte_de_previsao
+		);
+
+		previsto[0] = obstaculo[0] + vx * t;
+		previsto[1] = obstaculo[1] + vy * t;
+		previsto[2] = obstaculo[2];
+		previsto[3] = obstaculo[3] + opcoes.incerteza_da_previsao * sqrtf( vx * vx + vy * vy ) * t;
+		previsto[4] = obstaculo[4];
+	}
+
+	return (int) previstos.size();
+}
+
+
+void
+a_estrela(
+	ContextoDePlanejamento& contexto,
+	float parametros[],
+	int quantidade_de_parametros,
+	const OpcoesDeBusca& opcoes
+){
+	/*
+	Descrio:
+		A busca propriamente dita fica em buscar_caminho(). Aqui s aplicamos
+		o que vem antes e depois dela: a previso de
+		OpcoesDeBusca::obstaculos_em_movimento e a suavizao de
+		OpcoesDeBusca::qualquer_angulo.
+
+		Tambm fecha as estatsticas da chamada e as soma s do contexto.
+	*/
+	EstatisticasDaBusca& estatisticas = contexto.estatisticas_da_ultima_busca;
+	estatisticas.zerar();
+	estatisticas.chamadas = 1;
+
+	const high_resolution_clock::time_point inicio = high_resolution_clock::now();
+
+	CacheDeCaminhos& cache = contexto.cache_de_caminhos;
+	cache.veio_do_cache  = false;
+	cache.guardar_ao_fim = false;
+
+	if(
+		opcoes.obstaculos_em_movimento
+	){
+		quantidade_de_parametros = prever_obstaculos(
+			contexto.parametros_previstos,
+			parametros,
+			quantidade_de_parametros,
+			opcoes
+		);
+
+		parametros = contexto.parametros_previstos.data();
+	}
+
+	buscar_caminho(
+		contexto,
+		parametros,
+		quantidade_de_parametros,
+		opcoes
+	);
+
+	if(
+		// Do cache, o caminho j vem suavizado.
+		opcoes.qualquer_angulo && !cache.veio_do_cache
+	){
+		/*
+		O quadro de custo do contexto ainda tem os obstculos desta busca.
+		Mesmo limite calculado no incio de buscar_caminho().
+		*/
+		high_resolution_clock::time_point antes = high_resolution_clock::now();
+
+		suavizar_caminho(
+			contexto.caminho_final,
+			contexto.tamanho_do_caminho_final,
+			contexto.quadro_de_custo,
+			parametros[2] ? - 3 : - 2
+		);
+
+		estatisticas.tempo_de_reconstrucao += medir_etapa( antes );
+	}
+
+	if(
+		cache.guardar_ao_fim && contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ] != 1
+	){
+		guardar_no_cache( contexto );
+	}
+
+	estatisticas.tempo_total      = std::chrono::duration_cast<std::chrono::nanoseconds>( high_resolution_clock::now() - inicio ).count();
+	estatisticas.pior_tempo_total = estatisticas.tempo_total;
+	estatisticas.expansoes        = contexto.expansoes_na_ultima_busca;
+	estatisticas.tempos_esgotados = contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ] == 1;
+	estatisticas.tempo_de_busca   = estatisticas.tempo_total
+	                              - estatisticas.tempo_do_atalho
+	                              - estatisticas.tempo_de_preparo
+	                              - estatisticas.tempo_de_carimbo
+	                              - estatisticas.tempo_de_reconstrucao;
+
+	contexto.estatisticas_acumuladas.acumular( estatisticas );
+}
+
+
+void
+a_estrela(
+	float parametros[],
+	int quantidade_de_parametros,
+	const OpcoesDeBusca& opcoes
+){
+	/*
+	Descrio:
+		Mantida para quem no se importa com contextos, como o debug.cc.
+		O resultado fica em contexto_da_thread().caminho_final.
+	*/
+	a_estrela(
+		contexto_da_thread(),
+		parametros,
+		quantidade_de_parametros,
+		opcoes
+	);
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// Replanejamento Incremental (D* Lite)
+////////////////////////////////////////////////////////////////////////////
+
+ReplanejadorIncremental::ReplanejadorIncremental() :
+	tamanho_do_caminho_final           ( 0 ),
+	expansoes_na_ultima_chamada        ( 0 ),
+	celulas_alteradas_na_ultima_chamada( 0 ),
+	ultima_chamada_foi_incremental     ( false ),
+	inicializado                       ( false ),
+	expansoes_da_busca_completa        ( 0 ),
+	quadro_base                        ( nullptr ),
+	marca_atual                        ( 0 ),
+	tamanho_da_fila                    ( 0 )
+{
+	quadro_de_custo = new float        [ QUANT_POSICOES ];
+	g               = new float        [ QUANT_POSICOES ];
+	rhs             = new float        [ QUANT_POSICOES ];
+	marcas          = new unsigned int [ QUANT_POSICOES ];
+	fila            = new EntradaDaFila[ QUANT_POSICOES ];
+	indice_na_fila  = new int          [ QUANT_POSICOES ];
+
+	std::fill( marcas,         marcas         + QUANT_POSICOES, 0u );
+	std::fill( indice_na_fila, indice_na_fila + QUANT_POSICOES, -1 );
+}
+
+
+ReplanejadorIncremental::~ReplanejadorIncremental(){
+
+	delete[] quadro_de_custo;
+	delete[] g;
+	delete[] rhs;
+	delete[] marcas;
+	delete[] fila;
+	delete[] indice_na_fila;
+}
+
+
+void
+ReplanejadorIncremental::reiniciar(){
+
+	inicializado = false;
+}
+
+
+inline bool
+ReplanejadorIncremental::eh_objetivo(
+	int posicao
+) const {
+	return quadro_de_custo[posicao] == -1;
+}
+
+
+inline bool
+ReplanejadorIncremental::eh_celula_do_alvo(
+	int posicao
+) const {
+	/*
+	Mesmas clulas que a_estrela() marca com -1, caso estejam acessveis.
+	*/
+	if(
+		ir_ao_gol
+	){
+		const int coluna = posicao % QUANT_COLUNAS;
+
+		return posicao / QUANT_COLUNAS == Campo::linha_do_gol && coluna >= Campo::primeira_coluna_do_gol && coluna <= Campo::ultima_coluna_do_gol;
+	}
+
+	return posicao == alvo_linha * QUANT_COLUNAS + alvo_coluna;
+}
+
+
+inline float
+ReplanejadorIncremental::custo_da_aresta(
+	int   de,
+	int   para,
+	float passo
+) const {
+	/*
+	Descrio:
+		Custo de ir de 'de' para 'para', idntico ao que a_estrela() usa:
+		no se entra em clula impossvel vindo de uma mais barata, clulas
+		impossveis custam 100 e custos negativos no contam.
+	*/
+	const float custo = quadro_de_custo[para];
+
+	if(
+		custo <= limite_para_qual_custo_eh_impossivel && custo < quadro_de_custo[de]
+	){
+		return INFINITO;
+	}
+
+	return passo + ( custo <= limite_para_qual_custo_eh_impossivel ? 100.f : fmaxf( 0.f, custo ) );
+}
+
+
+inline float
+ReplanejadorIncremental::heuristica(
+	int posicao
+) const {
+	// A busca vai do objetivo ao agente, ento a heurstica mira o agente.
+	return distancia_diagonal(
+		false,
+		posicao   / QUANT_COLUNAS,
+		posicao   % QUANT_COLUNAS,
+		start_pos / QUANT_COLUNAS,
+		start_pos % QUANT_COLUNAS
+	);
+}
+
+
+inline void
+ReplanejadorIncremental::calcular_chave(
+	int    posicao,
+	float& k1,
+	float& k2
+) const {
+	k2 = min( g[posicao], rhs[posicao] );
+	k1 = k2 + heuristica( posicao ) + km;
+}
+
+
+////////////////////////////////////////////////////////////////////
+/// Fila de prioridade indexada, ordenada por (k1, k2)
+////////////////////////////////////////////////////////////////////
+
+inline bool
+chave_menor(
+	float a1, float a2,
+	float b1, float b2
+){
+	return a1 < b1 || ( a1 == b1 && a2 < b2 );
+}
+
+
+inline void
+ReplanejadorIncremental::fila_subir(
+	int indice
+){
+	EntradaDaFila entrada = fila[indice];
+
+	while(
+		indice > 0
+	){
+		int pai = (indice - 1) >> 1;
+
+		if(
+			!chave_menor( entrada.k1, entrada.k2, fila[pai].k1, fila[pai].k2 )
+		){
+			break;
+		}
+
+		fila[indice] = fila[pai];
+		indice_na_fila[ fila[indice].posicao ] = indice;
+		indice = pai;
+	}
+
+	fila[indice] = entrada;
+	indice_na_fila[ entrada.posicao ] = indice;
+}
+
+
+inline void
+ReplanejadorIncremental::fila_descer(
+	int indice
+){
+	EntradaDaFila entrada = fila[indice];
+
+	while(
+		true
+	){
+		int filho = 2 * indice + 1;
+
+		if(
+			filho >= tamanho_da_fila
+		){
+			break;
+		}
+
+		if(
+			filho + 1 < tamanho_da_fila && chave_menor( fila[filho + 1].k1, fila[filho + 1].k2, fila[filho].k1, fila[filho].k2 )
+		){
+			filho++;
+		}
+
+		if(
+			!chave_menor( fila[filho].k1, fila[filho].k2, entrada.k1, entrada.k2 )
+		){
+			break;
+		}
+
+		fila[indice] = fila[filho];
+		indice_na_fila[ fila[indice].posicao ] = indice;
+		indice = filho;
+	}
+
+	fila[indice] = entrada;
+	indice_na_fila[ entrada.posicao ] = indice;
+}
+
+
+inline void
+ReplanejadorIncremental::fila_colocar(
+	int   posicao,
+	float k1,
+	float k2
+){
+	/*
+	Insere ou, se j estiver na fila, muda a chave. A chave pode tanto
+	subir quanto descer, por isso tentamos os dois sentidos.
+	*/
+	int indice = indice_na_fila[posicao];
+
+	if(
+		indice < 0
+	){
+		indice = tamanho_da_fila++;
+	}
+
+	fila[indice].k1      = k1;
+	fila[indice].k2      = k2;
+	fila[indice].posicao = posicao;
+
+	fila_subir ( indice );
+	fila_descer( indice_na_fila[posicao] );
+}
+
+
+inline void
+ReplanejadorIncremental::fila_remover(
+	int posicao
+){
+	const int indice = indice_na_fila[posicao];
+
+	indice_na_fila[posicao] = -1;
+	tamanho_da_fila--;
+
+	if(
+		indice == tamanho_da_fila
+	){
+		return;
+	}
+
+	// O ltimo ocupa o buraco e pode precisar tanto subir quanto descer.
+	const int movida = fila[tamanho_da_fila].posicao;
+
+	fila[indice] = fila[tamanho_da_fila];
+	indice_na_fila[movida] = indice;
+
+	fila_subir ( indice );
+	fila_descer( indice_na_fila[movida] );
+}
+
+
+////////////////////////////////////////////////////////////////////
+/// D* Lite
+////////////////////////////////////////////////////////////////////
+
+inline void
+ReplanejadorIncremental::atualizar_pertinencia(
+	int posicao
+){
+	// S ns inconsistentes (g != rhs) ficam na fila.
+	if(
+		g[posicao] != rhs[posicao]
+	){
+		float k1, k2;
+		calcular_chave( posicao, k1, k2 );
+		fila_colocar( posicao, k1, k2 );
+	}
+	else if(
+		indice_na_fila[posicao] >= 0
+	){
+		fila_remover( posicao );
+	}
+}
+
+
+inline void
+ReplanejadorIncremental::atualizar_vertice(
+	int posicao
+){
+	/*
+	Recalcula rhs a partir de todos os sucessores. rhs  o custo do
+	melhor caminho at o objetivo, olhando apenas um passo  frente.
+	*/
+	if(
+		eh_objetivo( posicao )
+	){
+		rhs[posicao] = 0;
+	}
+	else{
+		const int linha  = posicao / QUANT_COLUNAS;
+		const int coluna = posicao % QUANT_COLUNAS;
+
+		float melhor = INFINITO;
+
+		for(
+			int k = 0;
+			k < 8;
+			k++
+		){
+			const int l = linha  + vizinhos_linha [k];
+			const int c = coluna + vizinhos_coluna[k];
+
+			if(
+				l < 0 || c < 0 || l >= QUANT_LINHAS || c >= QUANT_COLUNAS
+			){
+				continue;
+			}
+
+			const int vizinho = l * QUANT_COLUNAS + c;
+
+			melhor = min( melhor, custo_da_aresta( posicao, vizinho, vizinhos_passo[k] ) + g[vizinho] );
+		}
+
+		rhs[posicao] = melhor;
+	}
+
+	atualizar_pertinencia( posicao );
+}
+
+
+void
+ReplanejadorIncremental::inicializar(
+	const float obstaculos[],
+	int quantidade_de_obstaculos
+){
+	/*
+	Descrio:
+		Monta o quadro do zero, igual a_estrela() faria, e prepara uma
+		busca nova em que apenas as clulas do objetivo esto na fila.
+	*/
+
+	quadro_base = quadro_base_do_campo( permissao_para_ir_para_alem_dos_limites );
+
+	std::copy( quadro_base, quadro_base + QUANT_POSICOES, quadro_de_custo );
+
+	for(
+		int ob = 0;
+		ob + 5 <= quantidade_de_obstaculos;
+		ob += 5
+	){
+		const ObstaculoNoQuadro obstaculo = converter_obstaculo( obstaculos + ob );
+
+		carimbar_obstaculo(
+			quadro_de_custo,
+			obstaculo.linha,
+			obstaculo.coluna,
+			obstaculo.raio_hard,
+			obstaculo.raio_soft,
+			obstaculo.forca,
+			limite_para_qual_custo_eh_impossivel
+		);
+	}
+
+	obstaculos_anteriores.assign( obstaculos, obstaculos + quantidade_de_obstaculos );
+
+	std::fill( g,   g   + QUANT_POSICOES, INFINITO );
+	std::fill( rhs, rhs + QUANT_POSICOES, INFINITO );
+
+	for(
+		int i = 0;
+		i < tamanho_da_fila;
+		i++
+	){
+		indice_na_fila[ fila[i].posicao ] = -1;
+	}
+	tamanho_da_fila = 0;
+
+	km               = 0;
+	ultimo_start_pos = start_pos;
+
+	// O objetivo  a raiz da busca.
+	int primeira = ir_ao_gol ? Campo::linha_do_gol * QUANT_COLUNAS + Campo::primeira_coluna_do_gol : alvo_linha * QUANT_COLUNAS + alvo_coluna;
+	int ultima   = ir_ao_gol ? Campo::linha_do_gol * QUANT_COLUNAS + Campo::ultima_coluna_do_gol   : primeira;
+
+	for(
+		int posicao = primeira;
+		posicao <= ultima;
+		posicao++
+	){
+		if(
+			quadro_de_custo[posicao] > limite_para_qual_custo_eh_impossivel
+		){
+			quadro_de_custo[posicao] = -1;
+			atualizar_vertice( posicao );
+		}
+	}
+
+	inicializado = true;
+}
+
+
+int
+ReplanejadorIncremental::aplicar_obstaculos(
+	const float obstaculos[],
+	int quantidade_de_obstaculos
+){
+	/*
+	Descrio:
+		Compara os obstculos com os da chamada anterior, recarimba apenas
+		a regio dos que mudaram e avisa o D* Lite sobre cada clula cujo
+		custo de fato mudou.
+
+	Retorno:
+		Quantidade de clulas alteradas.
+	*/
+
+	const int quantidade_anterior = (int) obstaculos_anteriores.size() / 5;
+	const int quantidade_nova     = quantidade_de_obstaculos / 5;
+
+	std::vector<ObstaculoNoQuadro> mudancas;  // verses antigas e novas de quem mudou
+
+	for(
+		int i = 0;
+		i < max( quantidade_anterior, quantidade_nova );
+		i++
+	){
+		const bool tinha = i < quantidade_anterior;
+		const bool tem   = i < quantidade_nova;
+
+		ObstaculoNoQuadro antigo, novo;
+
+		if( tinha ){ antigo = converter_obstaculo( obstaculos_anteriores.data() + 5 * i ); }
+		if( tem   ){ novo   = converter_obstaculo( obstaculos                   + 5 * i ); }
+
+		if(
+			tinha && tem && antigo == novo
+		){
+			continue;
+		}
+
+		if( tinha ){ mudancas.push_back( antigo ); }
+		if( tem   ){ mudancas.push_back( novo   ); }
+	}
+
+	obstaculos_anteriores.assign( obstaculos, obstaculos + quantidade_de_obstaculos );
+
+	if(
+		mudancas.empty()
+	){
+		return 0;
+	}
+
+	/*
+	Marcamos as clulas da regio afetada, guardando o custo antigo, e as
+	devolvemos ao quadro base.
+	*/
+	marca_atual++;
+	if(
+		marca_atual == 0
+	){
+		// Deu a volta, zeramos para no confundir com marcas antigas.
+		std::fill( marcas, marcas + QUANT_POSICOES, 0u );
+		marca_atual = 1;
+	}
+
+	std::vector<int>   afetadas;
+	std::vector<float> custos_anteriores;
+
+	for(
+		int i = 0;
+		i < (int) mudancas.size();
+		i++
+	){
+		const int folga = mudancas[i].raio_max + 1;
+
+		const int linha_min  = max( 0,                 mudancas[i].linha  - folga );
+		const int linha_max  = min( QUANT_LINHAS  - 1, mudancas[i].linha  + folga );
+		const int coluna_min = max( 0,                 mudancas[i].coluna - folga );
+		const int coluna_max = min( QUANT_COLUNAS - 1, mudancas[i].coluna + folga );
+
+		for(
+			int linha = linha_min;
+			linha <= linha_max;
+			linha++
+		){
+			for(
+				int coluna = coluna_min;
+				coluna <= coluna_max;
+				coluna++
+			){
+				const int posicao = linha * QUANT_COLUNAS + coluna;
+
+				if(
+					marcas[posicao] == marca_atual
+				){
+					continue;
+				}
+
+				marcas[posicao] = marca_atual;
+				afetadas.push_back( posicao );
+				custos_anteriores.push_back( quadro_de_custo[posicao] );
+				quadro_de_custo[posicao] = quadro_base[posicao];
+			}
+		}
+	}
+
+	/*
+	Todo obstculo atual que alcana a regio  carimbado de novo, mas s
+	dentro dela. Como o resultado no depende da ordem dos carimbos, o
+	quadro fica idntico ao que seria montado do zero.
+	*/
+	for(
+		int ob = 0;
+		ob < quantidade_nova;
+		ob++
+	){
+		const ObstaculoNoQuadro obstaculo = converter_obstaculo( obstaculos + 5 * ob );
+
+		bool alcanca = false;
+		for(
+			int i = 0;
+			i < (int) mudancas.size() && !alcanca;
+			i++
+		){
+			alcanca = obstaculo.intercepta( mudancas[i] );
+		}
+
+		if(
+			alcanca
+		){
+			carimbar_obstaculo(
+				quadro_de_custo,
+				obstaculo.linha,
+				obstaculo.coluna,
+				obstaculo.raio_hard,
+				obstaculo.raio_soft,
+				obstaculo.forca,
+				limite_para_qual_custo_eh_impossivel,
+				marcas,
+				marca_atual
+			);
+		}
+	}
+
+	for(
+		int k = 0;
+		k < (int) afetadas.size();
+		k++
+	){
+		if(
+			eh_celula_do_alvo( afetadas[k] ) && quadro_de_custo[ afetadas[k] ] > limite_para_qual_custo_eh_impossivel
+		){
+			quadro_de_custo[ afetadas[k] ] = -1;
+		}
+	}
+
+	/*
+	S agora, com o quadro inteiro atualizado, avisamos o D* Lite. Uma
+	clula que mudou altera as arestas que chegam nela e tambm as que
+	saem dela, logo ela e seus vizinhos precisam de um novo rhs.
+
+	Clulas alteradas costumam ser vizinhas umas das outras, ento usamos
+	uma marca nova para atualizar cada n uma nica vez.
+	*/
+	int alteradas = 0;
+
+	marca_atual++;
+	if(
+		marca_atual == 0
+	){
+		std::fill( marcas, marcas + QUANT_POSICOES, 0u );
+		marca_atual = 1;
+	}
+
+	std::vector<int> a_atualizar;
+
+	for(
+		int k = 0;
+		k < (int) afetadas.size();
+		k++
+	){
+		if(
+			quadro_de_custo[ afetadas[k] ] == custos_anteriores[k]
+		){
+			continue;
+		}
+
+		alteradas++;
+
+		const int linha  = afetadas[k] / QUANT_COLUNAS;
+		const int coluna = afetadas[k] % QUANT_COLUNAS;
+
+		for(
+			int l = max( 0, linha - 1 );
+			l <= min( QUANT_LINHAS - 1, linha + 1 );
+			l++
+		){
+			for(
+				int c = max( 0, coluna - 1 );
+				c <= min( QUANT_COLUNAS - 1, coluna + 1 );
+				c++
+			){
+				const int posicao = l * QUANT_COLUNAS + c;
+
+				if(
+					marcas[posicao] != marca_atual
+				){
+					marcas[posicao] = marca_atual;
+					a_atualizar.push_back( posicao );
+				}
+			}
+		}
+	}
+
+	for(
+		int k = 0;
+		k < (int) a_atualizar.size();
+		k++
+	){
+		atualizar_vertice( a_atualizar[k] );
+	}
+
+	return alteradas;
+}
+
+
+bool
+ReplanejadorIncremental::computar_caminho_mais_curto(
+	long long tempo_limite,
+	long long tempo_ja_gasto,
+	int       limite_de_expansoes
+){
+	/*
+	Descrio:
+		Lao principal do D* Lite, na verso otimizada do artigo. Para assim
+		que o n do agente estiver consistente (g == rhs) e nada na fila
+		puder melhor-lo.
+
+	Retorno:
+		False se o tempo acabou ou se passamos de limite_de_expansoes. A
+		fila continua vlida e a prxima chamada continua de onde esta parou.
+	*/
+	auto inicio = high_resolution_clock::now();
+
+	int medida_de_tempo_limite = 0;
+
+	while(
+		tamanho_da_fila > 0
+	){
+		float start_k1, start_k2;
+		calcular_chave( start_pos, start_k1, start_k2 );
+
+		const EntradaDaFila topo = fila[0];
+
+		if(
+			!chave_menor( topo.k1, topo.k2, start_k1, start_k2 ) && rhs[start_pos] == g[start_pos]
+		){
+			break;
+		}
+
+		medida_de_tempo_limite = (medida_de_tempo_limite + 1) % 31;
+		if(
+			(
+				medida_de_tempo_limite == 0
+			) && (
+				tempo_ja_gasto + duration_cast<microseconds>( high_resolution_clock::now() - inicio ).count() > tempo_limite
+			)
+		){
+			return false;
+		}
+
+		const int u = topo.posicao;
+
+		float novo_k1, novo_k2;
+		calcular_chave( u, novo_k1, novo_k2 );
+
+		if(
+			// Chave velha, de antes do agente andar. S reposicionamos.
+			chave_menor( topo.k1, topo.k2, novo_k1, novo_k2 )
+		){
+			fila_colocar( u, novo_k1, novo_k2 );
+			continue;
+		}
+
+		if(
+			++expansoes_na_ultima_chamada > limite_de_expansoes
+		){
+			return false;
+		}
+
+		const int linha  = u / QUANT_COLUNAS;
+		const int coluna = u % QUANT_COLUNAS;
+
+		if(
+			g[u] > rhs[u]
+		){
+			// Melhorou: fixamos g e propagamos para os predecessores.
+			g[u] = rhs[u];
+			fila_remover( u );
+
+			for(
+				int k = 0;
+				k < 8;
+				k++
+			){
+				const int l = linha  + vizinhos_linha [k];
+				const int c = coluna + vizinhos_coluna[k];
+
+				if(
+					l < 0 || c < 0 || l >= QUANT_LINHAS || c >= QUANT_COLUNAS
+				){
+					continue;
+				}
+
+				const int   s     = l * QUANT_COLUNAS + c;
+				const float custo = custo_da_aresta( s, u, vizinhos_passo[k] ) + g[u];
+
+				if(
+					custo < rhs[s] && !eh_objetivo( s )
+				){
+					rhs[s] = custo;
+					atualizar_pertinencia( s );
+				}
+			}
+		}
+		else{
+			// Piorou: g volta a infinito e quem dependia de u recalcula.
+			const float g_antigo = g[u];
+			g[u] = INFINITO;
+
+			atualizar_vertice( u );
+
+			for(
+				int k = 0;
+				k < 8;
+				k++
+			){
+				const int l = linha  + vizinhos_linha [k];
+				const int c = coluna + vizinhos_coluna[k];
+
+				if(
+					l < 0 || c < 0 || l >= QUANT_LINHAS || c >= QUANT_COLUNAS
+				){
+					continue;
+				}
+
+				const int s = l * QUANT_COLUNAS + c;
+
+				if(
+					rhs[s] == custo_da_aresta( s, u, vizinhos_passo[k] ) + g_antigo
+				){
+					atualizar_vertice( s );
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+
+void
+ReplanejadorIncremental::construir_caminho(){
+	/*
+	Descrio:
+		Desce pelo g a partir do agente at o objetivo, no mesmo formato
+		de construir_caminho_final().
+	*/
+	int posicao = start_pos;
+	int indice  = 0;
+
+	caminho_final[ indice++ ] = ( posicao / QUANT_COLUNAS ) / 10.f - 16.f;  // x
+	caminho_final[ indice++ ] = ( posicao % QUANT_COLUNAS ) / 10.f - 11.f;  // y
+
+	while(
+		!eh_objetivo( posicao ) && indice < 2048
+	){
+		const int linha  = posicao / QUANT_COLUNAS;
+		const int coluna = posicao % QUANT_COLUNAS;
+
+		float melhor  = INFINITO;
+		int   proximo = -1;
+
+		for(
+			int k = 0;
+			k < 8;
+			k++
+		){
+			const int l = linha  + vizinhos_linha [k];
+			const int c = coluna + vizinhos_coluna[k];
+
+			if(
+				l < 0 || c < 0 || l >= QUANT_LINHAS || c >= QUANT_COLUNAS
+			){
+				continue;
+			}
+
+			const int   vizinho = l * QUANT_COLUNAS + c;
+			const float custo   = custo_da_aresta( posicao, vizinho, vizinhos_passo[k] ) + g[vizinho];
+
+			if(
+				custo < melhor
+			){
+				melhor  = custo;
+				proximo = vizinho;
+			}
+		}
+
+		if(
+			proximo < 0
+		){
+			break;
+		}
+
+		posicao = proximo;
+
+		caminho_final[ indice++ ] = ( posicao / QUANT_COLUNAS ) / 10.f - 16.f;
+		caminho_final[ indice++ ] = ( posicao % QUANT_COLUNAS ) / 10.f - 11.f;
+	}
+
+	if(
+		// Assim como a_estrela(), o ltimo ponto  o alvo exato.
+		!ir_ao_gol && eh_objetivo( posicao )
+	){
+		caminho_final[ indice - 2 ] = alvo_x;
+		caminho_final[ indice - 1 ] = alvo_y;
+	}
+
+	caminho_final[ indice++ ] = 0;  // Sucesso
+	caminho_final[ indice++ ] = g[start_pos] / 10.f;
+
+	tamanho_do_caminho_final = indice;
+}
+
+
+void
+ReplanejadorIncremental::planejar(
+	float parametros[],
+	int quantidade_de_parametros
+){
+	/*
+	Descrio:
+		Mesma entrada e mesma sada de a_estrela(), mas reaproveitando a
+		busca da chamada anterior sempre que possvel.
+	*/
+	auto inicio = high_resolution_clock::now();
+
+	expansoes_na_ultima_chamada         = 0;
+	celulas_alteradas_na_ultima_chamada = 0;
+	ultima_chamada_foi_incremental      = false;
+
+	const float start_x = parametros[ 0 ];
+	const float start_y = parametros[ 1 ];
+
+	const bool  nova_permissao = parametros[ 2 ];
+	const bool  novo_ir_ao_gol = parametros[ 3 ];
+	const float novo_alvo_x    = parametros[ 4 ];
+	const float novo_alvo_y    = parametros[ 5 ];
+	const int   tempo_limite   = parametros[ 6 ];
+
+	float *obstaculos = parametros + 7;
+	int quantidade_de_obstaculos = quantidade_de_parametros - 7;
+
+	start_pos = x_para_linha( start_x ) * QUANT_COLUNAS + y_para_col( start_y );
+
+	const bool recomecar = !inicializado
+	                    || nova_permissao != permissao_para_ir_para_alem_dos_limites
+	                    || novo_ir_ao_gol != ir_ao_gol
+	                    || ( !novo_ir_ao_gol && ( x_para_linha( novo_alvo_x ) != alvo_linha || y_para_col( novo_alvo_y ) != alvo_coluna ) );
+
+	alvo_x = novo_alvo_x;
+	alvo_y = novo_alvo_y;
+
+	if(
+		recomecar
+	){
+		permissao_para_ir_para_alem_dos_limites = nova_permissao;
+		ir_ao_gol                               = novo_ir_ao_gol;
+		limite_para_qual_custo_eh_impossivel    = nova_permissao ? - 3 : - 2;
+		alvo_linha                              = x_para_linha( novo_alvo_x );
+		alvo_coluna                             = y_para_col  ( novo_alvo_y );
+
+		inicializar( obstaculos, quantidade_de_obstaculos );
+	}
+
+	ContextoDePlanejamento& contexto = contexto_da_thread();
+
+	montar_fase_larga( contexto.fase_larga, obstaculos, quantidade_de_obstaculos );
+
+	if(
+		// Caminho direto, exatamente como a_estrela() decide.
+		!se_caminho_esta_obstruido(
+			contexto,
+			start_x,
+			start_y,
+			alvo_x,
+			alvo_y,
+			contexto.fase_larga,
+			ir_ao_gol,
+			limite_para_qual_custo_eh_impossivel,
+			quadro_base
+		)
+	){
+		std::copy( contexto.caminho_final, contexto.caminho_final + contexto.tamanho_do_caminho_final, caminho_final );
+		tamanho_do_caminho_final = contexto.tamanho_do_caminho_final;
+		return;
+	}
+
+	if(
+		!recomecar
+	){
+		ultima_chamada_foi_incremental      = true;
+		celulas_alteradas_na_ultima_chamada = aplicar_obstaculos( obstaculos, quantidade_de_obstaculos );
+	}
+
+	if(
+		// O agente andou: as chaves antigas ficam subestimadas em no mximo isso.
+		start_pos != ultimo_start_pos
+	){
+		km += distancia_diagonal(
+			false,
+			ultimo_start_pos / QUANT_COLUNAS,
+			ultimo_start_pos % QUANT_COLUNAS,
+			start_pos        / QUANT_COLUNAS,
+			start_pos        % QUANT_COLUNAS
+		);
+		ultimo_start_pos = start_pos;
+	}
+
+	const bool terminou = computar_caminho_mais_curto(
+		tempo_limite,
+		duration_cast<microseconds>( high_resolution_clock::now() - inicio ).count(),
+		recomecar ? std::numeric_limits<int>::max() : expansoes_da_busca_completa
+	);
+
+	if(
+		recomecar && terminou
+	){
+		// Um reparo que custe mais que isso no compensa.
+		expansoes_da_busca_completa = max( expansoes_na_ultima_chamada, 1000 );
+	}
+
+	if(
+		terminou && g[start_pos] < INFINITO
+	){
+		construir_caminho();
+		return;
+	}
+
+	if(
+		!terminou && expansoes_na_ultima_chamada > expansoes_da_busca_completa
+	){
+		// Reparo caro demais, a prxima chamada recomea do zero.
+		inicializado = false;
+	}
+
+	/*
+	Alvo inalcanvel ou tempo esgotado: o A* comum sabe devolver o
+	melhor caminho parcial com o status certo.
+	*/
+	a_estrela(
+		contexto,
+		parametros,
+		quantidade_de_parametros
+	);
+
+	std::copy( contexto.caminho_final, contexto.caminho_final + contexto.tamanho_do_caminho_final, caminho_final );
+	tamanho_do_caminho_final = contexto.tamanho_do_caminho_final;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// Campo de Custo At o Alvo (Dijkstra reverso)
+////////////////////////////////////////////////////////////////////////////
+
+CampoAteOAlvo::CampoAteOAlvo() :
+	expansoes_no_ultimo_calculo         ( 0 ),
+	calculado                           ( false ),
+	ir_ao_gol                           ( false ),
+	limite_para_qual_custo_eh_impossivel( -2 ),
+	alvo_x                              ( 0 ),
+	alvo_y                              ( 0 ),
+	quadro_base                         ( nullptr )
+{
+	custo_ate_o_alvo = new float        [ QUANT_POSICOES ];
+	quadro_de_custo  = new float        [ QUANT_POSICOES ];
+	proxima_posicao  = new int          [ QUANT_POSICOES ];
+	estado           = new unsigned char[ QUANT_POSICOES ];
+
+	std::fill( custo_ate_o_alvo, custo_ate_o_alvo + QUANT_POSICOES, INFINITO );
+	std::fill( proxima_posicao,  proxima_posicao  + QUANT_POSICOES, -1 );
+}
+
+
+CampoAteOAlvo::~CampoAteOAlvo(){
+
+	delete[] custo_ate_o_alvo;
+	delete[] quadro_de_custo;
+	delete[] proxima_posicao;
+	delete[] estado;
+}
+
+
+void
+CampoAteOAlvo::calcular(
+	const float parametros[],
+	int quantidade_de_parametros
+){
+	/*
+	Descrio:
+		Monta o quadro como a_estrela() monta e espalha o custo a partir das
+		clulas do objetivo at esvaziar a fila.
+
+		A aresta de u para v custa o mesmo que em expandir_filho() e depende
+		s de v, ento quando v sai da fila todos os seus vizinhos u ganham o
+		mesmo acrscimo. A proibio tambm  a mesma: no se entra numa
+		clula impossvel vindo de uma mais barata.
+
+		A fila  de caambas de largura 1, veja cacambas. Sem decrease-key:
+		quem melhora entra de novo, e a cpia velha  descartada por j
+		estar fechada quando sair.
+	*/
+	const bool permissao_para_ir_para_alem_dos_limites = parametros[ 2 ];
+
+	ir_ao_gol                            = parametros[ 3 ];
+	alvo_x                               = parametros[ 4 ];
+	alvo_y                               = parametros[ 5 ];
+	limite_para_qual_custo_eh_impossivel = permissao_para_ir_para_alem_dos_limites ? - 3 : - 2;
+
+	obstaculos.assign( parametros + 7, parametros + quantidade_de_parametros );
+
+	quadro_base = quadro_base_do_campo( permissao_para_ir_para_alem_dos_limites );
+
+	std::copy( quadro_base, quadro_base + QUANT_POSICOES, quadro_de_custo );
+
+	for(
+		int ob = 0;
+		ob + 5 <= (int) obstaculos.size();
+		ob += 5
+	){
+		const ObstaculoNoQuadro obstaculo = converter_obstaculo( obstaculos.data() + ob );
+
+		carimbar_obstaculo(
+			quadro_de_custo,
+			obstaculo.linha,
+			obstaculo.coluna,
+			obstaculo.raio_hard,
+			obstaculo.raio_soft,
+			obstaculo.forca,
+			limite_para_qual_custo_eh_impossivel
+		);
+	}
+
+	std::fill( custo_ate_o_alvo, custo_ate_o_alvo + QUANT_POSICOES, INFINITO );
+	std::fill( proxima_posicao,  proxima_posicao  + QUANT_POSICOES, -1 );
+	std::fill( estado,           estado           + QUANT_POSICOES, 0 );
+
+	for(
+		int k = 0;
+		k < (int) cacambas.size();
+		k++
+	){
+		cacambas[k].clear();
+	}
+
+	if(
+		cacambas.empty()
+	){
+		cacambas.resize( 1 );
+	}
+
+	// As mesmas clulas que a_estrela() marca com -1.
+	const int primeira = ir_ao_gol ? Campo::linha_do_gol * QUANT_COLUNAS + Campo::primeira_coluna_do_gol : x_para_linha( alvo_x ) * QUANT_COLUNAS + y_para_col( alvo_y );
+	const int ultima   = ir_ao_gol ? Campo::linha_do_gol * QUANT_COLUNAS + Campo::ultima_coluna_do_gol   : primeira;
+
+	for(
+		int posicao = primeira;
+		posicao <= ultima;
+		posicao++
+	){
+		if(
+			quadro_de_custo[posicao] > limite_para_qual_custo_eh_impossivel
+		){
+			quadro_de_custo [posicao] = -1;
+			custo_ate_o_alvo[posicao] = 0;
+			estado          [posicao] = 1;
+			cacambas[0].push_back( posicao );
+		}
+	}
+
+	expansoes_no_ultimo_calculo = 0;
+
+	for(
+		int atual = 0;
+		atual < (int) cacambas.size();
+		atual++
+	){
+		// Relaxar pode empurrar nesta mesma caamba, por isso nada de referncia.
+		while(
+			!cacambas[atual].empty()
+		){
+			const int posicao = cacambas[atual].back();
+			cacambas[atual].pop_back();
+
+			if(
+				estado[posicao] == 2
+			){
+				continue;
+			}
+
+			const int   linha   = posicao / QUANT_COLUNAS;
+			const int   coluna  = posicao % QUANT_COLUNAS;
+			const float custo   = quadro_de_custo[posicao];
+
+			estado[posicao] = 2;
+			expansoes_no_ultimo_calculo++;
+
+			// O que qualquer vizinho paga para entrar aqui, alm do passo.
+			const float custo_de_entrada = custo_ate_o_alvo[posicao] + (
+				custo <= limite_para_qual_custo_eh_impossivel ? 100.f : fmaxf( 0.f, custo )
+			);
+
+			// S as clulas da borda do quadro precisam conferir os limites.
+			const bool na_borda = linha == 0 || coluna == 0 || linha == QUANT_LINHAS - 1 || coluna == QUANT_COLUNAS - 1;
+
+			for(
+				int k = 0;
+				k < 8;
+				k++
+			){
+				const int l = linha  + vizinhos_linha [k];
+				const int c = coluna + vizinhos_coluna[k];
+
+				if(
+					na_borda && ( l < 0 || c < 0 || l >= QUANT_LINHAS || c >= QUANT_COLUNAS )
+				){
+					continue;
+				}
+
+				const int vizinho = posicao + vizinhos_linha[k] * QUANT_COLUNAS + vizinhos_coluna[k];
+
+				if(
+					estado[vizinho] == 2 || (
+						// A aresta vai do vizinho para c.
+						custo <= limite_para_qual_custo_eh_impossivel && custo < quadro_de_custo[vizinho]
+					)
+				){
+					continue;
+				}
+
+				const float novo_custo = custo_de_entrada + vizinhos_passo[k];
+
+				if(
+					estado[vizinho] == 1 && novo_custo >= custo_ate_o_alvo[vizinho]
+				){
+					continue;
+				}
+
+				estado          [vizinho] = 1;
+				custo_ate_o_alvo[vizinho] = novo_custo;
+				proxima_posicao [vizinho] = posicao;
+
+				const int cacamba = int( novo_custo );
+
+				if(
+					cacamba >= (int) cacambas.size()
+				){
+					cacambas.resize( cacamba + 1 );
+				}
+
+				cacambas[cacamba].push_back( vizinho );
+			}
+		}
+	}
+
+	for(
+		// Mesma unidade do custo que a_estrela() devolve.
+		int posicao = 0;
+		posicao < QUANT_POSICOES;
+		posicao++
+	){
+		custo_ate_o_alvo[posicao] /= 10.f;
+	}
+
+	calculado = true;
+}
+
+
+int
+CampoAteOAlvo::caminho_a_partir_de(
+	float start_x,
+	float start_y,
+	float caminho[]
+) const {
+	/*
+	Descrio:
+		Segue proxima_posicao a partir do incio. Antes, a mesma checagem de
+		caminho direto de a_estrela(), para que as respostas coincidam.
+	*/
+	ContextoDePlanejamento& contexto = contexto_da_thread();
+
+	montar_fase_larga( contexto.fase_larga, obstaculos.data(), (int) obstaculos.size() );
+
+	if(
+		!se_caminho_esta_obstruido(
+			contexto,
+			start_x,
+			start_y,
+			alvo_x,
+			alvo_y,
+			contexto.fase_larga,
+			ir_ao_gol,
+			limite_para_qual_custo_eh_impossivel,
+			quadro_base
+		)
+	){
+		std::copy( contexto.caminho_final, contexto.caminho_final + contexto.tamanho_do_caminho_final, caminho );
+		return contexto.tamanho_do_caminho_final;
+	}
+
+	const int start_pos = x_para_linha( start_x ) * QUANT_COLUNAS + y_para_col( start_y );
+
+	int posicao = start_pos;
+	int indice  = 0;
+
+	caminho[ indice++ ] = ( posicao / QUANT_COLUNAS ) / 10.f - 16.f;  // x
+	caminho[ indice++ ] = ( posicao % QUANT_COLUNAS ) / 10.f - 11.f;  // y
+
+	if(
+		custo_ate_o_alvo[start_pos] == INFINITO
+	){
+		caminho[ indice++ ] = 2;  // Impossvel
+		caminho[ indice++ ] = 0;
+
+		return indice;
+	}
+
+	while(
+		proxima_posicao[posicao] != -1 && indice < 2048
+	){
+		posicao = proxima_posicao[posicao];
+
+		caminho[ indice++ ] = ( posicao / QUANT_COLUNAS ) / 10.f - 16.f;
+		caminho[ indice++ ] = ( posicao % QUANT_COLUNAS ) / 10.f - 11.f;
+	}
+
+	if(
+		// Assim como a_estrela(), o ltimo ponto  o alvo exato.
+		!ir_ao_gol && proxima_posicao[posicao] == -1
+	){
+		caminho[ indice - 2 ] = alvo_x;
+		caminho[ indice - 1 ] = alvo_y;
+	}
+
+	caminho[ indice++ ] = 0;  // Sucesso
+	caminho[ indice++ ] = custo_ate_o_alvo[start_pos];
+
+	return indice;
+}
+
+
+#define PARAMETROS_POR_CONSULTA 7
+
+void
+a_estrela_em_lote(
+	const float consultas[],
+	int quantidade_de_consultas,
+	const float obstaculos[],
+	int quantidade_de_obstaculos,
+	int quantidade_de_threads,
+	ResultadoEmLote& resultado,
+	const OpcoesDeBusca& opcoes
+){
+	/*
+	Descrio:
+		Planeja vrias consultas de uma vez, usando um grupo de threads.
+
+		Cada thread usa o seu contexto_da_thread(), logo os buffers do A*
+		so alocados uma nica vez por thread e no por consulta. O grupo
+		 criado na primeira chamada e reaproveitado pelas seguintes.
+
+	Parmetros:
+		consultas                -> matriz quantidade_de_consultas x 7, linha a linha:
+		                            [start x][start y][allow out of bounds?][go to goal?]
+		                            [optional target x][optional target y][timeout]
+		obstaculos               -> [x][y][hard radius][soft radius][force] ..., comum a todas
+		quantidade_de_threads    -> total de threads usadas, <= 0 para todas
+		opcoes                   -> modo de busca, o mesmo para todas as consultas
+
+	Retorno:
+		Nada, o resultado  escrito em 'resultado'. Veja ResultadoEmLote.
+	*/
+
+	static GrupoDeTrabalhadores grupo(
+		// Quem chama tambm trabalha, por isso uma a menos.
+		max( (int) std::thread::hardware_concurrency(), 1 ) - 1
+	);
+
+	/*
+	Como cada caminho tem um tamanho, cada consulta escreve no seu
+	vetor e s depois empacotamos tudo.
+	*/
+	std::vector< std::vector<float> > caminhos_individuais( quantidade_de_consultas );
+
+	resultado.status.assign( quantidade_de_consultas, 0.f );
+	resultado.custos.assign( quantidade_de_consultas, 0.f );
+
+	grupo.executar(
+		quantidade_de_consultas,
+		[&]( int i ){
+
+			/*
+			a_estrela() espera os obstculos logo aps os parmetros fixos,
+			ento montamos o vetor completo em um rascunho da thread.
+			*/
+			thread_local std::vector<float> parametros;
+			parametros.assign( consultas + i * PARAMETROS_POR_CONSULTA, consultas + ( i + 1 ) * PARAMETROS_POR_CONSULTA );
+			parametros.insert( parametros.end(), obstaculos, obstaculos + quantidade_de_obstaculos );
+
+			ContextoDePlanejamento& contexto = contexto_da_thread();
+
+			a_estrela(
+				contexto,
+				parametros.data(),
+				(int) parametros.size(),
+				opcoes
+			);
+
+			const int tamanho = contexto.tamanho_do_caminho_final;
+
+			caminhos_individuais[i].assign( contexto.caminho_final, contexto.caminho_final + tamanho - 2 );
+			resultado.status[i] = contexto.caminho_final[ tamanho - 2 ];
+			resultado.custos[i] = contexto.caminho_final[ tamanho - 1 ];
+		},
+		quantidade_de_threads
+	);
+
+	////////////////////////////////////////////////////////////////////
+	/// Empacotamento
+	////////////////////////////////////////////////////////////////////
+
+	resultado.deslocamentos.resize( quantidade_de_consultas + 1 );
+	resultado.deslocamentos[0] = 0;
+	for(
+		int i = 0;
+		i < quantidade_de_consultas;
+		i++
+	){
+		resultado.deslocamentos[i + 1] = resultado.deslocamentos[i] + (int) caminhos_individuais[i].size();
+	}
+
+	resultado.caminhos.resize( resultado.deslocamentos[ quantidade_de_consultas ] );
+	for(
+		int i = 0;
+		i < quantidade_de_consultas;
+		i++
+	){
+		std::copy(
+			caminhos_individuais[i].begin(),
+			caminhos_individuais[i].end(),
+			resultado.caminhos.begin() + resultado.deslocamentos[i]
+		);
+	}
 }
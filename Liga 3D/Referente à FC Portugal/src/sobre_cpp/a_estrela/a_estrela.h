@@ -5,11 +5,20 @@ Matheus Deyvisson, 2025
 #ifndef A_ESTRELA_H
 #define A_ESTRELA_H
 
+#include <vector>
+#include <utility>
+#include <cstdlib>
+
 ////////////////////////////////////////////////////////////////////////////
 /// Variveis Inerentes ao Algoritmo
 ////////////////////////////////////////////////////////////////////////////
 
 struct Node{
+    /*
+    Hoje s a BST de comparao (LISTA_ABERTA_BST) usa esta struct. O estado
+    da busca vive em vetores separados no ContextoDePlanejamento.
+    */
+
     // Inerentes a Grafos BST
     
     Node* left;   // Filho Esquerdo (Conexo de Descida)
@@ -69,21 +78,680 @@ struct Node{
 	
 };
 
+class ListaAberta;  // Veja lista_aberta.h
+class BuscaPorSaltos;  // Veja a_estrela.cpp
+
+struct ObstaculoNoQuadro {
+	/*
+	Obstculo j convertido para o quadro, veja converter_obstaculo() em
+	a_estrela.cpp. Dois obstculos iguais aqui carimbam exatamente
+	as mesmas clulas, mesmo que x e y tenham mudado alguns milmetros.
+	*/
+	int   linha;
+	int   coluna;
+	int   raio_max;
+	float raio_hard;
+	float raio_soft;
+	float forca;
+
+	inline bool
+	operator==(
+		const ObstaculoNoQuadro& outro
+	) const {
+		return linha     == outro.linha     && coluna    == outro.coluna    &&
+		       raio_hard == outro.raio_hard && raio_soft == outro.raio_soft &&
+		       forca     == outro.forca;
+	}
+
+	inline bool
+	intercepta(
+		const ObstaculoNoQuadro& outro
+	) const {
+		// Compara as caixas que envolvem cada um, com uma clula de folga.
+		return abs( linha  - outro.linha  ) <= raio_max + outro.raio_max + 2 &&
+		       abs( coluna - outro.coluna ) <= raio_max + outro.raio_max + 2;
+	}
+};
+
+
+
+struct FaseLarga {
+	/*
+	Descrio:
+		Os obstculos de uma chamada, convertidos uma nica vez, e uma grade
+		de baldes de LADO_DO_BALDE metros sobre o campo dizendo quais deles
+		podem tocar cada balde. O teste do caminho direto s olha os baldes
+		que o segmento atravessa, e o carimbo reaproveita as converses.
+		Chamadas seguidas com os mesmos obstculos reaproveitam tudo.
+		Veja montar_fase_larga() em a_estrela.cpp.
+	*/
+	std::vector<float>             obstaculos;  // cpia do que foi montado, para reaproveitar a montagem
+	std::vector<ObstaculoNoQuadro> convertidos;
+	std::vector<float>             x, y;        // centro em metros
+	std::vector<float>             maior_raio;  // max( raio_hard, raio_soft ), limitado a DIST_MAX
+
+	/*
+	Baldes em formato compacto: os obstculos do balde b so
+	indices[ inicio_do_balde[b] .. inicio_do_balde[b + 1] ).
+	*/
+	std::vector<int>          inicio_do_balde;
+	std::vector<int>          indices;
+	std::vector<int>          caixas;  // [bx_min][bx_max][by_min][by_max] de cada obstculo
+	std::vector<unsigned int> visto_na_consulta;  // evita testar duas vezes quem ocupa vrios baldes
+	unsigned int              consulta;
+
+	// Resumo de 64 bits dos convertidos, refeito s quando eles mudam. Veja CacheDeCaminhos.
+	unsigned long long        resumo;
+
+	FaseLarga() : consulta( 0 ), resumo( 0 ) {}
+};
+
+#define CAPACIDADE_DO_CACHE 64  // caminhos guardados por contexto, veja CacheDeCaminhos
+
+struct ChaveDoCache {
+	/*
+	Tudo de que o resultado de uma busca depende depois do teste do caminho
+	direto: as clulas de incio e fim, os modos e os obstculos j
+	convertidos. Os floats exatos de incio e alvo no entram, pois a busca
+	s enxerga clulas.
+	*/
+	int                inicio;
+	int                fim;             // -1 quando vamos ao gol
+	unsigned int       modos;           // permisso para sair e os modos de OpcoesDeBusca que mudam o caminho
+	float              horizonte_fino;  // s conta com em_dois_niveis
+	int                quantidade_de_obstaculos;
+	unsigned long long obstaculos;      // FaseLarga::resumo
+
+	inline bool
+	operator==(
+		const ChaveDoCache& outra
+	) const {
+		// O resumo vem primeiro,  o que mais difere entre consultas.
+		return obstaculos     == outra.obstaculos     && inicio == outra.inicio && fim   == outra.fim   &&
+		       modos          == outra.modos          && quantidade_de_obstaculos == outra.quantidade_de_obstaculos &&
+		       horizonte_fino == outra.horizonte_fino;
+	}
+};
+
+struct CacheDeCaminhos {
+	/*
+	Descrio:
+		Os ltimos caminhos buscados por um contexto, usados por
+		OpcoesDeBusca::usar_cache. Dentro de um ciclo, e de um ciclo para o
+		outro, o mesmo agente pede quase sempre o mesmo caminho: mesma clula
+		de incio, mesmo alvo e os mesmos obstculos depois de convertidos.
+
+		Guarda at CAPACIDADE_DO_CACHE caminhos e, quando cheio, descarta o
+		usado h mais tempo (LRU). Com to poucas entradas, procurar  uma
+		varredura comparando primeiro o resumo dos obstculos, que sai mais
+		barata que um mapa de hash e no aloca nada. Cada entrada mantm o
+		seu vetor, que s cresce, logo em regime nada  alocado.
+
+		Veja procurar_no_cache() e guardar_no_cache() em a_estrela.cpp.
+	*/
+	struct Entrada {
+		ChaveDoCache       chave;
+		unsigned long long ultimo_uso;  // 0 quando vazia
+		std::vector<float> caminho;     // [x, y, ..., status, custo], j suavizado se for o caso
+		float              fator_de_suboptimalidade;
+
+		Entrada() : ultimo_uso( 0 ), fator_de_suboptimalidade( 1.f ) {}
+	};
+
+	std::vector<Entrada> entradas;
+	unsigned long long   relogio;
+
+	/*
+	Estado da chamada em andamento. buscar_caminho() monta a chave e procura,
+	e a_estrela() guarda o caminho s no fim, depois da suavizao.
+	*/
+	ChaveDoCache chave_da_chamada;
+	bool         guardar_ao_fim;
+	bool         veio_do_cache;
+
+	CacheDeCaminhos() :
+		entradas       ( CAPACIDADE_DO_CACHE ),
+		relogio        ( 0 ),
+		guardar_ao_fim ( false ),
+		veio_do_cache  ( false )
+	{}
+
+	inline void
+	limpar(){
+
+		for(
+			int i = 0;
+			i < (int) entradas.size();
+			i++
+		){
+			entradas[i].ultimo_uso = 0;
+		}
+	}
+};
+
+struct PlanoGrosso {
+	/*
+	Descrio:
+		Quadro de blocos de TAMANHO_DO_BLOCO x TAMANHO_DO_BLOCO clulas usado
+		por OpcoesDeBusca::em_dois_niveis, com o que a busca grossa precisa.
+		Fica no contexto e  dimensionado na primeira busca que o usa.
+	*/
+	std::vector<float> custo_do_bloco;     // pior custo de entrar numa clula do bloco, -1 se todas so impossveis
+	std::vector<int>   objetivo_no_bloco;  // uma clula objetivo do bloco, -1 se no h
+	std::vector<float> g;                  // custo acumulado da busca grossa
+	std::vector<int>   pai;                // bloco pai, -1 no incio
+	std::vector<int>   caminho;            // blocos do caminho grosso, do incio ao objetivo
+	std::vector<int>   desmarcados;        // objetivos retirados do quadro durante a busca fina
+
+	std::vector<std::pair<float, int>> fila;  // heap de (valor, bloco), com cpias velhas descartadas na sada
+};
+
+struct EstatisticasDaBusca {
+	/*
+	Descrio:
+		Para onde foi o tempo de uma chamada de a_estrela(), ou de vrias,
+		quando acumuladas. Tempos em nanossegundos, divididos em etapas:
+
+		atalho       -> montar_fase_larga() e o teste do caminho direto
+		preparo      -> preparar_quadro_de_custo(). O amortecimento das bordas
+		                j vem pronto no quadro base, ento o preparo  s a
+		                restaurao das linhas sujas pela chamada anterior
+		carimbo      -> obstculos e objetivo escritos no quadro
+		reconstrucao -> construir_caminho_final() e suavizar_caminho()
+		busca        -> todo o resto, vulgo o lao do A* em qualquer modo e a
+		                previso de OpcoesDeBusca::obstaculos_em_movimento
+
+		Custam poucas leituras de relgio por chamada, podem ficar ligadas em jogo.
+	*/
+	long long chamadas;
+	long long caminhos_diretos;       // resolvidas pelo teste do caminho direto
+	long long tempos_esgotados;       // status 1
+	long long expansoes;
+	long long linhas_restauradas;
+	long long obstaculos_carimbados;
+	long long acertos_no_cache;       // resolvidas por CacheDeCaminhos, sem busca
+	int       maior_lista_aberta;     // pico da lista aberta, o maior entre as chamadas
+
+	long long tempo_total;
+	long long tempo_do_atalho;
+	long long tempo_de_preparo;
+	long long tempo_de_carimbo;
+	long long tempo_de_busca;
+	long long tempo_de_reconstrucao;
+	long long pior_tempo_total;       // a chamada mais lenta
+
+	EstatisticasDaBusca() { zerar(); }
+
+	inline void
+	zerar(){
+		chamadas              = 0;
+		caminhos_diretos      = 0;
+		tempos_esgotados      = 0;
+		expansoes             = 0;
+		linhas_restauradas    = 0;
+		obstaculos_carimbados = 0;
+		acertos_no_cache      = 0;
+		maior_lista_aberta    = 0;
+		tempo_total           = 0;
+		tempo_do_atalho       = 0;
+		tempo_de_preparo      = 0;
+		tempo_de_carimbo      = 0;
+		tempo_de_busca        = 0;
+		tempo_de_reconstrucao = 0;
+		pior_tempo_total      = 0;
+	}
+
+	inline void
+	acumular(
+		const EstatisticasDaBusca& outra
+	){
+		chamadas              += outra.chamadas;
+		caminhos_diretos      += outra.caminhos_diretos;
+		tempos_esgotados      += outra.tempos_esgotados;
+		expansoes             += outra.expansoes;
+		linhas_restauradas    += outra.linhas_restauradas;
+		obstaculos_carimbados += outra.obstaculos_carimbados;
+		acertos_no_cache      += outra.acertos_no_cache;
+		tempo_total           += outra.tempo_total;
+		tempo_do_atalho       += outra.tempo_do_atalho;
+		tempo_de_preparo      += outra.tempo_de_preparo;
+		tempo_de_carimbo      += outra.tempo_de_carimbo;
+		tempo_de_busca        += outra.tempo_de_busca;
+		tempo_de_reconstrucao += outra.tempo_de_reconstrucao;
+
+		maior_lista_aberta = maior_lista_aberta > outra.maior_lista_aberta ? maior_lista_aberta : outra.maior_lista_aberta;
+		pior_tempo_total   = pior_tempo_total   > outra.pior_tempo_total   ? pior_tempo_total   : outra.pior_tempo_total;
+	}
+};
+
+class ContextoDePlanejamento {
+	/*
+	Descrio:
+		Rene tudo o que uma chamada de a_estrela() escreve.
+
+		Antes, o caminho final e o min_node eram globais e os ns viviam na
+		pilha da funo, logo duas buscas simultneas se atropelavam. Agora
+		cada contexto  dono do seu quadro de ns, da sua lista aberta e do
+		seu caminho final. Threads diferentes podem planejar ao mesmo tempo,
+		desde que cada uma use o seu prprio contexto.
+
+		Os buffers so alocados uma nica vez, no construtor. O estado por
+		clula da busca fica numa nica arena, veja o construtor.
+	*/
+public:
+
+	ContextoDePlanejamento();
+	~ContextoDePlanejamento();
+
+	// No faz sentido copiar alguns MB sem querer.
+	ContextoDePlanejamento( const ContextoDePlanejamento& ) = delete;
+	ContextoDePlanejamento& operator=( const ContextoDePlanejamento& ) = delete;
+
+	/*
+	Resultado da ltima busca: [x1, y1, ..., xn, yn, status, custo].
+	*/
+	float caminho_final[
+	    // Acredito que seja o comprimento total
+	    2050
+	];
+	int tamanho_do_caminho_final;
+
+	/*
+	Estado da busca, reaproveitado entre chamadas.
+
+	Antes era um Node por clula, com 4 ponteiros e 2 floats (40 bytes),
+	mais um unsigned int de estado ao lado. Agora so vetores separados,
+	indexados pela posio no quadro (linha * QUANT_COLUNAS + coluna), e o
+	pai  a posio dele, no um ponteiro. So 10 bytes por clula, e cada
+	expanso s toca nos vetores de que precisa.
+
+	Nada disso  zerado entre buscas. O estado  uma marca com a gerao da
+	busca, e marcas antigas valem como desconhecido, veja estado_na_geracao()
+	em a_estrela.cpp. Custo e pai s so lidos de ns com marca vlida.
+	*/
+	float*          custo_dos_nodes;    // custo acumulado desde o incio, vulgo g
+	int*            parente_dos_nodes;  // posio do pai, -1 no incio
+	unsigned short* estado_dos_nodes;   // geracao + estado - 1, menor que geracao  desconhecido
+	unsigned short  geracao_dos_nodes;  // gerao da ltima busca
+	ListaAberta*    lista_aberta;
+	BuscaPorSaltos* busca_por_saltos;  // s usado com OpcoesDeBusca::pontos_de_salto
+
+	/*
+	Quadro de custo da ltima busca. Em vez de remont-lo do zero, a prxima
+	chamada copia do quadro base apenas as linhas que a anterior sujou com
+	obstculos e objetivo. Veja preparar_quadro_de_custo().
+	*/
+	float*        quadro_de_custo;
+	bool*         linhas_sujas;
+	int           quadro_preparado_para;  // -1 nenhum, 0 dentro do campo, 1 fora permitido
+
+	// Bloco nico de onde saem os vetores acima, veja o construtor.
+	unsigned char* arena;
+
+	// Ns retirados da lista aberta na ltima busca, 0 se o caminho direto bastou.
+	int           expansoes_na_ultima_busca;
+
+	/*
+	Garantia sobre o custo do caminho da ltima busca com status 0 ou 3: ele
+	custa no mximo isso vezes o timo.  1 no A* comum e pode ser maior na
+	busca em qualquer tempo, veja OpcoesDeBusca::em_qualquer_tempo. Infinito
+	quando o fim do caminho veio da busca grossa de em_dois_niveis.
+	*/
+	float         fator_de_suboptimalidade;
+
+	// Clulas alcanadas pela busca em qualquer tempo, para refazer a lista aberta entre iteraes.
+	std::vector<int> posicoes_tocadas;
+
+	// S usado com OpcoesDeBusca::em_dois_niveis.
+	PlanoGrosso plano_grosso;
+
+	// Parmetros com os obstculos j previstos, veja OpcoesDeBusca::obstaculos_em_movimento.
+	std::vector<float> parametros_previstos;
+
+	// Obstculos da ltima chamada, montados antes do teste do caminho direto.
+	FaseLarga fase_larga;
+
+	// S usado com OpcoesDeBusca::usar_cache.
+	CacheDeCaminhos cache_de_caminhos;
+
+	/*
+	Instrumentao de a_estrela() com este contexto: a ltima chamada e a
+	soma desde o ltimo reset_stats(). Veja EstatisticasDaBusca.
+	*/
+	EstatisticasDaBusca estatisticas_da_ultima_busca;
+	EstatisticasDaBusca estatisticas_acumuladas;
+};
+
+struct OpcoesDeBusca {
+	/*
+	Descrio:
+		Escolhas feitas a cada consulta, que no cabem no vetor de parmetros
+		sem quebrar o formato que o Python j monta.
+
+		pontos_de_salto -> Jump Point Search. Atravessa de uma vez as faixas de
+		                   custo zero do campo e s abre ns onde o custo muda,
+		                   veja BuscaPorSaltos em a_estrela.cpp. O custo do
+		                   caminho  o mesmo do A* comum, mas entre caminhos
+		                   de mesmo custo a escolha pode ser outra.
+
+		em_qualquer_tempo -> ARA*. A primeira busca usa a heurstica inflada
+		                     por peso_inicial e acha rpido um caminho completo,
+		                     que custa no mximo peso_inicial vezes o timo. At
+		                     o timeout, o peso vai caindo de reducao_do_peso em
+		                     reducao_do_peso e o caminho  melhorado, reaproveitando
+		                     a busca anterior. Com o timeout, devolvemos o melhor
+		                     caminho completo j achado, e no um pedao. A
+		                     garantia fica em fator_de_suboptimalidade do contexto.
+		                     Tem precedncia sobre pontos_de_salto.
+
+		qualquer_angulo -> Depois da busca, o caminho em escada de clulas
+		                    encurtado por linha de visada, veja suavizar_caminho().
+		                   Sobram apenas os pontos onde o rob precisa virar.
+		                   Combina com qualquer um dos modos acima.
+
+		em_dois_niveis -> Para caminhos longos. Uma busca num quadro grosso,
+		                  de blocos de 0.5m com o pior custo de cada bloco,
+		                  acha o corredor at o objetivo. A busca fina roda
+		                  apenas na janela desse corredor at horizonte_fino
+		                  metros do incio, e o resto do caminho so os
+		                  centros dos blocos do corredor. Consultas mais curtas
+		                  que o horizonte, ou que o quadro grosso no resolve,
+		                  seguem a busca normal. Tem precedncia sobre
+		                  pontos_de_salto e em_qualquer_tempo.
+
+		obstaculos_em_movimento -> Cada obstculo vem com 7 valores, os 5 de
+		                           sempre mais [vx][vy] em m/s. Antes da busca,
+		                           cada um  levado para onde estar quando o
+		                           agente, a velocidade_do_agente, puder
+		                           alcan-lo, limitado a horizonte_de_previsao
+		                           segundos. O raio soft cresce incerteza_da_previsao
+		                           vezes o quanto ele andou, j que a previso
+		                           piora com o tempo. Obstculos parados ficam
+		                           exatamente como no formato de 5 valores.
+
+		usar_cache -> Depois do teste do caminho direto, procura a consulta no
+		              CacheDeCaminhos do contexto antes de buscar, e guarda o
+		              resultado no fim. Consultas com as mesmas clulas de incio
+		              e fim, os mesmos modos e os mesmos obstculos convertidos
+		              devolvem o caminho guardado, com o ltimo ponto trocado
+		              pelo alvo exato da consulta. Resultados com timeout e os
+		              de em_qualquer_tempo, que dependem do relgio, no so
+		              guardados.
+	*/
+	bool  pontos_de_salto;
+	bool  em_qualquer_tempo;
+	bool  qualquer_angulo;
+	bool  em_dois_niveis;
+	bool  obstaculos_em_movimento;
+	bool  usar_cache;
+	float peso_inicial;
+	float reducao_do_peso;
+	float horizonte_fino;
+	float velocidade_do_agente;   // m/s
+	float horizonte_de_previsao;  // s
+	float incerteza_da_previsao;
+
+	OpcoesDeBusca() :
+		pontos_de_salto         ( false ),
+		em_qualquer_tempo       ( false ),
+		qualquer_angulo         ( false ),
+		em_dois_niveis          ( false ),
+		obstaculos_em_movimento ( false ),
+		usar_cache              ( false ),
+		peso_inicial            ( 2.5f  ),
+		reducao_do_peso         ( 0.5f  ),
+		horizonte_fino          ( 3.f   ),
+		velocidade_do_agente    ( 0.7f  ),
+		horizonte_de_previsao   ( 2.f   ),
+		incerteza_da_previsao   ( 0.5f  )
+	{}
+};
+
+extern void a_estrela(
+	/*
+	O retorno acontece na modificao do caminho final
+	do contexto fornecido.
+	*/
+	ContextoDePlanejamento& contexto,
+    float parametros[],
+    int quantidade_de_parametros,
+    const OpcoesDeBusca& opcoes = OpcoesDeBusca()
+);
+
 extern void a_estrela(
 	/*
-	O retorno acontece na modificao do ponteiro 
-	do caminho final.
+	Mesma coisa, usando o contexto da thread que chamou.
 	*/
     float parametros[],
-    int quantidade_de_parametros
+    int quantidade_de_parametros,
+    const OpcoesDeBusca& opcoes = OpcoesDeBusca()
 );
 
-extern float caminho_final[
-    // Acredito que seja o comprimento total
-    2050
-];
+extern ContextoDePlanejamento& contexto_da_thread();
+
+extern void suavizar_caminho(
+	/*
+	Caminho no formato de sada de a_estrela(), [x, y, ..., status, custo],
+	reescrito no lugar. O tamanho  atualizado.
+	*/
+	float caminho[],
+	int& tamanho_do_caminho,
+	const float quadro_de_custo[],
+	int limite_para_qual_custo_eh_impossivel
+);
+
+class ReplanejadorIncremental {
+	/*
+	Descrio:
+		Planejador persistente para quem replaneja o mesmo problema a cada
+		ciclo, como o agente que persegue um alvo enquanto os adversrios
+		andam alguns centmetros.
+
+		Usa D* Lite (Koenig e Likhachev): a busca parte do objetivo rumo ao
+		agente, logo o agente pode se mover sem invalidar nada. Entre
+		chamadas guardamos o quadro de custo, os custos g/rhs e a fila. A
+		cada chamada comparamos a lista de obstculos com a anterior,
+		recarimbamos somente a regio dos obstculos que mudaram e
+		reparamos apenas os ns afetados pelas clulas cujo custo mudou.
+
+		Mudar a permisso de sair do campo, o modo ir ao gol ou a clula
+		do alvo reinicia a busca do zero.
+
+		Quando o alvo  inalcanvel ou o tempo acaba, a resposta vem do
+		a_estrela() comum, que sabe devolver o melhor caminho parcial.
+		A busca interrompida continua de onde parou na prxima chamada.
+
+		Mudanas perto do objetivo podem exigir um reparo maior que uma busca
+		nova. Se o reparo passar do nmero de expanses da ltima busca
+		completa, desistimos dele e recomeamos.
+
+		O resultado tem o mesmo formato de a_estrela(). Um objeto no pode
+		ser usado por duas threads ao mesmo tempo.
+	*/
+public:
+
+	ReplanejadorIncremental();
+	~ReplanejadorIncremental();
+
+	ReplanejadorIncremental( const ReplanejadorIncremental& ) = delete;
+	ReplanejadorIncremental& operator=( const ReplanejadorIncremental& ) = delete;
+
+	void planejar(
+		float parametros[],  // Mesmo formato de a_estrela()
+		int quantidade_de_parametros
+	);
+
+	// Esquece tudo, a prxima chamada faz uma busca completa.
+	void reiniciar();
+
+	float caminho_final[ 2050 ];
+	int   tamanho_do_caminho_final;
+
+	/*
+	Informaes da ltima chamada, teis para ver se o reparo compensa.
+	*/
+	int  expansoes_na_ultima_chamada;
+	int  celulas_alteradas_na_ultima_chamada;
+	bool ultima_chamada_foi_incremental;
+
+private:
 
-extern int tamanho_do_caminho_final;
+	struct EntradaDaFila {
+		float k1;
+		float k2;
+		int   posicao;
+	};
+
+	void  inicializar( const float obstaculos[], int quantidade_de_obstaculos );
+	int   aplicar_obstaculos( const float obstaculos[], int quantidade_de_obstaculos );
+	bool  computar_caminho_mais_curto( long long tempo_limite, long long tempo_ja_gasto, int limite_de_expansoes );
+	void  construir_caminho();
+
+	void  atualizar_vertice( int posicao );
+	void  atualizar_pertinencia( int posicao );
+	float custo_da_aresta( int de, int para, float passo ) const;
+	float heuristica( int posicao ) const;
+	void  calcular_chave( int posicao, float& k1, float& k2 ) const;
+	bool  eh_objetivo( int posicao ) const;
+	bool  eh_celula_do_alvo( int posicao ) const;
+
+	void  fila_colocar( int posicao, float k1, float k2 );
+	void  fila_remover( int posicao );
+	void  fila_subir  ( int indice );
+	void  fila_descer ( int indice );
+
+	// Estado do problema atual
+	bool  inicializado;
+	bool  permissao_para_ir_para_alem_dos_limites;
+	bool  ir_ao_gol;
+	int   limite_para_qual_custo_eh_impossivel;
+	float alvo_x, alvo_y;
+	int   alvo_linha, alvo_coluna;
+	int   start_pos;
+	int   ultimo_start_pos;
+	float km;
+	int   expansoes_da_busca_completa;  // teto para um reparo, veja planejar()
+
+	std::vector<float> obstaculos_anteriores;
+
+	// Quadros, todos com QUANT_LINHAS * QUANT_COLUNAS posies
+	const float*  quadro_base;      // campo + amortecimento, sem obstculos (compartilhado)
+	float*        quadro_de_custo;  // com obstculos e objetivo
+	float*        g;
+	float*        rhs;
+	unsigned int* marcas;
+	unsigned int  marca_atual;
+
+	// Fila de prioridade indexada do D* Lite
+	EntradaDaFila* fila;
+	int*           indice_na_fila;  // -1 se fora da fila
+	int            tamanho_da_fila;
+};
+
+class CampoAteOAlvo {
+	/*
+	Descrio:
+		Custo at o alvo de todas as clulas do campo, calculado uma vez e
+		compartilhado por quantos agentes planejarem para o mesmo alvo com os
+		mesmos obstculos, como o gol adversrio.
+
+		 um Dijkstra reverso: parte das clulas do objetivo e se espalha
+		pelo campo inteiro, com as mesmas arestas de a_estrela(). Cada clula
+		guarda o vizinho por onde desce at o objetivo, logo o caminho de
+		qualquer ponto sai em O(tamanho do caminho), sem busca nenhuma.
+
+		O campo cobre o quadro inteiro, e no s a janela que a_estrela()
+		recorta ao redor do incio e do objetivo, ento o custo daqui pode
+		sair menor que o do A* comum, nunca maior.
+
+		Clulas que no alcanam o objetivo ficam com custo infinito. Um
+		objeto no pode ser usado por duas threads ao mesmo tempo, mas depois
+		de calcular() qualquer nmero de leitores pode usar caminho_a_partir_de().
+	*/
+public:
+
+	CampoAteOAlvo();
+	~CampoAteOAlvo();
+
+	CampoAteOAlvo( const CampoAteOAlvo& ) = delete;
+	CampoAteOAlvo& operator=( const CampoAteOAlvo& ) = delete;
+
+	void calcular(
+		const float parametros[],  // Mesmo formato de a_estrela(), o incio e o timeout so ignorados
+		int quantidade_de_parametros
+	);
+
+	/*
+	Caminho a partir de (start_x, start_y) em 'caminho', no mesmo formato de
+	a_estrela(). Retorna o tamanho usado, no mximo 2050 floats. Status 3 se o
+	caminho direto basta, 0 se desce pelo campo, 2 se o incio no alcana
+	o objetivo, com apenas o incio no caminho.
+	*/
+	int caminho_a_partir_de(
+		float start_x,
+		float start_y,
+		float caminho[]
+	) const;
+
+	/*
+	Custo at o objetivo, QUANT_LINHAS x QUANT_COLUNAS, na mesma unidade do
+	custo que a_estrela() devolve. Infinito onde no h caminho.
+	*/
+	float* custo_ate_o_alvo;
+	int    expansoes_no_ultimo_calculo;
+	bool   calculado;
+
+private:
+
+	bool  ir_ao_gol;
+	int   limite_para_qual_custo_eh_impossivel;
+	float alvo_x, alvo_y;
+
+	std::vector<float> obstaculos;  // para a checagem do caminho direto
+
+	const float*   quadro_base;
+	float*         quadro_de_custo;
+	int*           proxima_posicao;  // vizinho rumo ao objetivo, -1 no objetivo e onde no h caminho
+	unsigned char* estado;           // 0 desconhecido, 1 aberto, 2 fechado
+
+	/*
+	Fila de Dial: a caamba k guarda as posies com custo em [k, k + 1).
+	Toda aresta custa pelo menos 1, ento nenhuma posio de uma caamba
+	melhora outra da mesma, e a ordem dentro dela no importa.
+	*/
+	std::vector< std::vector<int> > cacambas;
+};
+
+struct ResultadoEmLote {
+	/*
+	Descrio:
+		Resultado de vrias buscas, empacotado em vetores contguos.
+
+		O caminho da consulta i  caminhos[ deslocamentos[i] : deslocamentos[i + 1] ],
+		no mesmo formato [x1, y1, ..., xn, yn], porm sem status e custo, que
+		ficam em status[i] e custos[i].
+	*/
+	std::vector<float> caminhos;
+	std::vector<int>   deslocamentos;  // quantidade_de_consultas + 1 elementos
+	std::vector<float> status;
+	std::vector<float> custos;
+};
+
+extern void a_estrela_em_lote(
+	/*
+	Executa vrias buscas em um grupo de threads, cada uma com o seu contexto.
+
+	Cada linha de 'consultas' tem os 7 parmetros fixos de a_estrela() e todas
+	compartilham a mesma lista de obstculos.
+	*/
+	const float consultas[],
+	int quantidade_de_consultas,
+	const float obstaculos[],
+	int quantidade_de_obstaculos,  // em floats, ou seja, 5 por obstculo
+	int quantidade_de_threads,     // <= 0 usa todos os ncleos
+	ResultadoEmLote& resultado,
+	const OpcoesDeBusca& opcoes = OpcoesDeBusca()  // valem para todas as consultas
+);
 
 ////////////////////////////////////////////////////////////////////////////
 /// Definies Inerentes  Otimizao
@@ -93,9 +761,8 @@ extern int tamanho_do_caminho_final;
 #define QUANT_LINHAS 321
 #define QUANT_COLUNAS 221
 #define DIST_MAX 5  // Por exemplo, mxima distncia  um alvo.
-#define LINHA_DO_GOL 312  // Linha alvo quando a varivel ir_ao_gol  verdadeira, veja na funo a_estrela()
 
-#define TAMANHO_DO_AMORTECIMENTO 6  // relacionado  funo adicionar_espaco_de_amortecimento.
+#define TAMANHO_DO_AMORTECIMENTO 6  // relacionado ao amortecimento das bordas, veja QuadrosDoCampo em campo.h.
 
 ////////////////////////////////////////////////////////////////////////////
 /// Representao do Campo
@@ -119,34 +786,9 @@ Cr
 
 /*
 [(H)ard wall: -3, (S)oft wall: -2, (E)mpty: 0, 0 < Cost < inf] 
-As seguintes definies representam a matriz de pontos disponveis do campo.
-Note que h -3, -2, 0, sendo respectivamente Hard Wall, Soft Wall e Empty.
-
-Parece e  confuso, entretanto, foque apenas no fato da representao e que fazemos
-assim para preservar a legibilidade.
+Antes o campo acima era soletrado aqui em macros (H27, S98, L12x33, ...).
+Agora ele  gerado em tempo de compilao a partir da geometria, assim
+como a linha e as colunas do gol. Veja campo.h.
 */
-#define H27 -3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3  // Elementos de Hard Wall
-#define S11 -2,-2,-2,-2,-2,-2,-2,-2,-2,-2,-2  // Elementos de SoftWall
-#define S19 S11,-2,-2,-2,-2,-2,-2,-2,-2  // Elementos de SoftWall
-#define S97 S11,S11,S11,S11,S11,S11,S11,S11,-2,-2,-2,-2,-2,-2,-2,-2,-2  //
-#define S98 S11,S11,S11,S11,S11,S11,S11,S11,-2,-2,-2,-2,-2,-2,-2,-2,-2,-2
-#define S221 S98,S98,S11,S11,-2,-2,-2
-#define E19 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0
-#define E197 E19,E19,E19,E19,E19,E19,E19,E19,E19,E19,0,0,0,0,0,0,0
-#define L0 S221                              // Line 0: soft W
-#define L0_1 L0,L0
-#define L2 S97,H27,S97                       // Line 2: soft W, (goal post, back net, goal post), soft W
-#define L2_5 L2,L2,L2,L2
-#define L6 S98,-3,-3,-3,S19,-3,-3,-3,S98     // Line 6: soft W, goal post, soft W, goal post, soft W
-#define L6_10 L6,L6,L6,L6,L6
-#define L11 S98,-2,-3,-3,S19,-3,-3,-2,S98  // Line 11:soft W, empty field, goal post, soft W, goal post,empty field, soft W
-#define L12 S11,-2,E197,-2,S11                     // Line 12:soft W, empty field, soft W
-
-#define L12x33 L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12,L12
-#define LIN12_308 L12x33,L12x33,L12x33,L12x33,L12x33,L12x33,L12x33,L12x33,L12x33
-
-#define L309 S98,-2,-3,-3,E19,-3,-3,-2,S98  // Line 309: soft W, empty field, goal post, empty field, goal post,empty field, soft W
-#define L310 S98,-3,-3,-3,E19,-3,-3,-3,S98    // Line 310: soft W, goal post, inside goal, goal post, soft W
-#define L310_314 L310,L310,L310,L310,L310
 
 #endif // A_ESTRELA_H
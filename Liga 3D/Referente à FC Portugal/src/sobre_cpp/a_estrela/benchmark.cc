@@ -0,0 +1,425 @@
+#include "a_estrela.cpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+using std::chrono::nanoseconds;
+
+/*
+Benchmark do A* com cenários parecidos com os de uma partida.
+
+O debug.cc confere se as coisas funcionam e mostra um tempo ou outro. Aqui
+o objetivo é outro: um corpus fixo de consultas, gerado a partir de uma
+semente, para comparar mudanças no planejador contra a carga real.
+
+Uso:
+	make benchmark
+	make benchmark LISTA_ABERTA=RADIX ARGS="2025 1000 saltos"
+
+	./benchmark [semente] [consultas por cenário] [modo]
+
+	modo -> comum, saltos (OpcoesDeBusca::pontos_de_salto),
+	        qualquer_tempo (OpcoesDeBusca::em_qualquer_tempo) ou
+	        dois_niveis (OpcoesDeBusca::em_dois_niveis)
+
+A saída é um JSON em stdout, com latência (p50, p95, p99), expansões,
+taxa de timeout e contagem de status por cenário. Mesma semente, mesmas
+consultas, então dois JSON podem ser comparados cenário a cenário.
+*/
+
+#if defined(LISTA_ABERTA_BST)
+	#define NOME_DO_MOTOR "BST"
+#elif defined(LISTA_ABERTA_RADIX)
+	#define NOME_DO_MOTOR "RADIX"
+#else
+	#define NOME_DO_MOTOR "HEAP"
+#endif
+
+#define TIMEOUT_DO_BENCHMARK 3000  // O mesmo padrão de PathManager.get_path()
+#define MAX_OBSTACULOS 22          // 10 companheiros, 11 adversários e a bola
+#define CICLOS_POR_SEQUENCIA 50    // Consultas seguidas com os mesmos obstáculos andando
+
+typedef std::mt19937 Gerador;
+
+inline float
+sortear(
+	Gerador& gerador,
+	float minimo,
+	float maximo
+){
+	return std::uniform_real_distribution<float>( minimo, maximo )( gerador );
+}
+
+inline void
+adicionar_obstaculos_de_jogo(
+	Gerador& gerador,
+	std::vector<float>& parametros,
+	int quantidade
+){
+	/*
+	Descrição:
+		Obstáculos com os raios e forças que PathManager.get_obstacles()
+		costuma usar: companheiros, adversários e, às vezes, a bola com a
+		sua margem de segurança.
+	*/
+	for(
+		int i = 0;
+		i < quantidade;
+		i++
+	){
+		const float x = sortear( gerador, -15.f, 15.f );
+		const float y = sortear( gerador, -10.f, 10.f );
+		const int   tipo = std::uniform_int_distribution<int>( 0, 9 )( gerador );
+
+		if(
+			// Bola
+			tipo == 0
+		){
+			parametros.insert( parametros.end(), { x, y, 0.f, sortear( gerador, 0.1f, 0.3f ), 8.f } );
+		}
+		else if(
+			// Companheiro
+			tipo <= 4
+		){
+			parametros.insert( parametros.end(), { x, y, sortear( gerador, 0.2f, 0.4f ), tipo == 1 ? 1.5f : 0.6f, 1.f } );
+		}
+		else{
+			// Adversário, de vez em quando o goleiro, com força extra
+			const float raio_soft = tipo == 9 ? 2.3f : ( tipo >= 7 ? 1.f : 0.6f );
+
+			parametros.insert( parametros.end(), { x, y, sortear( gerador, 0.2f, 1.f ), raio_soft, tipo == 5 ? 1.5f : 1.f } );
+		}
+	}
+}
+
+inline std::vector<float>
+consulta_basica(
+	Gerador& gerador,
+	bool ir_ao_gol,
+	bool fora_permitido
+){
+	// [start x][start y][fora?][gol?][alvo x][alvo y][timeout]
+	const float limite_x = fora_permitido ? 16.f : 15.f;
+	const float limite_y = fora_permitido ? 11.f : 10.f;
+
+	return {
+		sortear( gerador, -limite_x, limite_x ),
+		sortear( gerador, -limite_y, limite_y ),
+		(float) fora_permitido,
+		(float) ir_ao_gol,
+		sortear( gerador, -limite_x, limite_x ),
+		sortear( gerador, -limite_y, limite_y ),
+		(float) TIMEOUT_DO_BENCHMARK
+	};
+}
+
+/*
+Obstáculos andando, como PathFinding.move_obstacles(): cada um tem uma
+velocidade e quica nas bordas do campo.
+*/
+struct ObstaculosEmMovimento {
+	std::vector<float> obstaculos;
+	std::vector<float> velocidades;  // vx, vy por obstáculo, em metros por ciclo
+
+	void
+	sortear_novos(
+		Gerador& gerador
+	){
+		obstaculos.clear();
+		velocidades.clear();
+
+		adicionar_obstaculos_de_jogo( gerador, obstaculos, MAX_OBSTACULOS );
+
+		for(
+			int i = 0;
+			i < MAX_OBSTACULOS;
+			i++
+		){
+			// Até ~1m/s, com ciclos de 20ms.
+			velocidades.push_back( sortear( gerador, -0.02f, 0.02f ) );
+			velocidades.push_back( sortear( gerador, -0.02f, 0.02f ) );
+		}
+	}
+
+	void
+	mover(){
+
+		for(
+			int i = 0;
+			i < (int) velocidades.size() / 2;
+			i++
+		){
+			obstaculos[i * 5    ] += velocidades[i * 2    ];
+			obstaculos[i * 5 + 1] += velocidades[i * 2 + 1];
+
+			if(
+				!( -16.f < obstaculos[i * 5] && obstaculos[i * 5] < 16.f )
+			){
+				velocidades[i * 2] *= -1;
+			}
+
+			if(
+				!( -11.f < obstaculos[i * 5 + 1] && obstaculos[i * 5 + 1] < 11.f )
+			){
+				velocidades[i * 2 + 1] *= -1;
+			}
+		}
+	}
+};
+
+struct Cenario {
+	const char* nome;
+	bool        ir_ao_gol;
+	bool        fora_permitido;
+	bool        em_movimento;
+	bool        perto_da_trave;
+};
+
+static const Cenario cenarios[] = {
+	// nome                       gol    fora   movimento  trave
+	{ "gol_dentro_do_campo",      true,  false, false,     false },
+	{ "gol_fora_permitido",       true,  true,  false,     false },
+	{ "alvo_dentro_do_campo",     false, false, false,     false },
+	{ "alvo_fora_permitido",      false, true,  false,     false },
+	{ "obstaculos_em_movimento",  false, false, true,      false },
+	{ "perto_da_trave",           true,  false, false,     true  },
+};
+
+static const int QUANT_CENARIOS = sizeof( cenarios ) / sizeof( Cenario );
+
+std::vector<float>
+gerar_consulta(
+	Gerador& gerador,
+	const Cenario& cenario,
+	int indice,
+	ObstaculosEmMovimento& movimento
+){
+	std::vector<float> parametros = consulta_basica( gerador, cenario.ir_ao_gol, cenario.fora_permitido );
+
+	if(
+		cenario.em_movimento
+	){
+		if(
+			indice % CICLOS_POR_SEQUENCIA == 0
+		){
+			movimento.sortear_novos( gerador );
+		}
+		else{
+			movimento.mover();
+		}
+
+		parametros.insert( parametros.end(), movimento.obstaculos.begin(), movimento.obstaculos.end() );
+	}
+	else if(
+		cenario.perto_da_trave
+	){
+		/*
+		Começamos colados numa das traves adversárias, que entram como
+		obstáculos com a margem de PathManager.get_obstacles(), com o
+		goleiro e alguns defensores por perto.
+		*/
+		const float lado = indice % 2 ? 1.f : -1.f;
+
+		parametros[0] = sortear( gerador, 13.6f, 15.4f );
+		parametros[1] = lado * sortear( gerador, 0.7f, 1.6f );
+
+		const float margem = sortear( gerador, 0.1f, 0.3f );
+
+		parametros.insert( parametros.end(), {
+			14.75f,  1.10f, margem, 0, 0,
+			14.75f, -1.10f, margem, 0, 0,
+			sortear( gerador, 14.f, 15.f ), sortear( gerador, -0.8f, 0.8f ), 0.5f, 2.3f, 1.5f  // goleiro
+		} );
+
+		adicionar_obstaculos_de_jogo( gerador, parametros, std::uniform_int_distribution<int>( 0, 4 )( gerador ) );
+	}
+	else{
+		adicionar_obstaculos_de_jogo( gerador, parametros, std::uniform_int_distribution<int>( 0, MAX_OBSTACULOS )( gerador ) );
+	}
+
+	return parametros;
+}
+
+template <typename T>
+T
+percentil(
+	const std::vector<T>& ordenado,
+	double p
+){
+	// Posto mais próximo, o vetor já deve estar ordenado.
+	if(
+		ordenado.empty()
+	){
+		return T( 0 );
+	}
+
+	int indice = (int) std::ceil( p / 100.0 * ordenado.size() ) - 1;
+	indice = std::max( 0, std::min( indice, (int) ordenado.size() - 1 ) );
+
+	return ordenado[indice];
+}
+
+struct Medidas {
+	std::vector<double> latencias;  // em microssegundos
+	std::vector<int>    expansoes;
+	int                 status[4];
+
+	Medidas() { std::fill( status, status + 4, 0 ); }
+
+	void
+	imprimir(
+		const char* nome,
+		bool ultimo
+	){
+		std::sort( latencias.begin(), latencias.end() );
+		std::sort( expansoes.begin(), expansoes.end() );
+
+		double soma_das_latencias = 0;
+		double soma_das_expansoes = 0;
+
+		for(
+			int i = 0;
+			i < (int) latencias.size();
+			i++
+		){
+			soma_das_latencias += latencias[i];
+			soma_das_expansoes += expansoes[i];
+		}
+
+		const int quantidade = std::max( 1, (int) latencias.size() );
+
+		printf( "    {\n" );
+		printf( "      \"nome\": \"%s\",\n", nome );
+		printf( "      \"consultas\": %d,\n", (int) latencias.size() );
+		printf(
+			"      \"latencia_us\": { \"p50\": %.2f, \"p95\": %.2f, \"p99\": %.2f, \"media\": %.2f, \"max\": %.2f },\n",
+			percentil( latencias, 50 ),
+			percentil( latencias, 95 ),
+			percentil( latencias, 99 ),
+			soma_das_latencias / quantidade,
+			latencias.empty() ? 0.0 : latencias.back()
+		);
+		printf(
+			"      \"expansoes\": { \"p50\": %d, \"p95\": %d, \"p99\": %d, \"media\": %.1f },\n",
+			percentil( expansoes, 50 ),
+			percentil( expansoes, 95 ),
+			percentil( expansoes, 99 ),
+			soma_das_expansoes / quantidade
+		);
+		printf( "      \"taxa_de_timeout\": %.4f,\n", status[1] / (double) quantidade );
+		printf(
+			"      \"status\": { \"sucesso\": %d, \"timeout\": %d, \"impossivel\": %d, \"direto\": %d }\n",
+			status[0], status[1], status[2], status[3]
+		);
+		printf( "    }%s\n", ultimo ? "" : "," );
+	}
+};
+
+int main(
+	int argc,
+	char* argv[]
+){
+	const unsigned int semente               = argc > 1 ? (unsigned int) atoi( argv[1] ) : 2025;
+	const int          consultas_por_cenario = argc > 2 ? atoi( argv[2] ) : 500;
+	const char*        modo                  = argc > 3 ? argv[3] : "comum";
+
+	OpcoesDeBusca opcoes;
+
+	if(
+		strcmp( modo, "saltos" ) == 0
+	){
+		opcoes.pontos_de_salto = true;
+	}
+	else if(
+		strcmp( modo, "qualquer_tempo" ) == 0
+	){
+		opcoes.em_qualquer_tempo = true;
+	}
+	else if(
+		strcmp( modo, "dois_niveis" ) == 0
+	){
+		opcoes.em_dois_niveis = true;
+	}
+	else if(
+		strcmp( modo, "comum" ) != 0
+	){
+		fprintf( stderr, "modo desconhecido: %s (use comum, saltos, qualquer_tempo ou dois_niveis)\n", modo );
+		return 1;
+	}
+
+	ContextoDePlanejamento& contexto = contexto_da_thread();
+
+	{
+		// Aquecimento: quadros base, tabelas do carimbo e páginas do contexto.
+		Gerador gerador( semente + 1 );
+		ObstaculosEmMovimento movimento;
+
+		for(
+			int i = 0;
+			i < 50;
+			i++
+		){
+			std::vector<float> parametros = gerar_consulta( gerador, cenarios[i % QUANT_CENARIOS], i, movimento );
+			a_estrela( contexto, parametros.data(), (int) parametros.size(), opcoes );
+		}
+	}
+
+	Medidas medidas[QUANT_CENARIOS];
+	Medidas todas;
+
+	for(
+		int c = 0;
+		c < QUANT_CENARIOS;
+		c++
+	){
+		// Cada cenário com o seu gerador, então mudar um não mexe nas consultas dos outros.
+		Gerador gerador( semente * 31u + c );
+		ObstaculosEmMovimento movimento;
+
+		for(
+			int i = 0;
+			i < consultas_por_cenario;
+			i++
+		){
+			std::vector<float> parametros = gerar_consulta( gerador, cenarios[c], i, movimento );
+
+			auto inicio = high_resolution_clock::now();
+			a_estrela( contexto, parametros.data(), (int) parametros.size(), opcoes );
+			auto fim = high_resolution_clock::now();
+
+			const double latencia = duration_cast<nanoseconds>( fim - inicio ).count() / 1000.0;
+			const int    status   = (int) contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ];
+
+			medidas[c].latencias.push_back( latencia );
+			medidas[c].expansoes.push_back( contexto.expansoes_na_ultima_busca );
+			medidas[c].status[ status & 3 ]++;
+
+			todas.latencias.push_back( latencia );
+			todas.expansoes.push_back( contexto.expansoes_na_ultima_busca );
+			todas.status[ status & 3 ]++;
+		}
+	}
+
+	printf( "{\n" );
+	printf( "  \"motor\": \"%s\",\n", NOME_DO_MOTOR );
+	printf( "  \"modo\": \"%s\",\n", modo );
+	printf( "  \"semente\": %u,\n", semente );
+	printf( "  \"consultas_por_cenario\": %d,\n", consultas_por_cenario );
+	printf( "  \"timeout_us\": %d,\n", TIMEOUT_DO_BENCHMARK );
+	printf( "  \"cenarios\": [\n" );
+
+	for(
+		int c = 0;
+		c < QUANT_CENARIOS;
+		c++
+	){
+		medidas[c].imprimir( cenarios[c].nome, false );
+	}
+	todas.imprimir( "todos", true );
+
+	printf( "  ]\n" );
+	printf( "}\n" );
+
+	return 0;
+}
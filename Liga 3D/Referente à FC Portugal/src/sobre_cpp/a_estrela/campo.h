@@ -0,0 +1,309 @@
+/*
+Quadro base do A*, gerado em tempo de compilação a partir da geometria do campo.
+
+Antes o quadro era soletrado em macros (H27, S98, L12x33, LIN12_308, ...)
+que só serviam para um campo de 32m x 22m, com o gol fixo nas colunas
+101 a 119 e LINHA_DO_GOL 312. Trocar de campo significava refazer a tabela
+na mão.
+
+Agora cada campo é só uma descrição em metros, com os mesmos valores de
+RobovizField (ambientacao/RobovizField.h), e QuadrosDoCampo<Geometria> monta
+os dois quadros base num construtor constexpr. O compilador entrega as 70 mil
+células prontas na seção de dados, então trocar de campo não custa nada em
+tempo de execução.
+
+A grade continua a mesma, QUANT_LINHAS x QUANT_COLUNAS com 10 células por
+metro e centrada na origem. Os campos menores apenas ocupam menos dela.
+
+Escolha do campo em tempo de compilação:
+
+	-DCAMPO_OFICIAL    -> 30m x 20m, o da competição (padrão)
+	-DCAMPO_DE_TREINO  -> 20m x 14m, com o mesmo gol
+
+Exige C++14, por causa dos laços dentro de funções constexpr.
+*/
+
+#ifndef CAMPO_H
+#define CAMPO_H
+
+#include "a_estrela.h"
+
+#if !defined(CAMPO_OFICIAL) && !defined(CAMPO_DE_TREINO)
+	#define CAMPO_OFICIAL
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+/// Geometrias
+////////////////////////////////////////////////////////////////////////////
+
+struct CampoOficial {
+	// Mesmos valores de RobovizField: cHalfFieldLength, cHalfFieldWidth, cHalfGoalWidth e cGoalDepth.
+	static constexpr double meio_comprimento    = 15.0;
+	static constexpr double meia_largura        = 10.0;
+	static constexpr double meia_largura_do_gol = 1.05;
+	static constexpr double profundidade_do_gol = 0.60;
+};
+
+struct CampoDeTreino {
+	// Campo reduzido dos treinos, com o gol oficial.
+	static constexpr double meio_comprimento    = 10.0;
+	static constexpr double meia_largura        = 7.0;
+	static constexpr double meia_largura_do_gol = 1.05;
+	static constexpr double profundidade_do_gol = 0.60;
+};
+
+////////////////////////////////////////////////////////////////////////////
+/// Medidas no Quadro
+////////////////////////////////////////////////////////////////////////////
+
+constexpr int
+metros_para_celulas(
+	double metros
+){
+	// Arredonda para a célula mais próxima, 10 células por metro. Só para medidas positivas.
+	return int( metros * 10.0 + 0.5 );
+}
+
+constexpr int
+metros_para_celulas_por_baixo(
+	double metros
+){
+	return int( metros * 10.0 );
+}
+
+constexpr int
+metros_para_celulas_por_cima(
+	double metros
+){
+	return int( metros * 10.0 ) + ( metros * 10.0 > int( metros * 10.0 ) );
+}
+
+template<class Geometria>
+struct CampoNoQuadro {
+	/*
+	Descrição:
+		Tudo o que o A* precisa saber do campo, já em células. As distâncias
+		ao longo das linhas (eixo x) são contadas a partir de linha_do_meio e
+		as ao longo das colunas (eixo y), a partir de coluna_do_meio. Os dois
+		gols são iguais, espelhados.
+
+		Os números entre parênteses são os do campo oficial, os mesmos da
+		antiga tabela de macros.
+	*/
+
+	static constexpr int linha_do_meio  = QUANT_LINHAS  / 2;  // (160)
+	static constexpr int coluna_do_meio = QUANT_COLUNAS / 2;  // (110)
+
+	// Linha de fundo e linha lateral (150 e 100).
+	static constexpr int linha_de_fundo  = metros_para_celulas( Geometria::meio_comprimento );
+	static constexpr int linha_lateral   = metros_para_celulas( Geometria::meia_largura     );
+
+	// Último ponto livre do campo, a 0.2m das linhas (148 e 98).
+	static constexpr int fim_do_campo_em_x = linha_de_fundo - 2;
+	static constexpr int fim_do_campo_em_y = linha_lateral  - 2;
+
+	/*
+	No quadro, a trave ocupa 0.1m para cada lado de meia_largura_do_gol,
+	arredondada para fora: a boca vai até 9 e a trave de 10 a 12.
+	*/
+	static constexpr int meia_boca_do_gol      = metros_para_celulas_por_baixo( Geometria::meia_largura_do_gol - 0.1 );
+	static constexpr int face_de_fora_da_trave = metros_para_celulas_por_cima ( Geometria::meia_largura_do_gol + 0.1 );
+
+	// Fundo do gol (156). O interior vai até 2 células antes dele e a rede, de 1 antes até 2 depois.
+	static constexpr int fundo_do_gol         = linha_de_fundo + metros_para_celulas( Geometria::profundidade_do_gol );
+	static constexpr int fim_do_gol           = fundo_do_gol - 2;
+	static constexpr int meia_largura_da_rede = face_de_fora_da_trave + 1;
+
+	// Onde a_estrela() procura quando ir_ao_gol é verdadeiro: meio do interior do gol deles (312, 101 a 119).
+	static constexpr int linha_do_gol           = linha_do_meio  + ( linha_de_fundo + fim_do_gol ) / 2;
+	static constexpr int primeira_coluna_do_gol = coluna_do_meio - meia_boca_do_gol;
+	static constexpr int ultima_coluna_do_gol   = coluna_do_meio + meia_boca_do_gol;
+
+	/*
+	Caixa de cada gol, com uma célula de folga além da rede, usada para
+	ampliar a área de trabalho quando o caminho passa perto dele (1 a 12 e
+	308 a 319 nas linhas, 96 a 124 nas colunas).
+	*/
+	static constexpr int inicio_da_caixa_do_gol  = fim_do_campo_em_x;
+	static constexpr int fim_da_caixa_do_gol     = fundo_do_gol + 3;
+	static constexpr int meia_largura_da_caixa   = meia_largura_da_rede + 1;
+
+	/*
+	Mesmas medidas em metros para o teste do caminho direto, que trabalha
+	fora do quadro. O contorno de fora de cada gol (15.75 e 1.25) e a
+	posição das traves (15.02 e 1.07).
+	*/
+	static constexpr double fundo_de_fora_do_gol    = Geometria::meio_comprimento + 0.75;
+	static constexpr double meia_largura_de_fora    = Geometria::meia_largura_do_gol + 0.2;
+	static constexpr double x_da_trave              = Geometria::meio_comprimento + 0.02;
+	static constexpr double y_da_trave              = Geometria::meia_largura_do_gol + 0.02;
+
+	static_assert(
+		fundo_do_gol + 3 < linha_do_meio && meia_largura_da_caixa < fim_do_campo_em_y,
+		"O campo precisa caber no quadro, com o gol dentro do campo na largura."
+	);
+};
+
+// Sem isso, em C++14, usar os membros por referência (como em min() e max()) não linka.
+template<class G> constexpr int    CampoNoQuadro<G>::linha_do_meio;
+template<class G> constexpr int    CampoNoQuadro<G>::coluna_do_meio;
+template<class G> constexpr int    CampoNoQuadro<G>::linha_de_fundo;
+template<class G> constexpr int    CampoNoQuadro<G>::linha_lateral;
+template<class G> constexpr int    CampoNoQuadro<G>::fim_do_campo_em_x;
+template<class G> constexpr int    CampoNoQuadro<G>::fim_do_campo_em_y;
+template<class G> constexpr int    CampoNoQuadro<G>::meia_boca_do_gol;
+template<class G> constexpr int    CampoNoQuadro<G>::face_de_fora_da_trave;
+template<class G> constexpr int    CampoNoQuadro<G>::fundo_do_gol;
+template<class G> constexpr int    CampoNoQuadro<G>::fim_do_gol;
+template<class G> constexpr int    CampoNoQuadro<G>::meia_largura_da_rede;
+template<class G> constexpr int    CampoNoQuadro<G>::linha_do_gol;
+template<class G> constexpr int    CampoNoQuadro<G>::primeira_coluna_do_gol;
+template<class G> constexpr int    CampoNoQuadro<G>::ultima_coluna_do_gol;
+template<class G> constexpr int    CampoNoQuadro<G>::inicio_da_caixa_do_gol;
+template<class G> constexpr int    CampoNoQuadro<G>::fim_da_caixa_do_gol;
+template<class G> constexpr int    CampoNoQuadro<G>::meia_largura_da_caixa;
+template<class G> constexpr double CampoNoQuadro<G>::fundo_de_fora_do_gol;
+template<class G> constexpr double CampoNoQuadro<G>::meia_largura_de_fora;
+template<class G> constexpr double CampoNoQuadro<G>::x_da_trave;
+template<class G> constexpr double CampoNoQuadro<G>::y_da_trave;
+
+////////////////////////////////////////////////////////////////////////////
+/// Geração dos Quadros
+////////////////////////////////////////////////////////////////////////////
+
+constexpr int
+distancia_absoluta(
+	int a,
+	int b
+){
+	return a < b ? b - a : a - b;
+}
+
+template<class Geometria>
+struct QuadrosDoCampo {
+	/*
+	Descrição:
+		Os dois campos vazios possíveis: um com o amortecimento das bordas,
+		para quando não podemos sair do campo, e outro sem, para quando podemos.
+
+		[(H)ard wall: -3, (S)oft wall: -2, (E)mpty: 0, 0 < Cost < inf]
+
+		Declarado constexpr, é montado pelo compilador e ninguém escreve nele
+		depois, então pode ser lido por qualquer thread ao mesmo tempo.
+	*/
+	typedef CampoNoQuadro<Geometria> Medidas;
+
+	float dentro_do_campo[ QUANT_LINHAS * QUANT_COLUNAS ];
+	float fora_do_campo  [ QUANT_LINHAS * QUANT_COLUNAS ];
+
+	constexpr QuadrosDoCampo() : dentro_do_campo(), fora_do_campo() {
+
+		for(
+			int posicao = 0;
+			posicao < QUANT_LINHAS * QUANT_COLUNAS;
+			posicao++
+		){
+			const int linha  = posicao / QUANT_COLUNAS;
+			const int coluna = posicao % QUANT_COLUNAS;
+
+			fora_do_campo  [posicao] = custo_da_celula( linha, coluna );
+			dentro_do_campo[posicao] = fora_do_campo[posicao] + amortecimento( linha, coluna );
+		}
+	}
+
+	static constexpr float
+	custo_da_celula(
+		int linha,
+		int coluna
+	){
+		/*
+		Descrição:
+			Custo de uma célula do campo vazio, sem amortecimento.
+
+			Nosso gol fica nas linhas de cima e o deles, nas de baixo. O
+			interior do nosso é soft, para que nunca seja atravessado, e o do
+			deles é livre, para que a bola possa ser levada até o fundo.
+		*/
+		const int  x          = distancia_absoluta( linha,  Medidas::linha_do_meio  );
+		const int  y          = distancia_absoluta( coluna, Medidas::coluna_do_meio );
+		const bool gol_deles  = linha > Medidas::linha_do_meio;
+
+		if(
+			x <= Medidas::fim_do_campo_em_x && y <= Medidas::fim_do_campo_em_y
+		){
+			return 0.f;
+		}
+
+		if(
+			// Interior do gol, desde a linha de frente das traves.
+			x >= Medidas::linha_de_fundo - 1 && x <= Medidas::fim_do_gol && y <= Medidas::meia_boca_do_gol
+		){
+			return gol_deles ? 0.f : -2.f;
+		}
+
+		if(
+			// Traves, que na linha de frente perdem a quina de fora.
+			x >= Medidas::linha_de_fundo - 1 && x <= Medidas::fim_do_gol &&
+			y >  Medidas::meia_boca_do_gol &&
+			y <= Medidas::face_de_fora_da_trave - ( x == Medidas::linha_de_fundo - 1 )
+		){
+			return -3.f;
+		}
+
+		if(
+			// Rede, em volta do fundo do gol.
+			x > Medidas::fim_do_gol && x <= Medidas::fundo_do_gol + 2 && y <= Medidas::meia_largura_da_rede
+		){
+			return -3.f;
+		}
+
+		return -2.f;
+	}
+
+	static constexpr float
+	amortecimento(
+		int linha,
+		int coluna
+	){
+		/*
+		Descrição:
+			Área de custo gradual junto às linhas do campo, a fim de evitar
+			colisões com as bordas. É como um campo de potencial: TAMANHO_DO_AMORTECIMENTO
+			na última célula livre, diminuindo de 1 em 1 para dentro.
+
+			Diante do gol deles não há amortecimento até a face de fora das
+			traves, senão o A* relutaria em entrar no gol.
+		*/
+		const int x = distancia_absoluta( linha,  Medidas::linha_do_meio  );
+		const int y = distancia_absoluta( coluna, Medidas::coluna_do_meio );
+
+		if(
+			x > Medidas::fim_do_campo_em_x || y > Medidas::fim_do_campo_em_y
+		){
+			return 0.f;
+		}
+
+		const int ate_o_fundo   = Medidas::fim_do_campo_em_x - x;
+		const int ate_a_lateral = Medidas::fim_do_campo_em_y - y;
+
+		if(
+			linha > Medidas::linha_do_meio && y < Medidas::face_de_fora_da_trave
+		){
+			return 0.f;
+		}
+
+		const int mais_perto = ate_o_fundo < ate_a_lateral ? ate_o_fundo : ate_a_lateral;
+
+		return mais_perto < TAMANHO_DO_AMORTECIMENTO ? float( TAMANHO_DO_AMORTECIMENTO - mais_perto ) : 0.f;
+	}
+};
+
+#if defined(CAMPO_OFICIAL)
+	typedef CampoOficial  GeometriaDoCampo;
+#else
+	typedef CampoDeTreino GeometriaDoCampo;
+#endif
+
+typedef CampoNoQuadro<GeometriaDoCampo> Campo;
+
+#endif // CAMPO_H
@@ -0,0 +1,575 @@
+/*
+Núcleo vetorizado do carimbo de obstáculos.
+
+O carimbo original percorria até 7845 entradas de obtendo_possibilidades.h
+por obstáculo, uma célula por vez, conferindo os limites do quadro em cada
+uma. Mas o disco de um obstáculo é, linha a linha, uma faixa contínua de
+colunas, então aqui o trabalho é feito por faixas:
+
+	- a faixa hard, em que todas as células viram -3;
+	- as duas faixas do anel soft, à esquerda e à direita da hard, em que
+	  cada célula fica com o maior entre o custo atual e a força naquela
+	  distância, desde que não seja impossível.
+
+Os limites do quadro são resolvidos uma vez por faixa e não por célula.
+
+A distância de cada deslocamento vem de uma tabela montada a partir de
+aneis_e_pontos_disponiveis, com os mesmos valores arredondados, e a força
+é calculada com as mesmas operações. O resultado é idêntico ao do laço
+original, que continua em a_estrela.cpp como carimbar_obstaculo_pela_tabela()
+para comparação.
+
+Motores, escolhidos na carga do módulo conforme o processador:
+
+	AVX2    -> 8 células por instrução
+	SSE2    -> 4 células por instrução (todo x86-64 tem)
+	escalar -> outros processadores, ou quando compilado com -DCARIMBO_ESCALAR
+*/
+
+#ifndef CARIMBO_H
+#define CARIMBO_H
+
+/*
+obtendo_possibilidades.h não tem guarda de inclusão, então este arquivo
+espera que ele já tenha sido incluído, como é feito em a_estrela.cpp.
+*/
+#include "a_estrela.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#if ( defined(__x86_64__) || defined(__i386__) ) && defined(__SSE2__) && defined(__GNUC__) && !defined(CARIMBO_ESCALAR)
+	#define CARIMBO_X86
+	#include <immintrin.h>
+#endif
+
+#define RAIO_DA_TABELA 50  // DIST_MAX em células
+#define LADO_DA_TABELA ( 2 * RAIO_DA_TABELA + 1 )
+#define FAIXA_CURTA    8   // Abaixo disso a faixa vai direto para o escalar
+
+struct TabelaDeDistancias {
+	/*
+	Descrição:
+		distancia[dl + RAIO_DA_TABELA][dc + RAIO_DA_TABELA] é o valor que
+		aneis_e_pontos_disponiveis dá ao deslocamento (dl, dc), ou infinito
+		se ele não está lá, ou seja, além de DIST_MAX.
+
+		Em cada linha a distância não diminui à medida que nos afastamos da
+		coluna central, o que permite corrigir as faixas só andando para os lados.
+	*/
+	float distancia[LADO_DA_TABELA][LADO_DA_TABELA];
+
+	TabelaDeDistancias(){
+
+		std::fill(
+			&distancia[0][0],
+			&distancia[0][0] + LADO_DA_TABELA * LADO_DA_TABELA,
+			std::numeric_limits<float>::infinity()
+		);
+
+		for(
+			int i = 0;
+			i < quantidade_de_pontos_disponiveis;
+			i++
+		){
+			distancia[ linhas_de_cada_ponto[i] + RAIO_DA_TABELA ][ colunas_de_cada_ponto[i] + RAIO_DA_TABELA ] = aneis_e_pontos_disponiveis[i];
+		}
+	}
+
+	inline int
+	meia_largura(
+		int   dl,
+		float raio
+	) const {
+		/*
+		Maior dc >= 0 da linha dl com distância <= raio, ou -1 se nenhum.
+
+		O palpite vem do próprio círculo e a tabela só corrige o arredondamento,
+		o que costuma custar uma ou duas comparações. Uma busca binária por
+		linha custava mais que o carimbo de um obstáculo pequeno inteiro.
+		*/
+		const float* centro = distancia[ dl + RAIO_DA_TABELA ] + RAIO_DA_TABELA;
+
+		const float quadrado = raio * raio * 100.f - float( dl * dl );
+
+		int dc = quadrado > 0.f ? int( sqrtf( quadrado ) ) : 0;
+		dc     = std::min( dc, RAIO_DA_TABELA );
+
+		while(
+			dc < RAIO_DA_TABELA && centro[dc + 1] <= raio
+		){
+			dc++;
+		}
+
+		while(
+			dc >= 0 && centro[dc] > raio
+		){
+			dc--;
+		}
+
+		return dc;
+	}
+};
+
+// Construída na carga do módulo, assim como os quadros base.
+static const TabelaDeDistancias tabela_de_distancias;
+
+
+struct NucleoDeCarimbo {
+	/*
+	Descrição:
+		As duas operações por faixa de um motor. 'quadro', 'distancias' e
+		'marcas' já apontam para a primeira célula da faixa. Sem marcas
+		(nullptr), todas as células são tocadas, veja carimbar_obstaculo().
+	*/
+	const char* nome;
+
+	void (*faixa_hard)(
+		float               quadro[],
+		const unsigned int* marcas,
+		unsigned int        marca,
+		int                 quantidade
+	);
+
+	void (*faixa_soft)(
+		float               quadro[],
+		const float         distancias[],
+		float               forca,
+		float               forca_por_metro,
+		float               limite_para_qual_custo_eh_impossivel,
+		const unsigned int* marcas,
+		unsigned int        marca,
+		int                 quantidade
+	);
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// Escalar
+////////////////////////////////////////////////////////////////////////////
+
+inline void
+faixa_hard_escalar(
+	float               quadro[],
+	const unsigned int* marcas,
+	unsigned int        marca,
+	int                 quantidade
+){
+	for(
+		int i = 0;
+		i < quantidade;
+		i++
+	){
+		if(
+			marcas == nullptr || marcas[i] == marca
+		){
+			quadro[i] = -3;
+		}
+	}
+}
+
+inline void
+faixa_soft_escalar(
+	float               quadro[],
+	const float         distancias[],
+	float               forca,
+	float               forca_por_metro,
+	float               limite_para_qual_custo_eh_impossivel,
+	const unsigned int* marcas,
+	unsigned int        marca,
+	int                 quantidade
+){
+	for(
+		int i = 0;
+		i < quantidade;
+		i++
+	){
+		// Mesma conta, na mesma ordem, do laço original.
+		const float fr = forca - ( forca_por_metro * distancias[i] );
+
+		if(
+			(
+				marcas == nullptr || marcas[i] == marca
+			) && (
+				quadro[i] > limite_para_qual_custo_eh_impossivel
+			) && (
+				quadro[i] < fr
+			)
+		){
+			quadro[i] = fr;
+		}
+	}
+}
+
+#if defined(CARIMBO_X86)
+
+////////////////////////////////////////////////////////////////////////////
+/// SSE2
+////////////////////////////////////////////////////////////////////////////
+
+inline void
+faixa_hard_sse2(
+	float               quadro[],
+	const unsigned int* marcas,
+	unsigned int        marca,
+	int                 quantidade
+){
+	const __m128 menos_tres = _mm_set1_ps( -3.f );
+
+	int i = 0;
+
+	if(
+		marcas == nullptr
+	){
+		for(
+			;
+			i + 4 <= quantidade;
+			i += 4
+		){
+			_mm_storeu_ps( quadro + i, menos_tres );
+		}
+	}
+	else{
+		const __m128i marca_v = _mm_set1_epi32( (int) marca );
+
+		for(
+			;
+			i + 4 <= quantidade;
+			i += 4
+		){
+			const __m128 pode  = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_loadu_si128( (const __m128i*) ( marcas + i ) ), marca_v ) );
+			const __m128 atual = _mm_loadu_ps( quadro + i );
+
+			_mm_storeu_ps( quadro + i, _mm_or_ps( _mm_and_ps( pode, menos_tres ), _mm_andnot_ps( pode, atual ) ) );
+		}
+	}
+
+	faixa_hard_escalar( quadro + i, marcas ? marcas + i : nullptr, marca, quantidade - i );
+}
+
+inline void
+faixa_soft_sse2(
+	float               quadro[],
+	const float         distancias[],
+	float               forca,
+	float               forca_por_metro,
+	float               limite_para_qual_custo_eh_impossivel,
+	const unsigned int* marcas,
+	unsigned int        marca,
+	int                 quantidade
+){
+	const __m128  forca_v   = _mm_set1_ps( forca );
+	const __m128  por_metro = _mm_set1_ps( forca_por_metro );
+	const __m128  limite    = _mm_set1_ps( limite_para_qual_custo_eh_impossivel );
+	const __m128i marca_v   = _mm_set1_epi32( (int) marca );
+
+	int i = 0;
+
+	for(
+		;
+		i + 4 <= quantidade;
+		i += 4
+	){
+		const __m128 fr    = _mm_sub_ps( forca_v, _mm_mul_ps( por_metro, _mm_loadu_ps( distancias + i ) ) );
+		const __m128 atual = _mm_loadu_ps( quadro + i );
+
+		// Comparações ordenadas: com NaN dão falso, como no escalar.
+		__m128 troca = _mm_and_ps( _mm_cmpgt_ps( atual, limite ), _mm_cmplt_ps( atual, fr ) );
+
+		if(
+			marcas != nullptr
+		){
+			troca = _mm_and_ps( troca, _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_loadu_si128( (const __m128i*) ( marcas + i ) ), marca_v ) ) );
+		}
+
+		_mm_storeu_ps( quadro + i, _mm_or_ps( _mm_and_ps( troca, fr ), _mm_andnot_ps( troca, atual ) ) );
+	}
+
+	faixa_soft_escalar(
+		quadro + i, distancias + i,
+		forca, forca_por_metro, limite_para_qual_custo_eh_impossivel,
+		marcas ? marcas + i : nullptr, marca,
+		quantidade - i
+	);
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// AVX2
+////////////////////////////////////////////////////////////////////////////
+
+/*
+Compiladas para AVX2 mesmo sem -mavx2, e só chamadas se o processador
+tiver suporte, veja nucleo_de_carimbo_ativo(). Não pedimos FMA, para que
+a força saia exatamente como no escalar.
+*/
+
+__attribute__(( target( "avx2" ) )) inline void
+faixa_hard_avx2(
+	float               quadro[],
+	const unsigned int* marcas,
+	unsigned int        marca,
+	int                 quantidade
+){
+	const __m256 menos_tres = _mm256_set1_ps( -3.f );
+
+	int i = 0;
+
+	if(
+		marcas == nullptr
+	){
+		for(
+			;
+			i + 8 <= quantidade;
+			i += 8
+		){
+			_mm256_storeu_ps( quadro + i, menos_tres );
+		}
+	}
+	else{
+		const __m256i marca_v = _mm256_set1_epi32( (int) marca );
+
+		for(
+			;
+			i + 8 <= quantidade;
+			i += 8
+		){
+			const __m256 pode = _mm256_castsi256_ps( _mm256_cmpeq_epi32( _mm256_loadu_si256( (const __m256i*) ( marcas + i ) ), marca_v ) );
+
+			_mm256_storeu_ps( quadro + i, _mm256_blendv_ps( _mm256_loadu_ps( quadro + i ), menos_tres, pode ) );
+		}
+	}
+
+	faixa_hard_escalar( quadro + i, marcas ? marcas + i : nullptr, marca, quantidade - i );
+}
+
+__attribute__(( target( "avx2" ) )) inline void
+faixa_soft_avx2(
+	float               quadro[],
+	const float         distancias[],
+	float               forca,
+	float               forca_por_metro,
+	float               limite_para_qual_custo_eh_impossivel,
+	const unsigned int* marcas,
+	unsigned int        marca,
+	int                 quantidade
+){
+	const __m256  forca_v   = _mm256_set1_ps( forca );
+	const __m256  por_metro = _mm256_set1_ps( forca_por_metro );
+	const __m256  limite    = _mm256_set1_ps( limite_para_qual_custo_eh_impossivel );
+	const __m256i marca_v   = _mm256_set1_epi32( (int) marca );
+
+	int i = 0;
+
+	for(
+		;
+		i + 8 <= quantidade;
+		i += 8
+	){
+		const __m256 fr    = _mm256_sub_ps( forca_v, _mm256_mul_ps( por_metro, _mm256_loadu_ps( distancias + i ) ) );
+		const __m256 atual = _mm256_loadu_ps( quadro + i );
+
+		__m256 troca = _mm256_and_ps( _mm256_cmp_ps( atual, limite, _CMP_GT_OQ ), _mm256_cmp_ps( atual, fr, _CMP_LT_OQ ) );
+
+		if(
+			marcas != nullptr
+		){
+			troca = _mm256_and_ps( troca, _mm256_castsi256_ps( _mm256_cmpeq_epi32( _mm256_loadu_si256( (const __m256i*) ( marcas + i ) ), marca_v ) ) );
+		}
+
+		_mm256_storeu_ps( quadro + i, _mm256_blendv_ps( atual, fr, troca ) );
+	}
+
+	faixa_soft_escalar(
+		quadro + i, distancias + i,
+		forca, forca_por_metro, limite_para_qual_custo_eh_impossivel,
+		marcas ? marcas + i : nullptr, marca,
+		quantidade - i
+	);
+}
+
+#endif // CARIMBO_X86
+
+
+////////////////////////////////////////////////////////////////////////////
+/// Escolha do motor
+////////////////////////////////////////////////////////////////////////////
+
+inline int
+nucleos_de_carimbo_disponiveis(
+	const NucleoDeCarimbo* nucleos[3]
+){
+	/*
+	Descrição:
+		Preenche 'nucleos' com os motores que este processador executa, do
+		mais simples ao mais rápido, e retorna quantos são. O debug.cc
+		compara todos com o laço original.
+	*/
+	static const NucleoDeCarimbo escalar = { "escalar", faixa_hard_escalar, faixa_soft_escalar };
+
+	int quantidade = 0;
+	nucleos[ quantidade++ ] = &escalar;
+
+#if defined(CARIMBO_X86)
+
+	static const NucleoDeCarimbo sse2 = { "sse2", faixa_hard_sse2, faixa_soft_sse2 };
+	static const NucleoDeCarimbo avx2 = { "avx2", faixa_hard_avx2, faixa_soft_avx2 };
+
+	nucleos[ quantidade++ ] = &sse2;
+
+	__builtin_cpu_init();  // Podemos estar antes dos construtores da libgcc.
+	if(
+		__builtin_cpu_supports( "avx2" )
+	){
+		nucleos[ quantidade++ ] = &avx2;
+	}
+
+#endif
+
+	return quantidade;
+}
+
+inline const NucleoDeCarimbo*
+nucleo_de_carimbo_mais_rapido(){
+
+	const NucleoDeCarimbo* nucleos[3];
+
+	return nucleos[ nucleos_de_carimbo_disponiveis( nucleos ) - 1 ];
+}
+
+inline const NucleoDeCarimbo&
+nucleo_de_carimbo_ativo(){
+	// Decidido uma única vez. Estáticos locais são inicializados com segurança entre threads.
+	static const NucleoDeCarimbo* const ativo = nucleo_de_carimbo_mais_rapido();
+
+	return *ativo;
+}
+
+
+inline void
+carimbar_por_faixas(
+	const NucleoDeCarimbo& nucleo,
+	float               quadro_de_custo[],
+	int                 linha,
+	int                 coluna,
+	float               raio_hard,
+	float               raio_soft,
+	float               forca,
+	int                 limite_para_qual_custo_eh_impossivel,
+	const unsigned int* marcas,
+	unsigned int        marca
+){
+	/*
+	Descrição:
+		Mesmo contrato de carimbar_obstaculo(), usando o motor 'nucleo'.
+
+		Para cada linha do disco, a tabela dá a meia largura
+		das faixas hard e soft. O anel soft é o que sobra da faixa soft fora
+		da hard, logo as duas nunca se sobrepõem, exatamente como no laço
+		original, em que cada célula aparece uma única vez.
+	*/
+	const float forca_por_metro = forca / raio_soft;
+
+	const int alcance = std::min(
+		RAIO_DA_TABELA,
+		int( std::max( raio_hard, raio_soft ) * 10.f ) + 1
+	);
+
+	for(
+		int dl = -alcance;
+		dl <= alcance;
+		dl++
+	){
+		const int linha_atual = linha + dl;
+
+		if(
+			linha_atual < 0 || linha_atual >= QUANT_LINHAS
+		){
+			continue;
+		}
+
+		const int largura_hard = tabela_de_distancias.meia_largura( dl, raio_hard );
+		const int largura_soft = tabela_de_distancias.meia_largura( dl, raio_soft );
+
+		float*              quadro_da_linha    = quadro_de_custo + linha_atual * QUANT_COLUNAS;
+		const unsigned int* marcas_da_linha    = marcas ? marcas + linha_atual * QUANT_COLUNAS : nullptr;
+		const float*        distancias_da_linha = tabela_de_distancias.distancia[ dl + RAIO_DA_TABELA ] + RAIO_DA_TABELA;
+
+		if(
+			largura_hard >= 0
+		){
+			const int inicio = std::max( 0,                 coluna - largura_hard );
+			const int fim    = std::min( QUANT_COLUNAS - 1, coluna + largura_hard );
+
+			if(
+				fim - inicio + 1 >= FAIXA_CURTA
+			){
+				nucleo.faixa_hard(
+					quadro_da_linha + inicio,
+					marcas_da_linha ? marcas_da_linha + inicio : nullptr,
+					marca,
+					fim - inicio + 1
+				);
+			}
+			else{
+				faixa_hard_escalar(
+					quadro_da_linha + inicio,
+					marcas_da_linha ? marcas_da_linha + inicio : nullptr,
+					marca,
+					fim - inicio + 1
+				);
+			}
+		}
+
+		if(
+			largura_soft <= largura_hard
+		){
+			continue;
+		}
+
+		// Anel à esquerda e à direita da faixa hard.
+		const int faixas[2][2] = {
+			{ coluna - largura_soft,     coluna - largura_hard - 1 },
+			{ coluna + largura_hard + 1, coluna + largura_soft     }
+		};
+
+		for(
+			int f = 0;
+			f < 2;
+			f++
+		){
+			const int inicio = std::max( 0,                 faixas[f][0] );
+			const int fim    = std::min( QUANT_COLUNAS - 1, faixas[f][1] );
+
+			if(
+				fim - inicio + 1 >= FAIXA_CURTA
+			){
+				nucleo.faixa_soft(
+					quadro_da_linha + inicio,
+					distancias_da_linha + ( inicio - coluna ),
+					forca,
+					forca_por_metro,
+					(float) limite_para_qual_custo_eh_impossivel,
+					marcas_da_linha ? marcas_da_linha + inicio : nullptr,
+					marca,
+					fim - inicio + 1
+				);
+			}
+			else{
+				// Faixas curtas não compensam a chamada indireta.
+				faixa_soft_escalar(
+					quadro_da_linha + inicio,
+					distancias_da_linha + ( inicio - coluna ),
+					forca,
+					forca_por_metro,
+					(float) limite_para_qual_custo_eh_impossivel,
+					marcas_da_linha ? marcas_da_linha + inicio : nullptr,
+					marca,
+					fim - inicio + 1
+				);
+			}
+		}
+	}
+}
+
+#endif // CARIMBO_H
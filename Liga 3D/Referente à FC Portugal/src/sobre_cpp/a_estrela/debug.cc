@@ -1,6 +1,11 @@
 #include "a_estrela.cpp"
 #include <iostream>  // Apenas para realizarmos testes.
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include <set>
+#include <tuple>
 /*
 Arquivo de Testes Exclusivamente Para Testar Funcionalidades.
 
@@ -249,6 +254,7 @@ Testando a função principal!
 using std::chrono::high_resolution_clock;
 using std::chrono::duration_cast;
 using std::chrono::microseconds;
+using std::chrono::nanoseconds;
 
 std::chrono::_V2::system_clock::time_point inicio, fim;
 
@@ -267,7 +273,7 @@ float parametros[] = {
 
 int quantidade_de_parametros = sizeof( parametros ) / sizeof(float);
 
-void teste_de_funcao_principal_a_estrela(){
+int teste_de_funcao_principal_a_estrela(){
 
 	inicio = high_resolution_clock::now();
 
@@ -288,12 +294,1908 @@ void teste_de_funcao_principal_a_estrela(){
     fim = high_resolution_clock::now();
 
     printf("\033[7m%d\033[0mus -> Sem inicializacao.\n", (int)duration_cast<microseconds>(fim - inicio).count());
+
+    // Só mede tempo, não tem o que conferir.
+    return 0;
+}
+
+float parametros_caminho_longo[] = {
+    /*
+    Atravessamos o campo inteiro rumo ao gol adversário, com alguns obstáculos
+    no meio. Era aqui que a BST degenerava e estourava o timeout.
+    */
+    -14, 3, //start
+    0,1, //out of bounds? go to goal?
+    0,0, //target (if not go to goal)
+    5000, // timeout
+    -8,2,0.3,1,1,
+    -3,-1,0.3,1,1,
+    2,4,0.3,1,1,
+    6,0,0.3,1,1,
+    11,-2,0.3,1,1
+};
+
+int quantidade_de_parametros_caminho_longo = sizeof( parametros_caminho_longo ) / sizeof(float);
+
+int teste_de_caminho_longo(){
+
+    inicio = high_resolution_clock::now();
+
+    a_estrela(parametros_caminho_longo, quantidade_de_parametros_caminho_longo);
+
+    fim = high_resolution_clock::now();
+
+    printf(
+        "\033[7m%d\033[0mus -> Caminho longo, status %d (0 = sucesso, 1 = timeout).\n",
+        (int)duration_cast<microseconds>(fim - inicio).count(),
+        (int)contexto_da_thread().caminho_final[contexto_da_thread().tamanho_do_caminho_final - 2]
+    );
+
+    // O status depende do relógio (timeout de 5ms), então só o mostramos.
+    return 0;
+}
+
+/*
+Medidas do campo compilado (make CAMPO=...), em metros. As consultas dos
+testes saem delas, para que o campo de treino seja testado de verdade e
+não com inícios e alvos fora dele.
+*/
+const float meio_comprimento = QuadrosDoCampo<GeometriaDoCampo>::Medidas::linha_de_fundo / 10.f;
+const float meia_largura     = QuadrosDoCampo<GeometriaDoCampo>::Medidas::linha_lateral  / 10.f;
+
+float sorteio_entre(
+    float de,
+    float ate
+){
+    return de + ( rand() % 10000 ) / 10000.f * ( ate - de );
+}
+
+std::vector<float> consulta_da_grade(
+    int i
+){
+    /*
+    A i-ésima de 256 consultas: inícios numa grade de 16 x 16 pelo campo
+    todo, alternando permissão para sair dele e ir ao gol, e alvos na metade
+    do adversário, sempre dentro do campo.
+    */
+    return {
+        -meio_comprimento + ( i % 16 ) * meio_comprimento / 8, -meia_largura + ( i / 16 ) * meia_largura / 8,  // start
+        (float) ( i % 2 ), (float) ( i % 3 == 0 ),                                                             // out of bounds? go to goal?
+        meio_comprimento * ( 0.8f - ( i % 7 ) * 0.07f ), meia_largura * ( 0.5f - ( i % 11 ) * 0.1f ),           // target
+        500000                                                                                                 // timeout
+    };
+}
+
+int teste_em_lote(){
+    /*
+    Planejamos várias consultas de uma vez e conferimos, uma a uma, se o
+    lote devolve exatamente o mesmo que chamadas individuais de a_estrela().
+    */
+    const int quantidade_de_consultas = 256;
+
+    std::vector<float> consultas;
+    for(
+        int i = 0;
+        i < quantidade_de_consultas;
+        i++
+    ){
+        const std::vector<float> consulta = consulta_da_grade( i );
+        consultas.insert( consultas.end(), consulta.begin(), consulta.end() );
+    }
+
+    // Mesmos obstáculos do caminho longo.
+    float* obstaculos = parametros_caminho_longo + 7;
+    const int quantidade_de_obstaculos = quantidade_de_parametros_caminho_longo - 7;
+
+    ResultadoEmLote resultado;
+
+    inicio = high_resolution_clock::now();
+
+    a_estrela_em_lote(
+        consultas.data(),
+        quantidade_de_consultas,
+        obstaculos,
+        quantidade_de_obstaculos,
+        0,
+        resultado
+    );
+
+    fim = high_resolution_clock::now();
+
+    const int tempo_do_lote = (int)duration_cast<microseconds>(fim - inicio).count();
+
+    int divergencias = 0;
+
+    inicio = high_resolution_clock::now();
+
+    for(
+        int i = 0;
+        i < quantidade_de_consultas;
+        i++
+    ){
+        std::vector<float> parametros_individuais( consultas.begin() + i * 7, consultas.begin() + ( i + 1 ) * 7 );
+        parametros_individuais.insert( parametros_individuais.end(), obstaculos, obstaculos + quantidade_de_obstaculos );
+
+        a_estrela( parametros_individuais.data(), (int) parametros_individuais.size() );
+
+        const ContextoDePlanejamento& contexto = contexto_da_thread();
+        const int tamanho = contexto.tamanho_do_caminho_final - 2;
+
+        bool igual = tamanho == resultado.deslocamentos[i + 1] - resultado.deslocamentos[i]
+                  && contexto.caminho_final[tamanho]     == resultado.status[i]
+                  && contexto.caminho_final[tamanho + 1] == resultado.custos[i];
+
+        for(
+            int k = 0;
+            igual && k < tamanho;
+            k++
+        ){
+            igual = contexto.caminho_final[k] == resultado.caminhos[ resultado.deslocamentos[i] + k ];
+        }
+
+        divergencias += !igual;
+    }
+
+    fim = high_resolution_clock::now();
+
+    printf(
+        "\033[7m%d\033[0mus -> Lote de %d consultas (%dus individualmente), %d divergencias.\n",
+        tempo_do_lote,
+        quantidade_de_consultas,
+        (int)duration_cast<microseconds>(fim - inicio).count(),
+        divergencias
+    );
+
+    return divergencias;
+}
+
+int teste_de_replanejamento_incremental(){
+    /*
+    Simulamos 300 ciclos de drible rumo ao gol: o agente avança um pouco e
+    os obstáculos do caminho longo andam alguns centímetros por ciclo. A
+    cada ciclo comparamos o replanejador com uma busca nova de a_estrela().
+
+    O D* Lite não usa a janela de busca do A*, logo pode achar caminhos
+    um pouco mais baratos, mas nunca mais caros, e o status deve ser o mesmo.
+    */
+    ReplanejadorIncremental replanejador;
+
+    std::vector<float> parametros_do_ciclo(
+        parametros_caminho_longo,
+        parametros_caminho_longo + quantidade_de_parametros_caminho_longo
+    );
+    parametros_do_ciclo[6] = 500000;  // Sem timeout, para que a comparação não dependa da máquina.
+
+    int  divergencias_de_status = 0;
+    int  mais_caros             = 0;
+    int  incrementais           = 0;
+    long tempo_incremental      = 0;
+    long tempo_completo         = 0;
+
+    for(
+        int ciclo = 0;
+        ciclo < 300;
+        ciclo++
+    ){
+        parametros_do_ciclo[0] += 0.01f;  // agente avança
+
+        for(
+            int ob = 7;
+            ob < quantidade_de_parametros_caminho_longo;
+            ob += 5
+        ){
+            // Cada obstáculo anda num sentido diferente.
+            parametros_do_ciclo[ob    ] += ( ob % 2 ? 0.015f : -0.01f );
+            parametros_do_ciclo[ob + 1] += ( ob % 3 ? 0.01f  : -0.015f );
+        }
+
+        inicio = high_resolution_clock::now();
+        replanejador.planejar( parametros_do_ciclo.data(), (int) parametros_do_ciclo.size() );
+        fim = high_resolution_clock::now();
+        tempo_incremental += duration_cast<microseconds>(fim - inicio).count();
+
+        inicio = high_resolution_clock::now();
+        a_estrela( parametros_do_ciclo.data(), (int) parametros_do_ciclo.size() );
+        fim = high_resolution_clock::now();
+        tempo_completo += duration_cast<microseconds>(fim - inicio).count();
+
+        const ContextoDePlanejamento& contexto = contexto_da_thread();
+
+        const float status_incremental = replanejador.caminho_final[ replanejador.tamanho_do_caminho_final - 2 ];
+        const float custo_incremental  = replanejador.caminho_final[ replanejador.tamanho_do_caminho_final - 1 ];
+        const float status_completo    = contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ];
+        const float custo_completo     = contexto.caminho_final[ contexto.tamanho_do_caminho_final - 1 ];
+
+        divergencias_de_status += status_incremental != status_completo;
+        mais_caros             += custo_incremental > custo_completo + 1e-3f;
+        incrementais           += replanejador.ultima_chamada_foi_incremental;
+    }
+
+    printf(
+        "\033[7m%ld\033[0mus -> 300 ciclos incrementais (%ldus com buscas novas), %d reparos, %d status divergentes, %d mais caros.\n",
+        tempo_incremental,
+        tempo_completo,
+        incrementais,
+        divergencias_de_status,
+        mais_caros
+    );
+
+    return divergencias_de_status + mais_caros;
+}
+
+int teste_de_custo_de_preparacao(){
+    /*
+    Custo de deixar o quadro de custo pronto para uma busca, antes e depois
+    dos quadros base estáticos.
+
+    Antes: o campo era montado na pilha a partir das macros e o amortecimento
+    das bordas era refeito a cada chamada. As macros não existem mais, então
+    imitamos isso gerando o quadro célula a célula com as funções de campo.h.
+    Depois: restauramos apenas as linhas que a chamada anterior sujou. Usamos
+    as linhas sujas pelo caminho longo, que tem vários obstáculos.
+    */
+    const int repeticoes = 1000;
+    float     soma       = 0;
+
+    inicio = high_resolution_clock::now();
+    for(
+        int r = 0;
+        r < repeticoes;
+        r++
+    ){
+        float quadro_de_custo[
+            QUANT_LINHAS * QUANT_COLUNAS
+        ];
+
+        for(
+            int posicao = 0;
+            posicao < QUANT_LINHAS * QUANT_COLUNAS;
+            posicao++
+        ){
+            const int linha  = posicao / QUANT_COLUNAS;
+            const int coluna = posicao % QUANT_COLUNAS;
+
+            quadro_de_custo[posicao] = QuadrosDoCampo<GeometriaDoCampo>::custo_da_celula( linha, coluna )
+                                     + QuadrosDoCampo<GeometriaDoCampo>::amortecimento  ( linha, coluna );
+        }
+
+        soma += quadro_de_custo[ r % ( QUANT_LINHAS * QUANT_COLUNAS ) ];
+    }
+    fim = high_resolution_clock::now();
+    long tempo_antes = duration_cast<microseconds>(fim - inicio).count();
+
+    a_estrela( parametros_caminho_longo, quantidade_de_parametros_caminho_longo );
+
+    ContextoDePlanejamento& contexto = contexto_da_thread();
+
+    bool linhas_sujas_por_jogada[QUANT_LINHAS];
+    std::copy( contexto.linhas_sujas, contexto.linhas_sujas + QUANT_LINHAS, linhas_sujas_por_jogada );
+
+    const bool permissao = parametros_caminho_longo[3];
+    int        linhas    = 0;
+
+    for(
+        int linha = 0;
+        linha < QUANT_LINHAS;
+        linha++
+    ){
+        linhas += linhas_sujas_por_jogada[linha];
+    }
+
+    inicio = high_resolution_clock::now();
+    for(
+        int r = 0;
+        r < repeticoes;
+        r++
+    ){
+        std::copy( linhas_sujas_por_jogada, linhas_sujas_por_jogada + QUANT_LINHAS, contexto.linhas_sujas );
+
+        soma += preparar_quadro_de_custo( contexto, permissao )[ r % ( QUANT_LINHAS * QUANT_COLUNAS ) ];
+    }
+    fim = high_resolution_clock::now();
+    long tempo_depois = duration_cast<microseconds>(fim - inicio).count();
+
+    printf(
+        "Preparo do quadro: %.2fus por chamada antes, \033[7m%.2fus\033[0m depois (%d linhas restauradas). [%g]\n",
+        tempo_antes  / (double) repeticoes,
+        tempo_depois / (double) repeticoes,
+        linhas,
+        soma
+    );
+
+    // Só mede tempo, não tem o que conferir.
+    return 0;
+}
+
+int teste_de_pontos_de_salto(){
+    /*
+    Mesmas consultas do lote, com e sem OpcoesDeBusca::pontos_de_salto.
+
+    Entre caminhos de mesmo custo o JPS pode escolher outro, então não
+    comparamos ponto a ponto: o status e o custo devem ser os mesmos do A*
+    comum (a menos de arredondamentos de float, pois o salto soma os passos
+    de uma vez), e o caminho desdobrado não pode ter buracos.
+    */
+    const int quantidade_de_consultas = 256;
+
+    float* obstaculos = parametros_caminho_longo + 7;
+    const int quantidade_de_obstaculos = quantidade_de_parametros_caminho_longo - 7;
+
+    OpcoesDeBusca por_saltos;
+    por_saltos.pontos_de_salto = true;
+
+    ContextoDePlanejamento& contexto = contexto_da_thread();
+
+    int  divergencias     = 0;
+    int  buracos          = 0;
+    long expansoes_comum  = 0;
+    long expansoes_saltos = 0;
+    long tempo_comum      = 0;
+    long tempo_saltos     = 0;
+
+    for(
+        int i = 0;
+        i < quantidade_de_consultas;
+        i++
+    ){
+        std::vector<float> parametros = consulta_da_grade( i );
+        parametros.insert( parametros.end(), obstaculos, obstaculos + quantidade_de_obstaculos );
+
+        inicio = high_resolution_clock::now();
+        a_estrela( contexto, parametros.data(), (int) parametros.size() );
+        fim = high_resolution_clock::now();
+        tempo_comum += duration_cast<microseconds>(fim - inicio).count();
+
+        const int   tamanho_comum  = contexto.tamanho_do_caminho_final;
+        const float status_comum   = contexto.caminho_final[ tamanho_comum - 2 ];
+        const float custo_comum    = contexto.caminho_final[ tamanho_comum - 1 ];
+        expansoes_comum           += contexto.expansoes_na_ultima_busca;
+
+        inicio = high_resolution_clock::now();
+        a_estrela( contexto, parametros.data(), (int) parametros.size(), por_saltos );
+        fim = high_resolution_clock::now();
+        tempo_saltos += duration_cast<microseconds>(fim - inicio).count();
+
+        const int   tamanho_saltos = contexto.tamanho_do_caminho_final;
+        const float status_saltos  = contexto.caminho_final[ tamanho_saltos - 2 ];
+        const float custo_saltos   = contexto.caminho_final[ tamanho_saltos - 1 ];
+        expansoes_saltos          += contexto.expansoes_na_ultima_busca;
+
+        divergencias += status_comum != status_saltos || fabsf( custo_comum - custo_saltos ) > 1e-2f;
+
+        for(
+            // O último ponto pode ser o alvo exato, fora da grade.
+            int k = 2;
+            k < tamanho_saltos - 4;
+            k += 2
+        ){
+            const float dx = fabsf( contexto.caminho_final[k    ] - contexto.caminho_final[k - 2] );
+            const float dy = fabsf( contexto.caminho_final[k + 1] - contexto.caminho_final[k - 1] );
+
+            if(
+                dx > 0.101f || dy > 0.101f || dx + dy < 0.05f
+            ){
+                buracos++;
+                break;
+            }
+        }
+    }
+
+    printf(
+        "\033[7m%ld\033[0mus -> %d consultas com pontos de salto (%ldus no A* comum), %ld expansoes contra %ld, %d divergencias, %d caminhos com buracos.\n",
+        tempo_saltos,
+        quantidade_de_consultas,
+        tempo_comum,
+        expansoes_saltos,
+        expansoes_comum,
+        divergencias,
+        buracos
+    );
+
+    return divergencias + buracos;
+}
+
+int teste_do_carimbo(){
+    /*
+    O carimbo por faixas de carimbo.h precisa dar exatamente o mesmo quadro
+    que o laço original pela tabela, em todos os motores disponíveis.
+
+    Os obstáculos são sorteados pelo campo todo, inclusive coladinhos e
+    além das bordas, com raios de 0 a 5 e com ou sem marcas, sobre um quadro
+    que já tem outros obstáculos carimbados.
+    */
+    const int quantidade_de_obstaculos = 4000;
+    const int tamanho                  = QUANT_LINHAS * QUANT_COLUNAS;
+
+    const NucleoDeCarimbo* nucleos[3];
+    const int quantidade_de_nucleos = nucleos_de_carimbo_disponiveis( nucleos );
+
+    std::vector<float>        referencia( tamanho );
+    std::vector<float>        candidato ( tamanho );
+    std::vector<unsigned int> marcas    ( tamanho );
+
+    srand( 42 );
+    for(
+        int i = 0;
+        i < tamanho;
+        i++
+    ){
+        marcas[i] = rand() % 3;
+    }
+
+    int divergencias = 0;
+
+    for(
+        int k = 0;
+        k < quantidade_de_obstaculos;
+        k++
+    ){
+        const bool  permissao = k % 2;
+        const int   limite    = permissao ? -3 : -2;
+        const int   linha     = rand() % ( QUANT_LINHAS  + 60 ) - 30;
+        const int   coluna    = rand() % ( QUANT_COLUNAS + 60 ) - 30;
+        const float raio_hard = ( rand() % 51 ) / 10.f;
+        const float raio_soft = ( rand() % 51 ) / 10.f;
+        const float forca     = ( rand() % 1000 ) / 100.f;
+
+        const unsigned int* com_marcas = ( k % 3 == 0 ) ? marcas.data() : nullptr;
+        const unsigned int  marca      = k % 3;
+
+        if(
+            // De tempos em tempos começamos de um quadro limpo.
+            k % 50 == 0
+        ){
+            const float* base = quadro_base_do_campo( permissao );
+            std::copy( base, base + tamanho, referencia.begin() );
+
+            for(
+                int j = 0;
+                j < 10;
+                j++
+            ){
+                carimbar_obstaculo_pela_tabela(
+                    referencia.data(),
+                    rand() % QUANT_LINHAS, rand() % QUANT_COLUNAS,
+                    ( rand() % 51 ) / 10.f, ( rand() % 51 ) / 10.f, ( rand() % 1000 ) / 100.f,
+                    limite
+                );
+            }
+        }
+
+        for(
+            int n = 0;
+            n < quantidade_de_nucleos;
+            n++
+        ){
+            std::copy( referencia.begin(), referencia.end(), candidato.begin() );
+
+            carimbar_por_faixas( *nucleos[n], candidato.data(), linha, coluna, raio_hard, raio_soft, forca, limite, com_marcas, marca );
+            carimbar_obstaculo_pela_tabela( referencia.data(), linha, coluna, raio_hard, raio_soft, forca, limite, com_marcas, marca );
+
+            divergencias += memcmp( referencia.data(), candidato.data(), tamanho * sizeof(float) ) != 0;
+
+            // A referência já recebeu este obstáculo, os próximos motores partem do mesmo quadro.
+            std::copy( candidato.begin(), candidato.end(), referencia.begin() );
+        }
+    }
+
+    /*
+    Tempo por obstáculo, com os raios típicos de um jogador (hard 0.3,
+    soft 1.0) e os de uma parede de obstáculos grandes (hard 1.0, soft 5.0).
+    Ficamos com a melhor de algumas passadas, os dois disputam o mesmo cache.
+    */
+    const int   repeticoes  = 5000;
+    const int   passadas    = 5;
+    const float raios[2][2] = { { 0.3f, 1.0f }, { 1.0f, 5.0f } };
+
+    for(
+        int r = 0;
+        r < 2;
+        r++
+    ){
+        const float* base = quadro_base_do_campo( false );
+        std::copy( base, base + tamanho, referencia.begin() );
+        std::copy( base, base + tamanho, candidato.begin() );
+
+        long tempo_tabela = std::numeric_limits<long>::max();
+        long tempo_faixas = std::numeric_limits<long>::max();
+
+        for(
+            int p = 0;
+            p < passadas;
+            p++
+        ){
+            inicio = high_resolution_clock::now();
+            for(
+                int k = 0;
+                k < repeticoes;
+                k++
+            ){
+                carimbar_obstaculo_pela_tabela( referencia.data(), 60 + k % 200, 60 + ( k * 7 ) % 100, raios[r][0], raios[r][1], 3.f, -2 );
+            }
+            fim = high_resolution_clock::now();
+            tempo_tabela = std::min( tempo_tabela, (long) duration_cast<nanoseconds>(fim - inicio).count() );
+
+            inicio = high_resolution_clock::now();
+            for(
+                int k = 0;
+                k < repeticoes;
+                k++
+            ){
+                carimbar_obstaculo( candidato.data(), 60 + k % 200, 60 + ( k * 7 ) % 100, raios[r][0], raios[r][1], 3.f, -2 );
+            }
+            fim = high_resolution_clock::now();
+            tempo_faixas = std::min( tempo_faixas, (long) duration_cast<nanoseconds>(fim - inicio).count() );
+        }
+
+        divergencias += memcmp( referencia.data(), candidato.data(), tamanho * sizeof(float) ) != 0;
+
+        printf(
+            "Carimbo (hard %.1f, soft %.1f): %.0fns por obstaculo pela tabela, \033[7m%.0fns\033[0m por faixas (%s).\n",
+            raios[r][0],
+            raios[r][1],
+            tempo_tabela / (double) repeticoes,
+            tempo_faixas / (double) repeticoes,
+            nucleo_de_carimbo_ativo().nome
+        );
+    }
+
+    printf(
+        "Carimbo: %d obstaculos em %d motores, %d divergencias.\n",
+        quantidade_de_obstaculos,
+        quantidade_de_nucleos,
+        divergencias
+    );
+
+    return divergencias;
+}
+
+struct ConsultaEmPilhaPequena {
+    std::vector<float> parametros;
+    float              caminho_final[2050];
+    int                tamanho_do_caminho_final;
+};
+
+void* planejar_em_pilha_pequena(
+    void* argumento
+){
+    ConsultaEmPilhaPequena& consulta = *(ConsultaEmPilhaPequena*) argumento;
+
+    // O contexto desta thread nasce aqui, a pilha só guarda a referência.
+    ContextoDePlanejamento& contexto = contexto_da_thread();
+
+    a_estrela( contexto, consulta.parametros.data(), (int) consulta.parametros.size() );
+
+    std::copy( contexto.caminho_final, contexto.caminho_final + contexto.tamanho_do_caminho_final, consulta.caminho_final );
+    consulta.tamanho_do_caminho_final = contexto.tamanho_do_caminho_final;
+
+    return nullptr;
+}
+
+int teste_em_pilha_pequena(){
+    /*
+    O estado da busca mora na arena do contexto, e não na pilha. Antes, um
+    Node por célula ocupava alguns MB, e a busca nem cabia numa thread
+    qualquer. Rodamos o caminho longo numa thread de 64KB de pilha e o
+    resultado deve ser o mesmo da thread principal.
+    */
+    const size_t tamanho_da_pilha = 64 * 1024;
+
+    ConsultaEmPilhaPequena consulta;
+    consulta.tamanho_do_caminho_final = -1;
+    consulta.parametros.assign( parametros_caminho_longo, parametros_caminho_longo + quantidade_de_parametros_caminho_longo );
+    consulta.parametros[6] = 1e7;  // Sem timeout, senão a comparação dependeria do relógio.
+
+    a_estrela( consulta.parametros.data(), (int) consulta.parametros.size() );
+    const ContextoDePlanejamento& principal = contexto_da_thread();
+
+    pthread_attr_t atributos;
+    pthread_attr_init( &atributos );
+    pthread_attr_setstacksize( &atributos, tamanho_da_pilha );
+
+    pthread_t thread;
+    const int erro = pthread_create( &thread, &atributos, planejar_em_pilha_pequena, &consulta );
+    pthread_attr_destroy( &atributos );
+
+    if(
+        erro != 0
+    ){
+        printf( "Pilha pequena: nao foi possivel criar a thread (erro %d).\n", erro );
+        return 1;
+    }
+
+    pthread_join( thread, nullptr );
+
+    const bool igual = consulta.tamanho_do_caminho_final == principal.tamanho_do_caminho_final && std::equal(
+        principal.caminho_final,
+        principal.caminho_final + principal.tamanho_do_caminho_final,
+        consulta.caminho_final
+    );
+
+    printf(
+        "Pilha de %zuKB: caminho longo com %d floats, %s. Estado da busca: %zu bytes por celula (antes %zu).\n",
+        tamanho_da_pilha / 1024,
+        consulta.tamanho_do_caminho_final,
+        igual ? "igual ao da thread principal" : "\033[7mDIFERENTE\033[0m da thread principal",
+        sizeof(*principal.custo_dos_nodes) + sizeof(*principal.parente_dos_nodes) + sizeof(*principal.estado_dos_nodes),
+        sizeof(Node) + sizeof(unsigned int)
+    );
+
+    return !igual;
+}
+
+int teste_de_geracoes(){
+    /*
+    O estado dos nós não é mais zerado a cada busca, cada uma tem a sua
+    geração. Conferimos duas coisas:
+
+        - Buscas curtas agora custam proporcional ao que visitam. Mostramos
+          o tempo delas ao lado do que custaria zerar o estado inteiro.
+        - Um contexto cujo contador estoura no meio do caminho responde
+          exatamente como um contexto novo.
+    */
+    const int quantidade_de_consultas = 64;
+
+    std::vector< std::vector<float> > consultas;
+
+    for(
+        int i = 0;
+        i < quantidade_de_consultas;
+        i++
+    ){
+        // Meio metro até o alvo, com um obstáculo no meio para não ser caminho direto.
+        const float x = -12.f + ( i % 8 ) * 3.f;
+        const float y =  -8.f + ( i / 8 ) * 2.f;
+
+        consultas.push_back( {
+            x, y, 0, 0, x + 0.5f, y + 0.2f, 1e7,
+            x + 0.25f, y + 0.1f, 0.05f, 0.15f, 1.f
+        } );
+    }
+
+    ContextoDePlanejamento* novo       = new ContextoDePlanejamento;
+    ContextoDePlanejamento* estourando = new ContextoDePlanejamento;
+
+    // Umas poucas buscas antes de o contador de 'estourando' dar a volta.
+    a_estrela( *estourando, consultas[0].data(), (int) consultas[0].size() );
+    estourando->geracao_dos_nodes = 0xFFFF - ESTADOS_POR_GERACAO * 12;
+
+    int divergencias = 0;
+
+    for(
+        int i = 0;
+        i < quantidade_de_consultas;
+        i++
+    ){
+        OpcoesDeBusca opcoes;
+        opcoes.pontos_de_salto = i % 2;
+
+        a_estrela( *novo,       consultas[i].data(), (int) consultas[i].size(), opcoes );
+        a_estrela( *estourando, consultas[i].data(), (int) consultas[i].size(), opcoes );
+
+        divergencias += novo->tamanho_do_caminho_final != estourando->tamanho_do_caminho_final || !std::equal(
+            novo->caminho_final,
+            novo->caminho_final + novo->tamanho_do_caminho_final,
+            estourando->caminho_final
+        );
+    }
+
+    const int repeticoes = 50;
+
+    inicio = high_resolution_clock::now();
+    for(
+        int r = 0;
+        r < repeticoes;
+        r++
+    ){
+        for(
+            int i = 0;
+            i < quantidade_de_consultas;
+            i++
+        ){
+            a_estrela( *novo, consultas[i].data(), (int) consultas[i].size() );
+        }
+    }
+    fim = high_resolution_clock::now();
+    const double tempo_por_busca = duration_cast<nanoseconds>(fim - inicio).count() / 1000.0 / ( repeticoes * quantidade_de_consultas );
+
+    inicio = high_resolution_clock::now();
+    for(
+        int r = 0;
+        r < repeticoes;
+        r++
+    ){
+        std::fill( novo->estado_dos_nodes, novo->estado_dos_nodes + QUANT_LINHAS * QUANT_COLUNAS, 0 );
+    }
+    fim = high_resolution_clock::now();
+    const double tempo_para_zerar = duration_cast<nanoseconds>(fim - inicio).count() / 1000.0 / repeticoes;
+
+    // Zeramos as marcas por fora, a geração precisa recomeçar.
+    novo->geracao_dos_nodes = 0xFFFF;
+
+    printf(
+        "Geracoes: busca curta em \033[7m%.2fus\033[0m (zerar o estado custaria %.2fus), %d expansoes na ultima, %d divergencias apos o contador dar a volta.\n",
+        tempo_por_busca,
+        tempo_para_zerar,
+        novo->expansoes_na_ultima_busca,
+        divergencias
+    );
+
+    delete novo;
+    delete estourando;
+
+    return divergencias;
+}
+
+int teste_em_qualquer_tempo(){
+    /*
+    ARA*, OpcoesDeBusca::em_qualquer_tempo. Conferimos três coisas:
+
+        - Com tempo de sobra ela chega ao mesmo status do A* comum e, nos
+          caminhos completos, ao mesmo custo. Com status 2 o pedaço de
+          caminho pode sair mais caro, pois vem da iteração com peso.
+        - Presa na primeira iteração (reducao_do_peso = 0), o custo respeita
+          a garantia devolvida em fator_de_suboptimalidade.
+        - Com um timeout apertado, quantas vezes ela ainda entrega um caminho
+          completo enquanto o A* comum desiste com status 1.
+    */
+    const int quantidade_de_consultas = 64;
+
+    float* obstaculos = parametros_caminho_longo + 7;
+    const int quantidade_de_obstaculos = quantidade_de_parametros_caminho_longo - 7;
+
+    OpcoesDeBusca em_qualquer_tempo;
+    em_qualquer_tempo.em_qualquer_tempo = true;
+
+    OpcoesDeBusca so_a_primeira = em_qualquer_tempo;
+    so_a_primeira.reducao_do_peso = 0;
+
+    ContextoDePlanejamento& contexto = contexto_da_thread();
+
+    int   divergencias       = 0;
+    int   garantias_violadas = 0;
+    float pior_garantia      = 1;
+
+    for(
+        int i = 0;
+        i < quantidade_de_consultas;
+        i++
+    ){
+        std::vector<float> parametros = {
+            -15.f + ( i % 8 ) * 4.f, -10.f + ( i / 8 ) * 2.6f,
+            (float) ( i % 2 ), (float) ( i % 3 == 0 ),
+            12.f - ( i % 7 ), 5.f - ( i % 11 ),
+            500000
+        };
+        parametros.insert( parametros.end(), obstaculos, obstaculos + quantidade_de_obstaculos );
+
+        a_estrela( contexto, parametros.data(), (int) parametros.size() );
+
+        const float status_comum = contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ];
+        const float custo_comum  = contexto.caminho_final[ contexto.tamanho_do_caminho_final - 1 ];
+
+        a_estrela( contexto, parametros.data(), (int) parametros.size(), em_qualquer_tempo );
+
+        divergencias += status_comum != contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ] || (
+            status_comum == 0 && fabsf( custo_comum - contexto.caminho_final[ contexto.tamanho_do_caminho_final - 1 ] ) > 1e-2f
+        );
+
+        // A primeira iteração gira em falso até o timeout, que baixamos para 1ms.
+        parametros[6] = 1000;
+        a_estrela( contexto, parametros.data(), (int) parametros.size(), so_a_primeira );
+
+        const float garantia = contexto.fator_de_suboptimalidade;
+        pior_garantia = std::max( pior_garantia, garantia );
+
+        /*
+        Se o 1ms acabar antes da primeira iteração achar o objetivo, o que
+        volta é um pedaço de caminho, sem garantia nenhuma. Só conferimos
+        os completos, senão o teste dependeria da velocidade da máquina.
+        */
+        garantias_violadas += status_comum == 0 && contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ] == 0 && (
+            garantia < 1 || contexto.caminho_final[ contexto.tamanho_do_caminho_final - 1 ] > garantia * custo_comum + 1e-2f
+        );
+    }
+
+    /*
+    Muro de obstáculos entre o início e o alvo, aberto só nas pontas, com um
+    timeout que o A* comum não costuma cumprir.
+    */
+    std::vector<float> parametros = { -10, 0, 0, 0, 10, 0, 2000 };
+
+    for(
+        int k = -8;
+        k <= 8;
+        k++
+    ){
+        parametros.insert( parametros.end(), { 0, k * 0.6f, 0.3f, 0.6f, 1.f } );
+    }
+
+    const int repeticoes = 20;
+    int completos_comum             = 0;
+    int completos_em_qualquer_tempo = 0;
+
+    for(
+        int r = 0;
+        r < repeticoes;
+        r++
+    ){
+        a_estrela( contexto, parametros.data(), (int) parametros.size() );
+        completos_comum += contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ] == 0;
+
+        a_estrela( contexto, parametros.data(), (int) parametros.size(), em_qualquer_tempo );
+        completos_em_qualquer_tempo += contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ] == 0;
+    }
+
+    printf(
+        "Em qualquer tempo: %d divergencias do A* comum, %d garantias violadas (pior %.2f), muro em %dus completo %d/%d vezes (A* comum %d/%d).\n",
+        divergencias,
+        garantias_violadas,
+        pior_garantia,
+        (int) parametros[6],
+        completos_em_qualquer_tempo,
+        repeticoes,
+        completos_comum,
+        repeticoes
+    );
+
+    return divergencias + garantias_violadas;
+}
+
+int teste_do_campo_ate_o_alvo(){
+    /*
+    Um time inteiro indo ao gol adversário, com uma linha de defensores
+    no meio do caminho: um CampoAteOAlvo contra uma busca por agente.
+
+    Calcular o campo custa o mesmo que dezenas de buscas curtas, então ele
+    só compensa quando as buscas de cada um são caras, como aqui.
+
+    O campo cobre o quadro todo e o A* só a sua janela, então o custo do
+    campo pode sair menor, nunca maior. Contamos os iguais e os menores, e
+    conferimos que o caminho descido não tem buracos.
+    */
+    const int quantidade_de_agentes = 11;
+    const int repeticoes            = 20;
+
+    std::vector<float> parametros = { 0, 0, 0, 1, 0, 0, 500000 };
+
+    for(
+        int k = -8;
+        k <= 8;
+        k++
+    ){
+        parametros.insert( parametros.end(), { 2.f, k * 0.6f, 0.3f, 0.6f, 1.f } );
+    }
+
+    ContextoDePlanejamento& contexto = contexto_da_thread();
+    CampoAteOAlvo*          campo    = new CampoAteOAlvo;
+
+    float caminho[ 2050 ];
+
+    int  iguais        = 0;
+    int  menores       = 0;
+    int  divergencias  = 0;
+    int  buracos       = 0;
+    long tempo_busca   = 0;
+    long tempo_campo   = 0;
+
+    for(
+        int r = 0;
+        r < repeticoes;
+        r++
+    ){
+        inicio = high_resolution_clock::now();
+        campo->calcular( parametros.data(), (int) parametros.size() );
+
+        for(
+            int i = 0;
+            i < quantidade_de_agentes;
+            i++
+        ){
+            campo->caminho_a_partir_de( -14.f + 1.2f * i, -9.f + 1.7f * i, caminho );
+        }
+        fim = high_resolution_clock::now();
+        tempo_campo += duration_cast<microseconds>(fim - inicio).count();
+
+        for(
+            int i = 0;
+            i < quantidade_de_agentes;
+            i++
+        ){
+            parametros[0] = -14.f + 1.2f * i;
+            parametros[1] =  -9.f + 1.7f * i;
+
+            inicio = high_resolution_clock::now();
+            a_estrela( contexto, parametros.data(), (int) parametros.size() );
+            fim = high_resolution_clock::now();
+            tempo_busca += duration_cast<microseconds>(fim - inicio).count();
+
+            const int   tamanho      = campo->caminho_a_partir_de( parametros[0], parametros[1], caminho );
+            const float status_campo = caminho[ tamanho - 2 ];
+            const float custo_campo  = caminho[ tamanho - 1 ];
+            const float status_busca = contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ];
+            const float custo_busca  = contexto.caminho_final[ contexto.tamanho_do_caminho_final - 1 ];
+
+            if(
+                status_campo != status_busca || custo_campo > custo_busca + 1e-3f
+            ){
+                divergencias++;
+            }
+            else if(
+                custo_campo < custo_busca - 1e-3f
+            ){
+                menores++;
+            }
+            else{
+                iguais++;
+            }
+
+            for(
+                int k = 2;
+                k < tamanho - 4;
+                k += 2
+            ){
+                const float dx = fabsf( caminho[k    ] - caminho[k - 2] );
+                const float dy = fabsf( caminho[k + 1] - caminho[k - 1] );
+
+                if(
+                    dx > 0.101f || dy > 0.101f || dx + dy < 0.05f
+                ){
+                    buracos++;
+                    break;
+                }
+            }
+        }
+    }
+
+    printf(
+        "\033[7m%ldus\033[0m -> Campo ate o gol + %d caminhos (%ldus em %d buscas), %d iguais, %d mais baratos, %d divergencias, %d com buracos, %d celulas.\n",
+        tempo_campo / repeticoes,
+        quantidade_de_agentes,
+        tempo_busca / repeticoes,
+        quantidade_de_agentes,
+        iguais,
+        menores,
+        divergencias,
+        buracos,
+        campo->expansoes_no_ultimo_calculo
+    );
+
+    delete campo;
+
+    return divergencias + buracos;
+}
+
+int teste_de_qualquer_angulo(){
+    /*
+    OpcoesDeBusca::qualquer_angulo. Para cada consulta conferimos que o
+    caminho suavizado tem o mesmo status, começa e termina nos mesmos
+    pontos, não custa mais que a escada e que toda reta entre dois pontos
+    seguidos é possível no quadro de custo da busca.
+    */
+    const int quantidade_de_consultas = 64;
+
+    float* obstaculos = parametros_caminho_longo + 7;
+    const int quantidade_de_obstaculos = quantidade_de_parametros_caminho_longo - 7;
+
+    OpcoesDeBusca qualquer_angulo;
+    qualquer_angulo.qualquer_angulo = true;
+
+    ContextoDePlanejamento& contexto = contexto_da_thread();
+
+    int   erros               = 0;
+    long  pontos_na_escada    = 0;
+    long  pontos_suavizados   = 0;
+    float custo_na_escada     = 0;
+    float custo_suavizado     = 0;
+
+    for(
+        int i = 0;
+        i < quantidade_de_consultas;
+        i++
+    ){
+        std::vector<float> parametros = {
+            -15.f + ( i % 8 ) * 4.f, -10.f + ( i / 8 ) * 2.6f,
+            (float) ( i % 2 ), (float) ( i % 3 == 0 ),
+            12.f - ( i % 7 ), 5.f - ( i % 11 ),
+            500000
+        };
+        parametros.insert( parametros.end(), obstaculos, obstaculos + quantidade_de_obstaculos );
+
+        a_estrela( contexto, parametros.data(), (int) parametros.size() );
+
+        const std::vector<float> escada( contexto.caminho_final, contexto.caminho_final + contexto.tamanho_do_caminho_final );
+
+        a_estrela( contexto, parametros.data(), (int) parametros.size(), qualquer_angulo );
+
+        const float* suavizado = contexto.caminho_final;
+        const int    tamanho   = contexto.tamanho_do_caminho_final;
+
+        erros += escada[ escada.size() - 2 ] != suavizado[ tamanho - 2 ]
+              || escada[0] != suavizado[0] || escada[1] != suavizado[1]
+              || escada[ escada.size() - 4 ] != suavizado[ tamanho - 4 ]
+              || escada[ escada.size() - 3 ] != suavizado[ tamanho - 3 ]
+              || suavizado[ tamanho - 1 ] > escada[ escada.size() - 1 ] + 1e-3f;
+
+        for(
+            int k = 2;
+            k < tamanho - 2;
+            k += 2
+        ){
+            const int linha_a  = x_para_linha( suavizado[ k - 2 ] ), coluna_a = y_para_col( suavizado[ k - 1 ] );
+            const int linha_b  = x_para_linha( suavizado[ k     ] ), coluna_b = y_para_col( suavizado[ k + 1 ] );
+
+            /*
+            Retas e diagonais exatas podem ser trechos retos da própria escada,
+            que não passam pelo teste de visada e podem até começar dentro de
+            um obstáculo. Conferimos só os atalhos de verdade.
+            */
+            if(
+                linha_b == linha_a || coluna_b == coluna_a || abs( linha_b - linha_a ) == abs( coluna_b - coluna_a )
+            ){
+                continue;
+            }
+
+            erros += custo_da_linha_de_visada(
+                linha_a, coluna_a, linha_b, coluna_b,
+                contexto.quadro_de_custo,
+                parametros[2] ? -3 : -2
+            ) < 0;
+        }
+
+        pontos_na_escada  += ( escada.size() - 2 ) / 2;
+        pontos_suavizados += ( tamanho - 2 ) / 2;
+        custo_na_escada   += escada[ escada.size() - 1 ];
+        custo_suavizado   += suavizado[ tamanho - 1 ];
+    }
+
+    printf(
+        "Qualquer angulo: %d erros, %ld pontos viraram %ld, custo total %.1f virou %.1f.\n",
+        erros,
+        pontos_na_escada,
+        pontos_suavizados,
+        custo_na_escada,
+        custo_suavizado
+    );
+
+    return erros;
+}
+
+int teste_em_dois_niveis(){
+    /*
+    OpcoesDeBusca::em_dois_niveis em travessias do campo, com a linha de
+    defensores do teste do campo até o alvo. Conferimos que os caminhos
+    completos saem com o mesmo início e o mesmo fim do A* comum, quanto o
+    custo piora e quantas travessias cabem num timeout curto. O timeout de
+    1ms é apertado de propósito para o binário de debug, sem otimização.
+    */
+    OpcoesDeBusca em_dois_niveis;
+    em_dois_niveis.em_dois_niveis = true;
+
+    ContextoDePlanejamento& contexto = contexto_da_thread();
+
+    std::vector<float> obstaculos;
+    for(
+        int k = -5;
+        k <= 5;
+        k++
+    ){
+        obstaculos.insert( obstaculos.end(), { 4.f, k * 1.5f, 0.3f, 1.f, 1.f } );
+    }
+    obstaculos.insert( obstaculos.end(), parametros_caminho_longo + 7, parametros_caminho_longo + quantidade_de_parametros_caminho_longo );
+
+    const int quantidade_de_consultas = 32;
+
+    int   erros                 = 0;
+    long  expansoes_comum       = 0;
+    long  expansoes_dois_niveis = 0;
+    float pior_razao            = 1;
+    long  tempo_comum           = 0;
+    long  tempo_dois_niveis     = 0;
+    int   completos_comum       = 0;
+    int   completos_dois_niveis = 0;
+
+    for(
+        int i = 0;
+        i < quantidade_de_consultas;
+        i++
+    ){
+        std::vector<float> parametros = {
+            -14.f, -9.f + ( i % 8 ) * 2.5f,
+            (float) ( i % 2 ), (float) ( i % 4 < 2 ),
+            13.f, 8.f - ( i % 5 ) * 4.f,
+            500000
+        };
+        parametros.insert( parametros.end(), obstaculos.begin(), obstaculos.end() );
+
+        inicio = high_resolution_clock::now();
+        a_estrela( contexto, parametros.data(), (int) parametros.size() );
+        tempo_comum += duration_cast<microseconds>( high_resolution_clock::now() - inicio ).count();
+
+        expansoes_comum += contexto.expansoes_na_ultima_busca;
+
+        const std::vector<float> comum( contexto.caminho_final, contexto.caminho_final + contexto.tamanho_do_caminho_final );
+
+        inicio = high_resolution_clock::now();
+        a_estrela( contexto, parametros.data(), (int) parametros.size(), em_dois_niveis );
+        tempo_dois_niveis += duration_cast<microseconds>( high_resolution_clock::now() - inicio ).count();
+
+        expansoes_dois_niveis += contexto.expansoes_na_ultima_busca;
+
+        const float* dois_niveis = contexto.caminho_final;
+        const int    tamanho     = contexto.tamanho_do_caminho_final;
+
+        if(
+            comum[ comum.size() - 2 ] == 0
+        ){
+            // Indo ao gol, qualquer célula da linha do gol serve de fim.
+            erros += dois_niveis[ tamanho - 2 ] != 0
+                  || dois_niveis[0] != comum[0] || dois_niveis[1] != comum[1]
+                  || dois_niveis[ tamanho - 4 ] != comum[ comum.size() - 4 ]
+                  || ( !parametros[3] && dois_niveis[ tamanho - 3 ] != comum[ comum.size() - 3 ] );
+
+            pior_razao = std::max( pior_razao, dois_niveis[ tamanho - 1 ] / comum[ comum.size() - 1 ] );
+        }
+
+        // A mesma travessia com 1ms de timeout.
+        parametros[6] = 1000;
+
+        a_estrela( contexto, parametros.data(), (int) parametros.size() );
+        completos_comum += contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ] == 0;
+
+        a_estrela( contexto, parametros.data(), (int) parametros.size(), em_dois_niveis );
+        completos_dois_niveis += contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ] == 0;
+    }
+
+    printf(
+        "\033[7m%ldus\033[0m -> %d travessias em dois niveis (%ldus no A* comum), %ld expansoes contra %ld, %d erros, custo ate %.2fx, com 1ms completas %d/%d (A* comum %d/%d).\n",
+        tempo_dois_niveis,
+        quantidade_de_consultas,
+        tempo_comum,
+        expansoes_dois_niveis,
+        expansoes_comum,
+        erros,
+        pior_razao,
+        completos_dois_niveis,
+        quantidade_de_consultas,
+        completos_comum,
+        quantidade_de_consultas
+    );
+
+    return erros;
+}
+
+int teste_de_obstaculos_em_movimento(){
+    /*
+    OpcoesDeBusca::obstaculos_em_movimento. Primeiro, obstáculos parados no
+    formato de 7 valores dão exatamente o caminho do formato de 5.
+
+    Depois simulamos um agente atravessando uma fila de adversários que
+    cruzam o seu caminho, replanejando a cada ciclo de 0.1s e andando até o
+    segundo ponto do caminho, como o PathManager. Contamos os ciclos em que a
+    direção escolhida vira mais de 30 graus e a menor distância a um adversário.
+    */
+    ContextoDePlanejamento& contexto = contexto_da_thread();
+
+    OpcoesDeBusca em_movimento;
+    em_movimento.obstaculos_em_movimento = true;
+
+    std::vector<float> parados_5 = { -3, 1, 0, 0, 4, 0, 500000 };
+    std::vector<float> parados_7 = parados_5;
+
+    for(
+        int k = 0;
+        k < 22;
+        k++
+    ){
+        const float obstaculo[5] = { -2.f + ( k % 6 ) * 1.1f, -3.f + ( k / 6 ) * 1.7f, 0.2f, 0.8f, 1.f };
+        parados_5.insert( parados_5.end(), obstaculo, obstaculo + 5 );
+        parados_7.insert( parados_7.end(), obstaculo, obstaculo + 5 );
+        parados_7.insert( parados_7.end(), { 0.f, 0.f } );
+    }
+
+    a_estrela( contexto, parados_5.data(), (int) parados_5.size() );
+    const std::vector<float> caminho_5( contexto.caminho_final, contexto.caminho_final + contexto.tamanho_do_caminho_final );
+
+    a_estrela( contexto, parados_7.data(), (int) parados_7.size(), em_movimento );
+    const bool parados_iguais = caminho_5 == std::vector<float>( contexto.caminho_final, contexto.caminho_final + contexto.tamanho_do_caminho_final );
+
+    const int   quantidade_de_adversarios = 4;
+    const float passo_do_agente           = 0.07f;  // 0.7 m/s, o padrão de velocidade_do_agente
+
+    int   viradas[2]        = { 0, 0 };
+    float menor_distancia[2] = { 100, 100 };
+    int   chegou[2]         = { -1, -1 };
+
+    for(
+        int modo = 0;
+        modo < 2;
+        modo++
+    ){
+        float agente_x = -6, agente_y = 0;
+        float direcao_x = 1, direcao_y = 0;
+
+        // Adversários que cruzam a reta y = 0, alternando o sentido.
+        float adversarios[quantidade_de_adversarios][4];
+        for(
+            int k = 0;
+            k < quantidade_de_adversarios;
+            k++
+        ){
+            adversarios[k][0] = -3.f + 2.5f * k;
+            adversarios[k][1] = ( k % 2 ? 2.5f : -2.5f );
+            adversarios[k][2] = 0;
+            adversarios[k][3] = ( k % 2 ? -0.5f : 0.5f );
+        }
+
+        for(
+            int ciclo = 0;
+            ciclo < 300 && chegou[modo] == -1;
+            ciclo++
+        ){
+            std::vector<float> parametros = { agente_x, agente_y, 0, 0, 6, 0, 500000 };
+
+            for(
+                int k = 0;
+                k < quantidade_de_adversarios;
+                k++
+            ){
+                parametros.insert( parametros.end(), { adversarios[k][0], adversarios[k][1], 0.4f, 1.f, 1.f } );
+
+                if(
+                    modo == 1
+                ){
+                    parametros.insert( parametros.end(), { adversarios[k][2], adversarios[k][3] } );
+                }
+            }
+
+            a_estrela( contexto, parametros.data(), (int) parametros.size(), modo == 1 ? em_movimento : OpcoesDeBusca() );
+
+            const int pontos = ( contexto.tamanho_do_caminho_final - 2 ) / 2;
+            const int alvo   = pontos > 2 ? 2 : pontos - 1;
+
+            float dx = contexto.caminho_final[ 2 * alvo     ] - agente_x;
+            float dy = contexto.caminho_final[ 2 * alvo + 1 ] - agente_y;
+            const float norma = sqrtf( dx * dx + dy * dy );
+
+            if(
+                norma < 1e-3f
+            ){
+                chegou[modo] = ciclo;
+                break;
+            }
+
+            dx /= norma;
+            dy /= norma;
+
+            viradas[modo] += ciclo > 0 && dx * direcao_x + dy * direcao_y < cosf( 30.f * 3.14159265f / 180.f );
+            direcao_x = dx;
+            direcao_y = dy;
+
+            agente_x += passo_do_agente * dx;
+            agente_y += passo_do_agente * dy;
+
+            for(
+                int k = 0;
+                k < quantidade_de_adversarios;
+                k++
+            ){
+                adversarios[k][0] += 0.1f * adversarios[k][2];
+                adversarios[k][1] += 0.1f * adversarios[k][3];
+
+                const float ox = adversarios[k][0] - agente_x;
+                const float oy = adversarios[k][1] - agente_y;
+                menor_distancia[modo] = std::min( menor_distancia[modo], sqrtf( ox * ox + oy * oy ) );
+            }
+
+            if(
+                fabsf( agente_x - 6 ) < 0.1f && fabsf( agente_y ) < 0.1f
+            ){
+                chegou[modo] = ciclo;
+            }
+        }
+    }
+
+    printf(
+        "Obstaculos em movimento: parados %s, viradas de mais de 30 graus %d (parados: %d), menor distancia %.2fm (parados: %.2fm), chegada no ciclo %d (parados: %d).\n",
+        parados_iguais ? "iguais" : "DIFERENTES",
+        viradas[1],
+        viradas[0],
+        menor_distancia[1],
+        menor_distancia[0],
+        chegou[1],
+        chegou[0]
+    );
+
+    return !parados_iguais;
+}
+
+int teste_da_fase_larga(){
+    /*
+    A fase larga só pode descartar obstáculos que não tocam o segmento. Para
+    segmentos e obstáculos sorteados, inclusive além das bordas e com raios
+    de até DIST_MAX, algum_obstaculo_ao_longo_do_segmento() precisa dar a
+    mesma resposta que testar todos os obstáculos um a um.
+
+    Depois medimos a_estrela() num caminho direto livre com muitos
+    obstáculos longe dele, com obstáculos novos a cada chamada e repetidos.
+    */
+    FaseLarga fase;
+    int divergencias = 0;
+    int obstruidos   = 0;
+
+    srand( 17 );
+    for(
+        int k = 0;
+        k < 3000;
+        k++
+    ){
+        const int quantidade = rand() % 40;
+
+        std::vector<float> obstaculos;
+        for(
+            int i = 0;
+            i < quantidade;
+            i++
+        ){
+            const float obstaculo[5] = {
+                sorteio_entre( -meio_comprimento - 5, meio_comprimento + 5 ),
+                sorteio_entre( -meia_largura     - 5, meia_largura     + 5 ),
+                ( rand() % 61 ) / 10.f - 0.5f,
+                ( rand() % 61 ) / 10.f - 0.5f,
+                1.f
+            };
+            obstaculos.insert( obstaculos.end(), obstaculo, obstaculo + 5 );
+        }
+
+        montar_fase_larga( fase, obstaculos.data(), (int) obstaculos.size() );
+
+        for(
+            int s = 0;
+            s < 10;
+            s++
+        ){
+            // Como em se_caminho_esta_obstruido(), os extremos ficam no campo, ou até 1m fora. Alguns segmentos são verticais ou horizontais.
+            const float a_x = sorteio_entre( -meio_comprimento - 1, meio_comprimento + 1 );
+            const float a_y = sorteio_entre( -meia_largura     - 1, meia_largura     + 1 );
+            const float b_x = s == 0 ? a_x : sorteio_entre( -meio_comprimento - 1, meio_comprimento + 1 );
+            const float b_y = s == 1 ? a_y : sorteio_entre( -meia_largura     - 1, meia_largura     + 1 );
+
+            bool referencia = false;
+            for(
+                int i = 0;
+                i < quantidade;
+                i++
+            ){
+                referencia = referencia || segmento_toca_circulo( a_x, a_y, b_x, b_y, fase.x[i], fase.y[i], fase.maior_raio[i] );
+            }
+
+            const bool candidato = algum_obstaculo_ao_longo_do_segmento(
+                fase,
+                a_x,
+                a_y,
+                b_x,
+                b_y,
+                [&]( int i ){ return segmento_toca_circulo( a_x, a_y, b_x, b_y, fase.x[i], fase.y[i], fase.maior_raio[i] ); }
+            );
+
+            divergencias += referencia != candidato;
+            obstruidos   += referencia;
+        }
+    }
+
+    // Caminho direto livre, perto do eixo x, e obstáculos a mais de 3m da linha até a lateral.
+    ContextoDePlanejamento& contexto = contexto_da_thread();
+
+    const int quantidade_de_obstaculos = 200;
+    const int repeticoes               = 2000;
+
+    std::vector<float> obstaculos;
+    for(
+        int i = 0;
+        i < quantidade_de_obstaculos;
+        i++
+    ){
+        const float obstaculo[5] = {
+            sorteio_entre( -meio_comprimento, meio_comprimento ),
+            ( rand() % 2 ? 1.f : -1.f ) * sorteio_entre( 3.f, meia_largura ),
+            0.3f,
+            1.f,
+            1.f
+        };
+        obstaculos.insert( obstaculos.end(), obstaculo, obstaculo + 5 );
+    }
+
+    long tempos[2];
+    int  diretos = 0;
+
+    for(
+        int repetidos = 0;
+        repetidos < 2;
+        repetidos++
+    ){
+        // Montadas antes, para medir só a_estrela().
+        std::vector<std::vector<float>> consultas( repeticoes );
+        for(
+            int k = 0;
+            k < repeticoes;
+            k++
+        ){
+            consultas[k] = {
+                meio_comprimento * ( -0.8f + ( k % 7 ) * 0.05f ), -1.f + ( k % 5 ) * 0.4f,
+                0, 0,
+                meio_comprimento * (  0.7f - ( k % 3 ) * 0.05f ),  1.f - ( k % 4 ) * 0.5f,
+                500000
+            };
+            consultas[k].insert( consultas[k].end(), obstaculos.begin(), obstaculos.end() );
+
+            if(
+                // Um obstáculo a mais que muda a cada chamada obriga a remontar a fase larga.
+                !repetidos
+            ){
+                consultas[k].insert( consultas[k].end(), { 0.f, 0.8f * meia_largura + ( k % 10 ) * 0.1f, 0.3f, 1.f, 1.f } );
+            }
+        }
+
+        inicio = high_resolution_clock::now();
+        for(
+            int k = 0;
+            k < repeticoes;
+            k++
+        ){
+            a_estrela( contexto, consultas[k].data(), (int) consultas[k].size() );
+            diretos += contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ] == 3;
+        }
+        fim = high_resolution_clock::now();
+        tempos[repetidos] = duration_cast<nanoseconds>(fim - inicio).count();
+    }
+
+    printf(
+        "Fase larga: %d divergencias em 30000 segmentos (%d obstruidos), caminho direto com %d obstaculos em %.2fus com obstaculos novos e %.2fus repetidos (%d de %d diretos).\n",
+        divergencias,
+        obstruidos,
+        quantidade_de_obstaculos,
+        tempos[0] / 1000.0 / repeticoes,
+        tempos[1] / 1000.0 / repeticoes,
+        diretos,
+        2 * repeticoes
+    );
+
+    // Todos os caminhos diretos precisam sair pelo atalho, senão a fase larga não foi medida.
+    return divergencias + ( diretos != 2 * repeticoes );
+}
+
+int teste_das_estatisticas(){
+    /*
+    EstatisticasDaBusca. As somas precisam bater com as chamadas feitas, as
+    etapas não podem ser negativas, e o custo da instrumentação, umas poucas
+    leituras de relógio, precisa ser pequeno perto de uma busca curta.
+    */
+    ContextoDePlanejamento& contexto = contexto_da_thread();
+    contexto.estatisticas_acumuladas.zerar();
+
+    const int quantidade_de_consultas = 200;
+
+    long long expansoes        = 0;
+    long long tempos_esgotados = 0;
+    int       maior_lista      = 0;
+    int       erros            = 0;
+
+    srand( 18 );
+    for(
+        int k = 0;
+        k < quantidade_de_consultas;
+        k++
+    ){
+        std::vector<float> parametros = {
+            ( rand() % 3000 ) / 100.f - 15.f, ( rand() % 2000 ) / 100.f - 10.f,
+            (float) ( k % 2 ), (float) ( k % 3 == 0 ),
+            ( rand() % 3000 ) / 100.f - 15.f, ( rand() % 2000 ) / 100.f - 10.f,
+            k % 10 == 0 ? 50.f : 500000.f  // alguns esgotam o tempo
+        };
+
+        for(
+            // Metade sem obstáculos, quase sempre resolvida pelo caminho direto.
+            int i = 0;
+            i < ( k % 2 ? 8 : 0 );
+            i++
+        ){
+            parametros.insert( parametros.end(), { ( rand() % 3000 ) / 100.f - 15.f, ( rand() % 2000 ) / 100.f - 10.f, 0.3f, 1.5f, 1.f } );
+        }
+
+        OpcoesDeBusca opcoes;
+        opcoes.qualquer_angulo = k % 4 == 1;
+
+        a_estrela( contexto, parametros.data(), (int) parametros.size(), opcoes );
+
+        const EstatisticasDaBusca& ultima = contexto.estatisticas_da_ultima_busca;
+
+        expansoes        += contexto.expansoes_na_ultima_busca;
+        tempos_esgotados += contexto.caminho_final[ contexto.tamanho_do_caminho_final - 2 ] == 1;
+        maior_lista       = std::max( maior_lista, ultima.maior_lista_aberta );
+
+        erros += ultima.chamadas != 1;
+        erros += ultima.tempo_do_atalho < 0 || ultima.tempo_de_preparo < 0 || ultima.tempo_de_carimbo < 0 ||
+                 ultima.tempo_de_busca  < 0 || ultima.tempo_de_reconstrucao < 0;
+        erros += ultima.caminhos_diretos && ( ultima.expansoes != 0 || ultima.tempo_de_preparo != 0 );
+        erros += ultima.obstaculos_carimbados != ( ultima.caminhos_diretos ? 0 : ( k % 2 ? 8 : 0 ) );
+    }
+
+    const EstatisticasDaBusca& soma = contexto.estatisticas_acumuladas;
+
+    erros += soma.chamadas           != quantidade_de_consultas;
+    erros += soma.expansoes          != expansoes;
+    erros += soma.tempos_esgotados   != tempos_esgotados;
+    erros += soma.maior_lista_aberta != maior_lista;
+    erros += soma.tempo_total        != soma.tempo_do_atalho + soma.tempo_de_preparo + soma.tempo_de_carimbo + soma.tempo_de_busca + soma.tempo_de_reconstrucao;
+
+    // Quanto custam as leituras de relógio que uma chamada com busca faz.
+    const int repeticoes = 100000;
+
+    inicio = high_resolution_clock::now();
+    for(
+        int k = 0;
+        k < repeticoes;
+        k++
+    ){
+        high_resolution_clock::now();
+    }
+    fim = high_resolution_clock::now();
+
+    const double por_leitura = duration_cast<nanoseconds>(fim - inicio).count() / (double) repeticoes;
+
+    a_estrela( parametros_caminho_longo, quantidade_de_parametros_caminho_longo );
+    const EstatisticasDaBusca& longo = contexto.estatisticas_da_ultima_busca;
+
+    printf(
+        "Estatisticas: %d erros em %d chamadas (%lld diretas, %lld sem tempo, pico da lista aberta %d), %.0fns por leitura de relogio, 7 por chamada.\n"
+        "Caminho longo: total %.1fus = atalho %.1f + preparo %.1f + carimbo %.1f + busca %.1f + reconstrucao %.1f, %lld expansoes, lista aberta ate %d.\n",
+        erros,
+        quantidade_de_consultas,
+        soma.caminhos_diretos,
+        soma.tempos_esgotados,
+        soma.maior_lista_aberta,
+        por_leitura,
+        longo.tempo_total           / 1000.0,
+        longo.tempo_do_atalho       / 1000.0,
+        longo.tempo_de_preparo      / 1000.0,
+        longo.tempo_de_carimbo      / 1000.0,
+        longo.tempo_de_busca        / 1000.0,
+        longo.tempo_de_reconstrucao / 1000.0,
+        longo.expansoes,
+        longo.maior_lista_aberta
+    );
+
+    return erros;
+}
+
+unsigned long long resumo_do_quadro(
+    const float* quadro
+){
+    // FNV-1a sobre os bytes das células.
+    unsigned long long resumo = 1469598103934665603ull;
+
+    for(
+        int posicao = 0;
+        posicao < QUANT_LINHAS * QUANT_COLUNAS;
+        posicao++
+    ){
+        unsigned int bits;
+        memcpy( &bits, &quadro[posicao], sizeof( bits ) );
+
+        for(
+            int byte = 0;
+            byte < 4;
+            byte++
+        ){
+            resumo ^= ( bits >> ( 8 * byte ) ) & 0xFF;
+            resumo *= 1099511628211ull;
+        }
+    }
+
+    return resumo;
+}
+
+int teste_da_geometria_do_campo(){
+    /*
+    Quadros gerados em tempo de compilação a partir da geometria (campo.h).
+
+    O oficial precisa ser idêntico, bit a bit, à antiga tabela de macros
+    L0_1 ... L310_314 com o amortecimento aplicado, cujos resumos estão
+    guardados aqui. O de treino precisa ter o campo, o gol e as traves
+    onde a geometria diz.
+    */
+    typedef CampoNoQuadro<CampoOficial>  Oficial;
+    typedef CampoNoQuadro<CampoDeTreino> Treino;
+
+    static_assert( Oficial::linha_do_gol == 312, "Linha do gol do campo oficial mudou." );
+    static_assert( Oficial::primeira_coluna_do_gol == 101 && Oficial::ultima_coluna_do_gol == 119, "Colunas do gol do campo oficial mudaram." );
+
+    static constexpr QuadrosDoCampo<CampoOficial>  oficial{};
+    static constexpr QuadrosDoCampo<CampoDeTreino> treino{};
+
+    int erros = 0;
+
+    erros += resumo_do_quadro( oficial.dentro_do_campo ) != 0xd0ad4b86e4e7d98aull;
+    erros += resumo_do_quadro( oficial.fora_do_campo   ) != 0x7eb39708f8acbcf3ull;
+
+    struct Celula { int linha; int coluna; float fora; float dentro; };
+
+    const int meio_l = Treino::linha_do_meio;
+    const int meio_c = Treino::coluna_do_meio;
+    const int fim_x  = Treino::fim_do_campo_em_x;
+    const int fim_y  = Treino::fim_do_campo_em_y;
+
+    const Celula esperadas[] = {
+        { meio_l,                 meio_c,                          0.f,  0.f },  // centro
+        { meio_l - fim_x,         meio_c,                          0.f,  6.f },  // junto ao nosso fundo
+        { meio_l + fim_x,         meio_c,                          0.f,  0.f },  // diante do gol deles, sem amortecimento
+        { meio_l + fim_x,         meio_c + 20,                     0.f,  6.f },  // no fundo deles, longe do gol
+        { meio_l,                 meio_c + fim_y,                  0.f,  6.f },  // junto à lateral
+        { meio_l,                 meio_c + fim_y - 3,              0.f,  3.f },
+        { meio_l,                 meio_c + fim_y + 1,             -2.f, -2.f },  // fora do campo de treino
+        { Treino::linha_do_gol,   Treino::primeira_coluna_do_gol,  0.f,  0.f },  // alvo no gol deles
+        { Treino::linha_do_gol,   Treino::ultima_coluna_do_gol + 1,-3.f, -3.f }, // trave
+        { 2 * meio_l - Treino::linha_do_gol,     meio_c,         -2.f, -2.f },  // interior do nosso gol
+        { meio_l + Treino::fundo_do_gol,          meio_c,         -3.f, -3.f },  // rede
+        { meio_l + Treino::fundo_do_gol + 3,      meio_c,         -2.f, -2.f },  // atrás da rede
+    };
+
+    for(
+        int i = 0;
+        i < (int) ( sizeof( esperadas ) / sizeof( esperadas[0] ) );
+        i++
+    ){
+        const int posicao = esperadas[i].linha * QUANT_COLUNAS + esperadas[i].coluna;
+
+        if(
+            treino.fora_do_campo[posicao] != esperadas[i].fora || treino.dentro_do_campo[posicao] != esperadas[i].dentro
+        ){
+            printf( "Campo de treino, celula %d (%d, %d): %g e %g, esperado %g e %g\n", i, esperadas[i].linha, esperadas[i].coluna,
+                    treino.fora_do_campo[posicao], treino.dentro_do_campo[posicao], esperadas[i].fora, esperadas[i].dentro );
+            erros++;
+        }
+    }
+
+    printf(
+        "Geometria do campo: %d erros. Oficial igual a tabela antiga, gol na linha %d (colunas %d a %d); treino %dm x %dm, gol na linha %d.\n",
+        erros,
+        Oficial::linha_do_gol,
+        Oficial::primeira_coluna_do_gol,
+        Oficial::ultima_coluna_do_gol,
+        2 * Treino::linha_de_fundo / 10,
+        2 * Treino::linha_lateral  / 10,
+        Treino::linha_do_gol
+    );
+
+    return erros;
+}
+
+bool mesmo_caminho(
+    const ContextoDePlanejamento& a,
+    const ContextoDePlanejamento& b
+){
+    // Bit a bit, status e custo inclusive.
+    return a.tamanho_do_caminho_final == b.tamanho_do_caminho_final &&
+           a.fator_de_suboptimalidade == b.fator_de_suboptimalidade &&
+           memcmp( a.caminho_final, b.caminho_final, a.tamanho_do_caminho_final * sizeof( float ) ) == 0;
+}
+
+int teste_do_cache_de_caminhos(){
+    /*
+    OpcoesDeBusca::usar_cache. Cada consulta roda num contexto com cache e
+    noutro sem, e os caminhos precisam ser idênticos, inclusive quando o
+    alvo anda sem sair da célula e o último ponto vem trocado do cache.
+    Depois conferimos o descarte do usado há mais tempo, que timeouts e
+    em_qualquer_tempo não são guardados e que obstáculos novos erram.
+    */
+    ContextoDePlanejamento com_cache;
+    ContextoDePlanejamento sem_cache;
+
+    // Uma parede em x = 0, de lado a lado, para que o caminho direto nunca resolva.
+    const int meia_parede = (int) ( meia_largura / 1.2f );
+
+    std::vector<float> obstaculos;
+    for(
+        int k = -meia_parede;
+        k <= meia_parede;
+        k++
+    ){
+        obstaculos.insert( obstaculos.end(), { 0.f, k * 1.2f, 0.3f, 1.f, 1.f } );
+    }
+
+    auto consulta = [&]( float sx, float sy, bool gol, float ax, float ay, float tempo_limite ){
+        std::vector<float> parametros = { sx, sy, 0, (float) gol, ax, ay, tempo_limite };
+        parametros.insert( parametros.end(), obstaculos.begin(), obstaculos.end() );
+        return parametros;
+    };
+
+    const int quantidade_de_consultas = 400;
+
+    int  erros            = 0;
+    long acertos_esperados = 0;
+    long tempo_com_cache  = 0;
+    long tempo_sem_cache  = 0;
+
+    /*
+    Consultas já vistas, pelas células de início e fim e pelo modo. Com até
+    16 originais e o alvo andando no máximo uma célula em cada eixo, nunca
+    passam de 64 e nada é descartado nesta parte.
+    */
+    std::vector<std::vector<float>> anteriores;
+    std::set<std::tuple<int, int, int>> vistas;
+
+    srand( 20 );
+    for(
+        int k = 0;
+        k < quantidade_de_consultas;
+        k++
+    ){
+        std::vector<float> parametros;
+        bool               deve_acertar;
+
+        if(
+            // Metade, e todas depois de 16 originais, repete uma anterior com o alvo alguns milímetros ao lado.
+            k % 2 || anteriores.size() == 16
+        ){
+            parametros = anteriores[ rand() % anteriores.size() ];
+
+            parametros[4] += ( rand() % 5 - 2 ) * 0.002f;
+            parametros[5] += ( rand() % 5 - 2 ) * 0.002f;
+        }
+        else{
+            parametros = consulta(
+                -sorteio_entre( 4.f, meio_comprimento - 1 ), sorteio_entre( -0.8f * meia_largura, 0.8f * meia_largura ),
+                k % 5 == 0,
+                 sorteio_entre( 4.f, meio_comprimento - 1 ), sorteio_entre( -0.8f * meia_largura, 0.8f * meia_largura ),
+                500000.f
+            );
+            anteriores.push_back( parametros );
+        }
+
+        // Os modos mudam a chave, logo são sorteados por consulta original.
+        OpcoesDeBusca opcoes;
+        const int     modo = (int) ( parametros[0] * 100 ) & 3;
+        opcoes.qualquer_angulo = modo == 1;
+        opcoes.pontos_de_salto = modo == 2;
+        opcoes.em_dois_niveis  = modo == 3;
+
+        const std::tuple<int, int, int> chave(
+            x_para_linha( parametros[0] ) * QUANT_COLUNAS + y_para_col( parametros[1] ),
+            parametros[3] ? -1 : x_para_linha( parametros[4] ) * QUANT_COLUNAS + y_para_col( parametros[5] ),
+            modo
+        );
+        deve_acertar = !vistas.insert( chave ).second;
+
+        std::vector<float> copia = parametros;
+
+        inicio = high_resolution_clock::now();
+        a_estrela( sem_cache, copia.data(), (int) copia.size(), opcoes );
+        fim = high_resolution_clock::now();
+        tempo_sem_cache += duration_cast<nanoseconds>(fim - inicio).count();
+
+        opcoes.usar_cache = true;
+
+        inicio = high_resolution_clock::now();
+        a_estrela( com_cache, parametros.data(), (int) parametros.size(), opcoes );
+        fim = high_resolution_clock::now();
+        tempo_com_cache += duration_cast<nanoseconds>(fim - inicio).count();
+
+        erros += !mesmo_caminho( com_cache, sem_cache );
+        erros += com_cache.estatisticas_da_ultima_busca.acertos_no_cache != ( deve_acertar ? 1 : 0 );
+        erros += deve_acertar && com_cache.expansoes_na_ultima_busca != 0;
+
+        acertos_esperados += deve_acertar;
+    }
+
+    const long long acertos = com_cache.estatisticas_acumuladas.acertos_no_cache;
+
+    // Descarte: 64 consultas distintas enchem o cache, a primeira é usada de novo e uma 65ª entra.
+    OpcoesDeBusca usar_cache;
+    usar_cache.usar_cache = true;
+
+    com_cache.cache_de_caminhos.limpar();
+
+    auto repetir = [&]( int i ){
+        std::vector<float> parametros = consulta( -0.8f * meio_comprimento + ( i % 8 ) * 0.5f, -0.7f * meia_largura + ( i / 8 ) * 0.5f, 1, 0, 0, 500000.f );
+        a_estrela( com_cache, parametros.data(), (int) parametros.size(), usar_cache );
+        return com_cache.estatisticas_da_ultima_busca.acertos_no_cache == 1;
+    };
+
+    for(
+        int i = 0;
+        i < CAPACIDADE_DO_CACHE;
+        i++
+    ){
+        erros += repetir( i );
+    }
+    erros += !repetir( 0 );
+    erros += repetir( CAPACIDADE_DO_CACHE );  // descarta a consulta 1
+    erros += !repetir( 0 );
+    erros += repetir( 1 );
+
+    // Timeout não é guardado.
+    std::vector<float> curta = consulta( -0.9f * meio_comprimento, 0.3f * meia_largura, 1, 0, 0, 1.f );
+    a_estrela( com_cache, curta.data(), (int) curta.size(), usar_cache );
+    const bool esgotou = com_cache.caminho_final[ com_cache.tamanho_do_caminho_final - 2 ] == 1;
+    a_estrela( com_cache, curta.data(), (int) curta.size(), usar_cache );
+    erros += esgotou && com_cache.estatisticas_da_ultima_busca.acertos_no_cache != 0;
+
+    // em_qualquer_tempo também não.
+    OpcoesDeBusca em_qualquer_tempo = usar_cache;
+    em_qualquer_tempo.em_qualquer_tempo = true;
+
+    std::vector<float> qualquer_tempo = consulta( -0.7f * meio_comprimento, -0.5f * meia_largura, 0, 0.7f * meio_comprimento, 0.5f * meia_largura, 500000.f );
+    a_estrela( com_cache, qualquer_tempo.data(), (int) qualquer_tempo.size(), em_qualquer_tempo );
+    a_estrela( com_cache, qualquer_tempo.data(), (int) qualquer_tempo.size(), em_qualquer_tempo );
+    erros += com_cache.estatisticas_da_ultima_busca.acertos_no_cache != 0;
+
+    // Um obstáculo que muda de célula muda a chave.
+    std::vector<float> outra = consulta( -0.7f * meio_comprimento, 0.5f * meia_largura, 0, 0.7f * meio_comprimento, -0.5f * meia_largura, 500000.f );
+    a_estrela( com_cache, outra.data(), (int) outra.size(), usar_cache );
+    outra[ 7 ] += 0.3f;
+    a_estrela( com_cache, outra.data(), (int) outra.size(), usar_cache );
+    erros += com_cache.estatisticas_da_ultima_busca.acertos_no_cache != 0;
+
+    printf(
+        "Cache de caminhos: %d erros, %lld acertos em %d consultas (%ld esperados), %.2fus por consulta com cache e %.2fus sem%s.\n",
+        erros,
+        acertos,
+        quantidade_de_consultas,
+        acertos_esperados,
+        tempo_com_cache / 1000.0 / quantidade_de_consultas,
+        tempo_sem_cache / 1000.0 / quantidade_de_consultas,
+        esgotou ? "" : " (a consulta curta nao esgotou o tempo)"
+    );
+
+    return erros;
 }
 
 int main()
 {
-	teste_de_funcao_principal_a_estrela();
-		
-	
-   return 0;
+	/*
+	Cada teste devolve quantos erros achou. Qualquer erro faz o programa sair
+	com 1, e assim o make teste falha em vez de depender de alguém ler a saída.
+	*/
+	int erros = 0;
+
+	erros += teste_de_funcao_principal_a_estrela();
+
+	erros += teste_de_caminho_longo();
+
+	erros += teste_em_lote();
+
+	erros += teste_de_replanejamento_incremental();
+
+	erros += teste_de_custo_de_preparacao();
+
+	erros += teste_de_pontos_de_salto();
+
+	erros += teste_do_carimbo();
+
+	erros += teste_em_pilha_pequena();
+
+	erros += teste_de_geracoes();
+
+	erros += teste_em_qualquer_tempo();
+
+	erros += teste_do_campo_ate_o_alvo();
+
+	erros += teste_de_qualquer_angulo();
+
+	erros += teste_em_dois_niveis();
+
+	erros += teste_de_obstaculos_em_movimento();
+
+	erros += teste_da_fase_larga();
+
+	erros += teste_das_estatisticas();
+
+	erros += teste_da_geometria_do_campo();
+
+	erros += teste_do_cache_de_caminhos();
+
+	printf( "%s%d erros no total.%s\n", erros ? "\033[7m" : "", erros, erros ? "\033[0m" : "" );
+
+	return erros ? 1 : 0;
 }
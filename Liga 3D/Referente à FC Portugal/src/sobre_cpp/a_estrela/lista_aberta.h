@@ -0,0 +1,410 @@
+/*
+Motores da lista aberta do A*.
+
+A lista aberta guarda os nós já descobertos, mas ainda não expandidos, e
+precisa responder rápido a três perguntas: quem é o menor, insira este e
+este ficou mais barato.
+
+A BST original (namespace noding em a_estrela.cpp) não é balanceada. Como
+os custos f chegam quase em ordem crescente em caminhos longos, ela vira
+praticamente uma lista ligada e cada inserção passa a custar O(n).
+
+Escolha do motor em tempo de compilação:
+
+	-DLISTA_ABERTA_HEAP   -> heap binário indexado com decrease-key (padrão)
+	-DLISTA_ABERTA_RADIX  -> radix heap sobre o custo f quantizado
+	-DLISTA_ABERTA_BST    -> BST original, mantida para comparação
+
+Todos os motores falam a mesma língua, vulgo posições do quadro (linha * QUANT_COLUNAS + coluna):
+
+	limpar()                            -> esvazia a estrutura
+	vazia()                             -> se não há mais nós abertos
+	extrair_min()                       -> remove e retorna a posição de menor valor
+	inserir  (posicao, valor, custo)    -> adiciona um nó novo
+	atualizar(posicao, valor, custo)    -> o nó já está na lista e ficou mais barato
+	tamanho()                           -> quantidade de nós abertos
+
+'custo' é o custo acumulado g, usado apenas como critério de desempate.
+*/
+
+#ifndef LISTA_ABERTA_H
+#define LISTA_ABERTA_H
+
+#include "a_estrela.h"
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+#if !defined(LISTA_ABERTA_HEAP) && !defined(LISTA_ABERTA_RADIX) && !defined(LISTA_ABERTA_BST)
+	#define LISTA_ABERTA_HEAP
+#endif
+
+#define QUANT_POSICOES (QUANT_LINHAS * QUANT_COLUNAS)
+
+#if defined(LISTA_ABERTA_HEAP)
+
+class ListaAberta {
+	/*
+	Descrição:
+		Heap binário mínimo em que cada entrada sabe sua posição no quadro
+		e cada posição do quadro sabe onde está no heap. É isso que permite
+		o decrease-key em O(log n) sem precisar procurar o nó.
+
+		Em empates de valor, preferimos o nó de maior custo acumulado, ou seja,
+		o mais próximo do objetivo. Em campo aberto isso evita que a busca
+		se espalhe por todos os caminhos de mesmo custo.
+
+		Somas de SQRT_2 em float raramente empatam de verdade, por isso o valor
+		é arredondado para baixo em passos de 1/RESOLUCAO_DO_DESEMPATE antes de
+		ser comparado. Sem isso o desempate quase nunca acontece.
+	*/
+public:
+
+	ListaAberta() : quantidade( 0 ) {}
+
+	inline void limpar()         { quantidade = 0;        }
+	inline bool vazia()   const  { return quantidade == 0; }
+	inline int  tamanho() const  { return quantidade;      }
+
+	inline int
+	extrair_min(){
+
+		const int posicao = heap[0].posicao;
+
+		quantidade--;
+		if(
+			quantidade > 0
+		){
+			heap[0] = heap[quantidade];
+			indice_no_heap[ heap[0].posicao ] = 0;
+			descer( 0 );
+		}
+
+		return posicao;
+	}
+
+	inline void
+	inserir(
+		int   posicao,
+		float valor,
+		float custo
+	){
+		int indice = quantidade++;
+
+		heap[indice].valor   = arredondar( valor );
+		heap[indice].custo   = custo;
+		heap[indice].posicao = posicao;
+		indice_no_heap[posicao] = indice;
+
+		subir( indice );
+	}
+
+	inline void
+	atualizar(
+		int   posicao,
+		float valor,
+		float custo
+	){
+		/*
+		O A* só atualiza um nó quando encontra um caminho mais barato para ele,
+		logo o valor sempre diminui e basta subir.
+		*/
+		int indice = indice_no_heap[posicao];
+
+		heap[indice].valor = arredondar( valor );
+		heap[indice].custo = custo;
+
+		subir( indice );
+	}
+
+private:
+
+	struct Entrada {
+		float valor;
+		float custo;
+		int   posicao;
+	};
+
+	static constexpr float RESOLUCAO_DO_DESEMPATE = 64.f;
+
+	inline static float
+	arredondar(
+		float valor
+	){
+		return floorf( valor * RESOLUCAO_DO_DESEMPATE );
+	}
+
+	inline static bool
+	menor(
+		const Entrada& a,
+		const Entrada& b
+	){
+		return (a.valor < b.valor) || (a.valor == b.valor && a.custo > b.custo);
+	}
+
+	inline void
+	subir(
+		int indice
+	){
+		Entrada entrada = heap[indice];
+
+		while(
+			indice > 0
+		){
+			int pai = (indice - 1) >> 1;
+
+			if(
+				!menor( entrada, heap[pai] )
+			){
+				break;
+			}
+
+			heap[indice] = heap[pai];
+			indice_no_heap[ heap[indice].posicao ] = indice;
+			indice = pai;
+		}
+
+		heap[indice] = entrada;
+		indice_no_heap[ entrada.posicao ] = indice;
+	}
+
+	inline void
+	descer(
+		int indice
+	){
+		Entrada entrada = heap[indice];
+
+		while(
+			true
+		){
+			int filho = 2 * indice + 1;
+
+			if(
+				filho >= quantidade
+			){
+				break;
+			}
+
+			if(
+				// Escolhemos o menor dos dois filhos.
+				filho + 1 < quantidade && menor( heap[filho + 1], heap[filho] )
+			){
+				filho++;
+			}
+
+			if(
+				!menor( heap[filho], entrada )
+			){
+				break;
+			}
+
+			heap[indice] = heap[filho];
+			indice_no_heap[ heap[indice].posicao ] = indice;
+			indice = filho;
+		}
+
+		heap[indice] = entrada;
+		indice_no_heap[ entrada.posicao ] = indice;
+	}
+
+	/*
+	Cada posição entra no máximo uma vez, logo o heap nunca passa do tamanho do quadro.
+	indice_no_heap só é lido para posições que estão abertas, então não precisa ser zerado.
+	*/
+	Entrada heap          [QUANT_POSICOES];
+	int     indice_no_heap[QUANT_POSICOES];
+	int     quantidade;
+};
+
+#elif defined(LISTA_ABERTA_RADIX)
+
+class ListaAberta {
+	/*
+	Descrição:
+		Radix heap (Ahuja, Mehlhorn, Orlin e Tarjan). Funciona porque, com a
+		heurística consistente de distancia_diagonal(), os valores extraídos
+		nunca diminuem.
+
+		O valor f é quantizado em passos de 1/RESOLUCAO_RADIX e a caçamba de
+		cada entrada é o bit mais significativo em que ela difere do último
+		valor extraído. Inserir é O(1) e cada entrada é redistribuída no máximo
+		32 vezes.
+
+		Não há decrease-key propriamente dito: a atualização insere uma cópia
+		nova e a antiga é descartada quando aparecer, pois sua chave não
+		corresponde mais à chave_atual da posição.
+	*/
+public:
+
+	ListaAberta() : ultimo( 0 ), quantidade( 0 ) {
+
+		for(
+			int i = 0;
+			i < QUANT_CACAMBAS;
+			i++
+		){
+			cacambas[i].reserve( 256 );
+		}
+	}
+
+	inline void
+	limpar(){
+
+		for(
+			int i = 0;
+			i < QUANT_CACAMBAS;
+			i++
+		){
+			cacambas[i].clear();
+		}
+
+		ultimo     = 0;
+		quantidade = 0;
+	}
+
+	inline bool vazia()   const  { return quantidade == 0; }
+	inline int  tamanho() const  { return quantidade;      }
+
+	inline int
+	extrair_min(){
+
+		while(
+			true
+		){
+			if(
+				cacambas[0].empty()
+			){
+				redistribuir();
+			}
+
+			Entrada entrada = cacambas[0].back();
+			cacambas[0].pop_back();
+
+			if(
+				// Cópia velha de uma posição que já foi atualizada ou extraída.
+				chave_atual[ entrada.posicao ] != entrada.chave
+			){
+				continue;
+			}
+
+			chave_atual[ entrada.posicao ] = CHAVE_INVALIDA;
+			quantidade--;
+
+			return entrada.posicao;
+		}
+	}
+
+	inline void
+	inserir(
+		int   posicao,
+		float valor,
+		float /* custo */
+	){
+		quantidade++;
+		empurrar( posicao, quantizar( valor ) );
+	}
+
+	inline void
+	atualizar(
+		int   posicao,
+		float valor,
+		float /* custo */
+	){
+		empurrar( posicao, quantizar( valor ) );
+	}
+
+private:
+
+	static const int      QUANT_CACAMBAS  = 33;
+	static const uint32_t CHAVE_INVALIDA  = 0xFFFFFFFFu;
+	static constexpr float RESOLUCAO_RADIX = 64.f;
+
+	struct Entrada {
+		uint32_t chave;
+		int      posicao;
+	};
+
+	inline uint32_t
+	quantizar(
+		float valor
+	) const {
+		/*
+		Arredondamentos de float podem gerar uma chave um pouco menor que a
+		última extraída, o que quebraria a monotonia. Saturamos em 'ultimo'.
+		*/
+		float escalado = valor * RESOLUCAO_RADIX;
+
+		uint32_t chave = (escalado >= 4.0e9f) ? CHAVE_INVALIDA - 1 : uint32_t( escalado > 0.f ? escalado : 0.f );
+
+		return chave < ultimo ? ultimo : chave;
+	}
+
+	inline static int
+	cacamba_de(
+		uint32_t chave,
+		uint32_t referencia
+	){
+		uint32_t diferenca = chave ^ referencia;
+
+		return diferenca == 0 ? 0 : 32 - __builtin_clz( diferenca );
+	}
+
+	inline void
+	empurrar(
+		int      posicao,
+		uint32_t chave
+	){
+		chave_atual[posicao] = chave;
+
+		Entrada entrada = { chave, posicao };
+		cacambas[ cacamba_de( chave, ultimo ) ].push_back( entrada );
+	}
+
+	inline void
+	redistribuir(){
+		/*
+		A caçamba 0 esvaziou. Achamos a primeira caçamba não vazia, seu menor
+		valor vira a nova referência e todas as suas entradas descem.
+		*/
+		int i = 1;
+		while(
+			cacambas[i].empty()
+		){
+			i++;
+		}
+
+		uint32_t novo_ultimo = CHAVE_INVALIDA;
+		for(
+			int k = 0;
+			k < (int) cacambas[i].size();
+			k++
+		){
+			novo_ultimo = cacambas[i][k].chave < novo_ultimo ? cacambas[i][k].chave : novo_ultimo;
+		}
+
+		ultimo = novo_ultimo;
+
+		for(
+			int k = 0;
+			k < (int) cacambas[i].size();
+			k++
+		){
+			const Entrada& entrada = cacambas[i][k];
+			cacambas[ cacamba_de( entrada.chave, ultimo ) ].push_back( entrada );
+		}
+
+		cacambas[i].clear();
+	}
+
+	std::vector<Entrada> cacambas[QUANT_CACAMBAS];
+	uint32_t             chave_atual[QUANT_POSICOES];
+	uint32_t             ultimo;
+	int                  quantidade;
+};
+
+#endif // LISTA_ABERTA_HEAP / LISTA_ABERTA_RADIX
+
+// LISTA_ABERTA_BST é definida em a_estrela.cpp, logo após o namespace noding.
+
+#endif // LISTA_ABERTA_H
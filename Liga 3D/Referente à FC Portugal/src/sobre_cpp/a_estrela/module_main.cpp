@@ -24,6 +24,7 @@ a_estrela.find_optimal_path()
 */
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
+#include <algorithm>
 
 /*
 Usar 'using namespace pybind11' traria todas as funes e
@@ -35,9 +36,64 @@ Ao ver 'py::' saiba que vem imediatamente de pybind11.
 namespace py = pybind11;
 using namespace std;
 
+/*
+Garante que o buffer recebido seja contguo e de float32. Caso o numpy
+envie outra coisa, o pybind11 converte antes de chegar aqui.
+*/
+typedef py::array_t<float, py::array::c_style | py::array::forcecast> array_de_parametros;
+
+/*
+A busca l os 7 valores fixos (incio, permisso, objetivo, alvo e timeout)
+sem conferir o tamanho, ento um vetor menor a faria ler alm do array.
+*/
+inline void
+conferir_parametros(
+    const array_de_parametros& parametros_de_campo_e_de_situacao
+){
+    if(
+        parametros_de_campo_e_de_situacao.ndim() != 1 || parametros_de_campo_e_de_situacao.shape( 0 ) < 7
+    ){
+        throw py::value_error( "parametros deve ter os 7 valores fixos de find_optimal_path e os obstaculos" );
+    }
+}
+
+/*
+Os dois planejadores respondem no mesmo formato, em caminho_final e
+tamanho_do_caminho_final. S muda a forma de chamar a busca.
+*/
+inline void
+buscar( ContextoDePlanejamento& contexto, float parametros[], int quantidade, const OpcoesDeBusca& opcoes ){ a_estrela( contexto, parametros, quantidade, opcoes ); }
+
+inline void
+buscar( ReplanejadorIncremental& replanejador, float parametros[], int quantidade, const OpcoesDeBusca& ){ replanejador.planejar( parametros, quantidade ); }
+
+inline OpcoesDeBusca
+opcoes_de_busca(
+    bool pontos_de_salto,
+    bool em_qualquer_tempo = false,
+    bool qualquer_angulo   = false,
+    bool em_dois_niveis    = false,
+    bool obstaculos_em_movimento = false,
+    bool usar_cache        = false
+){
+    // Monta as opes a partir dos argumentos nomeados do Python.
+    OpcoesDeBusca opcoes;
+    opcoes.pontos_de_salto         = pontos_de_salto;
+    opcoes.em_qualquer_tempo       = em_qualquer_tempo;
+    opcoes.qualquer_angulo         = qualquer_angulo;
+    opcoes.em_dois_niveis          = em_dois_niveis;
+    opcoes.obstaculos_em_movimento = obstaculos_em_movimento;
+    opcoes.usar_cache              = usar_cache;
+
+    return opcoes;
+}
+
+template <typename Planejador>
 py::array_t<float>
-find_optimal_path(
-    py::array_t<float> parametros_de_campo_e_de_situacao
+planejar(
+    Planejador& contexto,
+    array_de_parametros parametros_de_campo_e_de_situacao,
+    const OpcoesDeBusca& opcoes = OpcoesDeBusca()
 ){
     /*
     Descrio:
@@ -46,6 +102,14 @@ find_optimal_path(
         intensivos do A* sejam realizados em C++ enquanto
         mantm uma interface limpa com Python.
 
+        O GIL  liberado durante a busca. Como tudo que a_estrela()
+        escreve pertence ao contexto, threads Python diferentes podem
+        planejar ao mesmo tempo, cada uma com o seu contexto.
+
+        'contexto' pode ser um ContextoDePlanejamento ou um
+        ReplanejadorIncremental. O replanejador ignora 'opcoes', pois o
+        D* Lite tem a sua prpria expanso.
+
     Parmetros:
         Somente vendo a funo a_estrela(), disponvel
         no arquivo correspondente a_estrela.cpp, j sanar suas
@@ -60,6 +124,8 @@ find_optimal_path(
         Caminho a ser executado pelo agente.
     */
 
+    conferir_parametros( parametros_de_campo_e_de_situacao );
+
     /*
     Com isso passamos um array numpy do Python direto
     para C++ via pybind11. Essa biblioteca  to bizarra de
@@ -84,40 +150,426 @@ find_optimal_path(
     /// Calculamos o caminho
     /////////////////////////////////////////////////////////////////////
 
-    a_estrela(
-        (float*) buffer_de_entrada.ptr,
-        quantidade_de_parametros
-    );
+    {
+        /*
+        Enquanto este objeto existir, o GIL fica liberado. No podemos
+        tocar em nenhum objeto Python dentro deste bloco.
+        */
+        py::gil_scoped_release sem_gil;
+
+        buscar(
+            contexto,
+            (float*) buffer_de_entrada.ptr,
+            quantidade_de_parametros,
+            opcoes
+        );
+    }
 
     /////////////////////////////////////////////////////////////////////
     /// Retornaremos o caminho obtido.
     /////////////////////////////////////////////////////////////////////
 
     // Alocamos memria
+    const float* caminho_final            = contexto.caminho_final;
+    const int    tamanho_do_caminho_final = contexto.tamanho_do_caminho_final;
+
     py::array_t<float> a_ser_retornado = py::array_t<float>(tamanho_do_caminho_final);
 
-    // Obtemos informaes de ponteiros.
-    py::buffer_info buffer_de_saida = a_ser_retornado.request();
+    /*
+    No podemos retornar o ponteiro de caminho_final pois ele ser
+    reutilizado e alterado. Quem no quer a cpia nem a alocao usa
+    planejar_no_buffer().
+    */
+    std::copy( caminho_final, caminho_final + tamanho_do_caminho_final, a_ser_retornado.mutable_data() );
+
+    return a_ser_retornado;
+}
+
+/*
+Buffer de sada fornecido pelo Python. Sem forcecast e com noconvert() no
+argumento: se o pybind11 convertesse, escreveramos numa cpia temporria
+e o chamador nunca veria o caminho.
+*/
+typedef py::array_t<float, py::array::c_style> buffer_de_saida;
+
+#define TAMANHO_MINIMO_DA_SAIDA 2048  // Maior caminho possvel, sem status e custo
+
+template <typename Planejador>
+py::tuple
+planejar_no_buffer(
+    Planejador& contexto,
+    array_de_parametros parametros_de_campo_e_de_situacao,
+    buffer_de_saida saida,
+    const OpcoesDeBusca& opcoes = OpcoesDeBusca()
+){
+    /*
+    Descrio:
+        Mesma busca de planejar(), mas sem alocar nada por chamada: o
+        caminho [x1, y1, ..., xn, yn] vai direto para 'saida', que o
+        chamador aloca uma vez e reaproveita, e status e custo voltam como
+        int e float, em vez de ficarem no fim do array.
 
-    float *ptr = (float*) buffer_de_saida.ptr;  // Pegamos o primeiro ponteiro do array.
+    Retorno:
+        (quantidade de floats escritos em saida, status, custo)
+    */
+    conferir_parametros( parametros_de_campo_e_de_situacao );
 
-    for(
-        int index = 0;
-        index < tamanho_do_caminho_final;
-        index++
+    if(
+        saida.ndim() != 1 || saida.shape( 0 ) < TAMANHO_MINIMO_DA_SAIDA
     ){
-        /*
-        Preenchemos o buffer_de_saida a partir do ponteiro.
+        throw py::value_error( "saida deve ser um vetor float32 com pelo menos 2048 posicoes" );
+    }
 
-        No podemos retornar o ponteiro de caminho_final pois
-        ele ser reutilizado e alterado.
-        */
-        ptr[index] = caminho_final[index];
+    const float* ptr_parametros           = parametros_de_campo_e_de_situacao.data();
+    const int    quantidade_de_parametros = (int) parametros_de_campo_e_de_situacao.shape( 0 );
+    float*       ptr_saida                = saida.mutable_data();  // Lana exceo se no for gravvel
+
+    int   tamanho;
+    int   status;
+    float custo;
+
+    {
+        py::gil_scoped_release sem_gil;
+
+        buscar(
+            contexto,
+            (float*) ptr_parametros,
+            quantidade_de_parametros,
+            opcoes
+        );
+
+        tamanho = contexto.tamanho_do_caminho_final - 2;
+        status  = (int) contexto.caminho_final[ tamanho     ];
+        custo   =       contexto.caminho_final[ tamanho + 1 ];
+
+        std::copy( contexto.caminho_final, contexto.caminho_final + tamanho, ptr_saida );
+    }
+
+    return py::make_tuple( tamanho, status, custo );
+}
+
+py::array_t<float>
+find_optimal_path(
+    array_de_parametros parametros_de_campo_e_de_situacao,
+    bool pontos_de_salto,
+    bool em_qualquer_tempo,
+    bool qualquer_angulo,
+    bool em_dois_niveis,
+    bool obstaculos_em_movimento,
+    bool usar_cache
+){
+    /*
+    Descrio:
+        Mesma coisa que planejar(), usando o contexto da thread que
+        chamou. Cada thread Python recebe o seu na primeira chamada.
+    */
+    return planejar<ContextoDePlanejamento>(
+        contexto_da_thread(),
+        parametros_de_campo_e_de_situacao,
+        opcoes_de_busca( pontos_de_salto, em_qualquer_tempo, qualquer_angulo, em_dois_niveis, obstaculos_em_movimento, usar_cache )
+    );
+}
+
+py::tuple
+find_optimal_path_into(
+    array_de_parametros parametros_de_campo_e_de_situacao,
+    buffer_de_saida saida,
+    bool pontos_de_salto,
+    bool em_qualquer_tempo,
+    bool qualquer_angulo,
+    bool em_dois_niveis,
+    bool obstaculos_em_movimento,
+    bool usar_cache
+){
+    // find_optimal_path sem alocao, no contexto da thread que chamou.
+    return planejar_no_buffer<ContextoDePlanejamento>(
+        contexto_da_thread(),
+        parametros_de_campo_e_de_situacao,
+        saida,
+        opcoes_de_busca( pontos_de_salto, em_qualquer_tempo, qualquer_angulo, em_dois_niveis, obstaculos_em_movimento, usar_cache )
+    );
+}
+
+float
+last_suboptimality(){
+    // Garantia da ltima busca desta thread, veja ContextoDePlanejamento::fator_de_suboptimalidade.
+    return contexto_da_thread().fator_de_suboptimalidade;
+}
+
+py::dict
+estatisticas_para_dict(
+    const EstatisticasDaBusca& estatisticas
+){
+    // Tempos em microssegundos, a mesma unidade do timeout.
+    py::dict dicionario;
+
+    dicionario["calls"]             = estatisticas.chamadas;
+    dicionario["shortcuts"]         = estatisticas.caminhos_diretos;
+    dicionario["timeouts"]          = estatisticas.tempos_esgotados;
+    dicionario["expansions"]        = estatisticas.expansoes;
+    dicionario["peak_open_list"]    = estatisticas.maior_lista_aberta;
+    dicionario["restored_rows"]     = estatisticas.linhas_restauradas;
+    dicionario["stamped_obstacles"] = estatisticas.obstaculos_carimbados;
+    dicionario["cache_hits"]        = estatisticas.acertos_no_cache;
+    dicionario["total_us"]          = estatisticas.tempo_total           / 1000.0;
+    dicionario["shortcut_us"]       = estatisticas.tempo_do_atalho       / 1000.0;
+    dicionario["board_setup_us"]    = estatisticas.tempo_de_preparo      / 1000.0;
+    dicionario["stamping_us"]       = estatisticas.tempo_de_carimbo      / 1000.0;
+    dicionario["search_us"]         = estatisticas.tempo_de_busca        / 1000.0;
+    dicionario["reconstruction_us"] = estatisticas.tempo_de_reconstrucao / 1000.0;
+    dicionario["max_total_us"]      = estatisticas.pior_tempo_total      / 1000.0;
+
+    return dicionario;
+}
+
+py::dict
+estatisticas_do_contexto(
+    const ContextoDePlanejamento& contexto
+){
+    // PathPlanner.get_stats: a soma desde o ltimo reset, com a ltima chamada em "last".
+    py::dict dicionario = estatisticas_para_dict( contexto.estatisticas_acumuladas );
+    dicionario["last"]  = estatisticas_para_dict( contexto.estatisticas_da_ultima_busca );
+
+    return dicionario;
+}
+
+void
+zerar_estatisticas_do_contexto(
+    ContextoDePlanejamento& contexto
+){
+    // PathPlanner.reset_stats
+    contexto.estatisticas_acumuladas.zerar();
+}
+
+py::dict
+get_stats(){
+    return estatisticas_do_contexto( contexto_da_thread() );
+}
+
+void
+reset_stats(){
+    zerar_estatisticas_do_contexto( contexto_da_thread() );
+}
+
+void
+limpar_cache_do_contexto(
+    ContextoDePlanejamento& contexto
+){
+    // PathPlanner.clear_cache
+    contexto.cache_de_caminhos.limpar();
+}
+
+void
+clear_cache(){
+    limpar_cache_do_contexto( contexto_da_thread() );
+}
+
+py::array_t<float>
+planejar_com_contexto(
+    ContextoDePlanejamento& contexto,
+    array_de_parametros parametros_de_campo_e_de_situacao,
+    bool pontos_de_salto,
+    bool em_qualquer_tempo,
+    bool qualquer_angulo,
+    bool em_dois_niveis,
+    bool obstaculos_em_movimento,
+    bool usar_cache
+){
+    // PathPlanner.find_optimal_path
+    return planejar( contexto, parametros_de_campo_e_de_situacao, opcoes_de_busca( pontos_de_salto, em_qualquer_tempo, qualquer_angulo, em_dois_niveis, obstaculos_em_movimento, usar_cache ) );
+}
+
+py::tuple
+planejar_com_contexto_no_buffer(
+    ContextoDePlanejamento& contexto,
+    array_de_parametros parametros_de_campo_e_de_situacao,
+    buffer_de_saida saida,
+    bool pontos_de_salto,
+    bool em_qualquer_tempo,
+    bool qualquer_angulo,
+    bool em_dois_niveis,
+    bool obstaculos_em_movimento,
+    bool usar_cache
+){
+    // PathPlanner.find_optimal_path_into
+    return planejar_no_buffer( contexto, parametros_de_campo_e_de_situacao, saida, opcoes_de_busca( pontos_de_salto, em_qualquer_tempo, qualquer_angulo, em_dois_niveis, obstaculos_em_movimento, usar_cache ) );
+}
+
+py::tuple
+planejar_com_replanejador_no_buffer(
+    ReplanejadorIncremental& replanejador,
+    array_de_parametros parametros_de_campo_e_de_situacao,
+    buffer_de_saida saida
+){
+    // IncrementalPathPlanner.find_optimal_path_into
+    return planejar_no_buffer( replanejador, parametros_de_campo_e_de_situacao, saida );
+}
+
+py::array_t<float>
+planejar_com_replanejador(
+    ReplanejadorIncremental& replanejador,
+    array_de_parametros parametros_de_campo_e_de_situacao
+){
+    // IncrementalPathPlanner.find_optimal_path
+    return planejar( replanejador, parametros_de_campo_e_de_situacao );
+}
+
+void
+calcular_campo(
+    CampoAteOAlvo& campo,
+    array_de_parametros parametros_de_campo_e_de_situacao
+){
+    // CostToGoField.compute
+    conferir_parametros( parametros_de_campo_e_de_situacao );
+
+    const float* ptr        = parametros_de_campo_e_de_situacao.data();
+    const int    quantidade = (int) parametros_de_campo_e_de_situacao.shape( 0 );
+
+    py::gil_scoped_release sem_gil;
+
+    campo.calcular( ptr, quantidade );
+}
+
+py::array_t<float>
+caminho_pelo_campo(
+    const CampoAteOAlvo& campo,
+    float start_x,
+    float start_y
+){
+    // CostToGoField.path_from
+    if(
+        !campo.calculado
+    ){
+        throw py::value_error( "o campo ainda nao foi calculado, chame compute() antes" );
     }
 
+    float caminho[ 2050 ];
+    const int tamanho = campo.caminho_a_partir_de( start_x, start_y, caminho );
+
+    py::array_t<float> a_ser_retornado( tamanho );
+    std::copy( caminho, caminho + tamanho, a_ser_retornado.mutable_data() );
+
     return a_ser_retornado;
 }
 
+py::array_t<float>
+vista_do_campo(
+    py::object objeto_do_campo
+){
+    /*
+    Descrio:
+        CostToGoField.field. No copiamos nada: o array aponta para
+        custo_ate_o_alvo, e o objeto Python do campo  a sua base, ento o
+        campo continua vivo enquanto algum segurar a vista.
+
+        A vista  somente leitura e mostra sempre o ltimo compute().
+    */
+    const CampoAteOAlvo& campo = objeto_do_campo.cast<const CampoAteOAlvo&>();
+
+    py::array_t<float> vista(
+        { (py::ssize_t) QUANT_LINHAS, (py::ssize_t) QUANT_COLUNAS },
+        { (py::ssize_t) ( QUANT_COLUNAS * sizeof(float) ), (py::ssize_t) sizeof(float) },
+        campo.custo_ate_o_alvo,
+        objeto_do_campo
+    );
+
+    vista.attr( "setflags" )( py::arg( "write" ) = false );
+
+    return vista;
+}
+
+template <typename T>
+py::array_t<T>
+para_numpy(
+    const std::vector<T>& vetor
+){
+    // Copia um std::vector para um array numpy novo, que passa a ser do Python.
+    py::array_t<T> array( vetor.size() );
+
+    std::copy( vetor.begin(), vetor.end(), array.mutable_data() );
+
+    return array;
+}
+
+py::tuple
+find_optimal_paths(
+    array_de_parametros consultas,
+    array_de_parametros obstaculos,
+    int threads,
+    bool pontos_de_salto,
+    bool qualquer_angulo,
+    bool em_dois_niveis,
+    bool obstaculos_em_movimento,
+    bool usar_cache
+){
+    /*
+    Descrio:
+        Verso em lote de find_optimal_path(). Em vez de uma travessia
+        Python -> C++ por consulta, fazemos uma s para todas, e as
+        consultas so divididas entre vrias threads.
+
+    Parmetros:
+        consultas  -> matriz N x 7, uma consulta por linha, com os 7
+                      parmetros fixos de a_estrela().
+        obstaculos -> [x, y, hard radius, soft radius, force] * k,
+                      compartilhados por todas as consultas.
+        threads    -> quantas threads usar, <= 0 para todas.
+        pontos_de_salto -> usa Jump Point Search em todas as consultas.
+        qualquer_angulo -> suaviza todos os caminhos, veja OpcoesDeBusca.
+        em_dois_niveis  -> planeja em dois nveis as consultas longas, veja OpcoesDeBusca.
+        obstaculos_em_movimento -> obstaculos vem com [vx][vy], 7 valores cada.
+        usar_cache      -> cada thread usa o cache do seu contexto, veja OpcoesDeBusca.
+
+    Retorno:
+        (caminhos, deslocamentos, status, custos), em que o caminho i 
+        caminhos[deslocamentos[i] : deslocamentos[i + 1]].
+    */
+
+    if(
+        consultas.ndim() != 2 || consultas.shape( 1 ) != 7
+    ){
+        throw py::value_error( "consultas deve ser uma matriz N x 7" );
+    }
+
+    if(
+        obstaculos.ndim() != 1 || obstaculos.shape( 0 ) % ( obstaculos_em_movimento ? 7 : 5 ) != 0
+    ){
+        throw py::value_error(
+            obstaculos_em_movimento ? "obstaculos deve ser um vetor com 7 valores por obstaculo"
+                                    : "obstaculos deve ser um vetor com 5 valores por obstaculo"
+        );
+    }
+
+    const float* ptr_consultas            = consultas.data();
+    const int    quantidade_de_consultas  = (int) consultas.shape( 0 );
+    const float* ptr_obstaculos           = obstaculos.data();
+    const int    quantidade_de_obstaculos = (int) obstaculos.shape( 0 );
+
+    ResultadoEmLote resultado;
+
+    {
+        // Os arrays de entrada continuam vivos, pois so argumentos desta funo.
+        py::gil_scoped_release sem_gil;
+
+        a_estrela_em_lote(
+            ptr_consultas,
+            quantidade_de_consultas,
+            ptr_obstaculos,
+            quantidade_de_obstaculos,
+            threads,
+            resultado,
+            opcoes_de_busca( pontos_de_salto, false, qualquer_angulo, em_dois_niveis, obstaculos_em_movimento, usar_cache )
+        );
+    }
+
+    return py::make_tuple(
+        para_numpy( resultado.caminhos      ),
+        para_numpy( resultado.deslocamentos ),
+        para_numpy( resultado.status        ),
+        para_numpy( resultado.custos        )
+    );
+}
+
 /*
 Usamos esse mdulo para possibilitar a adio de argumentos nomeados.
 
@@ -163,7 +615,367 @@ PYBIND11_MODULE(
         Return:
             A trajectory or path that avoids obstacles and is optimal with respect to
             time and space constraints.
+
+        The GIL is released during the search. Each Python thread uses its own
+        planning context, so calls from different threads run concurrently.
+
+        With pontos_de_salto=True the search uses Jump Point Search: runs of
+        zero-cost cells are crossed in a single jump and only cells where the
+        cost changes are expanded. The path cost is the same as the regular
+        A*, although ties between equally cheap paths may be broken differently.
+
+        With em_qualquer_tempo=True the search is anytime (ARA*): it first finds
+        a path with an inflated heuristic and keeps improving it, reusing the
+        previous search, until it is optimal or the timeout expires. The best
+        complete path found is returned with status 0 even if time runs out.
+        Its cost is at most last_suboptimality() times the optimal cost.
+        Takes precedence over pontos_de_salto.
+
+        With qualquer_angulo=True the grid staircase is shortened by line of
+        sight after the search, leaving only the points where the path turns.
+        A shortcut is taken only if it crosses no impassable cell and costs no
+        more than the stretch it replaces, so soft obstacles are still avoided
+        and the returned cost (updated) never increases. Consecutive points are
+        then usually much more than 0.1 m apart. Works with any search mode.
+
+        With em_dois_niveis=True long queries are planned coarse-to-fine. A search
+        over 0.5 m blocks, each with the worst cell cost inside it, finds a corridor
+        to the goal. The fine search only runs inside that corridor, up to 3 m from
+        the start, and the rest of the path is made of the corridor's block centers.
+        The path starts and ends like the regular one (any goal cell when going to the
+        goal), but its cost is not guaranteed (last_suboptimality() is inf). Queries
+        shorter than the horizon, or that the coarse grid cannot solve, run the
+        regular search.
+        Takes precedence over pontos_de_salto and em_qualquer_tempo.
+
+        With obstaculos_em_movimento=True each obstacle takes 7 values,
+        [x, y, hard_radius, soft_radius, force, vx, vy], velocities in m/s. Every
+        obstacle is planned around where it will be when the agent could first reach
+        it, assuming the agent moves at 0.7 m/s and the obstacle keeps its velocity
+        for at most 2 s. The soft radius grows with the distance the obstacle travels
+        in that time, to account for the prediction getting worse. Obstacles with zero
+        velocity give exactly the same path as the regular 5-value format.
+
+        With usar_cache=True, queries that the straight-line test cannot solve are
+        looked up in a small cache (64 paths, least recently used evicted) before
+        searching, and the result is stored afterwards. A query hits when its start
+        cell, target cell, out-of-bounds permission, search modes and obstacles (after
+        conversion to the grid) match an earlier one, and returns exactly the path a
+        new search would. Timeouts and em_qualquer_tempo results are never stored.
+        The cache belongs to the planning context, i.e. this thread, and is emptied
+        by clear_cache().
+        )pbdoc",
+        "parametros"_a,  // Nomeamos o argumento da funo.
+        "pontos_de_salto"_a   = false,
+        "em_qualquer_tempo"_a = false,
+        "qualquer_angulo"_a   = false,
+        "em_dois_niveis"_a    = false,
+        "obstaculos_em_movimento"_a = false,
+        "usar_cache"_a        = false
+    );
+
+    m.def(
+        "find_optimal_path_into",
+        &find_optimal_path_into,
+        R"pbdoc(
+        Same search as find_optimal_path, without allocating or copying a result array.
+
+        The path [x1, y1, ..., xn, yn] is written into 'saida', a C-contiguous,
+        writable float32 vector with at least 2048 elements that the caller allocates
+        once and reuses. Other dtypes are rejected instead of silently converted.
+
+        Return:
+            Tuple (length, status, cost): number of floats written, status code as int
+            (same codes as find_optimal_path) and path cost as float.
+        )pbdoc",
+        "parametros"_a,
+        "saida"_a.noconvert(),
+        "pontos_de_salto"_a   = false,
+        "em_qualquer_tempo"_a = false,
+        "qualquer_angulo"_a   = false,
+        "em_dois_niveis"_a    = false,
+        "obstaculos_em_movimento"_a = false,
+        "usar_cache"_a        = false
+    );
+
+    m.def(
+        "last_suboptimality",
+        &last_suboptimality,
+        R"pbdoc(
+        Suboptimality bound of the last find_optimal_path call made by this thread:
+        the returned path costs at most this factor times the optimal one. Always 1
+        for the regular search, inf when the path tail came from the coarse search of
+        em_dois_niveis, only meaningful for statuses 0 and 3.
         )pbdoc"
-        "parametros"_a  // Nomeamos o argumento da funo.
     );
+
+    m.def(
+        "get_stats",
+        &get_stats,
+        R"pbdoc(
+        Where the planning time of this thread went, summed over every call since the
+        last reset_stats() (find_optimal_path, find_optimal_path_into and the batch
+        workers, each thread with its own numbers). Times are in microseconds:
+
+            - shortcut_us: obstacle conversion and the straight-line test.
+            - board_setup_us: restoring the cost board. The out-of-bounds buffer zone is
+              precomputed in the base board, so this is only the rows the previous call dirtied.
+            - stamping_us: writing obstacles and goal into the board.
+            - search_us: everything else, i.e. the search loop in any mode.
+            - reconstruction_us: building the output path, including any-angle smoothing.
+            - total_us, max_total_us: sum and slowest call.
+
+        Counters: calls, shortcuts (calls solved by the straight-line test), timeouts,
+        expansions, peak_open_list (largest open list of any call), restored_rows and
+        stamped_obstacles, cache_hits (calls answered by the usar_cache cache). The same
+        numbers for the last call alone are in "last".
+
+        A few clock reads per call, cheap enough to leave on during matches.
+        IncrementalPathPlanner and CostToGoField are not counted.
+        )pbdoc"
+    );
+
+    m.def(
+        "reset_stats",
+        &reset_stats,
+        "Zeroes the sums returned by get_stats() for this thread."
+    );
+
+    m.def(
+        "clear_cache",
+        &clear_cache,
+        "Forgets every path cached by usar_cache in this thread."
+    );
+
+    m.def(
+        "find_optimal_paths",
+        &find_optimal_paths,
+        R"pbdoc(
+        Description:
+            Batched version of find_optimal_path. Plans every query in a single
+            native call, splitting them across a pool of worker threads. The GIL
+            is released while the queries run.
+
+        Parameters:
+            - queries: float32 matrix N x 7, one query per row:
+              [start_x, start_y, allow_out_of_bounds, go_to_goal, target_x, target_y, timeout]
+            - obstacles: [x, y, hard_radius, soft_radius, force] * k, shared by all queries.
+            - threads: number of threads to use (counting the caller), <= 0 uses all cores.
+            - pontos_de_salto: use Jump Point Search for every query, see find_optimal_path.
+            - qualquer_angulo: return any-angle paths for every query, see find_optimal_path.
+            - em_dois_niveis: plan long queries coarse-to-fine, see find_optimal_path.
+            - obstaculos_em_movimento: obstacles carry [vx, vy], 7 values each, see find_optimal_path.
+            - usar_cache: look every query up in the cache of the worker thread that runs it,
+              see find_optimal_path.
+
+        Return:
+            Tuple (paths, offsets, statuses, costs):
+            - paths: float32, every path [x1, y1, ..., xn, yn] back to back.
+            - offsets: int32 with N + 1 elements, path i is paths[offsets[i]:offsets[i + 1]].
+            - statuses: float32 with N elements, same codes as find_optimal_path.
+            - costs: float32 with N elements.
+        )pbdoc",
+        "consultas"_a,
+        "obstaculos"_a = py::array_t<float>( 0 ),
+        "threads"_a = 0,
+        "pontos_de_salto"_a = false,
+        "qualquer_angulo"_a = false,
+        "em_dois_niveis"_a  = false,
+        "obstaculos_em_movimento"_a = false,
+        "usar_cache"_a        = false
+    );
+
+    py::class_<ContextoDePlanejamento>(
+        m,
+        "PathPlanner",
+        R"pbdoc(
+        Planning context that owns its node grid, open list and output buffer
+        (a few MB, allocated once).
+
+        Give one to each agent. Searches on different PathPlanner objects can
+        run at the same time from different threads. The same object must not
+        be used by two threads at once.
+        )pbdoc"
+    )
+        .def(
+            py::init<>()
+        )
+        .def(
+            "find_optimal_path",
+            &planejar_com_contexto,
+            R"pbdoc(
+            Same as a_estrela.find_optimal_path, but uses this planner's context.
+            The GIL is released during the search.
+            )pbdoc",
+            "parametros"_a,
+            "pontos_de_salto"_a   = false,
+            "em_qualquer_tempo"_a = false,
+            "qualquer_angulo"_a   = false,
+            "em_dois_niveis"_a    = false,
+            "obstaculos_em_movimento"_a = false,
+            "usar_cache"_a        = false
+        )
+        .def(
+            "find_optimal_path_into",
+            &planejar_com_contexto_no_buffer,
+            R"pbdoc(
+            Same as a_estrela.find_optimal_path_into, but uses this planner's context.
+            The GIL is released during the search.
+            )pbdoc",
+            "parametros"_a,
+            "saida"_a.noconvert(),
+            "pontos_de_salto"_a   = false,
+            "em_qualquer_tempo"_a = false,
+            "qualquer_angulo"_a   = false,
+            "em_dois_niveis"_a    = false,
+            "obstaculos_em_movimento"_a = false,
+            "usar_cache"_a        = false
+        )
+        .def_readonly(
+            "last_suboptimality",
+            &ContextoDePlanejamento::fator_de_suboptimalidade,
+            "Suboptimality bound of the last search, see a_estrela.last_suboptimality."
+        )
+        .def_readonly(
+            "last_expansions",
+            &ContextoDePlanejamento::expansoes_na_ultima_busca,
+            "Nodes expanded by the last search."
+        )
+        .def(
+            "get_stats",
+            &estatisticas_do_contexto,
+            "Same as a_estrela.get_stats, for the searches made with this planner."
+        )
+        .def(
+            "reset_stats",
+            &zerar_estatisticas_do_contexto,
+            "Zeroes the sums returned by get_stats()."
+        )
+        .def(
+            "clear_cache",
+            &limpar_cache_do_contexto,
+            "Forgets every path cached by usar_cache in this planner."
+        );
+
+    py::class_<ReplanejadorIncremental>(
+        m,
+        "IncrementalPathPlanner",
+        R"pbdoc(
+        Persistent planner for queries repeated every cycle (D* Lite).
+
+        It keeps the cost grid and the search tree between calls. Each call
+        diffs the obstacle list against the previous one, restamps only the
+        region of the obstacles that changed, and repairs the affected part of
+        the search. The start may move freely. Changing allow_out_of_bounds,
+        go_to_goal or the target cell restarts the search from scratch.
+
+        Unreachable targets, timeouts and repairs more expensive than a fresh
+        search are answered by the regular A*, so the output format and status
+        codes are the same as find_optimal_path.
+
+        Use one planner per recurring query (e.g. dribbling). The same object
+        must not be used by two threads at once.
+        )pbdoc"
+    )
+        .def(
+            py::init<>()
+        )
+        .def(
+            "find_optimal_path",
+            &planejar_com_replanejador,
+            R"pbdoc(
+            Same parameters and return value as a_estrela.find_optimal_path.
+            The GIL is released during the search.
+            )pbdoc",
+            "parametros"_a
+        )
+        .def(
+            "find_optimal_path_into",
+            &planejar_com_replanejador_no_buffer,
+            R"pbdoc(
+            Same as a_estrela.find_optimal_path_into, using this incremental planner.
+            The GIL is released during the search.
+            )pbdoc",
+            "parametros"_a,
+            "saida"_a.noconvert()
+        )
+        .def(
+            "reset",
+            &ReplanejadorIncremental::reiniciar,
+            "Forget the previous search, the next call plans from scratch."
+        )
+        .def_readonly(
+            "last_expansions",
+            &ReplanejadorIncremental::expansoes_na_ultima_chamada,
+            "Nodes expanded by the last call (0 when nothing had to be repaired)."
+        )
+        .def_readonly(
+            "last_changed_cells",
+            &ReplanejadorIncremental::celulas_alteradas_na_ultima_chamada,
+            "Grid cells whose cost changed since the previous call."
+        )
+        .def_readonly(
+            "last_was_incremental",
+            &ReplanejadorIncremental::ultima_chamada_foi_incremental,
+            "Whether the last call repaired the previous search instead of starting over."
+        );
+
+    py::class_<CampoAteOAlvo>(
+        m,
+        "CostToGoField",
+        R"pbdoc(
+        Cost-to-go from every grid cell to one target (reverse Dijkstra).
+
+        Agents that plan to the same target with the same obstacles, e.g. the
+        opponent goal, can share one field per cycle: compute() once, then each
+        agent gets its path with path_from() in O(path length), without a search.
+
+        The field covers the whole grid, not only the window the regular search
+        uses, so its cost is never higher than find_optimal_path's. The same
+        object must not be computed by two threads at once.
+        )pbdoc"
+    )
+        .def(
+            py::init<>()
+        )
+        .def(
+            "compute",
+            &calcular_campo,
+            R"pbdoc(
+            Builds the grid and the field. Same parameters as a_estrela.find_optimal_path;
+            start and timeout are ignored. The GIL is released while it runs.
+            )pbdoc",
+            "parametros"_a
+        )
+        .def(
+            "path_from",
+            &caminho_pelo_campo,
+            R"pbdoc(
+            Path from (start_x, start_y) to the target, same format as find_optimal_path:
+            [x1, y1, ..., xn, yn, status, cost]. Status 3 if the direct path is free,
+            0 if the path follows the field, 2 if the start cannot reach the target
+            (only the start is returned, fall back to find_optimal_path).
+            )pbdoc",
+            "start_x"_a,
+            "start_y"_a
+        )
+        .def_property_readonly(
+            "field",
+            &vista_do_campo,
+            R"pbdoc(
+            Read-only float32 view (321 x 221) of the cost-to-go, no copy. Row is
+            10 * x + 160 and column is 10 * y + 110. Same units as the path cost,
+            inf where the target is unreachable. Always shows the last compute().
+            )pbdoc"
+        )
+        .def_readonly(
+            "computed",
+            &CampoAteOAlvo::calculado,
+            "Whether compute() was called at least once."
+        )
+        .def_readonly(
+            "last_expansions",
+            &CampoAteOAlvo::expansoes_no_ultimo_calculo,
+            "Cells settled by the last compute()."
+        );
 }
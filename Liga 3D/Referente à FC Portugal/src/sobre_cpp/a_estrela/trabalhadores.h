@@ -0,0 +1,201 @@
+/*
+Grupo de trabalhadores usado pelas consultas em lote.
+
+Criar threads a cada chamada custaria mais que as próprias buscas curtas,
+logo as threads nascem uma única vez e ficam dormindo esperando o próximo
+lote. Cada uma mantém o seu contexto_da_thread(), então os buffers do A*
+também são alocados uma única vez por thread.
+
+As tarefas de um lote são apenas índices 0 .. n - 1, distribuídos por um
+contador atômico. Quem chamou executar() também trabalha, em vez de ficar
+parado esperando.
+*/
+
+#ifndef TRABALHADORES_H
+#define TRABALHADORES_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+class GrupoDeTrabalhadores {
+public:
+
+	explicit GrupoDeTrabalhadores(
+		int quantidade_de_threads
+	) :
+		tarefa                ( nullptr ),
+		quantidade_de_tarefas ( 0 ),
+		proxima_tarefa        ( 0 ),
+		participantes         ( 0 ),
+		trabalhadores_ativos  ( 0 ),
+		geracao               ( 0 ),
+		encerrar              ( false )
+	{
+		for(
+			int i = 0;
+			i < quantidade_de_threads;
+			i++
+		){
+			threads.emplace_back( &GrupoDeTrabalhadores::laco_do_trabalhador, this, i );
+		}
+	}
+
+	~GrupoDeTrabalhadores(){
+		{
+			std::lock_guard<std::mutex> trava( mutex_do_lote );
+			encerrar = true;
+		}
+		ha_trabalho.notify_all();
+
+		for(
+			int i = 0;
+			i < (int) threads.size();
+			i++
+		){
+			threads[i].join();
+		}
+	}
+
+	GrupoDeTrabalhadores( const GrupoDeTrabalhadores& ) = delete;
+	GrupoDeTrabalhadores& operator=( const GrupoDeTrabalhadores& ) = delete;
+
+	inline int tamanho() const { return (int) threads.size(); }
+
+	void
+	executar(
+		int quantidade,
+		const std::function<void(int)>& funcao,
+		int quantidade_de_threads
+	){
+		/*
+		Descrição:
+			Executa funcao(i) para todo i em [0, quantidade) e só retorna
+			quando todos terminarem.
+
+		Parâmetros:
+			quantidade            -> número de tarefas do lote
+			funcao                -> o que fazer com cada índice
+			quantidade_de_threads -> total de threads a usar, contando quem
+			                         chamou. Valores <= 0 usam todas.
+		*/
+
+		// Um lote por vez. Dois chamadores simultâneos apenas esperam a vez.
+		std::lock_guard<std::mutex> um_lote_por_vez( mutex_de_entrada );
+
+		int ajudantes = quantidade_de_threads <= 0 ? tamanho() : quantidade_de_threads - 1;
+		ajudantes = ajudantes < tamanho()      ? ajudantes : tamanho();
+		ajudantes = ajudantes < quantidade - 1 ? ajudantes : quantidade - 1;
+
+		if(
+			ajudantes <= 0
+		){
+			for(
+				int i = 0;
+				i < quantidade;
+				i++
+			){
+				funcao( i );
+			}
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> trava( mutex_do_lote );
+
+			tarefa                = &funcao;
+			quantidade_de_tarefas = quantidade;
+			participantes         = ajudantes;
+			trabalhadores_ativos  = ajudantes;
+			proxima_tarefa.store( 0 );
+			geracao++;
+		}
+		ha_trabalho.notify_all();
+
+		consumir_tarefas();
+
+		std::unique_lock<std::mutex> trava( mutex_do_lote );
+		lote_terminado.wait( trava, [this]{ return trabalhadores_ativos == 0; } );
+
+		tarefa = nullptr;
+	}
+
+private:
+
+	inline void
+	consumir_tarefas(){
+
+		while(
+			true
+		){
+			const int i = proxima_tarefa.fetch_add( 1 );
+
+			if(
+				i >= quantidade_de_tarefas
+			){
+				return;
+			}
+
+			(*tarefa)( i );
+		}
+	}
+
+	void
+	laco_do_trabalhador(
+		int indice
+	){
+		unsigned int ultima_geracao = 0;
+
+		while(
+			true
+		){
+			{
+				std::unique_lock<std::mutex> trava( mutex_do_lote );
+				ha_trabalho.wait( trava, [&]{ return encerrar || geracao != ultima_geracao; } );
+
+				if(
+					encerrar
+				){
+					return;
+				}
+
+				ultima_geracao = geracao;
+
+				if(
+					// Este lote pediu menos threads, ficamos de fora.
+					indice >= participantes
+				){
+					continue;
+				}
+			}
+
+			consumir_tarefas();
+
+			{
+				std::lock_guard<std::mutex> trava( mutex_do_lote );
+				trabalhadores_ativos--;
+			}
+			lote_terminado.notify_one();
+		}
+	}
+
+	std::vector<std::thread> threads;
+
+	std::mutex              mutex_de_entrada;
+	std::mutex              mutex_do_lote;
+	std::condition_variable ha_trabalho;
+	std::condition_variable lote_terminado;
+
+	const std::function<void(int)>* tarefa;
+	int                             quantidade_de_tarefas;
+	std::atomic<int>                proxima_tarefa;
+	int                             participantes;
+	int                             trabalhadores_ativos;
+	unsigned int                    geracao;
+	bool                            encerrar;
+};
+
+#endif // TRABALHADORES_H
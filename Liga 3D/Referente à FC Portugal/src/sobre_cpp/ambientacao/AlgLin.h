@@ -785,6 +785,167 @@ public:
 
 };
 
+class Covariancia3D {
+    /*
+    Descrição:
+        Acumula a covariância 3x3 de um conjunto de pontos, com pesos opcionais, e obtém em forma
+        fechada o autovetor do menor autovalor. É o que basta para ajustar um plano por mínimos
+        quadrados (a normal do plano é esse autovetor), sem montar a matriz Nx3 dos pontos nem
+        chamar uma SVD.
+
+    Métodos principais:
+        - acumular(Vetor3D, peso = 1):
+            Soma um ponto. Peso w equivale a repetir o ponto w vezes.
+
+        - obter_centroide():
+            Média ponderada dos pontos acumulados.
+
+        - obter_menor_autovetor(double[3]):
+            Autovetor unitário do menor autovalor da covariância. O sentido é arbitrário.
+
+    Observações:
+        - Tudo é feito em double. O menor autovalor sai de uma subtração entre números da ordem
+          do maior, então em float a normal perderia precisão justamente nos planos bem definidos.
+        - As somas são feitas em torno do primeiro ponto, o que evita o cancelamento de
+          somar quadrados de coordenadas grandes para depois subtrair o centróide.
+    */
+public:
+
+    Covariancia3D() : soma_dos_pesos(0), referencia{0, 0, 0}, soma{0, 0, 0}, soma_dos_produtos{0, 0, 0, 0, 0, 0} {}
+
+    void
+    acumular( const Vetor3D& ponto, double peso = 1 ){
+
+        if(
+            soma_dos_pesos == 0
+        ){
+
+            referencia[0] = ponto.x; referencia[1] = ponto.y; referencia[2] = ponto.z;
+        }
+
+        const double d[3] = { ponto.x - referencia[0], ponto.y - referencia[1], ponto.z - referencia[2] };
+
+        soma_dos_pesos += peso;
+        for(int i = 0; i < 3; i++){ soma[i] += peso * d[i]; }
+
+        // xx, xy, xz, yy, yz, zz
+        soma_dos_produtos[0] += peso * d[0] * d[0];
+        soma_dos_produtos[1] += peso * d[0] * d[1];
+        soma_dos_produtos[2] += peso * d[0] * d[2];
+        soma_dos_produtos[3] += peso * d[1] * d[1];
+        soma_dos_produtos[4] += peso * d[1] * d[2];
+        soma_dos_produtos[5] += peso * d[2] * d[2];
+    }
+
+    Vetor3D
+    obter_centroide() const {
+
+        return Vetor3D(
+                       referencia[0] + soma[0] / soma_dos_pesos,
+                       referencia[1] + soma[1] / soma_dos_pesos,
+                       referencia[2] + soma[2] / soma_dos_pesos
+                      );
+    }
+
+    void
+    obter_menor_autovetor( double autovetor[3] ) const {
+        /*
+        Descrição:
+            Autovalores pela fórmula trigonométrica para matrizes simétricas 3x3 (Smith, 1961) e,
+            com o menor deles (l), o autovetor como o maior produto vetorial entre duas linhas de
+            A - l*I: as linhas são ortogonais ao autovetor, logo o produto vetorial é paralelo a ele.
+
+            Se o menor autovalor for duplo (pontos colineares), qualquer vetor ortogonal à linha
+            não nula de A - l*I serve, como também seria com a SVD.
+        */
+
+        // Covariância centrada, E[dd^T] - E[d]E[d]^T
+        const double m[3] = { soma[0] / soma_dos_pesos, soma[1] / soma_dos_pesos, soma[2] / soma_dos_pesos };
+        const double A[3][3] = {
+            { soma_dos_produtos[0] / soma_dos_pesos - m[0] * m[0], soma_dos_produtos[1] / soma_dos_pesos - m[0] * m[1], soma_dos_produtos[2] / soma_dos_pesos - m[0] * m[2] },
+            { soma_dos_produtos[1] / soma_dos_pesos - m[0] * m[1], soma_dos_produtos[3] / soma_dos_pesos - m[1] * m[1], soma_dos_produtos[4] / soma_dos_pesos - m[1] * m[2] },
+            { soma_dos_produtos[2] / soma_dos_pesos - m[0] * m[2], soma_dos_produtos[4] / soma_dos_pesos - m[1] * m[2], soma_dos_produtos[5] / soma_dos_pesos - m[2] * m[2] }
+        };
+
+        autovetor[0] = 0; autovetor[1] = 0; autovetor[2] = 1;
+
+        const double fora_da_diagonal = A[0][1] * A[0][1] + A[0][2] * A[0][2] + A[1][2] * A[1][2];
+        const double q  = ( A[0][0] + A[1][1] + A[2][2] ) / 3;
+        const double p2 = (A[0][0] - q) * (A[0][0] - q) + (A[1][1] - q) * (A[1][1] - q) + (A[2][2] - q) * (A[2][2] - q) + 2 * fora_da_diagonal;
+
+        // Múltiplo da identidade: qualquer vetor é autovetor
+        if( p2 <= 0 ){ return; }
+
+        const double p = sqrt( p2 / 6 );
+
+        // B = (A - q*I) / p, r = det(B) / 2
+        double B[3][3];
+        for(int i = 0; i < 3; i++){ for(int j = 0; j < 3; j++){ B[i][j] = ( A[i][j] - (i == j ? q : 0) ) / p; } }
+
+        double r = ( B[0][0] * (B[1][1] * B[2][2] - B[1][2] * B[2][1])
+                   - B[0][1] * (B[1][0] * B[2][2] - B[1][2] * B[2][0])
+                   + B[0][2] * (B[1][0] * B[2][1] - B[1][1] * B[2][0]) ) / 2;
+        r = max( -1.0, min( 1.0, r ) );
+
+        const double menor_autovalor = q + 2 * p * cos( acos(r) / 3 + 2 * M_PI / 3 );
+
+        double M[3][3];
+        for(int i = 0; i < 3; i++){ for(int j = 0; j < 3; j++){ M[i][j] = A[i][j] - (i == j ? menor_autovalor : 0); } }
+
+        // Maior produto vetorial entre pares de linhas
+        const int pares[3][2] = { {0, 1}, {0, 2}, {1, 2} };
+        double melhor[3] = {0, 0, 0}, melhor_norma2 = 0;
+        for(
+            int k = 0;
+                k < 3;
+                k++
+        ){
+
+            const double* u = M[ pares[k][0] ];
+            const double* v = M[ pares[k][1] ];
+            const double c[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+            const double norma2 = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+
+            if( norma2 > melhor_norma2 ){ melhor_norma2 = norma2; melhor[0] = c[0]; melhor[1] = c[1]; melhor[2] = c[2]; }
+        }
+
+        if(
+            melhor_norma2 <= 1e-20 * p2 * p2
+        ){
+
+            // Autovalor duplo: vetor ortogonal à maior linha de M
+            int maior_linha = 0;
+            double maior_norma2 = 0;
+            for(int i = 0; i < 3; i++){
+                const double norma2 = M[i][0] * M[i][0] + M[i][1] * M[i][1] + M[i][2] * M[i][2];
+                if( norma2 > maior_norma2 ){ maior_norma2 = norma2; maior_linha = i; }
+            }
+
+            const double* u = M[maior_linha];
+
+            // Eixo menos alinhado com u
+            int eixo = 0;
+            for(int i = 1; i < 3; i++){ if( fabs(u[i]) < fabs(u[eixo]) ){ eixo = i; } }
+            const double e[3] = { (double) (eixo == 0), (double) (eixo == 1), (double) (eixo == 2) };
+
+            melhor[0] = u[1] * e[2] - u[2] * e[1];
+            melhor[1] = u[2] * e[0] - u[0] * e[2];
+            melhor[2] = u[0] * e[1] - u[1] * e[0];
+            melhor_norma2 = melhor[0] * melhor[0] + melhor[1] * melhor[1] + melhor[2] * melhor[2];
+        }
+
+        const double norma = sqrt( melhor_norma2 );
+        for(int i = 0; i < 3; i++){ autovetor[i] = melhor[i] / norma; }
+    }
+
+private:
+
+    double soma_dos_pesos;
+    double referencia[3];
+    double soma[3];
+    double soma_dos_produtos[6];
+};
+
 class Linha6D  {
     /*
     Descrição:
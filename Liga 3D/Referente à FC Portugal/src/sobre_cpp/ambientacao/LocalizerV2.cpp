@@ -1,6 +1,5 @@
 #include "LocalizerV2.h"
 #include <cstdio>
-static World& mundo_existente = Singular<World>::obter_instancia();
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -24,7 +23,7 @@ LocalizerV2::estimar_erro_posicional(
 	  Retorno:
 	    - 1 se o erro foi computado e acumulado; 0 caso contrário.
 	*/
-    if (mundo_existente.pos_abs_agente_cartesiana_cheat == Vetor3D(0,0,0) ) { return 0; }
+    if (mundo.pos_abs_agente_cartesiana_cheat == Vetor3D(0,0,0) ) { return 0; }
 
     double erro_x  = posicao_estimativa.x - posicao_real.x;
     double erro_y  = posicao_estimativa.y - posicao_real.y;
@@ -76,12 +75,12 @@ LocalizerV2::fine_tune(
         - false — se falhou em alguma etapa do processo.
     */
 
-    RobovizField& campo_existente = Singular<RobovizField>::obter_instancia();
+    RobovizField& campo_existente = campo;
 
     // Estatísticas antes do ajuste fino
     counter_fineTune += estimar_erro_posicional(
                                                 Vetor3D(initial_x, initial_y, _Head_to_Field_Prelim.obter(11)),
-                                                mundo_existente.pos_abs_agente_cartesiana_cheat,
+                                                mundo.pos_abs_agente_cartesiana_cheat,
                                                 errorSum_fineTune_before
                                                 );
 
@@ -91,7 +90,7 @@ LocalizerV2::fine_tune(
     // Estatísticas para o primeiro ajuste fino
     estimar_erro_posicional(
                             Vetor3D(initial_x, initial_y, _Head_to_Field_Prelim.obter(11)),
-                            mundo_existente.pos_abs_agente_cartesiana_cheat,
+                            mundo.pos_abs_agente_cartesiana_cheat,
                             errorSum_fineTune_euclidianDist
                             );
 
@@ -104,7 +103,7 @@ LocalizerV2::fine_tune(
     // Estatísticas para o segundo ajuste fino
     estimar_erro_posicional(
                            _Head_to_Field_Prelim.obter_vetor_de_translacao(),
-                           mundo_existente.pos_abs_agente_cartesiana_cheat,
+                           mundo.pos_abs_agente_cartesiana_cheat,
                            errorSum_fineTune_probabilistic
                            );
 
@@ -136,7 +135,7 @@ LocalizerV2::run(){
         Resultado da localização é armazenado em variáveis da classe e do ambiente.
     */
 
-    RobovizField& campo_existente = Singular<RobovizField>::obter_instancia();
+    RobovizField& campo_existente = campo;
 
     atualizar_estado_do_sistema(RUNNING);
 
@@ -145,6 +144,7 @@ LocalizerV2::run(){
     _is_uptodate = false;
     _is_head_z_uptodate = false;
     _steps_since_last_update++;
+    _avaliacoes_de_custo = 0;
 
     // reseta a matriz de transformação preliminar
     resetar_matriz_preliminar(); 
@@ -175,12 +175,12 @@ LocalizerV2::run(){
 
     // Estatísticas da posição da bola
     if(
-        mundo_existente.bola_detectada
+        mundo.bola_detectada
     ){
         // counter_ball é definido no header
         counter_ball += estimar_erro_posicional(
-                                                _Head_to_Field_Prelim * mundo_existente.pos_rel_bola_cartesiana,
-                                                mundo_existente.pos_abs_bola_cartesiana_cheat,
+                                                _Head_to_Field_Prelim * mundo.pos_rel_bola_cartesiana,
+                                                mundo.pos_abs_bola_cartesiana_cheat,
                                                 errorSum_ball
                                                 );
     }
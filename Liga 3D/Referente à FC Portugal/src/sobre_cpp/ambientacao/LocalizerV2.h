@@ -19,7 +19,6 @@ headTofieldRotate e sua inversa
 #ifndef LOCALIZERV2_H
 #define LOCALIZERV2_H
 
-#include "Singular.h"
 #include "Ruido_de_Campo.h"
 #include "RobovizField.h"
 #include <cstdio>
@@ -33,13 +32,6 @@ e os valores previstos.
 */
 #include <gsl/gsl_multifit.h>  
 
-/*
-Implementa algoritmos de álgebra linear, como decomposição em valores singulares (SVD),
-fatorações LU e QR, resolução de sistemas lineares e cálculo de determinantes. Essencial para
-operações robustas com matrizes.
-*/
-#include <gsl/gsl_linalg.h>   
-
 /*
 Disponibiliza algoritmos para minimização de funções multivariadas, com ou sem derivadas.
 É útil para encontrar o ponto de mínimo (ótimo) de funções complexas em espaços de múltiplas variáveis.
@@ -134,46 +126,59 @@ class LocalizerV2 {
 	      significa que não houve dados visuais suficientes ou válidos para uma nova estimativa.
 
 	    - A classe mantém um histórico das últimas 10 posições para cálculo de velocidade.
-	*/
-	friend class Singular<LocalizerV2>;
 
-private:
+	    - Cada agente deve ter o seu LocalizerV2, que é dono do seu World e do seu RobovizField.
+	      Localizadores diferentes podem rodar ao mesmo tempo em threads diferentes; o mesmo
+	      localizador, não.
+	*/
+public:
 
-	LocalizerV2() {}
+	/*
+	Entradas do ciclo, preenchidas pelo chamador antes de run(), e os marcadores e linhas
+	interpretados a partir delas. O campo guarda uma referência ao mundo, que por isso vem antes.
+	*/
+	World        mundo;
+	RobovizField campo;
 
-	template<std::size_t TAMANHO> static gsl_vector* 
-	criar_vetor_gsl(
-		const array<double, TAMANHO> &conteudo
-	){
+	LocalizerV2() : campo(mundo) {
 		/*
 		Descrição:
-		    Cria e inicializa um vetor GSL (`gsl_vector`) a partir de um `array` de valores do tipo `double`.
-		    A função é útil para converter dados estáticos ou computados previamente em estruturas compatíveis com
-		    algoritmos da biblioteca GSL.
+			Cria os espaços de trabalho dos simplex do GSL uma única vez, para que os ciclos
+			de localização não precisem alocar nada.
+		*/
 
-		Parâmetros:
-		- conteudo:
-		    array padrão da STL contendo os valores a serem copiados para o vetor GSL.
-		    O tamanho do vetor é definido pelo tamanho do array passado como argumento.
+		_simplex_ajuste_fino = gsl_multimin_fminimizer_alloc(gsl_multimin_fminimizer_nmsimplex2, 3);
 
-		Retorno:
-		    Retorna um ponteiro para um vetor GSL alocado dinamicamente (`gsl_vector*`) contendo os dados copiados.
-		    É responsabilidade do usuário liberar a memória posteriormente com `gsl_vector_free()`.
-		*/
+		for(
+			int i = 0;
+				i < 4;
+				i++
+		){
 
-	    gsl_vector* vetor_gsl = gsl_vector_alloc(TAMANHO);
-	    
-	    for(
-	    	size_t i = 0; 
-	    		i < TAMANHO; 
-	    		i++
-	    ){
-	        gsl_vector_set(vetor_gsl, i, conteudo[i]);
-	    }
+			_simplex_hipoteses_xy[i] = gsl_multimin_fminimizer_alloc(gsl_multimin_fminimizer_nmsimplex2, 2);
+		}
+	}
+
+	~LocalizerV2(){
 
-	    return vetor_gsl;
+		gsl_multimin_fminimizer_free(_simplex_ajuste_fino);
+
+		for(
+			int i = 0;
+				i < 4;
+				i++
+		){
+
+			gsl_multimin_fminimizer_free(_simplex_hipoteses_xy[i]);
+		}
 	}
 
+	// Os espaços de trabalho são exclusivos de cada instância
+	LocalizerV2(const LocalizerV2&) = delete;
+	LocalizerV2& operator=(const LocalizerV2&) = delete;
+
+private:
+
 	static Vetor2D
 	obter_vetor_unitario_perpendicular_ao_chao( const Vetor3D& vec ) {
 		/*
@@ -308,6 +313,44 @@ private:
 	    vetor_y = normal_solo.CrossProduct(vetor_x); 
 	}
 
+	static void
+	calcular_derivada_dos_eixos_XY(
+		const Vetor3D& normal_solo,
+		float angulo_em_torno_de_z,
+		Vetor3D& derivada_x,
+		Vetor3D& derivada_y
+	){
+		/*
+		Descrição:
+		    Derivada, em relação ao ângulo, dos vetores calculados por calcular_eixos_XY_a_partir_de_Z().
+		    É a mesma conta, trocando cos(angulo_x) por -sen(angulo_x) e sen(angulo_x) por cos(angulo_x),
+		    com o sinal invertido pois angulo_x = -angulo_em_torno_de_z. Como Z não depende do ângulo,
+		    a derivada de Y = Z x X é simplesmente Z x dX.
+
+		Parâmetros:
+		    - Mesmos de calcular_eixos_XY_a_partir_de_Z().
+
+		Retorno:
+		    Os vetores derivada_x e derivada_y são modificados por referência.
+		*/
+
+	    Vetor2D vetor_base_chao = obter_vetor_unitario_perpendicular_ao_chao(normal_solo);
+
+	    const float& cosseno_z = normal_solo.z;
+	    const float  seno_z    = sqrtf(1 - cosseno_z * cosseno_z);
+	    const float  produto_xy_base = vetor_base_chao.x * vetor_base_chao.y;
+	    const float  angulo_x  = -angulo_em_torno_de_z;
+	    const float  cosseno_x = cosf(angulo_x);
+	    const float  seno_x    = sinf(angulo_x);
+	    const float  inverso_cosseno_z = 1 - cosseno_z;
+
+	    derivada_x.x = cosseno_z * seno_x    + inverso_cosseno_z * (vetor_base_chao.x * vetor_base_chao.x * seno_x    - produto_xy_base * cosseno_x);
+	    derivada_x.y = -cosseno_z * cosseno_x - inverso_cosseno_z * (vetor_base_chao.y * vetor_base_chao.y * cosseno_x - produto_xy_base * seno_x);
+	    derivada_x.z = -seno_z * (vetor_base_chao.x * cosseno_x + vetor_base_chao.y * seno_x);
+
+	    derivada_y = normal_solo.CrossProduct(derivada_x);
+	}
+
 	Matriz4D _Head_to_Field_Prelim = Matriz4D();
 
 	void 
@@ -348,9 +391,234 @@ private:
     bool  _is_uptodate = false;
     bool  _is_head_z_uptodate = false;
     unsigned int _steps_since_last_update = 0;
+    unsigned int _avaliacoes_de_custo = 0; // avaliações das funções de custo no último run()
+    unsigned int _retornos_ao_simplex = 0; // vezes em que o Levenberg-Marquardt falhou e o simplex foi usado
+
+    /*
+    Espaços de trabalho dos simplex, criados no construtor e reaproveitados a cada ciclo.
+    */
+    gsl_multimin_fminimizer *_simplex_ajuste_fino     = nullptr; // x, y e ângulo
+    gsl_multimin_fminimizer *_simplex_hipoteses_xy[4] = {nullptr, nullptr, nullptr, nullptr}; // x e y, um por hipótese
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+	/*
+	Os ajustes de pose minimizam funções de 3 variáveis (x, y e o ângulo de Xvec em torno de Zvec), ou apenas
+	de 2 quando o ângulo está fixo. Com tão poucas variáveis, o Levenberg-Marquardt não precisa guardar os
+	resíduos nem o jacobiano: basta acumular J^T*J (3x3), J^T*r e a soma dos quadrados enquanto o custo é
+	avaliado, e resolver o sistema 3x3 em forma fechada.
+	*/
+	struct SistemaNormal {
+
+		// Derivadas de Xvec e Yvec em relação ao ângulo, na pose que está sendo avaliada
+		Vetor3D derivada_x, derivada_y;
+
+		double JtJ[3][3];
+		double Jtr[3];
+		double soma_dos_quadrados;
+		int    quantidade_de_residuos;
+
+		void
+		zerar(){
+
+			for(int i = 0; i < 3; i++){
+				for(int j = 0; j < 3; j++){ JtJ[i][j] = 0; }
+				Jtr[i] = 0;
+			}
+
+			soma_dos_quadrados     = 0;
+			quantidade_de_residuos = 0;
+		}
+
+		void
+		acumular( double residuo, double j0, double j1, double j2 ){
+
+			const double J[3] = {j0, j1, j2};
+
+			for(int i = 0; i < 3; i++){
+				for(int j = 0; j < 3; j++){ JtJ[i][j] += J[i] * J[j]; }
+				Jtr[i] += J[i] * residuo;
+			}
+
+			soma_dos_quadrados += residuo * residuo;
+			quantidade_de_residuos++;
+		}
+	};
+
+	static void
+	posicionar_preliminar(
+		Matriz4D& transfMat,
+		float x,
+		float y,
+		float angle,
+		SistemaNormal* sistema
+	){
+		/*
+		Descrição:
+			Escreve as linhas 0 e 1 de transfMat a partir da pose (x, y, ângulo), mantendo Zvec e a altura.
+			É o trecho comum a todas as funções de custo, que testam as poses diretamente em _Head_to_Field_Prelim.
+
+		Parâmetros:
+			- transfMat: matriz preliminar, cuja linha 2 (Zvec) já foi calculada.
+			- x, y, angle: pose a ser escrita.
+			- sistema: se não for nulo, é zerado e recebe as derivadas dos eixos nesta pose.
+
+		Retorno:
+			Nada além da modificação de transfMat e de sistema.
+		*/
+
+	    Vetor3D Zvec(transfMat.obter(2,0), transfMat.obter(2,1), transfMat.obter(2,2));
+
+	    Vetor3D Xvec, Yvec;
+	    calcular_eixos_XY_a_partir_de_Z(Zvec, angle, Xvec, Yvec );
+
+	    // Estes são os coeficientes de transformação que estão sendo otimizados
+	    transfMat.setar(0,0,Xvec.x);
+	    transfMat.setar(0,1,Xvec.y);
+	    transfMat.setar(0,2,Xvec.z);
+	    transfMat.setar(0,3,x);
+	    transfMat.setar(1,0,Yvec.x);
+	    transfMat.setar(1,1,Yvec.y);
+	    transfMat.setar(1,2,Yvec.z);
+	    transfMat.setar(1,3,y);
+
+	    if(
+	    	sistema
+	    ){
+
+	    	sistema->zerar();
+	    	calcular_derivada_dos_eixos_XY(Zvec, angle, sistema->derivada_x, sistema->derivada_y);
+	    }
+	}
+
+	static void
+	acumular_residuos_esfericos(
+		const Vetor3D& pos_rel,
+		const Vetor3D  derivadas[3],
+		const Vetor3D& pos_rel_esf_vista,
+		SistemaNormal& sistema
+	){
+		/*
+		Descrição:
+			Versão em mínimos quadrados dos termos log_prob_r/h/v de Ruido_de_Campo: cada componente
+			esférica vira um resíduo normalizado pelo desvio padrão do ruído (o intervalo de 0.005 é
+			desprezado), de modo que a soma dos quadrados é, a menos de constantes, o -log da probabilidade.
+
+		Parâmetros:
+			- pos_rel: ponto previsto no referencial do agente (cartesiano).
+			- derivadas: derivadas de pos_rel em relação a x, y e ao ângulo.
+			- pos_rel_esf_vista: o que a visão mediu (distância, horizontal e vertical em graus).
+			- sistema: onde os resíduos são acumulados.
+
+		Retorno:
+			Nenhum.
+		*/
+
+		const double graus = 180 / M_PI;
+
+		const double x = pos_rel.x, y = pos_rel.y, z = pos_rel.z;
+		const double quadrado_xy = x*x + y*y;
+		const double quadrado    = quadrado_xy + z*z;
+
+		// Em cima do agente as direções não são definidas, mas isso nunca é visto
+		if( quadrado_xy < 1e-12 ){ return; }
+
+		const double modulo_xy = sqrt(quadrado_xy);
+		const double modulo    = sqrt(quadrado);
+		const Vetor3D esf      = pos_rel.to_esfe();
+
+		// Desvios padrões em Ruido_de_Campo::log_prob_r/h/v (a distância é em porcentagem)
+		const double dp_r = 0.0965, dp_h = 0.1225, dp_v = 0.1480;
+
+		double diferenca_h = pos_rel_esf_vista.y - esf.y;
+		if     ( diferenca_h >  180 ){ diferenca_h -= 360; }
+		else if( diferenca_h < -180 ){ diferenca_h += 360; }
+
+		const double residuo_r = 100 * ( pos_rel_esf_vista.x / esf.x - 1 ) / dp_r;
+		const double residuo_h = diferenca_h / dp_h;
+		const double residuo_v = ( pos_rel_esf_vista.z - esf.z ) / dp_v;
+
+		// Gradientes dos resíduos em relação a pos_rel
+		const double k_r = -100 * pos_rel_esf_vista.x / ( dp_r * quadrado * modulo );
+		const Vetor3D gradiente_r( k_r * x, k_r * y, k_r * z );
+
+		const double k_h = -graus / ( dp_h * quadrado_xy );
+		const Vetor3D gradiente_h( -k_h * y, k_h * x, 0 );
+
+		const double k_v = -graus / ( dp_v * quadrado );
+		const Vetor3D gradiente_v( -k_v * x * z / modulo_xy, -k_v * y * z / modulo_xy, k_v * modulo_xy );
+
+		sistema.acumular( residuo_r, gradiente_r.InnerProduct(derivadas[0]), gradiente_r.InnerProduct(derivadas[1]), gradiente_r.InnerProduct(derivadas[2]) );
+		sistema.acumular( residuo_h, gradiente_h.InnerProduct(derivadas[0]), gradiente_h.InnerProduct(derivadas[1]), gradiente_h.InnerProduct(derivadas[2]) );
+		sistema.acumular( residuo_v, gradiente_v.InnerProduct(derivadas[0]), gradiente_v.InnerProduct(derivadas[1]), gradiente_v.InnerProduct(derivadas[2]) );
+	}
+
+	static void
+	acumular_distancia_ao_segmento(
+		const RobovizField::sSegmento& segm,
+		const Vetor3D& ponto_rel,
+		const Vetor3D& ponto_abs,
+		double peso,
+		SistemaNormal& sistema
+	){
+		/*
+		Descrição:
+			Resíduo de RobovizField::calcular_dist_segm_para_pt2D_c() e seu gradiente. No interior do segmento
+			o resíduo é a distância com sinal até a reta (suave dos dois lados); fora dele, a distância ao extremo.
+
+		Parâmetros:
+			- segm: segmento de campo casado com o ponto.
+			- ponto_rel: ponto visto, no referencial do agente.
+			- ponto_abs: o mesmo ponto levado ao campo pela pose atual.
+			- peso: multiplica resíduo e gradiente.
+			- sistema: onde o resíduo é acumulado.
+
+		Retorno:
+			Nenhum.
+		*/
+
+		const Vetor2D inicio( segm.pt[0]->svet.x, segm.pt[0]->svet.y );
+		const Vetor2D final ( segm.pt[1]->svet.x, segm.pt[1]->svet.y );
+
+		Vetor2D direcao( final - inicio );
+		Vetor2D w1( ponto_abs.to_2d() - inicio );
+		Vetor2D w2( ponto_abs.to_2d() - final  );
+
+		double residuo, gx, gy;
+
+		if(
+			w1.InnerProduct(direcao) <= 0 || w2.InnerProduct(direcao) >= 0
+		){
+
+			Vetor2D w = w1.InnerProduct(direcao) <= 0 ? w1 : w2;
+			residuo = w.obter_modulo();
+
+			// Exatamente no extremo, qualquer direção serve e o resíduo é nulo
+			if( residuo < 1e-9 ){ gx = gy = 0; }
+			else                { gx = w.x / residuo; gy = w.y / residuo; }
+		}else{
+
+			residuo = direcao.CrossProduct(w1) / segm.comprimento;
+			gx = -direcao.y / segm.comprimento;
+			gy =  direcao.x / segm.comprimento;
+		}
+
+		// ponto_abs = (Xvec . ponto_rel + x, Yvec . ponto_rel + y)
+		const double dx_dangulo = sistema.derivada_x.InnerProduct(ponto_rel);
+		const double dy_dangulo = sistema.derivada_y.InnerProduct(ponto_rel);
+
+		sistema.acumular( peso * residuo, peso * gx, peso * gy, peso * (gx * dx_dangulo + gy * dy_dangulo) );
+	}
+
+	/*
+	O GSL só repassa um ponteiro às funções de custo, que são estáticas. Por ele vão o
+	localizador que está otimizando e, quando o ângulo está fixo (2 variáveis), esse ângulo.
+	*/
+	struct ParametrosDoCusto {
+		LocalizerV2* localizador;
+		float        angulo_fixo;
+	};
+
 	static double 
 	map_error_logprob(
 		const gsl_vector *v,
@@ -363,14 +631,14 @@ private:
 
 		  Parâmetros:
 		    - v: vetor de otimização do GSL.
-		    - params: parâmetros auxiliares (pode fornecer o ângulo fixo).
+		    - params: ParametrosDoCusto (localizador e, se for o caso, o ângulo fixo).
 
 		  Retorno:
 		    - Logaritmo negativo da probabilidade normalizada, utilizado como função de perda para otimização.
 		*/
 
+	    const ParametrosDoCusto* parametros = (const ParametrosDoCusto*) params;
 	    float angle;
-	    RobovizField& campo_existente = Singular<RobovizField>::obter_instancia();
 
 	    // Obtém o ângulo do vetor de otimização, ou dos parâmetros (como constante)
 	    if(
@@ -380,27 +648,39 @@ private:
 	        angle = gsl_vector_get(v, 2);
 	    }else{
 
-	        angle = *(float *)params;
+	        angle = parametros->angulo_fixo;
 	    }
 
-	    Matriz4D& transfMat = Singular<LocalizerV2>::obter_instancia()._Head_to_Field_Prelim;
-	    Vetor3D Zvec(transfMat.obter(2,0), transfMat.obter(2,1), transfMat.obter(2,2));
-	    
-	    Vetor3D Xvec, Yvec;
-	    calcular_eixos_XY_a_partir_de_Z(Zvec, angle, Xvec, Yvec );
+	    Matriz4D& transfMat = parametros->localizador->_Head_to_Field_Prelim;
+	    posicionar_preliminar(transfMat, gsl_vector_get(v, 0), gsl_vector_get(v, 1), angle, nullptr);
 
-	    // Estes são os coeficientes de transformação que estão sendo otimizados
-	    transfMat.setar(0,0,Xvec.x);
-	    transfMat.setar(0,1,Xvec.y);
-	    transfMat.setar(0,2,Xvec.z);
-	    transfMat.setar(0,3,gsl_vector_get(v, 0));
-	    transfMat.setar(1,0,Yvec.x);
-	    transfMat.setar(1,1,Yvec.y);
-	    transfMat.setar(1,2,Yvec.z);
-	    transfMat.setar(1,3,gsl_vector_get(v, 1));
+	    return parametros->localizador->avaliar_erro_logprob(transfMat, nullptr);
+	}
+
+	double
+	avaliar_erro_logprob(
+		const Matriz4D& transfMat,
+		SistemaNormal*  sistema
+	){
+		/*
+		Descrição:
+			Corpo de map_error_logprob(), avaliado na pose já escrita em transfMat. Se sistema não
+			for nulo, acumula também os resíduos esféricos de cada marcador e suas derivadas.
+
+		Retorno:
+			- O mesmo de map_error_logprob().
+		*/
+
+	    RobovizField& campo_existente = campo;
+	    _avaliacoes_de_custo++;
 
 	    Matriz4D inverseTransMat = transfMat.criar_transformacao_inversa();
 
+	    // Usados apenas nas derivadas
+	    const Vetor3D Xvec(transfMat.obter(0,0), transfMat.obter(0,1), transfMat.obter(0,2));
+	    const Vetor3D Yvec(transfMat.obter(1,0), transfMat.obter(1,1), transfMat.obter(1,2));
+	    const float   x = transfMat.obter(0,3), y = transfMat.obter(1,3);
+
 	    double total_logprob = 0;
 	    int total_err_cnt =0;
 	    
@@ -415,12 +695,39 @@ private:
 
 	        Linha6D rel_field_s(rel_field_s_start, rel_field_s_end, mkr.segm->comprimento);
 
-	        Vetor3D closest_polar_pt = rel_field_s.ponto_mais_proximo_na_reta_para_ponto_cartesiano(mkr.pos_rel_cart).to_esfe();
+	        Vetor3D closest_cart_pt  = rel_field_s.ponto_mais_proximo_na_reta_para_ponto_cartesiano(mkr.pos_rel_cart);
+	        Vetor3D closest_polar_pt = closest_cart_pt.to_esfe();
 
 	        total_logprob += Ruido_de_Campo::log_prob_r(closest_polar_pt.x, mkr.pos_rel_esf.x);
 	        total_logprob += Ruido_de_Campo::log_prob_h(closest_polar_pt.y, mkr.pos_rel_esf.y);
 	        total_logprob += Ruido_de_Campo::log_prob_v(closest_polar_pt.z, mkr.pos_rel_esf.z);
 	        total_err_cnt++;
+
+	        if(
+	        	sistema
+	        ){
+	        	/*
+	        	O ponto mais próximo é c = a + D*u, com a e D = b - a trazidos para o referencial do agente
+	        	e u = (m - a).D / L^2. Derivando: dc = da + dD*u + D*du, com du = ((m - a).dD - da.D) / L^2.
+	        	*/
+	        	const Vetor3D a_abs = mkr.segm->pt[0]->obter_vetor();
+	        	const Vetor3D b_abs = mkr.segm->pt[1]->obter_vetor();
+	        	const Vetor3D D     = rel_field_s_end - rel_field_s_start;
+	        	const Vetor3D m_a   = mkr.pos_rel_cart - rel_field_s_start;
+	        	const float   L2    = mkr.segm->comprimento * mkr.segm->comprimento;
+	        	const float   u     = m_a.InnerProduct(D) / L2;
+
+	        	const Vetor3D da[3] = { Xvec * -1, Yvec * -1, sistema->derivada_x * (a_abs.x - x) + sistema->derivada_y * (a_abs.y - y) };
+	        	const Vetor3D dD[3] = { Vetor3D(), Vetor3D(), sistema->derivada_x * (b_abs.x - a_abs.x) + sistema->derivada_y * (b_abs.y - a_abs.y) };
+
+	        	Vetor3D derivadas[3];
+	        	for(int k = 0; k < 3; k++){
+	        		const float du = ( m_a.InnerProduct(dD[k]) - da[k].InnerProduct(D) ) / L2;
+	        		derivadas[k] = da[k] + dD[k] * u + D * du;
+	        	}
+
+	        	acumular_residuos_esfericos(closest_cart_pt, derivadas, mkr.pos_rel_esf, *sistema);
+	        }
 	    }
 
 	    // Adiciona a log-probabilidade dos marcadores conhecidos
@@ -429,13 +736,26 @@ private:
 	    ){
 
 	        // Traz o marcador para o referencial do agente
-	        Vetor3D rel_k = (inverseTransMat * mkr.pos_abs.obter_vetor()).to_esfe();
+	        Vetor3D rel_k_cart = inverseTransMat * mkr.pos_abs.obter_vetor();
+	        Vetor3D rel_k      = rel_k_cart.to_esfe();
 
 	        total_logprob += Ruido_de_Campo::log_prob_r(rel_k.x, mkr.pos_rel_esf.x);
 	        total_logprob += Ruido_de_Campo::log_prob_h(rel_k.y, mkr.pos_rel_esf.y);
 	        total_logprob += Ruido_de_Campo::log_prob_v(rel_k.z, mkr.pos_rel_esf.z);
 	        total_err_cnt++;
 
+	        if(
+	        	sistema
+	        ){
+	        	// rel = Xvec*(abs.x - x) + Yvec*(abs.y - y) + Zvec*(abs.z - z)
+	        	const Vetor3D derivadas[3] = {
+	        		Xvec * -1,
+	        		Yvec * -1,
+	        		sistema->derivada_x * (mkr.pos_abs.x - x) + sistema->derivada_y * (mkr.pos_abs.y - y)
+	        	};
+
+	        	acumular_residuos_esfericos(rel_k_cart, derivadas, mkr.pos_rel_esf, *sistema);
+	        }
 	    }
 
 	    // retorna o log da "probabilidade normalizada" = (p1*p2*p3*...*pn)^(1/n)
@@ -464,12 +784,13 @@ private:
 
 		  Parâmetros:
 		    - v: vetor de otimização do GSL.
-		    - params: parâmetros auxiliares (pode fornecer o ângulo fixo).
+		    - params: ParametrosDoCusto (localizador e, se for o caso, o ângulo fixo).
 
 		  Retorno:
 		    - Média das distâncias (erro) calculadas.
 		*/
-	    RobovizField& campo_existente = Singular<RobovizField>::obter_instancia();
+
+	    const ParametrosDoCusto* parametros = (const ParametrosDoCusto*) params;
 
 	    // Obtém o ângulo do vetor de otimização, ou dos parâmetros (como constante)
 	    float angle = 0;
@@ -481,24 +802,35 @@ private:
 		}
 		else{
 
-			angle = *(float *) params;
+			angle = parametros->angulo_fixo;
 		}
 
-	    Matriz4D& transfMat = Singular<LocalizerV2>::obter_instancia()._Head_to_Field_Prelim;
-	    Vetor3D Zvec(transfMat.obter(2,0), transfMat.obter(2,1), transfMat.obter(2,2));
-	    
-	    Vetor3D Xvec, Yvec;
-	    calcular_eixos_XY_a_partir_de_Z( Zvec, angle, Xvec, Yvec );
+	    Matriz4D& transfMat = parametros->localizador->_Head_to_Field_Prelim;
+	    posicionar_preliminar(transfMat, gsl_vector_get(v, 0), gsl_vector_get(v, 1), angle, nullptr);
 
-	    // Estes são os coeficientes de transformação que estão sendo otimizados
-	    transfMat.setar(0,0,Xvec.x);
-	    transfMat.setar(0,1,Xvec.y);
-	    transfMat.setar(0,2,Xvec.z);
-	    transfMat.setar(0,3,gsl_vector_get(v, 0));
-	    transfMat.setar(1,0,Yvec.x);
-	    transfMat.setar(1,1,Yvec.y);
-	    transfMat.setar(1,2,Yvec.z);
-	    transfMat.setar(1,3,gsl_vector_get(v, 1));
+	    return parametros->localizador->avaliar_erro_euclidiano(transfMat, nullptr);
+	}
+
+	double
+	avaliar_erro_euclidiano(
+		const Matriz4D& transfMat,
+		SistemaNormal*  sistema
+	){
+		/*
+		Descrição:
+			Corpo de map_error_euclidian_distance(), avaliado na pose já escrita em transfMat. Se sistema
+			não for nulo, acumula também os resíduos: as distâncias de cada extremo de linha ao segmento de
+			campo casado e o desvio (x, y) de cada marco.
+
+			Os marcos com erro acima de 0.5 têm peso 100 na média; nos mínimos quadrados isso vira um
+			fator 10 no resíduo, pois ele é elevado ao quadrado.
+
+		Retorno:
+			- O mesmo de map_error_euclidian_distance().
+		*/
+
+	    RobovizField& campo_existente = campo;
+	    _avaliacoes_de_custo++;
 
 	    float total_err = 0;
 	    int total_err_cnt =0;
@@ -576,6 +908,7 @@ private:
 	        // Procura a distância para a linha de campo mais próxima
 	        // Erro padrão de 1e6f é aplicado quando não há correspondência (matriz de transf. Xvec/Yvec errada)
 	        float min_err = 1e6f;
+	        const RobovizField::sSegmento* melhor_segm = nullptr;
 	        for(
 	        	const auto& segm : RobovizField::cSegmentos::list
 	        ){ 
@@ -592,11 +925,20 @@ private:
 	            float err = RobovizField::calcular_dist_segm_para_pt2D_c(segm,ponto_inicial_da_linha_abs.to_2d());
 	            if(err < min_err) { err += RobovizField::calcular_dist_segm_para_pt2D_c(segm,ponto_final_da_linha_abs.to_2d()); }
 
-	            if(err < min_err) { min_err = err; }
+	            if(err < min_err) { min_err = err; melhor_segm = &segm; }
 	        }
 
 	        total_err += min_err;
 	        total_err_cnt += 2; // uma linha tem 2 pontos, peso dobrado comparado a um único marco
+
+	        // Linhas sem correspondência não têm derivada, apenas pesam no erro acima
+	        if(
+	        	sistema && melhor_segm
+	        ){
+
+	        	acumular_distancia_ao_segmento(*melhor_segm, linha_qualquer.ponto_inicial_cartesiano, ponto_inicial_da_linha_abs, 1, *sistema);
+	        	acumular_distancia_ao_segmento(*melhor_segm, linha_qualquer.ponto_final_cartesiano,   ponto_final_da_linha_abs,   1, *sistema);
+	        }
 	    }
 
 	    for(
@@ -609,6 +951,16 @@ private:
 	        float err = lpt.to_2d().obter_distancia_para(Vetor2D(m.pos_abs.x, m.pos_abs.y));
 	        total_err += err > 0.5 ? err * 100 : err;
 	        total_err_cnt++;
+
+	        if(
+	        	sistema
+	        ){
+
+	        	const double peso = err > 0.5 ? 10 : 1;
+
+	        	sistema->acumular( peso * (lpt.x - m.pos_abs.x), peso, 0, peso * sistema->derivada_x.InnerProduct(m.pos_rel_cart) );
+	        	sistema->acumular( peso * (lpt.y - m.pos_abs.y), 0, peso, peso * sistema->derivada_y.InnerProduct(m.pos_rel_cart) );
+	        }
 	    }
 
 	    double media_de_error = total_err / total_err_cnt;
@@ -634,7 +986,7 @@ private:
 			- false — se não foi possível encontrar uma solução adequada
 		*/
 
-		RobovizField& campo_existente = Singular<RobovizField>::obter_instancia();
+		RobovizField& campo_existente = campo;
 
 		const int goalNo = campo_existente.list_landmarks_goalposts.size();
 
@@ -732,10 +1084,10 @@ private:
 		// Este vetor do travessão aponta para a esquerda se visto do meio de campo (isso é importante para o produto vetorial)
 		Vetor3D crossbar_left_vec, crossbar_midp;
 
-		const auto& goal_mm = RobovizField::gMkrs::goal_mm;
-		const auto& goal_mp = RobovizField::gMkrs::goal_mp;
-		const auto& goal_pm = RobovizField::gMkrs::goal_pm;
-		const auto& goal_pp = RobovizField::gMkrs::goal_pp;
+		const auto& goal_mm = campo_existente.marcadores_fixos.goal_mm;
+		const auto& goal_mp = campo_existente.marcadores_fixos.goal_mp;
+		const auto& goal_pm = campo_existente.marcadores_fixos.goal_pm;
+		const auto& goal_pp = campo_existente.marcadores_fixos.goal_pp;
 
 		if(                     goal_mm.detectado   && goal_mp.detectado){
 
@@ -786,8 +1138,8 @@ private:
 	estimar_plano_solo_e_altura(){
 		/*
 		Descrição:
-			Encontra o vetor normal do plano do solo que melhor se ajusta aos marcadores do chão utilizando 
-			Decomposição em Valores Singulares (SVD).
+			Encontra o vetor normal do plano do solo que melhor se ajusta aos marcadores do chão: o autovetor
+			do menor autovalor da covariância ponderada dos marcadores (ver Covariancia3D em AlgLin.h).
 			
 			Também calcula a altura do agente com base no centróide dos marcadores de referência no chão.
 				- Requer pelo menos 3 referências de solo para funcionar corretamente.
@@ -801,52 +1153,38 @@ private:
 			- Não necessarimente, atualiza a altura da cabeça do agente.
 		*/
 
-		RobovizField& campo_existente = Singular<RobovizField>::obter_instancia();
+		RobovizField& campo_existente = campo;
 
-		const auto& ground_markers = campo_existente.list_weighted_ground_markers;
+		const auto& ground_markers = campo_existente.list_ground_markers;
+		const auto& pesos          = campo_existente.list_ground_markers_weights;
 		const int   ground_m_size  = ground_markers.size();
 
 		// Calcula o plano dos marcadores do solo (se houver ao menos 3 marcadores)
 
-		gsl_matrix *matriz_marcadores_solo     = gsl_matrix_alloc(ground_m_size, 3); 
-		gsl_matrix *matriz_vetores_singulares  = gsl_matrix_alloc(3, 3); 
-		gsl_vector *valores_singulares         = gsl_vector_alloc(3); 
-		gsl_vector *vetor_trabalho_svd         = gsl_vector_alloc(3);
-
-		// Calcula o centróide dos marcadores
-		Vetor3D centroid(0,0,0);
-		for(
-			const auto& gmkr : ground_markers
-		){ 
-
-			centroid += gmkr.pos_rel_cart;
-		}
-		centroid /= (float) ground_m_size;
-
-		// Insere todos os marcadores na matriz após subtrair o centróide
+		/*
+		É o mesmo plano que a SVD da matriz Nx3 dos marcadores centrados dava: os vetores singulares
+		à direita são os autovetores de M^T*M, a covariância a menos de um fator. Peso w equivale a
+		repetir o marcador w vezes.
+		*/
+		Covariancia3D covariancia;
 		for(
 			int i = 0; 
 				i < ground_m_size; 
 				i++
 		){ 
 
-			gsl_matrix_set(matriz_marcadores_solo,i,0, ground_markers[i].pos_rel_cart.x - centroid.x );
-			gsl_matrix_set(matriz_marcadores_solo,i,1, ground_markers[i].pos_rel_cart.y - centroid.y );
-			gsl_matrix_set(matriz_marcadores_solo,i,2, ground_markers[i].pos_rel_cart.z - centroid.z );
-		} 
+			covariancia.acumular( ground_markers[i].pos_rel_cart, pesos[i] );
+		}
+
+		const Vetor3D centroid = covariancia.obter_centroide();
 
-		// Decomposição em valores singulares para encontrar o plano que melhor se ajusta
-		gsl_linalg_SV_decomp(
-							matriz_marcadores_solo,
-							matriz_vetores_singulares,
-							valores_singulares,
-							vetor_trabalho_svd
-							);
+		double normal[3];
+		covariancia.obter_menor_autovetor( normal );
 
 		// plano: ax + by + cz = d
-		double a = gsl_matrix_get(matriz_vetores_singulares,0,2);
-		double b = gsl_matrix_get(matriz_vetores_singulares,1,2);
-		double c = gsl_matrix_get(matriz_vetores_singulares,2,2);
+		double a = normal[0];
+		double b = normal[1];
+		double c = normal[2];
 
 		/*
 		 * Equação do plano: ax + by + cz = d
@@ -858,11 +1196,6 @@ private:
 
 		// Nota: |d| é uma estimativa da altura do agente, mas é possível melhorar incluindo referências aéreas posteriormente
 
-		gsl_matrix_free (matriz_marcadores_solo);
-		gsl_matrix_free (matriz_vetores_singulares);
-		gsl_vector_free (valores_singulares);
-		gsl_vector_free (vetor_trabalho_svd);
-
 		/*
 		Infelizmente, o vetor normal nem sempre aponta para cima
 		O plano é definido por (ax + by + cz - d = 0)
@@ -939,19 +1272,26 @@ private:
 			- Atualiza o valor da altura.
 		*/
 
-		RobovizField& campo_existente = Singular<RobovizField>::obter_instancia();
+		RobovizField& campo_existente = campo;
+
+		const auto& ground_markers = campo_existente.list_ground_markers;
+		const auto& pesos          = campo_existente.list_ground_markers_weights;
 
 		Vetor3D zsum;
+		int soma_dos_pesos = 0;
 		for(
-			const auto& gmkr : campo_existente.list_weighted_ground_markers
+			size_t i = 0;
+				   i < ground_markers.size();
+				   i++
 		){
 
-			zsum += gmkr.pos_rel_cart;
+			zsum           += ground_markers[i].pos_rel_cart * pesos[i];
+			soma_dos_pesos += pesos[i];
 		}
 
 		// Altura mínima: 0.064m
 		float z =  max( 
-					  -( zsum / campo_existente.list_weighted_ground_markers.size() ).InnerProduct(Zvec)  ,
+					  -( zsum / soma_dos_pesos ).InnerProduct(Zvec)  ,
 					  0.064f
 					  );
 
@@ -970,6 +1310,176 @@ private:
 		float initial_y
 	);
 
+	/*
+	Estado de uma busca de Levenberg-Marquardt sobre a pose (x, y, ângulo). Com o ângulo fixo
+	(quantidade_de_parametros == 2), p[2] apenas guarda o ângulo e somente x e y são ajustados.
+	*/
+	struct BuscaLM {
+		double p[3];
+		int    quantidade_de_parametros;
+		bool   use_probabilities;
+		double lambda;
+		double custo; // soma dos quadrados dos resíduos em p, o que o LM minimiza
+		double erro;  // map_error em p, a métrica usada pelos critérios de aceitação
+		SistemaNormal sistema;
+	};
+
+	double
+	avaliar_pose(
+		const double   p[3],
+		bool           use_probabilities,
+		SistemaNormal* sistema
+	){
+		/*
+		Descrição:
+			Escreve a pose p em _Head_to_Field_Prelim e avalia a função de custo escolhida, acumulando
+			o sistema normal quando pedido.
+
+		Retorno:
+			- O map_error correspondente (euclidiano ou log-probabilidade).
+		*/
+
+		posicionar_preliminar(_Head_to_Field_Prelim, p[0], p[1], p[2], sistema);
+
+		return use_probabilities ? avaliar_erro_logprob(_Head_to_Field_Prelim, sistema) : avaliar_erro_euclidiano(_Head_to_Field_Prelim, sistema);
+	}
+
+	void
+	iniciar_busca_lm(
+		BuscaLM& busca,
+		float    x,
+		float    y,
+		float    angle,
+		int      quantidade_de_parametros,
+		bool     use_probabilities
+	){
+
+		busca.p[0] = x;
+		busca.p[1] = y;
+		busca.p[2] = angle;
+		busca.quantidade_de_parametros = quantidade_de_parametros;
+		busca.use_probabilities        = use_probabilities;
+		busca.lambda                   = 1e-3;
+
+		busca.erro  = avaliar_pose(busca.p, use_probabilities, &busca.sistema);
+		busca.custo = busca.sistema.soma_dos_quadrados;
+	}
+
+	static bool
+	resolver_sistema_amortecido(
+		const SistemaNormal& sistema,
+		double lambda,
+		int    n,
+		double delta[3]
+	){
+		/*
+		Descrição:
+			Resolve (J^T*J + lambda*diag(J^T*J)) * delta = -J^T*r em forma fechada, para n = 2 ou 3.
+			O pequeno termo somado à diagonal evita singularidade quando algum parâmetro não influencia
+			nenhum resíduo.
+
+		Retorno:
+			- false se o sistema for singular.
+		*/
+
+		double A[3][3], b[3];
+		for(int i = 0; i < n; i++){
+			for(int j = 0; j < n; j++){ A[i][j] = sistema.JtJ[i][j]; }
+			A[i][i] += lambda * A[i][i] + 1e-9;
+			b[i]     = -sistema.Jtr[i];
+		}
+
+		if(
+			n == 2
+		){
+
+			const double det = A[0][0] * A[1][1] - A[0][1] * A[1][0];
+			if( !gsl_finite(det) || fabs(det) < 1e-300 ){ return false; }
+
+			delta[0] = ( b[0] * A[1][1] - A[0][1] * b[1] ) / det;
+			delta[1] = ( A[0][0] * b[1] - A[1][0] * b[0] ) / det;
+			return true;
+		}
+
+		// Matriz adjunta
+		const double C[3][3] = {
+			{ A[1][1]*A[2][2] - A[1][2]*A[2][1],  A[0][2]*A[2][1] - A[0][1]*A[2][2],  A[0][1]*A[1][2] - A[0][2]*A[1][1] },
+			{ A[1][2]*A[2][0] - A[1][0]*A[2][2],  A[0][0]*A[2][2] - A[0][2]*A[2][0],  A[0][2]*A[1][0] - A[0][0]*A[1][2] },
+			{ A[1][0]*A[2][1] - A[1][1]*A[2][0],  A[0][1]*A[2][0] - A[0][0]*A[2][1],  A[0][0]*A[1][1] - A[0][1]*A[1][0] }
+		};
+
+		const double det = A[0][0] * C[0][0] + A[0][1] * C[1][0] + A[0][2] * C[2][0];
+		if( !gsl_finite(det) || fabs(det) < 1e-300 ){ return false; }
+
+		for(int i = 0; i < 3; i++){
+			delta[i] = ( C[i][0] * b[0] + C[i][1] * b[1] + C[i][2] * b[2] ) / det;
+		}
+
+		return true;
+	}
+
+	int
+	passo_levenberg_marquardt(
+		BuscaLM& busca,
+		double   tolerancia
+	){
+		/*
+		Descrição:
+			Um passo de Levenberg-Marquardt. Se o passo não reduz o custo, lambda cresce (o passo fica
+			mais curto e mais próximo do gradiente) e tentamos de novo; se reduz, lambda diminui (mais
+			próximo de Gauss-Newton). Os casamentos entre linhas vistas e linhas do campo são refeitos a
+			cada avaliação, então um passo que perde correspondências é recusado.
+
+		Parâmetros:
+			- busca: estado atual, atualizado quando o passo é aceito.
+			- tolerancia: maior componente do passo abaixo da qual consideramos que convergiu.
+
+		Retorno:
+			- GSL_CONTINUE: passo aceito, ainda não convergiu.
+			- GSL_SUCCESS:  convergiu (passo pequeno, ou nenhum passo reduz o custo).
+			- GSL_ENOPROG:  resíduos insuficientes ou sistema singular, não há o que fazer.
+		*/
+
+		const int n = busca.quantidade_de_parametros;
+
+		if( busca.sistema.quantidade_de_residuos < n ){ return GSL_ENOPROG; }
+
+		SistemaNormal tentativa;
+		for(
+			int tentativas = 0;
+				tentativas < 10;
+				tentativas++
+		){
+
+			double delta[3] = {0, 0, 0};
+			if( !resolver_sistema_amortecido(busca.sistema, busca.lambda, n, delta) ){ return GSL_ENOPROG; }
+
+			const double p[3] = { busca.p[0] + delta[0], busca.p[1] + delta[1], busca.p[2] + delta[2] };
+			const double erro = avaliar_pose(p, busca.use_probabilities, &tentativa);
+
+			if(
+				tentativa.soma_dos_quadrados < busca.custo && tentativa.quantidade_de_residuos >= busca.sistema.quantidade_de_residuos
+			){
+
+				busca.p[0]    = p[0];
+				busca.p[1]    = p[1];
+				busca.p[2]    = p[2];
+				busca.erro    = erro;
+				busca.custo   = tentativa.soma_dos_quadrados;
+				busca.sistema = tentativa;
+				busca.lambda  = max(busca.lambda * 0.1, 1e-7);
+
+				const double maior_passo = max( max(fabs(delta[0]), fabs(delta[1])), fabs(delta[2]) );
+				return maior_passo < tolerancia ? GSL_SUCCESS : GSL_CONTINUE;
+			}
+
+			busca.lambda *= 10;
+		}
+
+		// Nenhum passo reduz o custo: já estamos no mínimo (local)
+		return GSL_SUCCESS;
+	}
+
 	bool 
 	fine_tune_aux(
 	    float &initial_angle, 
@@ -984,8 +1494,117 @@ private:
 		    - Diretamente nos valores iniciais de ângulo, x e y se use_probabilities == false.
 		    - Diretamente na matriz _Head_to_Field_Prelim utilizando probabilidades (se use_probabilities == true).
 
+		    Por padrão usa Levenberg-Marquardt com derivadas analíticas. Se ele falhar, ou se metodo_de_ajuste
+		    pedir, usa o simplex do GSL (Nelder-Mead), que era o único método antes.
+
+		Parâmetros:
+			- initial_angle: referência para o ângulo inicial de Xvec ao redor de Zvec (pode ser atualizado pela função).
+		    - initial_x: referência para a translação inicial em x (pode ser atualizado pela função).
+		    - initial_y: referência para a translação inicial em y (pode ser atualizado pela função).
+		    - use_probabilities: se true, usa função de erro baseada em probabilidade; se false, usa erro euclidiano 2D.
+
+		Retorno:
+			- true  —> se o ajuste fino foi realizado com sucesso e os parâmetros/matriz foram atualizados.
+		    - false —> se o ajuste fino falhou (por exemplo, erro de mapeamento acima do limite permitido).
+		*/
+
+		if(
+			metodo_de_ajuste == LEVENBERG_MARQUARDT
+		){
+
+			if( fine_tune_aux_levenberg_marquardt(initial_angle, initial_x, initial_y, use_probabilities) ){ return true; }
+
+			_retornos_ao_simplex++;
+		}
+
+		return fine_tune_aux_nelder_mead(initial_angle, initial_x, initial_y, use_probabilities);
+	}
+
+	bool
+	fine_tune_aux_levenberg_marquardt(
+	    float &initial_angle, 
+	    float &initial_x, 
+	    float &initial_y, 
+	    bool   use_probabilities
+	){
+		/*
+		Descrição:
+			fine_tune_aux() por Levenberg-Marquardt. O resultado passa pelos mesmos critérios do simplex,
+			medidos com o map_error original: no ajuste euclidiano o erro não pode passar de 0.10 e, no
+			probabilístico, não pode ficar pior que o do ponto de partida.
+
+		Retorno:
+			- false se o LM não chegou a uma solução aceitável; nada é alterado além de _Head_to_Field_Prelim,
+			  que será sobrescrita pelo simplex.
+		*/
+
+		BuscaLM busca;
+		iniciar_busca_lm(busca, initial_x, initial_y, initial_angle, 3, use_probabilities);
+
+		const double erro_inicial = busca.erro;
+		const double p_inicial[3] = { busca.p[0], busca.p[1], busca.p[2] };
+
+		int status = GSL_CONTINUE;
+		for(
+			int iter = 0;
+				status == GSL_CONTINUE && iter < 20;
+				iter++
+		){
+
+			status = passo_levenberg_marquardt(busca, 1e-3);
+		}
+
+		if( status == GSL_ENOPROG ){ return false; }
+
+		if( !use_probabilities && busca.erro > 0.10 ){ return false; }
+
+		if(
+			use_probabilities && busca.erro > erro_inicial
+		){
+			/*
+			O LM minimiza a aproximação gaussiana dos termos de Ruido_de_Campo, cujo mínimo pode ficar um
+			fio de cabelo ao lado do da log-probabilidade exata (diferenças de 1e-8 com observações perfeitas).
+			Nesse caso ficamos com o ponto de partida; o simplex só vale a pena se a piora for de verdade.
+			*/
+			if( busca.erro > erro_inicial + 1e-3 ){ return false; }
+
+			busca.p[0] = p_inicial[0];
+			busca.p[1] = p_inicial[1];
+			busca.p[2] = p_inicial[2];
+		}
+
+		// A última avaliação pode ter sido de um passo recusado, então reescrevemos a melhor pose
+		posicionar_preliminar(_Head_to_Field_Prelim, busca.p[0], busca.p[1], busca.p[2], nullptr);
+
+		if(
+			!use_probabilities
+		){
+
+			initial_x     = busca.p[0];
+			initial_y     = busca.p[1];
+			initial_angle = busca.p[2];
+		}
+
+		return true;
+	}
+
+	bool 
+	fine_tune_aux_nelder_mead(
+	    float &initial_angle, 
+	    float &initial_x, 
+	    float &initial_y, 
+	    bool   use_probabilities
+	){
+		/*
+		Descrição:
+			Aplica o ajuste fino (fine tuning) à estimativa de orientação e posição do agente.
+		    O ajuste pode ser feito de duas formas:
+		    - Diretamente nos valores iniciais de ângulo, x e y se use_probabilities == false.
+		    - Diretamente na matriz _Head_to_Field_Prelim utilizando probabilidades (se use_probabilities == true).
+
 		    Utiliza o algoritmo de minimizar simplex do GSL para encontrar a melhor configuração dos parâmetros,
 		    otimizando a função de erro escolhida (distância euclidiana 2D ou log-probabilidade).
+		    É a reserva de fine_tune_aux() quando o Levenberg-Marquardt falha.
 
 		Parâmetros:
 			- initial_angle: referência para o ângulo inicial de Xvec ao redor de Zvec (pode ser atualizado pela função).
@@ -999,14 +1618,16 @@ private:
 		*/
 
 		int status, iter = 0;
-		gsl_vector* x =  criar_vetor_gsl<3>({initial_x, initial_y, initial_angle});    // Transformação inicial
-		gsl_vector* ss = criar_vetor_gsl<3>({0.02, 0.02, 0.03});                       // Define os tamanhos de passo iniciais
-		gsl_multimin_function minex_func = {map_error_euclidian_distance, 3, nullptr}; // Função de erro, número de variáveis, params
+		double inicial[3] = {initial_x, initial_y, initial_angle};                    // Transformação inicial
+		double passos[3]  = {0.02, 0.02, 0.03};                                       // Define os tamanhos de passo iniciais
+		gsl_vector_view x  = gsl_vector_view_array(inicial, 3);
+		gsl_vector_view ss = gsl_vector_view_array(passos, 3);
+		ParametrosDoCusto parametros = {this, 0};
+		gsl_multimin_function minex_func = {map_error_euclidian_distance, 3, &parametros}; // Função de erro, número de variáveis, params
 		if(use_probabilities) { minex_func.f = map_error_logprob; } 		           // Usa função de erro baseada em probabilidade
 
-		const gsl_multimin_fminimizer_type *T = gsl_multimin_fminimizer_nmsimplex2;   // Tipo de algoritmo
-		gsl_multimin_fminimizer *s = gsl_multimin_fminimizer_alloc (T, 3);            // Aloca espaço de trabalho
-	  	gsl_multimin_fminimizer_set (s, &minex_func, x, ss);                          // Configura o espaço de trabalho
+		gsl_multimin_fminimizer *s = _simplex_ajuste_fino;                            // Espaço de trabalho criado no construtor
+	  	gsl_multimin_fminimizer_set (s, &minex_func, &x.vector, &ss.vector);          // Configura o espaço de trabalho
 
 		float best_x, best_y, best_ang;
 
@@ -1031,10 +1652,6 @@ private:
 
 		float best_map_error = s->fval;
 
-		gsl_vector_free(x);
-		gsl_vector_free(ss);
-		gsl_multimin_fminimizer_free (s);
-
 		if(!use_probabilities){
 			if(best_map_error > 0.10){
 
@@ -1086,7 +1703,7 @@ private:
 			- false — caso contrário (por exemplo, se o ajuste fino falhar).
 		*/
 
-		RobovizField& campo_existente = Singular<RobovizField>::obter_instancia();
+		RobovizField& campo_existente = campo;
 
 		Vetor3D Zvec(_Head_to_Field_Prelim.obter(2,0), _Head_to_Field_Prelim.obter(2,1), _Head_to_Field_Prelim.obter(2,2));
 
@@ -1144,6 +1761,153 @@ private:
 		return fine_tune(AgentAngle, initial_x, initial_y);
 	}
 
+	void
+	otimizar_hipoteses_xy_levenberg_marquardt(
+		float   fixed_angle[4],
+		float   initial_x[4],
+		float   initial_y[4],
+		Vetor2D best_xy[4],
+		float   current_error[4],
+		bool    plausible_solution[4]
+	){
+		/*
+		Descrição:
+			Mesmo que otimizar_hipoteses_xy_nelder_mead(), com um Levenberg-Marquardt de 2 variáveis por
+			hipótese. As hipóteses avançam juntas, um passo por vez, para que as muito piores que a melhor
+			sejam abandonadas cedo. Uma hipótese só é plausível se convergiu.
+		*/
+
+		BuscaLM busca[4];
+		bool running[4]    = {true,true,true,true};
+		float lowest_error = 1e6;
+		const int maximum_iterations = 50;
+
+		for(int i=0; i<4; i++){
+
+			iniciar_busca_lm(busca[i], initial_x[i], initial_y[i], fixed_angle[i], 2, false);
+			current_error[i]      = busca[i].erro;
+			plausible_solution[i] = false;
+		}
+
+		int iter = 0;
+		do{
+			iter++;
+			for(int i=0; i<4; i++){
+				if(!running[i]) { continue; }
+
+				int status = passo_levenberg_marquardt(busca[i], 1e-2);
+
+				current_error[i] = busca[i].erro;
+				if(current_error[i] < lowest_error) lowest_error = current_error[i];
+
+				// Não há resíduos suficientes ou o sistema é singular
+				if(status == GSL_ENOPROG) {
+
+					running[i] = false;
+					continue;
+				}
+
+				if(status != GSL_CONTINUE || (lowest_error * 50 < current_error[i])) { // finalizou ou abortou
+
+					best_xy[i].x = busca[i].p[0];
+					best_xy[i].y = busca[i].p[1];
+					running[i] = false;
+					plausible_solution[i] = (status == GSL_SUCCESS); // somente válido se convergiu para mínimo local
+				}
+			}
+		} while (iter < maximum_iterations && (running[0] || running[1] || running[2] || running[3]));
+	}
+
+	void
+	otimizar_hipoteses_xy_nelder_mead(
+		float   fixed_angle[4],
+		float   initial_x[4],
+		float   initial_y[4],
+		Vetor2D best_xy[4],
+		float   current_error[4],
+		bool    plausible_solution[4]
+	){
+		/*
+		Descrição:
+			Otimiza a translação XY de cada uma das 4 hipóteses de estimar_translacao_rotacao_xy() com o
+			simplex do GSL, em paralelo, abandonando as que ficam muito piores que a melhor.
+
+		Parâmetros:
+			- fixed_angle, initial_x, initial_y: ângulo (fixo) e translação inicial de cada hipótese.
+			- best_xy, current_error, plausible_solution: saída, por hipótese.
+
+		Retorno:
+			Nada além das saídas.
+		*/
+
+		gsl_multimin_fminimizer **s = _simplex_hipoteses_xy; // Espaços de trabalho criados no construtor
+		double inicial[4][2], passos[4][2];
+		gsl_multimin_function minex_func[4];
+		ParametrosDoCusto parametros[4];
+
+		size_t iter = 0;
+		int status;
+		double size;
+
+		for(int i=0; i<4; i++){
+
+			inicial[i][0] = initial_x[i]; inicial[i][1] = initial_y[i]; // Transformação inicial
+			passos[i][0]  = 1;            passos[i][1]  = 1;            // Passos iniciais em 1
+			gsl_vector_view x  = gsl_vector_view_array(inicial[i], 2);
+			gsl_vector_view ss = gsl_vector_view_array(passos[i], 2);
+
+			// Inicializa método
+			minex_func[i].n = 2;
+			minex_func[i].f = map_error_euclidian_distance;
+			parametros[i] = {this, fixed_angle[i]};
+			minex_func[i].params = &parametros[i];
+
+	  		gsl_multimin_fminimizer_set (s[i], &minex_func[i], &x.vector, &ss.vector);
+		}
+
+		// Inicia iteração de minimização para cada caso possível
+		bool running[4]        = {true,true,true,true};
+		float lowest_error     = 1e6;
+		const int maximum_iterations = 50;
+
+		for(int i=0; i<4; i++){
+			current_error[i]      = 1e6;
+			plausible_solution[i] = false;
+		}
+
+	  	do{
+			iter++;
+			for(int i=0; i<4; i++){
+				if(!running[i]) { continue; }
+
+				status = gsl_multimin_fminimizer_iterate(s[i]);
+
+				current_error[i] = s[i]->fval;
+				if(current_error[i] < lowest_error) lowest_error = current_error[i];
+
+				// Possíveis erros: tamanhos incompatíveis, contração falhou, etc.
+				if (status) {  
+
+					running[i] = false; // Esta não é uma solução válida
+					continue; 
+				}
+
+				// Critério de parada da minimização: simplex se contrai próximo ao mínimo
+				size = gsl_multimin_fminimizer_size (s[i]);
+				status = gsl_multimin_test_size (size, 1e-2);
+
+				if(status != GSL_CONTINUE || (lowest_error * 50 < current_error[i])) { // finalizou ou abortou
+					
+					best_xy[i].x = gsl_vector_get (s[i]->x, 0);
+					best_xy[i].y = gsl_vector_get (s[i]->x, 1);
+					running[i] = false; 
+					plausible_solution[i]=(status == GSL_SUCCESS); // somente válido se convergiu para mínimo local
+					continue; 
+				} 
+			}	
+	    } while (iter < maximum_iterations && (running[0] || running[1] || running[2] || running[3]));
+	}
+
 	bool 
 	estimar_translacao_rotacao_xy(){
 		/*
@@ -1166,7 +1930,7 @@ private:
 		    - false — se não for possível encontrar uma solução plausível ou se o ajuste fino falhar.
 		*/
 
-		RobovizField& campo_existente = Singular<RobovizField>::obter_instancia();
+		RobovizField& campo_existente = campo;
 
 		// Obtém Zvec dos passos anteriores
 		Vetor3D Zvec(_Head_to_Field_Prelim.obter(2,0), _Head_to_Field_Prelim.obter(2,1), _Head_to_Field_Prelim.obter(2,2));
@@ -1239,72 +2003,33 @@ private:
 		
 		// ------------------------------------------------------------ Otimiza rotação XY para cada orientação possível
 
-		const gsl_multimin_fminimizer_type *T = gsl_multimin_fminimizer_nmsimplex2;
-		gsl_multimin_fminimizer *s[4] = {nullptr,nullptr,nullptr,nullptr};
-		gsl_vector *ss[4], *x[4];
-		gsl_multimin_function minex_func[4];
-
-		size_t iter = 0;
-		int status;
-		double size;
-
-		for(int i=0; i<4; i++){
-
-			x[i]  = criar_vetor_gsl<2>({initial_x[i], initial_y[i]}); // Transformação inicial
-			ss[i] = criar_vetor_gsl<2>({1, 1});						  // Passos iniciais em 1
-
-			// Inicializa método
-			minex_func[i].n = 2;
-			minex_func[i].f = map_error_euclidian_distance;
-			minex_func[i].params = &fixed_angle[i];	
-
-			s[i] = gsl_multimin_fminimizer_alloc (T, 2);
-	  		gsl_multimin_fminimizer_set (s[i], &minex_func[i], x[i], ss[i]);
-		}
-
-		// Inicia iteração de minimização para cada caso possível
-		bool running[4]        = {true,true,true,true};
 		float current_error[4] = {1e6,1e6,1e6,1e6};
-		float lowest_error     = 1e6;
-		Vetor2D best_xy[4]; 
-		const int maximum_iterations = 50;
+		Vetor2D best_xy[4];
 		bool plausible_solution[4] = {false,false,false,false};
-	  	do{
-			iter++;
-			for(int i=0; i<4; i++){
-				if(!running[i]) { continue; }
 
-				status = gsl_multimin_fminimizer_iterate(s[i]);
+		if(
+			metodo_de_ajuste == LEVENBERG_MARQUARDT
+		){
 
-				current_error[i] = s[i]->fval;
-				if(current_error[i] < lowest_error) lowest_error = current_error[i];
+			otimizar_hipoteses_xy_levenberg_marquardt(fixed_angle, initial_x, initial_y, best_xy, current_error, plausible_solution);
 
-				// Possíveis erros: tamanhos incompatíveis, contração falhou, etc.
-				if (status) {  
-
-					running[i] = false; // Esta não é uma solução válida
-					continue; 
-				}
+			// Se nenhuma hipótese passaria pelos critérios abaixo, o simplex tem a palavra final
+			bool alguma_candidata = false;
+			for(int i=0; i<4; i++){
+				bool isDistanceOk = (!noLandmarks) || last_known_position.obter_distancia_para(best_xy[i]) < 0.5;
+				if(plausible_solution[i] && current_error[i] < 0.12 && isDistanceOk) { alguma_candidata = true; }
+			}
 
-				// Critério de parada da minimização: simplex se contrai próximo ao mínimo
-				size = gsl_multimin_fminimizer_size (s[i]);
-				status = gsl_multimin_test_size (size, 1e-2);
+			if(
+				!alguma_candidata
+			){
 
-				if(status != GSL_CONTINUE || (lowest_error * 50 < current_error[i])) { // finalizou ou abortou
-					
-					best_xy[i].x = gsl_vector_get (s[i]->x, 0);
-					best_xy[i].y = gsl_vector_get (s[i]->x, 1);
-					running[i] = false; 
-					plausible_solution[i]=(status == GSL_SUCCESS); // somente válido se convergiu para mínimo local
-					continue; 
-				} 
-			}	
-	    } while (iter < maximum_iterations && (running[0] || running[1] || running[2] || running[3]));
+				_retornos_ao_simplex++;
+				otimizar_hipoteses_xy_nelder_mead(fixed_angle, initial_x, initial_y, best_xy, current_error, plausible_solution);
+			}
+		}else{
 
-		for(int i=0; i<4; i++){
-			gsl_vector_free(x[i]);
-			gsl_vector_free(ss[i]);
-			gsl_multimin_fminimizer_free (s[i]);
+			otimizar_hipoteses_xy_nelder_mead(fixed_angle, initial_x, initial_y, best_xy, current_error, plausible_solution);
 		}
 
 		// Neste ponto, uma solução é plausível se convergiu para um mínimo local
@@ -1404,6 +2129,7 @@ private:
     	*/
 
     	counter_fineTune = 0;
+    	_retornos_ao_simplex = 0;
 
     	for(
     		int i = 0;
@@ -1510,6 +2236,25 @@ public:
 	*/
 	const unsigned int &steps_since_last_update = _steps_since_last_update;
 
+	/*
+	Método usado para ajustar a pose em fine_tune_aux() e estimar_translacao_rotacao_xy():
+
+	- LEVENBERG_MARQUARDT: padrão. Derivadas analíticas e sistemas 3x3 (ou 2x2) resolvidos em forma fechada,
+	  convergindo em poucas iterações. Se falhar, o simplex é usado em seguida.
+	- NELDER_MEAD: apenas o simplex do GSL, como era antes. Útil para comparar os dois.
+	*/
+	enum METODO_DE_AJUSTE{
+		LEVENBERG_MARQUARDT,
+		NELDER_MEAD
+	};
+	METODO_DE_AJUSTE metodo_de_ajuste = LEVENBERG_MARQUARDT;
+
+	// Quantas vezes as funções de custo foram avaliadas no último run()
+	const unsigned int &avaliacoes_de_custo = _avaliacoes_de_custo;
+
+	// Quantas vezes o Levenberg-Marquardt falhou e o simplex teve de ser usado
+	const unsigned int &retornos_ao_simplex = _retornos_ao_simplex;
+
 	void 
     reportar_situacao( bool for_debugging = false ) const {
 		/*
@@ -1604,6 +2349,7 @@ public:
 		printf("--- >1 solution:       %i \n", st[FAILguessMany]);
 		printf("--- Weak solution:     %i \n", st[FAILguessTest]);
 		printf("- Eucl. tune fail:     %i \n", st[FAILtune]); //Euclidian distance tune error above 6cm
+		printf("- LM -> simplex:       %u \n", _retornos_ao_simplex);
 		printf("----------------------------------------------------------------------------------------\n");
 	}
 
@@ -1,8 +1,6 @@
 #include "RobovizLogger.h"
 #include "RobovizField.h"
 
-static World& mundo_existente = Singular<World>::obter_instancia();
-
 /*
 Único motivo de precisarmos deste .cpp são as seguintes definições
 
@@ -26,11 +24,31 @@ decltype(RobovizField::cPenaltyLength)              constexpr RobovizField::cPen
 decltype(RobovizField::cPenaltyWidth)               constexpr RobovizField::cPenaltyWidth;
 decltype(RobovizField::cSegmentos::list)            constexpr RobovizField::cSegmentos::list;
 decltype(RobovizField::cPontos::list)               constexpr RobovizField::cPontos::list;
-
-decltype(RobovizField::gMkrs::list)                           RobovizField::gMkrs::list;
+decltype(RobovizField::cMaxLinhasVisiveis)          constexpr RobovizField::cMaxLinhasVisiveis;
+decltype(RobovizField::cMaxMarcadoresSolo)          constexpr RobovizField::cMaxMarcadoresSolo;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+RobovizField::RobovizField( World& mundo_ ) : mundo(mundo_) {
+	/*
+	Descrição:
+	    Reserva, de uma vez, a capacidade máxima de todas as listas de marcadores.
+	    Como clear() mantém a capacidade, os ciclos seguintes não tocam no heap.
+	*/
+
+    list_landmarks.reserve              (8);
+    list_landmarks_corners.reserve      (4);
+    list_landmarks_goalposts.reserve    (4);
+    list_feet_contact_points.reserve    (2);
+    list_segments.reserve               (cMaxLinhasVisiveis);
+    linhas_em_ordem_decrescente.reserve (cMaxLinhasVisiveis);
+    list_known_segments.reserve         (cMaxLinhasVisiveis);
+    list_known_markers.reserve          (8 + 2 * cMaxLinhasVisiveis);
+    list_unknown_markers.reserve        (2 * cMaxLinhasVisiveis);
+    list_ground_markers.reserve         (cMaxMarcadoresSolo);
+    list_ground_markers_weights.reserve (cMaxMarcadoresSolo);
+}
+
 void 
 RobovizField::obter_marcadores_de_campo() {
 	/*
@@ -46,7 +64,7 @@ RobovizField::obter_marcadores_de_campo() {
 	    Popula as listas:
 	      - list_feet_contact_points
 	      - list_ground_markers
-	      - list_weighted_ground_markers
+	      - list_ground_markers_weights
 	    Também atualiza o valor de `non_collinear_ground_markers`.
 	*/
 
@@ -63,18 +81,18 @@ RobovizField::obter_marcadores_de_campo() {
     		i++
     ){
         if(
-        	mundo_existente.pe_em_contato[i]
+        	mundo.pe_em_contato[i]
         ){ 
 
             list_feet_contact_points.emplace_back(
             									  sVetor3D({0, 0, 0}), 
-            									  mundo_existente.pos_rel_contato_pe[i].to_esfe(), 
-            									  mundo_existente.pos_rel_contato_pe[i]
+            									  mundo.pos_rel_contato_pe[i].to_esfe(), 
+            									  mundo.pos_rel_contato_pe[i]
             									  );
             list_ground_markers.emplace_back     (
             									  sVetor3D({0, 0, 0}), 
-            									  mundo_existente.pos_rel_contato_pe[i].to_esfe(), 
-            									  mundo_existente.pos_rel_contato_pe[i]
+            									  mundo.pos_rel_contato_pe[i].to_esfe(), 
+            									  mundo.pos_rel_contato_pe[i]
             									  );
         }
     }
@@ -127,24 +145,22 @@ RobovizField::obter_marcadores_de_campo() {
 	    
 	    Aplicaremos da seguinte forma:
 		
-	    repetition = max(int(k*(1/var)),1), where k=1/1500
-	    repetitions for    1 meter:  71
-	    repetitions for    2 meters: 55
-	    repetitions for >=19 meters:  1
+	    weight = max(int(k*(1/var)),1), where k=1/1500
+	    weight for    1 meter:  71
+	    weight for    2 meters: 55
+	    weight for >=19 meters:  1
 		
 		Onde K é apenas uma constante númerica.
+		O peso equivale a repetir o marcador esse número de vezes.
 	*/
     for (
     	const auto& mkr : list_ground_markers
     ) {
     	// Observe que a componente x é a distância
         float var = pow(mkr.pos_rel_esf.x / 100.f, 2) * var_distance + var_round_hundredth;
-        int repeticoes = max(int(1.f / (1500.f * var)), 1);
 
-        list_weighted_ground_markers.insert(
-        	list_weighted_ground_markers.end(), 
-        	repeticoes,
-        	mkr
+        list_ground_markers_weights.push_back(
+        	max(int(1.f / (1500.f * var)), 1)
         );
     }
 }
@@ -173,8 +189,7 @@ RobovizField::atualizar_marcadores(){
 	        - list_ground_markers
 	*/
 
-	// Não é necessário reservar espaço, já que os vetores irão expandir mais nos
-	// primeiros ciclos.
+	// A capacidade foi reservada no construtor, clear() não a devolve.
     list_segments.clear();
     list_landmarks.clear();
     list_landmarks_corners.clear();
@@ -184,7 +199,7 @@ RobovizField::atualizar_marcadores(){
     list_unknown_markers.clear();
     list_known_segments.clear();
     list_ground_markers.clear();
-    list_weighted_ground_markers.clear();
+    list_ground_markers_weights.clear();
 
     // Preparando as list's landmarks
     for(
@@ -194,17 +209,17 @@ RobovizField::atualizar_marcadores(){
     ){
         sFixedMkr    *landmark8;  // Há 8 possibilidades no total.
         const sPonto *ponto_de_referencia;
-        World::gMkr  *landmark = &mundo_existente.landmark[i];
+        World::gMkr  *landmark = &mundo.landmark[i];
 
         // Identifica qual dos 8 pontos fixos está sendo observado
-        if      (landmark->pos_absoluta.x == -15 && landmark->pos_absoluta.y == -10) { landmark8 = &gMkrs::_corner_mm; ponto_de_referencia = &cPontos::corner_mm; }
-        else if (landmark->pos_absoluta.x == -15 && landmark->pos_absoluta.y == +10) { landmark8 = &gMkrs::_corner_mp; ponto_de_referencia = &cPontos::corner_mp; }
-        else if (landmark->pos_absoluta.x == +15 && landmark->pos_absoluta.y == -10) { landmark8 = &gMkrs::_corner_pm; ponto_de_referencia = &cPontos::corner_pm; }
-        else if (landmark->pos_absoluta.x == +15 && landmark->pos_absoluta.y == +10) { landmark8 = &gMkrs::_corner_pp; ponto_de_referencia = &cPontos::corner_pp; }
-        else if (landmark->pos_absoluta.x == -15 && landmark->pos_absoluta.y < 0)    { landmark8 = &gMkrs::_goal_mm;   ponto_de_referencia = &cPontos::goal_mm; }
-        else if (landmark->pos_absoluta.x == -15 && landmark->pos_absoluta.y > 0)    { landmark8 = &gMkrs::_goal_mp;   ponto_de_referencia = &cPontos::goal_mp; }
-        else if (landmark->pos_absoluta.x == +15 && landmark->pos_absoluta.y < 0)    { landmark8 = &gMkrs::_goal_pm;   ponto_de_referencia = &cPontos::goal_pm; }
-        else if (landmark->pos_absoluta.x == +15 && landmark->pos_absoluta.y > 0)    { landmark8 = &gMkrs::_goal_pp;   ponto_de_referencia = &cPontos::goal_pp; }
+        if      (landmark->pos_absoluta.x == -15 && landmark->pos_absoluta.y == -10) { landmark8 = &marcadores_fixos._corner_mm; ponto_de_referencia = &cPontos::corner_mm; }
+        else if (landmark->pos_absoluta.x == -15 && landmark->pos_absoluta.y == +10) { landmark8 = &marcadores_fixos._corner_mp; ponto_de_referencia = &cPontos::corner_mp; }
+        else if (landmark->pos_absoluta.x == +15 && landmark->pos_absoluta.y == -10) { landmark8 = &marcadores_fixos._corner_pm; ponto_de_referencia = &cPontos::corner_pm; }
+        else if (landmark->pos_absoluta.x == +15 && landmark->pos_absoluta.y == +10) { landmark8 = &marcadores_fixos._corner_pp; ponto_de_referencia = &cPontos::corner_pp; }
+        else if (landmark->pos_absoluta.x == -15 && landmark->pos_absoluta.y < 0)    { landmark8 = &marcadores_fixos._goal_mm;   ponto_de_referencia = &cPontos::goal_mm; }
+        else if (landmark->pos_absoluta.x == -15 && landmark->pos_absoluta.y > 0)    { landmark8 = &marcadores_fixos._goal_mp;   ponto_de_referencia = &cPontos::goal_mp; }
+        else if (landmark->pos_absoluta.x == +15 && landmark->pos_absoluta.y < 0)    { landmark8 = &marcadores_fixos._goal_pm;   ponto_de_referencia = &cPontos::goal_pm; }
+        else if (landmark->pos_absoluta.x == +15 && landmark->pos_absoluta.y > 0)    { landmark8 = &marcadores_fixos._goal_pp;   ponto_de_referencia = &cPontos::goal_pp; }
         else { return; }
 
         // Se o landmark foi visto, registra a posição relativa e o marca como visível
@@ -230,8 +245,16 @@ RobovizField::atualizar_marcadores(){
 
     // Preparando as list's lines
     for(
-    	const auto& linha : mundo_existente.linhas_esfericas
+    	const auto& linha : mundo.linhas_esfericas
     ){
+    	// Não passamos da capacidade reservada
+    	if(
+    		list_segments.size() == cMaxLinhasVisiveis
+    	){
+
+    		break;
+    	}
+
         list_segments.emplace_back(linha.ponto_inicial, linha.ponto_final);
     }
 
@@ -267,20 +290,20 @@ RobovizField::atualizar_marcadores_por_transformacao( const Matriz4D& Head_to_Fi
 	        - list_unknown_markers
 	*/
 
-	vector<Linha6D*> lines_descending_length;
+	linhas_em_ordem_decrescente.clear();
     for(
     	Linha6D& linha_qualquer : list_segments
     ){
 
-        lines_descending_length.push_back(
+        linhas_em_ordem_decrescente.push_back(
         								 &linha_qualquer
         								 );
     }	
 
     // Ordenamos da maior para menor.
     sort(
-    	lines_descending_length.begin(),
-    	lines_descending_length.end(), 
+    	linhas_em_ordem_decrescente.begin(),
+    	linhas_em_ordem_decrescente.end(), 
         []( // -> Função Anônima de Comparação
         	const Linha6D* a, const Linha6D* b
         ) { 
@@ -291,7 +314,7 @@ RobovizField::atualizar_marcadores_por_transformacao( const Matriz4D& Head_to_Fi
 
     // Identificamos as linhas 
     for(
-    	const Linha6D* linha : lines_descending_length
+    	const Linha6D* linha : linhas_em_ordem_decrescente
     ){
         Vetor3D linha_absoluta[2] = {
         	Head_to_Field * linha->ponto_inicial_cartesiano, 
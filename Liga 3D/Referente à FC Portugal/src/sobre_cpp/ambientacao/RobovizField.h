@@ -8,7 +8,6 @@ fieldLineSegmentDistToCartPoint()
 #ifndef ROBOVIZFIELD_H
 #define ROBOVIZFIELD_H
 
-#include "Singular.h"
 #include "AlgLin.h"
 #include "World.h"
 #include <vector>  // Alocação Dinâmica
@@ -24,15 +23,29 @@ class RobovizField {
 
 private:
 
-	RobovizField(){};
+	/*
+	Entradas do ciclo (landmarks, linhas e pés), de quem é dono este campo.
+	*/
+	World& mundo;
 
 	void
 	obter_marcadores_de_campo();
 
-	friend class Singular<RobovizField>;
+	/*
+	Ponteiros para list_segments, do maior para o menor segmento.
+	Usado apenas em atualizar_marcadores_por_transformacao(), mas mantido aqui
+	para que a capacidade reservada sobreviva entre os ciclos.
+	*/
+	vector<Linha6D*> linhas_em_ordem_decrescente;
 
 public:
 
+	explicit RobovizField( World& mundo_ );
+
+	// marcadores_fixos referencia a própria lista, uma cópia apontaria para a do original
+	RobovizField(const RobovizField&) = delete;
+	RobovizField& operator=(const RobovizField&) = delete;
+
 	/*
 	Definição de Dimensões de Campo
 
@@ -63,6 +76,17 @@ public:
     static constexpr float var_distance        =        0.00931225; //     variance of error ed  (distance error=d/100*ed)
     static constexpr float var_round_hundredth =      0.01*0.01/12; //variance of uniformly distributed random variable [-0.005,0.005]
 
+    /*
+    Capacidades das listas de marcadores.
+
+    Todas são reservadas uma única vez no construtor e apenas limpas a cada ciclo, 
+    logo, em regime, atualizar os marcadores não aloca nada. O servidor nunca mostra
+    mais que os 21 segmentos do campo (que podem vir partidos), então 64 linhas é folga.
+    Linhas além disso são ignoradas.
+    */
+    static constexpr int cMaxLinhasVisiveis = 64;
+    static constexpr int cMaxMarcadoresSolo = 2 + 2 * cMaxLinhasVisiveis + 4; // pés + extremos das linhas + cantos
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     struct sVetor3D  {
@@ -518,10 +542,11 @@ public:
 	int marcadores_nao_colineares;
 
 	/*
-	Versão ponderada de marcadores_de_solo.
-	Pontos mais próximos são repetidos mais vezes, proporcionalmente à sua distância.
+	Pesos de list_ground_markers, na mesma ordem.
+	Pontos mais próximos valem mais, proporcionalmente à sua distância. Antes eram repetidos
+	esse número de vezes numa lista à parte, que podia passar de milhares de cópias.
 	*/
-	vector<sMkr> list_weighted_ground_markers;
+	vector<int> list_ground_markers_weights;
 
 	/*
 	Pontos de contato dos pés com o solo.
@@ -543,31 +568,33 @@ public:
 		    - Diferente da lista de marcadores presente em `world.landmarks`, esta lista é ordenada com base na posição no campo,
 		      o que é essencial para manter consistência quando os times trocam de lado.
 		    - Todos os marcadores são definidos como constantes de leitura pública para fácil acesso direto ao elemento desejado.
-		    - O uso de variáveis estáticas garante alta performance no acesso sem duplicação de memória.
+		    - Cada campo tem a sua lista, pois ela guarda o que o agente dono do campo viu por último.
 		*/
         friend class RobovizField;
 
         private:
-            static sFixedMkr list[8];
-            static constexpr sFixedMkr &_corner_mm = list[0];
-            static constexpr sFixedMkr &_corner_mp = list[1];
-            static constexpr sFixedMkr &_corner_pm = list[2];
-            static constexpr sFixedMkr &_corner_pp = list[3];
-            static constexpr sFixedMkr &_goal_mm   = list[4];
-            static constexpr sFixedMkr &_goal_mp   = list[5];
-            static constexpr sFixedMkr &_goal_pm   = list[6];
-            static constexpr sFixedMkr &_goal_pp   = list[7];
+            sFixedMkr list[8];
+            sFixedMkr &_corner_mm = list[0];
+            sFixedMkr &_corner_mp = list[1];
+            sFixedMkr &_corner_pm = list[2];
+            sFixedMkr &_corner_pp = list[3];
+            sFixedMkr &_goal_mm   = list[4];
+            sFixedMkr &_goal_mp   = list[5];
+            sFixedMkr &_goal_pm   = list[6];
+            sFixedMkr &_goal_pp   = list[7];
         public:
-            static constexpr const sFixedMkr &corner_mm = list[0];
-            static constexpr const sFixedMkr &corner_mp = list[1];
-            static constexpr const sFixedMkr &corner_pm = list[2];
-            static constexpr const sFixedMkr &corner_pp = list[3];
-            static constexpr const sFixedMkr &goal_mm   = list[4];
-            static constexpr const sFixedMkr &goal_mp   = list[5];
-            static constexpr const sFixedMkr &goal_pm   = list[6];
-            static constexpr const sFixedMkr &goal_pp   = list[7];
+            const sFixedMkr &corner_mm = list[0];
+            const sFixedMkr &corner_mp = list[1];
+            const sFixedMkr &corner_pm = list[2];
+            const sFixedMkr &corner_pp = list[3];
+            const sFixedMkr &goal_mm   = list[4];
+            const sFixedMkr &goal_mp   = list[5];
+            const sFixedMkr &goal_pm   = list[6];
+            const sFixedMkr &goal_pp   = list[7];
     };
 
+    gMkrs marcadores_fixos;
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     /*
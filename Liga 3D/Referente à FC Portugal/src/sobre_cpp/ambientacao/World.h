@@ -6,7 +6,6 @@ Créditos:
 #ifndef WORLD_H
 #define WORLD_H
 
-#include "Singular.h"
 #include "AlgLin.h"
 #include <iostream>
 #include <vector>
@@ -49,14 +48,10 @@ class World {
 		    Vetor de linhas detectadas em coordenadas esféricas.
 	*/
 
-    friend class Singular<World>;
-
-private:
+public:
 
     World(){};
 
-public:
-
     // Variáveis dos pés: (0) esquerdo, (1) direito
 
     /*
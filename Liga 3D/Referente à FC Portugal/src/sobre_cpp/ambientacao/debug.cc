@@ -1,10 +1,35 @@
 #include "LocalizerV2.h"
+#include <gsl/gsl_linalg.h> // SVD de referência para Covariancia3D
 #include <iostream>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
 
 using namespace std;
 
-static LocalizerV2& loc = Singular<LocalizerV2>::obter_instancia();
+static LocalizerV2 loc;
+
+/*
+Contagem de alocações no heap.
+
+Substituímos malloc/calloc/realloc/free do glibc por versões que apenas
+contam as chamadas e repassam para as originais (__libc_*). Como o operator new
+e o GSL acabam em malloc, isso pega tudo que o ciclo de localização alocar.
+*/
+
+extern "C" void* __libc_malloc (size_t);
+extern "C" void* __libc_calloc (size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void  __libc_free   (void*);
+
+static bool         contando_alocacoes = false;
+static unsigned int alocacoes_contadas = 0;
+
+extern "C" void* malloc (size_t n)           { if(contando_alocacoes){ alocacoes_contadas++; } return __libc_malloc(n);     }
+extern "C" void* calloc (size_t n, size_t t) { if(contando_alocacoes){ alocacoes_contadas++; } return __libc_calloc(n, t);  }
+extern "C" void* realloc(void* p, size_t n)  { if(contando_alocacoes){ alocacoes_contadas++; } return __libc_realloc(p, n); }
+extern "C" void  free   (void* p)            { __libc_free(p); }
 
 void
 apresentar_infos_gerais(){
@@ -24,7 +49,7 @@ apresentar_infos_gerais(){
         - Não possui retorno (void). Os dados são impressos no console padrão (stdout).
     */
 
-    static World& mundo_existente = Singular<World>::obter_instancia();
+    World& mundo_existente = loc.mundo;
 
 	cout << "Pé Tocando: " << mundo_existente.pe_em_contato[0] << " " << mundo_existente.pe_em_contato[1] << endl;
     cout << "Ponto de Contato Rel (LFoot): " << mundo_existente.pos_rel_contato_pe[0].x << " " << mundo_existente.pos_rel_contato_pe[0].y << " " << mundo_existente.pos_rel_contato_pe[0].z << endl;
@@ -111,7 +136,7 @@ ilustrador( bool is_right_side ){
 	      A função realiza chamadas ao RobovizLogger para desenhar graficamente os elementos no campo.
 	*/
 
-	RobovizField& campo_existente = Singular<RobovizField>::obter_instancia();
+	RobovizField& campo_existente = loc.campo;
 
 	campo_existente.ilustrador(loc.Head_to_Field_Transform, is_right_side);
 }
@@ -127,7 +152,9 @@ localize_agent_pose(
     double landmarks[],
     double lines[],
     int    lines_no,
-    float* retval // somente para executarmos os testes
+    float* retval, // somente para executarmos os testes
+    bool   imprimir = true,
+    LocalizerV2& localizador = loc
 ){
 	/*
 	Descrição:
@@ -153,6 +180,10 @@ localize_agent_pose(
 			Vetor contendo os dados das linhas visíveis, cada linha com 6 valores: [start.x, start.y, start.z, end.x, end.y, end.z].
 		- lines_no: 
 			Quantidade de linhas presentes no vetor lines.
+		- imprimir:
+			Se falso, as matrizes resultantes não são impressas.
+		- localizador:
+			Instância que processa a observação; por padrão, a global deste arquivo.
 
 	Retorno:
 		- float* : Ponteiro para um vetor de 35 floats, contendo:
@@ -163,7 +194,7 @@ localize_agent_pose(
 	    	- [34]: Indicador de atualização do head_z (is_head_z_uptodate, 0 ou 1).
 	*/
 
-	static World& mundo_existente = Singular<World>::obter_instancia();
+	World& mundo_existente = localizador.mundo;
 
 	mundo_existente.pe_em_contato[0] = lfoot_touch;
     mundo_existente.pe_em_contato[1] = rfoot_touch;
@@ -219,37 +250,468 @@ localize_agent_pose(
     
     // ================================================= 2. Compute 6D pose
 
-    loc.run(); 
+    localizador.run(); 
     
     // ================================================= 3. Prepare data to return
     
     float *ptr = retval;
-    printf("\n-Head_to_Field\n");
+    if(imprimir) printf("\n-Head_to_Field\n");
     for(int i=0; i<16; i++){
-        ptr[i] = loc.Head_to_Field_Transform.conteudo[i];
-        printf("\n(index, valor) = (%d, %.8lf)", i, ptr[i]);
+        ptr[i] = localizador.Head_to_Field_Transform.conteudo[i];
+        if(imprimir) printf("\n(index, valor) = (%d, %.8lf)", i, ptr[i]);
     }
-    printf("\n");
+    if(imprimir) printf("\n");
     ptr += 16;
-    printf("\n-Field_to_Head-\n");
+    if(imprimir) printf("\n-Field_to_Head-\n");
     for(int i=0; i<16; i++){
-        ptr[i] = loc.Field_to_Head_Transform.conteudo[i];
-        printf("\n(index, valor) = (%d, %.8lf)", i, ptr[i]);
+        ptr[i] = localizador.Field_to_Head_Transform.conteudo[i];
+        if(imprimir) printf("\n(index, valor) = (%d, %.8lf)", i, ptr[i]);
     }
     ptr += 16;
-    printf("\n");
+    if(imprimir) printf("\n");
 
-    ptr[0] = (float) loc.is_uptodate;
-    ptr[1] = loc.head_z;
-    ptr[2] = (float) loc.is_head_z_uptodate;
+    ptr[0] = (float) localizador.is_uptodate;
+    ptr[1] = localizador.head_z;
+    ptr[2] = (float) localizador.is_head_z_uptodate;
 
-    printf("\nis_uptodate = %lf", ptr[0]);
-    printf("\nhead_z = %lf", ptr[1]);
-    printf("\nis_head_z_uptodate = %lf\n", ptr[2]);
+    if(imprimir) printf("\nis_uptodate = %lf", ptr[0]);
+    if(imprimir) printf("\nhead_z = %lf", ptr[1]);
+    if(imprimir) printf("\nis_head_z_uptodate = %lf\n", ptr[2]);
 
     return retval;
 }
 
+static Vetor3D
+observar_ponto(
+	const Vetor3D& ponto_abs,
+	double x,
+	double y,
+	double angulo
+){
+	/*
+	Descrição:
+		Posição esférica (distância, horizontal e vertical em graus) com que um agente de cabeça
+		nivelada a 0.5m de altura, em (x, y) e olhando na direção angulo, veria ponto_abs.
+	*/
+
+	const Vetor3D d( ponto_abs.x - x, ponto_abs.y - y, ponto_abs.z - 0.5 );
+
+	return Vetor3D(
+		 cos(angulo) * d.x + sin(angulo) * d.y,
+		-sin(angulo) * d.x + cos(angulo) * d.y,
+		 d.z
+	).to_esfe();
+}
+
+static bool
+dentro_do_campo_de_visao( const Vetor3D& esf ){ return esf.x > 0.3 && fabs(esf.y) < 60 && fabs(esf.z) < 60; }
+
+static int
+montar_observacao_sintetica(
+	double x,
+	double y,
+	double angulo,
+	int    maximo_de_marcos,
+	double landmarks[64],
+	double lines[],
+	int&   lines_no
+){
+	/*
+	Descrição:
+		Monta a entrada de localize_agent_pose() para um agente em (x, y, angulo) sem ruído algum:
+		os marcos e as linhas do campo inteiramente dentro do campo de visão, limitando a quantidade
+		de marcos vistos para que os dois caminhos de LocalizerV2 (com 2+ marcos ou com a adivinhação
+		pela maior linha) sejam exercitados.
+
+	Retorno:
+		- Quantidade de marcos vistos.
+	*/
+
+	// Mesma ordem de World::landmark: cantos e depois traves
+	const double marcos_abs[8][3] = {
+		{-15, -10, 0  }, {-15, 10, 0  }, {15, -10, 0  }, {15, 10, 0  },
+		{-15,-1.05,0.8}, {-15,1.05,0.8}, {15,-1.05,0.8}, {15,1.05,0.8}
+	};
+
+	int vistos = 0;
+	for(int i=0; i<8; i++){
+
+		Vetor3D esf = observar_ponto(Vetor3D(marcos_abs[i][0], marcos_abs[i][1], marcos_abs[i][2]), x, y, angulo);
+		bool visto  = dentro_do_campo_de_visao(esf) && vistos < maximo_de_marcos;
+		vistos     += visto;
+
+		const double linha[8] = { (double) visto, (double) (i < 4), marcos_abs[i][0], marcos_abs[i][1], marcos_abs[i][2], esf.x, esf.y, esf.z };
+		for(int k=0; k<8; k++){ landmarks[8*i + k] = linha[k]; }
+	}
+
+	lines_no = 0;
+	for(const auto& segm : RobovizField::cSegmentos::list){
+
+		Vetor3D inicio = observar_ponto(segm.pt[0]->obter_vetor(), x, y, angulo);
+		Vetor3D final  = observar_ponto(segm.pt[1]->obter_vetor(), x, y, angulo);
+		if( !dentro_do_campo_de_visao(inicio) || !dentro_do_campo_de_visao(final) ){ continue; }
+
+		const double linha[6] = { inicio.x, inicio.y, inicio.z, final.x, final.y, final.z };
+		for(int k=0; k<6; k++){ lines[6*lines_no + k] = linha[k]; }
+		lines_no++;
+	}
+
+	return vistos;
+}
+
+int
+comparar_metodos_de_ajuste(
+	double feet_contact[],
+	double ball_pos[],
+	double me_pos[],
+	double landmarks[],
+	double lines[],
+	int    lines_no
+){
+	/*
+	Descrição:
+		Roda cada cenário com o simplex (NELDER_MEAD) e depois com LEVENBERG_MARQUARDT e confere que:
+		- ambos chegam ao mesmo veredito (is_uptodate) e praticamente à mesma pose;
+		- nos cenários sintéticos, sem ruído, ambos recuperam a pose verdadeira;
+		- o LM avalia as funções de custo bem menos vezes.
+
+		O primeiro cenário é a observação real de main(), cujos ajustes passam por
+		calcular_translacao_rotacao_xy(). Os sintéticos com 1 ou nenhum marco passam por
+		estimar_translacao_rotacao_xy(), que usa a última posição conhecida (a do cenário anterior).
+
+	Retorno:
+		- Quantidade de erros encontrados.
+	*/
+
+	printf("\n---------------------------- Nelder-Mead x Levenberg-Marquardt ----------------------------\n");
+
+	const LocalizerV2::METODO_DE_AJUSTE metodos[2] = { LocalizerV2::NELDER_MEAD, LocalizerV2::LEVENBERG_MARQUARDT };
+	const char* nomes[2] = { "NM", "LM" };
+
+	float retval[35];
+	int erros = 0;
+	unsigned int avaliacoes_totais[2] = {0, 0};
+	const unsigned int retornos_antes = loc.retornos_ao_simplex;
+
+	// x, y, ângulo e quantidade máxima de marcos. x = 99 indica a observação real.
+	const double cenarios[][4] = {
+		{ 99  ,  0  , 0  , 8 },
+		{ -8  ,  3  , 0.3, 8 },
+		{ -8.1,  3.1, 0.3, 1 },
+		{ -8.2,  3  , 0.3, 0 },
+		{  5  , -4  , 2.5, 8 },
+		{  5.1, -4  , 2.5, 1 },
+		{  5.2, -4.1, 2.5, 0 }
+	};
+	const int quantidade_de_cenarios = sizeof(cenarios) / sizeof(cenarios[0]);
+
+	double feet_sintetico[] = { 0, 0.055, -0.5, 0, -0.055, -0.5 };
+	double ball_sintetico[] = { 0, 0, 0, 0, 0, 0 };
+	double landmarks_sintetico[64];
+	double lines_sintetico[21 * 6];
+
+	for(int c=0; c<quantidade_de_cenarios; c++){
+
+		const bool real = cenarios[c][0] == 99;
+		double me_sintetico[] = { cenarios[c][0], cenarios[c][1], 0.5 };
+		int lines_no_sintetico = 0;
+		int marcos = real ? 7 : montar_observacao_sintetica(cenarios[c][0], cenarios[c][1], cenarios[c][2], (int) cenarios[c][3], landmarks_sintetico, lines_sintetico, lines_no_sintetico);
+
+		bool    ok[2];
+		Vetor3D pos[2];
+		for(int m=0; m<2; m++){
+
+			loc.metodo_de_ajuste = metodos[m];
+
+			if(real){ localize_agent_pose(true, true, feet_contact, true, ball_pos, me_pos, landmarks, lines, lines_no, retval, false); }
+			else    { localize_agent_pose(true, true, feet_sintetico, false, ball_sintetico, me_sintetico, landmarks_sintetico, lines_sintetico, lines_no_sintetico, retval, false); }
+
+			ok[m]  = loc.is_uptodate;
+			pos[m] = loc.head_position;
+			avaliacoes_totais[m] += loc.avaliacoes_de_custo;
+
+			printf("%s (%d marcos): %s ok=%d pos=(%8.4f, %8.4f, %6.4f) avaliações=%u\n",
+				real ? "real      " : "sintético ", marcos, nomes[m], ok[m], pos[m].x, pos[m].y, pos[m].z, loc.avaliacoes_de_custo);
+		}
+
+		if( ok[0] != ok[1] ){ erros++; printf("-> ERRO: vereditos diferentes\n"); }
+		if( ok[0] && ok[1] && pos[0].obter_distancia_para(pos[1]) > 0.01 ){ erros++; printf("-> ERRO: poses diferentes\n"); }
+
+		if(
+			!real
+		){
+
+			for(int m=0; m<2; m++){
+				if( !ok[m] || pos[m].obter_distancia_para(Vetor3D(cenarios[c][0], cenarios[c][1], 0.5)) > 1e-3 ){
+					erros++;
+					printf("-> ERRO: %s não recuperou a pose verdadeira\n", nomes[m]);
+				}
+			}
+		}
+	}
+
+	if( avaliacoes_totais[1] >= avaliacoes_totais[0] ){ erros++; printf("-> ERRO: o LM não reduziu as avaliações\n"); }
+
+	loc.metodo_de_ajuste = LocalizerV2::LEVENBERG_MARQUARDT;
+
+	printf("Avaliações das funções de custo: NM = %u, LM = %u\n", avaliacoes_totais[0], avaliacoes_totais[1]);
+	printf("Retornos do LM ao simplex: %u\n", loc.retornos_ao_simplex - retornos_antes);
+	printf("Erros: %d\n", erros);
+
+	return erros;
+}
+
+static bool
+normais_concordam(
+	const vector<Vetor3D>& pontos,
+	const vector<int>&     pesos,
+	double&                desvio
+){
+	/*
+	Descrição:
+		Ajusta o plano aos pontos de duas formas, pela SVD do GSL da matriz dos pontos centrados
+		(cada linha multiplicada pela raiz do peso), como estimar_plano_solo_e_altura() fazia, e por
+		Covariancia3D, e compara as normais, que podem ter sentidos opostos.
+
+	Retorno:
+		- true se as normais coincidem. desvio recebe 1 - |cos| do ângulo entre elas.
+	*/
+
+	const int n = pontos.size();
+
+	Covariancia3D covariancia;
+	for(int i = 0; i < n; i++){ covariancia.acumular(pontos[i], pesos[i]); }
+
+	const Vetor3D centroide = covariancia.obter_centroide();
+	double normal[3];
+	covariancia.obter_menor_autovetor(normal);
+
+	gsl_matrix *M = gsl_matrix_alloc(n, 3);
+	gsl_matrix *V = gsl_matrix_alloc(3, 3);
+	gsl_vector *S = gsl_vector_alloc(3);
+	gsl_vector *T = gsl_vector_alloc(3);
+
+	for(int i = 0; i < n; i++){
+		const double raiz_do_peso = sqrt( (double) pesos[i] );
+		gsl_matrix_set(M, i, 0, raiz_do_peso * (pontos[i].x - centroide.x));
+		gsl_matrix_set(M, i, 1, raiz_do_peso * (pontos[i].y - centroide.y));
+		gsl_matrix_set(M, i, 2, raiz_do_peso * (pontos[i].z - centroide.z));
+	}
+	gsl_linalg_SV_decomp(M, V, S, T);
+
+	const double cosseno = normal[0] * gsl_matrix_get(V, 0, 2) + normal[1] * gsl_matrix_get(V, 1, 2) + normal[2] * gsl_matrix_get(V, 2, 2);
+
+	gsl_matrix_free(M);
+	gsl_matrix_free(V);
+	gsl_vector_free(S);
+	gsl_vector_free(T);
+
+	desvio = 1 - fabs(cosseno);
+	return desvio < 1e-6;
+}
+
+int
+comparar_ajuste_do_plano(){
+	/*
+	Descrição:
+		Confere que Covariancia3D encontra a mesma normal que a SVD do GSL, sem e com pesos:
+		- nos marcadores de solo da última observação processada;
+		- em nuvens sintéticas de pontos perto de planos inclinados, com ruído;
+		- em pontos exatamente no plano, em que o menor autovalor é zero.
+
+	Retorno:
+		- Quantidade de erros encontrados.
+	*/
+
+	printf("\n---------------------------- Plano do solo: Covariancia3D x SVD ----------------------------\n");
+
+	int erros = 0;
+	double desvio, maior_desvio = 0;
+	vector<Vetor3D> pontos;
+	vector<int>     pesos, pesos_unitarios;
+
+	// Observação real
+	const RobovizField& campo = loc.campo;
+	for(const auto& mkr : campo.list_ground_markers){ pontos.push_back(mkr.pos_rel_cart); pesos_unitarios.push_back(1); }
+
+	if( !normais_concordam(pontos, pesos_unitarios, desvio) )                  { erros++; printf("-> ERRO: observação real, sem pesos\n"); }
+	maior_desvio = max(maior_desvio, desvio);
+	if( !normais_concordam(pontos, campo.list_ground_markers_weights, desvio) ){ erros++; printf("-> ERRO: observação real, com pesos\n"); }
+	maior_desvio = max(maior_desvio, desvio);
+
+	// Nuvens sintéticas
+	srand(7);
+	auto aleatorio = [](double a, double b){ return a + (b - a) * rand() / (double) RAND_MAX; };
+
+	for(
+		int caso = 0;
+			caso < 200;
+			caso++
+	){
+
+		// Normal aleatória, parecida com a de uma cabeça de pé ou inclinada
+		const Vetor3D normal = Vetor3D(aleatorio(-0.5, 0.5), aleatorio(-0.5, 0.5), 1).normalize();
+		const Vetor3D u      = normal.CrossProduct(Vetor3D(1, 0, 0)).normalize();
+		const Vetor3D v      = normal.CrossProduct(u);
+		const double  altura = aleatorio(0.1, 0.6);
+		const double  ruido  = (caso % 4 == 0) ? 0 : 0.01;
+
+		const int n = 3 + rand() % 40;
+		pontos.clear();
+		pesos.clear();
+		pesos_unitarios.clear();
+		for(int i = 0; i < n; i++){
+			pontos.push_back( u * aleatorio(-15, 15) + v * aleatorio(-15, 15) + normal * (aleatorio(-ruido, ruido) - altura) );
+			pesos.push_back( 1 + rand() % 80 );
+			pesos_unitarios.push_back(1);
+		}
+
+		if( !normais_concordam(pontos, pesos_unitarios, desvio) ){ erros++; printf("-> ERRO: caso sintético %d, sem pesos (desvio %g)\n", caso, desvio); }
+		maior_desvio = max(maior_desvio, desvio);
+		if( !normais_concordam(pontos, pesos, desvio) )          { erros++; printf("-> ERRO: caso sintético %d, com pesos (desvio %g)\n", caso, desvio); }
+		maior_desvio = max(maior_desvio, desvio);
+	}
+
+	printf("Maior desvio (1 - |cos|) entre as normais: %g\n", maior_desvio);
+	printf("Erros: %d\n", erros);
+
+	return erros;
+}
+
+int
+verificar_alocacoes_em_regime(
+	double feet_contact[],
+	double ball_pos[],
+	double me_pos[],
+	double landmarks[],
+	double lines[],
+	int    lines_no
+){
+	/*
+	Descrição:
+		Depois de alguns ciclos de aquecimento, nos quais os espaços de trabalho são criados,
+		LocalizerV2::run() não deve mais tocar no heap. Conferimos com os dois métodos de
+		ajuste, já que o NELDER_MEAD exercita os minimizadores do GSL, e com uma observação
+		sintética pelo caminho da maior linha.
+
+	Retorno:
+		- Quantidade de erros encontrados.
+	*/
+
+	printf("\n---------------------------- Alocações em regime ----------------------------\n");
+
+	const LocalizerV2::METODO_DE_AJUSTE metodos[2] = { LocalizerV2::NELDER_MEAD, LocalizerV2::LEVENBERG_MARQUARDT };
+	const char* nomes[2] = { "NM", "LM" };
+
+	double feet_sintetico[] = { 0, 0.055, -0.5, 0, -0.055, -0.5 };
+	double ball_sintetico[] = { 0, 0, 0, 0, 0, 0 };
+	double me_sintetico[]   = { -8, 3, 0.5 };
+	double landmarks_sintetico[64];
+	double lines_sintetico[21 * 6];
+	int    lines_no_sintetico = 0;
+	montar_observacao_sintetica(-8, 3, 0.3, 1, landmarks_sintetico, lines_sintetico, lines_no_sintetico);
+
+	float retval[35];
+	int erros = 0;
+
+	for(int m=0; m<2; m++){
+
+		loc.metodo_de_ajuste = metodos[m];
+
+		for(int ciclo=0; ciclo<20; ciclo++){
+
+			// Os 5 primeiros ciclos são de aquecimento
+			contando_alocacoes = (ciclo >= 5);
+
+			localize_agent_pose(true, true, feet_contact, true, ball_pos, me_pos, landmarks, lines, lines_no, retval, false);
+			localize_agent_pose(true, true, feet_sintetico, false, ball_sintetico, me_sintetico, landmarks_sintetico, lines_sintetico, lines_no_sintetico, retval, false);
+		}
+
+		contando_alocacoes = false;
+
+		printf("%s: %u alocações em 30 ciclos após o aquecimento\n", nomes[m], alocacoes_contadas);
+		if( alocacoes_contadas != 0 ){ erros++; printf("-> ERRO: o ciclo de localização alocou memória\n"); }
+		alocacoes_contadas = 0;
+	}
+
+	loc.metodo_de_ajuste = LocalizerV2::LEVENBERG_MARQUARDT;
+
+	printf("Erros: %d\n", erros);
+
+	return erros;
+}
+
+int
+verificar_localizadores_independentes(
+	double feet_contact[],
+	double ball_pos[],
+	double me_pos[],
+	double landmarks[],
+	double lines[],
+	int    lines_no
+){
+	/*
+	Descrição:
+		Cada agente tem o seu LocalizerV2. Dois localizadores, um vendo a observação real e o
+		outro uma sintética, primeiro rodam sozinhos, um depois do outro, e depois ao mesmo tempo
+		em duas threads. Como um não enxerga o estado do outro, as saídas têm de ser idênticas
+		bit a bit.
+
+	Retorno:
+		- Quantidade de erros encontrados.
+	*/
+
+	printf("\n---------------------------- Localizadores independentes ----------------------------\n");
+
+	double feet_sintetico[] = { 0, 0.055, -0.5, 0, -0.055, -0.5 };
+	double ball_sintetico[] = { 0, 0, 0, 0, 0, 0 };
+	double me_sintetico[]   = { 4, -2, 0.5 };
+	double landmarks_sintetico[64];
+	double lines_sintetico[21 * 6];
+	int    lines_no_sintetico = 0;
+	montar_observacao_sintetica(4, -2, -2.1, 1, landmarks_sintetico, lines_sintetico, lines_no_sintetico);
+
+	const int ciclos = 50;
+
+	auto agente_real = [&](LocalizerV2& l, float* retval){
+		for(int c=0; c<ciclos; c++){ localize_agent_pose(true, true, feet_contact, true, ball_pos, me_pos, landmarks, lines, lines_no, retval, false, l); }
+	};
+	auto agente_sintetico = [&](LocalizerV2& l, float* retval){
+		for(int c=0; c<ciclos; c++){ localize_agent_pose(true, true, feet_sintetico, false, ball_sintetico, me_sintetico, landmarks_sintetico, lines_sintetico, lines_no_sintetico, retval, false, l); }
+	};
+
+	float sozinho[2][35], em_paralelo[2][35];
+
+	{
+		LocalizerV2 a, b;
+		agente_real(a, sozinho[0]);
+		agente_sintetico(b, sozinho[1]);
+	}
+
+	{
+		LocalizerV2 a, b;
+		thread t1(agente_real,      ref(a), em_paralelo[0]);
+		thread t2(agente_sintetico, ref(b), em_paralelo[1]);
+		t1.join();
+		t2.join();
+	}
+
+	int erros = 0;
+	const char* nomes[2] = { "real", "sintético" };
+	for(int i=0; i<2; i++){
+
+		const bool iguais = memcmp(sozinho[i], em_paralelo[i], sizeof(sozinho[i])) == 0;
+		printf("%-10s: sozinho (%.3f, %.3f) | em paralelo (%.3f, %.3f) | %s\n", nomes[i],
+			sozinho[i][3], sozinho[i][7], em_paralelo[i][3], em_paralelo[i][7], iguais ? "iguais" : "DIFERENTES");
+
+		if( !iguais ){ erros++; printf("-> ERRO: o localizador %s foi afetado pelo outro\n", nomes[i]); }
+	}
+
+	printf("Erros: %d\n", erros);
+
+	return erros;
+}
+
 int main(){
 
 	double feet_contact[] = {0.02668597,  0.055     , -0.49031584,  0.02668597, -0.055     , -0.49031584};
@@ -301,5 +763,10 @@ int main(){
             retval
     );                         
 
+    comparar_ajuste_do_plano();
+    comparar_metodos_de_ajuste(feet_contact, ball_pos, me_pos, landmarks, lines, lines_no);
+    verificar_alocacoes_em_regime(feet_contact, ball_pos, me_pos, landmarks, lines, lines_no);
+    verificar_localizadores_independentes(feet_contact, ball_pos, me_pos, landmarks, lines, lines_no);
+
 	return 0;
 }
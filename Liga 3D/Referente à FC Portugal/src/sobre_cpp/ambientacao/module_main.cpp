@@ -8,10 +8,8 @@
 namespace py = pybind11;
 using namespace std;
 
-static LocalizerV2& loc = Singular<LocalizerV2>::obter_instancia();
-
 void
-expose_runtime_data(){
+expose_runtime_data( const LocalizerV2& loc ){
 	/*
 	Descrição:
 		Exibe no console informações relevantes do estado atual do mundo do agente,
@@ -19,16 +17,16 @@ expose_runtime_data(){
 		de contato, visibilidade e posição da bola, posição do agente, informações
 		dos marcadores de chão (landmarks) e dados das linhas em coordenadas esféricas. 
 
-		Todas as informações são obtidas a partir da instância singleton da classe World 
+		Todas as informações são obtidas a partir do World do localizador fornecido
 		e são destinadas à inspeção em tempo de execução.
 
 	Parâmetros:
-	  	None
+	  	- loc: localizador cujo mundo será exibido.
 
 	Retorno:
 		Apenas imprime dados no console padrão.
 	*/
-	static World &world = Singular<World>::obter_instancia();
+	const World &world = loc.mundo;
 
     printf("%-26s %d %d\n", "Pé Tocando: ", world.pe_em_contato[0], world.pe_em_contato[1]);
     printf("%-26s %9.3f, %9.3f, %9.3f\n", "Ponto de Contato Rel (LFoot): ",
@@ -82,6 +80,7 @@ expose_runtime_data(){
 
 py::array_t<float>
 localize_agent_pose(
+            LocalizerV2& loc,
             // Não vou renomear estes pq já estão bons.
             bool lfoot_touch,
             bool rfoot_touch, 
@@ -95,7 +94,7 @@ localize_agent_pose(
 
     // Traduzir informações
     
-    static World &world = Singular<World>::obter_instancia();
+    World &world = loc.mundo;
     world.pe_em_contato[0] = lfoot_touch;
     world.pe_em_contato[1] = rfoot_touch;
 
@@ -187,7 +186,15 @@ localize_agent_pose(
     
     //// Realizamos o super algoritmo. //// 
 
-    loc.run(); 
+    {
+        /*
+        O localizador só lê o seu próprio mundo, já preenchido acima, então
+        o GIL pode ser liberado e outros agentes localizam-se ao mesmo tempo.
+        */
+        py::gil_scoped_release sem_gil;
+
+        loc.run(); 
+    }
     
     // Preparamos data para retornar.  ////
     
@@ -213,21 +220,19 @@ localize_agent_pose(
     return retval;
 }
 
-void report_calculation_status(bool for_debugging = false){
+void report_calculation_status(LocalizerV2& loc, bool for_debugging = false){
 
     loc.reportar_situacao(for_debugging);
     return;
 }
 
 // Não ache estranho, é apenas ilustrador em inglês.
-void illustrator(bool is_right_side){
-
-    RobovizField& campo_existente = Singular<RobovizField>::obter_instancia();
+void illustrator(LocalizerV2& loc, bool is_right_side){
 
-    campo_existente.ilustrador(
-                                loc.Head_to_Field_Transform,
-                                ((is_right_side) ? -1 : 1)
-                              );
+    loc.campo.ilustrador(
+                          loc.Head_to_Field_Transform,
+                          ((is_right_side) ? -1 : 1)
+                        );
 
     return;
 }
@@ -248,102 +253,117 @@ PYBIND11_MODULE(
     and analysis.
     )pbdoc";
 
-    m.def(
-        "localize_agent_pose",
-        &localize_agent_pose, 
-        R"pbdoc(
-        Description:
-            This function estimates the 3D pose of an agent's head in the environment using
-            visual and geometric cues such as field lines, ground markers, and goalposts.
-
-            It follows a multi-stage process involving minimum data requirements, orientation 
-            vector estimation (via SVD or relative geometry), Z-coordinate translation, and 
-            full transformation matrix assembly. 
-
-            It includes logic for ambiguity resolution, probabilistic validation, and refinement 
-            based on prior position and measurement quality. When visual input is partial or
-            ambiguous, the system may choose not to update the global transformation matrix, 
-            preserving consistency. The resulting head pose is always updated, while the world 
-            matrix is only updated under strict confidence conditions.
-
-        Parameters:
-            - if_lfoot_touch_the_ground: Whether the agent's **left foot** is currently in contact with the ground.
-            - if_rfoot_touch_the_ground: Whether the agent's **right foot** is currently in contact with the ground.
-            - relative_position_of_feet_contact: The estimated **position(s)** where the agent's feet make contact with the ground, relative to the head or body.
-            - if_ball_seen: Whether the **ball is currently visible** in the agent's field of view.
-            - ball_pos: The **3D position** of the ball in the agent's relative coordinate frame.
-            - me_pos: The current **estimated pose** (position and orientation) of the agent in the world.
-            - landmarks: A set of **ground reference markers** (e.g., field corners, penalty marks) visible in the scene.
-            - lines: A set of **line segments** detected from the field markings used for geometric pose estimation.
-
-        Returns:
-            A flat array of 35 float values containing:
-            - [0–15]   : The 4x4 transformation matrix from head to world coordinates (row-major order).
-            - [16–31]  : The 4x4 inverse transformation matrix from world to head coordinates.
-            - [32]     : Flag indicating whether the pose is ready to update the global transformation matrix (1.0 or 0.0).
-            - [33]     : The estimated Z-coordinate (height) of the agent's head.
-            - [34]     : Flag indicating whether the head Z estimation is considered valid (1.0 or 0.0).
-        )pbdoc",
-        "if_lfoot_touch_the_ground"_a,
-        "if_rfoot_touch_the_ground"_a,
-        "relative_position_of_feet_contact"_a,
-        "if_ball_seen"_a,
-        "ball_pos"_a,
-        "me_pos"_a,
-        "landmarks"_a,
-        "lines"_a
-    );
-
-    m.def(
-        "expose_runtime_data",
-        &expose_runtime_data, 
-        R"pbdoc(
-        Description:
-            Exposes internal world state and calculated values to Python
-            in real-time for inspection or debugging purposes. Useful for
-            monitoring agent state during runtime.
-
-        Parameters:
-            None
-
-        Return:
-            None, but the visual information given.
-        )pbdoc"
-    );
-
-    m.def(
-        "report_calculation_status",
-        &report_calculation_status,
+    py::class_<LocalizerV2>(
+        m,
+        "Localizer",
         R"pbdoc(
-        Description:
-            Prints diagnostic information about the most recent pose calculation, 
-            including convergence status, error metrics, and internal decisions 
-            made by the optimizer.
-
-        Parameters:
-            - for_debugging (bool): False if not for debug.
-                This paramter exists only to prevent a big segment fault.
+        Localizer that owns its world state, interpreted field markers and
+        optimizer workspaces, and keeps the pose history of a single agent.
 
-        Return:
-            None, but the visual information given.
+        Give one to each agent. Localizations on different Localizer objects can
+        run at the same time from different threads. The same object must not
+        be used by two threads at once.
         )pbdoc"
-    );
-
-    m.def(
-        "illustrator", 
-        &illustrator, 
-        R"pbdoc(
-        Description:
-            Triggers visualization of currently detected field elements
-            (lines, markers, goalposts) and pose estimation results, 
-            typically using a debug rendering layer or graphical interface.
-
-        Parameters:
-            - is_right_side: if field side is switch
-
-        Return:
-            None, but the visual lines and markers.
-        )pbdoc",
-        "is_right_side"_a
-    );
+    )
+        .def(
+            py::init<>()
+        )
+        .def(
+            "localize",
+            &localize_agent_pose,
+            R"pbdoc(
+            Description:
+                This function estimates the 3D pose of an agent's head in the environment using
+                visual and geometric cues such as field lines, ground markers, and goalposts.
+
+                It follows a multi-stage process involving minimum data requirements, orientation 
+                vector estimation (via a ground-plane fit or relative geometry), Z-coordinate translation, and 
+                full transformation matrix assembly. 
+
+                It includes logic for ambiguity resolution, probabilistic validation, and refinement 
+                based on prior position and measurement quality. When visual input is partial or
+                ambiguous, the system may choose not to update the global transformation matrix, 
+                preserving consistency. The resulting head pose is always updated, while the world 
+                matrix is only updated under strict confidence conditions.
+
+            Parameters:
+                - if_lfoot_touch_the_ground: Whether the agent's **left foot** is currently in contact with the ground.
+                - if_rfoot_touch_the_ground: Whether the agent's **right foot** is currently in contact with the ground.
+                - relative_position_of_feet_contact: The estimated **position(s)** where the agent's feet make contact with the ground, relative to the head or body.
+                - if_ball_seen: Whether the **ball is currently visible** in the agent's field of view.
+                - ball_pos: The **3D position** of the ball in the agent's relative coordinate frame.
+                - me_pos: The current **estimated pose** (position and orientation) of the agent in the world.
+                - landmarks: A set of **ground reference markers** (e.g., field corners, penalty marks) visible in the scene.
+                - lines: A set of **line segments** detected from the field markings used for geometric pose estimation.
+
+            Returns:
+                A flat array of 35 float values containing:
+                - [0–15]   : The 4x4 transformation matrix from head to world coordinates (row-major order).
+                - [16–31]  : The 4x4 inverse transformation matrix from world to head coordinates.
+                - [32]     : Flag indicating whether the pose is ready to update the global transformation matrix (1.0 or 0.0).
+                - [33]     : The estimated Z-coordinate (height) of the agent's head.
+                - [34]     : Flag indicating whether the head Z estimation is considered valid (1.0 or 0.0).
+
+                The GIL is released while the pose is computed.
+            )pbdoc",
+            "if_lfoot_touch_the_ground"_a,
+            "if_rfoot_touch_the_ground"_a,
+            "relative_position_of_feet_contact"_a,
+            "if_ball_seen"_a,
+            "ball_pos"_a,
+            "me_pos"_a,
+            "landmarks"_a,
+            "lines"_a
+        )
+        .def(
+            "expose_runtime_data",
+            &expose_runtime_data,
+            R"pbdoc(
+            Description:
+                Exposes internal world state and calculated values to Python
+                in real-time for inspection or debugging purposes. Useful for
+                monitoring agent state during runtime.
+
+            Parameters:
+                None
+
+            Return:
+                None, but the visual information given.
+            )pbdoc"
+        )
+        .def(
+            "report_calculation_status",
+            &report_calculation_status,
+            R"pbdoc(
+            Description:
+                Prints diagnostic information about the most recent pose calculation, 
+                including convergence status, error metrics, and internal decisions 
+                made by the optimizer.
+
+            Parameters:
+                - for_debugging (bool): False if not for debug.
+                    This paramter exists only to prevent a big segment fault.
+
+            Return:
+                None, but the visual information given.
+            )pbdoc",
+            "for_debugging"_a = false
+        )
+        .def(
+            "illustrator",
+            &illustrator,
+            R"pbdoc(
+            Description:
+                Triggers visualization of currently detected field elements
+                (lines, markers, goalposts) and pose estimation results, 
+                typically using a debug rendering layer or graphical interface.
+
+            Parameters:
+                - is_right_side: if field side is switch
+
+            Return:
+                None, but the visual lines and markers.
+            )pbdoc",
+            "is_right_side"_a
+        );
 }
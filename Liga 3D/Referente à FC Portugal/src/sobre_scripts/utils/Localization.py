@@ -1,5 +1,4 @@
 from Agent.Agent import Agent
-from sobre_cpp.ambientacao import ambientacao
 from math_ops.GeneralMath import GeneralMath
 from sobre_scripts.commons.Script import Script
 from world.commons.Draw import Draw
@@ -36,10 +35,10 @@ class Localization:
             self.script.batch_receive(slice(1, None))  # receive & update world state
 
             if p.world.vision_is_up_to_date:
-                if p.world.robot.loc_is_up_to_date:  # ambientacao will draw the world of the last agent to be executed
-                    ambientacao.expose_runtime_data()  # print data received by the ambientacao module
-                    ambientacao.illustrator(not p.world.team_side_is_left)  # draw visible elements
-                    ambientacao.report_calculation_status(False)  # print report with stats
+                if p.world.robot.loc_is_up_to_date:  # each agent has its own localizer, so this is always p's world
+                    p.world.localizer.expose_runtime_data()  # print data received by p's localizer
+                    p.world.localizer.illustrator(not p.world.team_side_is_left)  # draw visible elements
+                    p.world.localizer.report_calculation_status(False)  # print report with stats
                     print("\nPress ctrl+c to return.")
                     d.circle(p.world.ball_abs_pos, 0.1, 6, Draw.Color.purple_magenta, "world", False)
                 else:
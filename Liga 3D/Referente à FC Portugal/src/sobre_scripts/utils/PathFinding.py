@@ -119,27 +119,38 @@ class PathFinding:
     def __init__(self, script: Script) -> None:
         self.player = None
         self.script = script
-        a_estrela.find_optimal_path(np.zeros(6, np.float32))  # Initialize (not needed, but the first run takes a bit more time)
+        a_estrela.find_optimal_path(np.zeros(7, np.float32))  # Initialize (not needed, but the first run takes a bit more time)
 
     def draw_grid(self):
         d = self.player.world.draw
         MAX_RAW_COST = 0.6  # dribble cushion
 
-        for x in np.arange(-16, 16.01, 0.1):
-            for y in np.arange(-11, 11.01, 0.1):
-                s_in, cost_in = a_estrela.find_optimal_path(np.array([x, y, 0, 0, x, y, 5000], np.float32))[-2:]  # do not allow out of bounds
-                s_out, cost_out = a_estrela.find_optimal_path(np.array([x, y, 1, 0, x, y, 5000], np.float32))[-2:]  # allow out of bounds
-                # print(path_cost_in, path_cost_out)
-                if s_out != 3:
-                    d.point((x, y), 5, d.Color.red, "grid", False)
-                elif s_in != 3:
-                    d.point((x, y), 4, d.Color.blue_pale, "grid", False)
-                elif 0 < cost_in < MAX_RAW_COST + 1e-6:
-                    d.point((x, y), 4, d.Color.get(255, (1 - cost_in / MAX_RAW_COST) * 255, 0), "grid", False)
-                elif cost_in > MAX_RAW_COST:
-                    d.point((x, y), 4, d.Color.black, "grid", False)
-                # else:
-                #    d.point((x,y), 4, d.Color.white, "grid", False)
+        # Todas as células em uma única chamada: para cada (x, y), uma consulta sem e outra com permissão de sair do campo.
+        xs, ys = np.meshgrid(np.arange(-16, 16.01, 0.1), np.arange(-11, 11.01, 0.1), indexing="ij")
+        xs, ys = xs.ravel(), ys.ravel()
+        consultas = np.zeros((len(xs), 2, 7), np.float32)
+        consultas[:, :, 0] = xs[:, None]
+        consultas[:, :, 1] = ys[:, None]
+        consultas[:, 1, 2] = 1  # allow out of bounds (segunda consulta de cada par)
+        consultas[:, :, 4] = xs[:, None]
+        consultas[:, :, 5] = ys[:, None]
+        consultas[:, :, 6] = 5000
+
+        _, _, status, custos = a_estrela.find_optimal_paths(consultas.reshape(-1, 7))
+        status, custos = status.reshape(-1, 2), custos.reshape(-1, 2)
+
+        for x, y, (s_in, s_out), (cost_in, cost_out) in zip(xs, ys, status, custos):
+            # print(path_cost_in, path_cost_out)
+            if s_out != 3:
+                d.point((x, y), 5, d.Color.red, "grid", False)
+            elif s_in != 3:
+                d.point((x, y), 4, d.Color.blue_pale, "grid", False)
+            elif 0 < cost_in < MAX_RAW_COST + 1e-6:
+                d.point((x, y), 4, d.Color.get(255, (1 - cost_in / MAX_RAW_COST) * 255, 0), "grid", False)
+            elif cost_in > MAX_RAW_COST:
+                d.point((x, y), 4, d.Color.black, "grid", False)
+            # else:
+            #    d.point((x,y), 4, d.Color.white, "grid", False)
         d.flush("grid")
 
     def sync(self):
@@ -221,12 +232,13 @@ class PathFinding:
             param_vec_pb = np.array([*rpos, 1, go_to_goal, *ball, timeout, *obst[0]], np.float32)  # allow out of bounds (player->ball)
             param_vec_bp = np.array([*ball, 0, go_to_goal, *rpos, timeout, *obst[0]], np.float32)  # don't allow (ball->player)
             t1 = time()
-            path_ret_pb = a_estrela.find_optimal_path(param_vec_pb)
+            # As duas consultas compartilham os obstáculos, então vão juntas em uma única chamada.
+            caminhos, deslocamentos, status, custos = a_estrela.find_optimal_paths(np.stack([param_vec_pb[:7], param_vec_bp[:7]]), param_vec_pb[7:])
+            path_ret_pb = np.append(caminhos[deslocamentos[0]:deslocamentos[1]], [status[0], custos[0]]).astype(np.float32)
+            path_ret_bp = np.append(caminhos[deslocamentos[1]:deslocamentos[2]], [status[1], custos[1]]).astype(np.float32)
             t2 = time()
-            path_ret_bp = a_estrela.find_optimal_path(param_vec_bp)
-            t3 = time()
 
-            print(end=f"\rplayer->ball {int((t2 - t1) * 1000000):5}us (len:{len(path_ret_pb[:-2]) // 2:4})      ball->player {int((t3 - t2) * 1000000):5}us  (len:{len(path_ret_bp[:-2]) // 2:4}) ")
+            print(end=f"\rplayer->ball + ball->player {int((t2 - t1) * 1000000):5}us (len:{len(path_ret_pb[:-2]) // 2:4} / {len(path_ret_bp[:-2]) // 2:4}) ")
 
             self.draw_path_and_obstacles(obst, path_ret_pb, path_ret_bp)
             self.sync()
@@ -198,6 +198,7 @@ class World:
 
         self.logger = logger
         self.robot = Robot(unum, robot_type)
+        self.localizer = ambientacao.Localizer()  # Localizador próprio deste agente (mundo, campo e histórico de poses)
 
     def log(self, msg: str) -> None:
         """
@@ -373,7 +374,7 @@ class World:
 
             # Compute ambientacao
 
-            loc = ambientacao.localize_agent_pose(
+            loc = self.localizer.localize(
                 i_am_the_robot.feet_toes_are_touching['lf'],
                 i_am_the_robot.feet_toes_are_touching['rf'],
                 feet_contact,
@@ -55,6 +55,12 @@ class PathManager:
     HOT_START_DIST_WALK = 0.05  # saída a uma distância de 0.05 m, enquanto se mover caminhando
     HOT_START_DIST_DRIBBLE = 0.10  # saída a uma distância de 0.10 m, enquanto se mover driblando
 
+    ##########################################################################
+    # Campos de custo até o alvo compartilhados pelos agentes deste processo,
+    # válidos por um ciclo, veja get_path(shared_field=True)
+    _shared_fields = {}
+    _shared_fields_time = None
+
     def __init__(self, world: World) -> None:
         """
         Descrição:
@@ -79,6 +85,18 @@ class PathManager:
         self.last_update = 0  # timestamp da última atualização do path planning
         self.last_start_dist = None  # última distância usada como ponto de saída na hora de gerar o caminho
 
+        # Contexto de planejamento próprio deste agente (quadro de nós, lista aberta e saída).
+        # Com um por agente, vários agentes no mesmo processo podem planejar em threads diferentes.
+        self.planner = a_estrela.PathPlanner()
+
+        # O drible repete o mesmo problema a cada ciclo (mesmo alvo, obstáculos andando pouco),
+        # então usa um planejador incremental que só repara o que mudou desde o ciclo anterior.
+        self.dribble_planner = a_estrela.IncrementalPathPlanner()
+
+        # Saída dos planejadores, alocada uma única vez: a busca escreve o caminho direto aqui,
+        # sem criar um array novo por chamada. Veja get_path().
+        self._path_buffer = np.empty(2048, np.float32)
+
     def draw_options(self, enable_obstacles: bool, enable_path: bool, use_team_drawing_channel: bool = False) -> None:
         """
         Descrição:
@@ -110,7 +128,8 @@ class PathManager:
             ball_safety_margin: float = 0,
             goalpost_safety_margin: float = 0,
             mode: int = MODE_CAUTIOUS,
-            priority_unums: list = None
+            priority_unums: list = None,
+            include_velocity: bool = False
     ) -> list:
         """
         Descrição:
@@ -137,11 +156,16 @@ class PathManager:
                 atitude do robô quanto às margens de segurança (cauteloso, agressivo ou drible). Padrão = MODE_CAUTIOUS.
             priority_unums (list) :
                 lista de números de uniforme dos companheiros que serão evitados com maior ênfase. Padrão = [].
+            include_velocity (bool) :
+                se True, cada tupla ganha a velocidade (vx, vy) do obstáculo em m/s, vinda de
+                state_filtered_velocity. Restrições, bola e traves são parados, (0, 0).
+                get_path() reconhece esse formato e planeja contra onde os jogadores estarão. Padrão = False.
 
         Retorna:
             obstacles (list) :
                 uma lista de tuplas, onde cada tupla representa um obstáculo:
-                (x, y, raio_hard, raio_soft, força_repulsiva).
+                (x, y, raio_hard, raio_soft, força_repulsiva), ou
+                (x, y, raio_hard, raio_soft, força_repulsiva, vx, vy) com include_velocity.
         """
 
         if priority_unums is None:
@@ -155,6 +179,10 @@ class PathManager:
         # 'comparator' is a variable local to the lambda, which captures the current value of (w.time_local_ms - max_age)
         check_age = lambda last_update, comparator=w.time_local_ms - max_age: last_update > 0 and last_update >= comparator
 
+        # Com include_velocity, cada jogador leva a própria velocidade na tupla; o resto fica parado
+        velocity = (lambda p: tuple(p.state_filtered_velocity[:2])) if include_velocity else (lambda p: ())
+        stopped = (0, 0) if include_velocity else ()
+
         # Get recently seen close teammates
         if include_teammates:
             soft_radius = 1.1 if mode == PathManager.MODE_DRIBBLE else 0.6  # soft radius: repulsive force is max at center and fades
@@ -169,7 +197,8 @@ class PathManager:
             obstacles.extend((*t.state_ground_area[0],
                               get_hard_radius(t),
                               1.5 if t.unum in priority_unums else soft_radius,
-                              1.0)  # repulsive force
+                              1.0,  # repulsive force
+                              *velocity(t))
                              for t in w.teammates if not t.is_self and check_age(t.state_last_update) and t.state_horizontal_dist < max_distance)
 
         # Get recently seen close opponents
@@ -191,17 +220,18 @@ class PathManager:
             obstacles.extend((*o.state_ground_area[0],
                               hard_radius(o),
                               soft_radius,
-                              1.5 if o.unum == 1 else 1.0)  # repulsive force (extra for their GK)
+                              1.5 if o.unum == 1 else 1.0,  # repulsive force (extra for their GK)
+                              *velocity(o))
                              for o in w.opponents if o.state_last_update > 0 and w.time_local_ms - o.state_last_update <= max_age and o.state_horizontal_dist < max_distance)
 
         # ---------------------------------------------- Get play mode restrictions
         if include_play_mode_restrictions:
             if w.play_mode == World.M_THEIR_GOAL_KICK:
-                obstacles.extend((15, i, 2.1, 0, 0) for i in range(-2, 3))  # 5 circular obstacles to cover their goal area
+                obstacles.extend((15, i, 2.1, 0, 0, *stopped) for i in range(-2, 3))  # 5 circular obstacles to cover their goal area
             elif w.play_mode == World.M_THEIR_PASS:
-                obstacles.append((*ball_2d, 1.2, 0, 0))
+                obstacles.append((*ball_2d, 1.2, 0, 0, *stopped))
             elif w.play_mode in [World.M_THEIR_KICK_IN, World.M_THEIR_CORNER_KICK, World.M_THEIR_FREE_KICK, World.M_THEIR_DIR_FREE_KICK, World.M_THEIR_OFFSIDE]:
-                obstacles.append((*ball_2d, 2.5, 0, 0))
+                obstacles.append((*ball_2d, 2.5, 0, 0, *stopped))
 
         # ---------------------------------------------- Get ball
         if ball_safety_margin > 0:
@@ -210,12 +240,12 @@ class PathManager:
             if (w.play_mode_group != w.MG_OTHER) or abs(ball_2d[1]) > 9.5 or abs(ball_2d[0]) > 14.5:
                 ball_safety_margin += 0.12
 
-            obstacles.append((*ball_2d, 0, ball_safety_margin, 8))
+            obstacles.append((*ball_2d, 0, ball_safety_margin, 8, *stopped))
 
         # ---------------------------------------------- Get goal posts
         if goalpost_safety_margin > 0:
-            obstacles.append((14.75, 1.10, goalpost_safety_margin, 0, 0))
-            obstacles.append((14.75, -1.10, goalpost_safety_margin, 0, 0))
+            obstacles.append((14.75, 1.10, goalpost_safety_margin, 0, 0, *stopped))
+            obstacles.append((14.75, -1.10, goalpost_safety_margin, 0, 0, *stopped))
 
         # ---------------------------------------------- Draw obstacles
         if self._draw_obstacles:
@@ -312,12 +342,12 @@ class PathManager:
         if path_len >= ret_seg_ceil:
             i = ret_seg_ceil * 2  # path index of ceil point (x)
             if ret_seg_ceil == ret_segments:
-                return path[i:i + 2]
+                return path[i:i + 2].copy()  # o caminho é reaproveitado na próxima busca, veja get_path()
             else:
                 floor_w = ret_seg_ceil - ret_segments
                 return path[i - 2:i] * floor_w + path[i:i + 2] * (1 - floor_w)
         else:
-            return path[-2:]  # path end
+            return path[-2:].copy()  # path end
 
     def get_path_to_ball(
             self,
@@ -470,7 +500,8 @@ class PathManager:
         # veja a explicação para o contexto na seção de atualização do hot start
         start_pos = self._get_hot_start(PathManager.HOT_START_DIST_WALK) if target_dist > 0.4 else self.world.robot.loc_head_position[:2]
 
-        path, path_len, path_status, path_cost = self.get_path(start_pos, True, obstacles, target, timeout)
+        # Busca em qualquer tempo: se o timeout apertar, ainda recebemos um caminho completo até a bola
+        path, path_len, path_status, path_cost = self.get_path(start_pos, True, obstacles, target, timeout, anytime=True)
         path_end = path[-2:]  # última posição permitida pelo A*
 
         ####################
@@ -594,7 +625,8 @@ class PathManager:
         # Veja a explicação na seção de atualização do hot start
         start_pos = self._get_hot_start(PathManager.HOT_START_DIST_WALK) if target_dist > 0.4 else self.world.robot.loc_head_position[:2]
 
-        path, path_len, path_status, path_cost = self.get_path(start_pos, True, obstacles, target, timeout)
+        # Caminhada livre pelo campo, justamente o caso em que os saltos mais economizam
+        path, path_len, path_status, path_cost = self.get_path(start_pos, True, obstacles, target, timeout, jump_points=True)
         path_end = path[-2:]  # última posição permitida pelo A*
 
         #########################################
@@ -682,7 +714,7 @@ class PathManager:
 
         start_pos = self._get_hot_start(PathManager.HOT_START_DIST_DRIBBLE)
 
-        path, path_len, path_status, path_cost = self.get_path(start_pos, False, obstacles, optional_2d_target, timeout)
+        path, path_len, path_status, path_cost = self.get_path(start_pos, False, obstacles, optional_2d_target, timeout, self.dribble_planner)
 
         # ------------------------------------------- get next target position & orientation
 
@@ -757,13 +789,40 @@ class PathManager:
 
         return next_pos
 
+    def _get_shared_field(self, params: np.ndarray):
+        """
+        Descrição:
+            Retorna o campo de custo até o alvo para estes parâmetros, calculando-o apenas se
+            nenhum agente o pediu neste ciclo. O início e o timeout não fazem parte da chave.
+        """
+        if PathManager._shared_fields_time != self.world.time_server:
+            PathManager._shared_fields = {}
+            PathManager._shared_fields_time = self.world.time_server
+
+        key = params[2:6].tobytes() + params[7:].tobytes()
+        field = PathManager._shared_fields.get(key)
+
+        if field is None:
+            field = a_estrela.CostToGoField()
+            field.compute(params)
+            PathManager._shared_fields[key] = field
+
+        return field
+
     def get_path(
             self,
             start,
             allow_out_of_bounds,
             obstacles=None,
             optional_2d_target=None,
-            timeout=3000
+            timeout=3000,
+            planner=None,
+            jump_points=False,
+            anytime=False,
+            shared_field=False,
+            any_angle=False,
+            coarse_to_fine=False,
+            use_cache=False
     ) -> tuple[np.ndarray, int, int, float]:
         """
         Descrição:
@@ -786,6 +845,11 @@ class PathManager:
                 - raio_forte: raio onde o robô deve definitivamente desviar
                 - raio_suave: raio onde o robô é influenciado para se desviar
                 - forca_repulsiva: intensidade dessa influência
+                Também aceita tuplas de 7 floats, com a velocidade (vx, vy) em m/s no fim,
+                como get_obstacles(include_velocity=True) devolve. Nesse caso cada obstáculo
+                é considerado onde estará quando o robô puder chegar até ele, o que evita
+                replanejar a todo ciclo em volta de onde o adversário estava. Só o planejador
+                padrão usa as velocidades; shared_field e os demais planejadores as descartam.
 
             optional_2d_target : iterable de dois floats ou None
                 Ponto opcional que deve ser o destino.
@@ -794,9 +858,56 @@ class PathManager:
             timeout : float
                 Tempo máximo de execução do A* em microsegundos.
 
+            planner : a_estrela.PathPlanner ou a_estrela.IncrementalPathPlanner ou None
+                Planejador a ser usado. Se for None, usa o planejador padrão deste agente.
+
+            jump_points : bool
+                Se True, usa Jump Point Search, que atravessa as regiões de custo zero
+                em saltos e expande muito menos nós em campo aberto. O custo do caminho
+                é o mesmo. Vale apenas para o planejador padrão (planner=None).
+
+            anytime : bool
+                Se True, usa a busca em qualquer tempo (ARA*). Um primeiro caminho sai
+                rápido, com a heurística inflada, e vai sendo melhorado até o timeout.
+                Se o tempo acabar, recebemos o melhor caminho completo em vez de um pedaço.
+                Tem prioridade sobre jump_points e vale apenas para o planejador padrão.
+
+            shared_field : bool
+                Se True, o caminho desce por um a_estrela.CostToGoField compartilhado por todos
+                os agentes deste processo. O campo é calculado uma vez por ciclo para cada
+                combinação de alvo e obstáculos, e cada agente só o percorre, sem busca.
+                Calcular um campo custa o mesmo que dezenas de buscas curtas, logo só compensa
+                quando vários agentes passam exatamente os mesmos obstáculos. Ignora planner,
+                jump_points e anytime. Se o início não alcança o alvo, cai na busca comum.
+
+            any_angle : bool
+                Se True, a escada de células é encurtada por linha de visada e sobram apenas
+                os pontos onde o caminho vira, sem passar por regiões mais caras. O caminho
+                fica bem menor, mas os segmentos deixam de ter ~0.1m, então path_len e o
+                ret_segments de _extract_target_from_path() perdem o sentido de distância.
+                Vale apenas para o planejador padrão.
+
+            coarse_to_fine : bool
+                Se True, caminhos longos são planejados em dois níveis: um quadro grosso de
+                blocos de 0.5m acha o corredor e a busca fina só roda nele, até 3m do início.
+                Dali em diante os pontos são os centros dos blocos, 0.5m entre si. Travessias
+                do campo passam a caber em poucos décimos de milissegundo. O custo deixa de
+                ser o ótimo. Consultas curtas seguem a busca comum. Vale apenas para o
+                planejador padrão e tem prioridade sobre jump_points e anytime.
+
+            use_cache : bool
+                Se True, o planejador padrão guarda os últimos caminhos buscados e devolve o
+                guardado quando a consulta se repete: mesmas células de início e alvo, mesmos
+                obstáculos depois de convertidos para o quadro e mesmas opções. O caminho é
+                idêntico ao de uma busca nova. Compensa para quem pede o mesmo caminho várias
+                vezes no ciclo ou de um ciclo para o outro, parado ou andando devagar.
+                Ignorado com anytime, cujo resultado depende do tempo.
+
         Retorna:
             path : ndarray
                 Uma sequência de posições (x, y) que formam o caminho.
+                É uma vista de um buffer deste agente, sobrescrito na próxima chamada.
+                Use path.copy() para guardá-lo.
 
             path_len : int
                 Quantidade de segmentos que formam o caminho (path_len == len(path)/2 - 1).
@@ -823,14 +934,35 @@ class PathManager:
         # Concatenará os obstaculos
         # Antes : obst = [(1, 2), (3, 4), (5, 6)]
         # Depois: obst = (1, 2, 3, 4, 5, 6)
+        moving = len(obstacles) > 0 and len(obstacles[0]) == 7
+        if moving and (shared_field or planner is not None):
+            obstacles = [o[:5] for o in obstacles]
+            moving = False
+
         obstacles = sum(obstacles, tuple())
-        assert len(obstacles) % 5 == 0, "Cada obstáculo deve ser caracterizado como 5 valores float, veja PathManager.py"
+        if moving:
+            assert len(obstacles) % 7 == 0, "Com velocidade, cada obstáculo deve ter 7 valores float, veja PathManager.py"
+        else:
+            assert len(obstacles) % 5 == 0, "Cada obstáculo deve ser caracterizado como 5 valores float, veja PathManager.py"
 
         # Path parameters: start, allow_out_of_bounds, go_to_goal, optional_target, timeout (us), obstacles
         params = np.array([*start, int(allow_out_of_bounds), go_to_goal, *optional_2d_target, timeout, *obstacles], np.float32)
-        path_ret = a_estrela.find_optimal_path(params)
-        path = path_ret[:-2]
-        path_status = path_ret[-2]
+        path = None
+        if shared_field:
+            path_ret = self._get_shared_field(params).path_from(*start)
+            if path_ret[-2] != PathManager.STATUS_IMPOSSIBLE:  # senão, a busca comum sabe devolver o melhor caminho parcial
+                path, path_status, path_cost = path_ret[:-2], int(path_ret[-2]), float(path_ret[-1])
+
+        if path is None:
+            # O caminho é escrito direto em self._path_buffer, e status e custo já voltam tipados.
+            if planner is None:
+                path_size, path_status, path_cost = self.planner.find_optimal_path_into(
+                    params, self._path_buffer, pontos_de_salto=jump_points, em_qualquer_tempo=anytime,
+                    qualquer_angulo=any_angle, em_dois_niveis=coarse_to_fine, obstaculos_em_movimento=moving,
+                    usar_cache=use_cache)
+            else:
+                path_size, path_status, path_cost = planner.find_optimal_path_into(params, self._path_buffer)
+            path = self._path_buffer[:path_size]
 
         # ---------------------------------------------- Draw path segments
         if self._draw_path:
@@ -841,4 +973,4 @@ class PathManager:
                     d.line((path[j], path[j + 1]), (path[j + 2], path[j + 3]), 1, c, "path_segments", False)
                 d.flush("path_segments")
 
-        return path, len(path) // 2 - 1, path_status, path_ret[-1]  # path, path_len (number of segments), path_status, path_cost (A* cost)
+        return path, len(path) // 2 - 1, path_status, path_cost  # path, path_len (number of segments), path_status, path_cost (A* cost)